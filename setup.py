@@ -80,6 +80,13 @@ Use "HEADLESS=True pip install ." to build in headless mode with pip""",
  Default value is otherwise false or provided  WITH_BULLET=ON or WITH_BULLET_OFF when doing pip install.""",
     )
     parser.add_argument("--no-bullet", dest="with_bullet", action="store_false")
+    parser.add_argument(
+        "--bullet-mt",
+        dest="with_bullet_mt",
+        action="store_true",
+        help="""Build Bullet with multi-threading support so physics can be stepped on
+ several threads (see PhysicsManagerAttributes.num_threads).""",
+    )
     parser.add_argument(
         "--vhacd",
         dest="with_vhacd",
@@ -334,6 +341,11 @@ class CMakeBuild(build_ext):
         cmake_args += [
             "-DBUILD_WITH_BULLET={}".format("ON" if args.with_bullet else "OFF")
         ]
+        cmake_args += [
+            "-DBUILD_WITH_BULLET_MULTITHREADING={}".format(
+                "ON" if args.with_bullet_mt else "OFF"
+            )
+        ]
         cmake_args += [
             "-DBUILD_WITH_VHACD={}".format("ON" if args.with_vhacd else "OFF")
         ]
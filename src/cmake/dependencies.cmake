@@ -108,6 +108,7 @@ set(BUILD_SHARED_LIBS OFF)
 include(GNUInstallDirs)
 add_subdirectory("${DEPS_DIR}/recastnavigation/Recast")
 add_subdirectory("${DEPS_DIR}/recastnavigation/Detour")
+add_subdirectory("${DEPS_DIR}/recastnavigation/DetourCrowd")
 set(BUILD_SHARED_LIBS ${_PREV_BUILD_SHARED_LIBS})
 # Needed so that Detour doesn't hide the implementation of the method on dtQueryFilter
 target_compile_definitions(Detour PUBLIC DT_VIRTUAL_QUERYFILTER)
@@ -184,10 +185,19 @@ if(BUILD_WITH_BULLET AND NOT USE_SYSTEM_BULLET)
   # that causes rigid objects to never come to rest.
   # This needs to be further examined on bullet side
   add_definitions(-DBT_DISABLE_CONVEX_CONCAVE_EARLY_OUT=1)
+  if(BUILD_WITH_BULLET_MULTITHREADING)
+    set(BULLET2_MULTITHREADING ON CACHE BOOL "" FORCE)
+  endif()
   add_subdirectory(${DEPS_DIR}/bullet3 EXCLUDE_FROM_ALL)
   set(CMAKE_CXX_FLAGS ${_PREV_CMAKE_CXX_FLAGS})
 endif()
 
+if(BUILD_WITH_BULLET AND BUILD_WITH_BULLET_MULTITHREADING)
+  # Bullet headers change layout with BT_THREADSAFE, so our code has to see the
+  # same definition Bullet itself was built with
+  add_definitions(-DBT_THREADSAFE=1)
+endif()
+
 # Magnum. Use a system package, if preferred.
 if(NOT USE_SYSTEM_MAGNUM)
   set(MAGNUM_BUILD_PLUGINS_STATIC ON CACHE BOOL "" FORCE)
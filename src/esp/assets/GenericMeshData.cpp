@@ -6,9 +6,15 @@
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/MeshTools/Compile.h>
+#include <Magnum/MeshTools/GenerateNormals.h>
 #include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/VertexFormat.h>
+
+#include "esp/geo/MeshSimplification.h"
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
@@ -25,17 +31,109 @@ void GenericMeshData::uploadBuffersToGPU(bool forceReload) {
 
   renderingBuffer_.reset();
   renderingBuffer_ = std::make_unique<GenericMeshData::RenderingBuffer>();
-  Magnum::MeshTools::CompileFlags compileFlags{};
-  if (needsNormals_ &&
-      !meshData_->hasAttribute(Mn::Trade::MeshAttribute::Normal)) {
-    compileFlags |= Magnum::MeshTools::CompileFlag::GenerateSmoothNormals;
+  const bool generateNormals =
+      needsNormals_ &&
+      !meshData_->hasAttribute(Mn::Trade::MeshAttribute::Normal);
+  if (lods_.empty()) {
+    Magnum::MeshTools::CompileFlags compileFlags{};
+    if (generateNormals) {
+      compileFlags |= Magnum::MeshTools::CompileFlag::GenerateSmoothNormals;
+    }
+    // position, normals, uv, colors are bound to corresponding attributes
+    renderingBuffer_->mesh =
+        Magnum::MeshTools::compile(*meshData_, compileFlags);
+    buffersOnGPU_ = true;
+    return;
+  }
+
+  // the levels of detail index into the vertices of the full mesh, so the
+  // vertices (with normals generated from the full mesh's triangles) are
+  // uploaded once and each level only adds its own index buffer
+  Cr::Containers::Optional<Mn::Trade::MeshData> withNormals;
+  if (generateNormals) {
+    withNormals = Mn::MeshTools::interleave(
+        *meshData_, {Mn::Trade::MeshAttributeData{
+                        Mn::Trade::MeshAttribute::Normal,
+                        Mn::VertexFormat::Vector3, nullptr}});
+    Mn::MeshTools::generateSmoothNormalsInto(
+        Cr::Containers::arrayView(collisionMeshData_.indices),
+        Cr::Containers::arrayView(positionData_),
+        withNormals->mutableAttribute<Mn::Vector3>(
+            Mn::Trade::MeshAttribute::Normal));
+  }
+  const Mn::Trade::MeshData& vertices = withNormals ? *withNormals : *meshData_;
+  renderingBuffer_->vertexBuffer = Mn::GL::Buffer{
+      Mn::GL::Buffer::TargetHint::Array, vertices.vertexData()};
+  renderingBuffer_->mesh = Magnum::MeshTools::compile(
+      vertices,
+      Mn::GL::Buffer{Mn::GL::Buffer::TargetHint::ElementArray,
+                     vertices.indexData()},
+      renderingBuffer_->vertexBuffer);
+
+  for (Lod& lod : lods_) {
+    const Mn::Trade::MeshIndexData indices{lod.indices};
+    const Mn::Trade::MeshData lodMeshData{
+        vertices.primitive(),
+        {},
+        lod.indices,
+        indices,
+        {},
+        vertices.vertexData(),
+        Mn::Trade::meshAttributeDataNonOwningArray(vertices.attributeData()),
+        vertices.vertexCount()};
+    lod.mesh = Magnum::MeshTools::compile(
+        lodMeshData,
+        Mn::GL::Buffer{Mn::GL::Buffer::TargetHint::ElementArray, lod.indices},
+        renderingBuffer_->vertexBuffer);
   }
-  // position, normals, uv, colors are bound to corresponding attributes
-  renderingBuffer_->mesh = Magnum::MeshTools::compile(*meshData_, compileFlags);
 
   buffersOnGPU_ = true;
 }
 
+Magnum::GL::Mesh* GenericMeshData::getLodGLMesh(std::size_t level) {
+  if (level >= lods_.size() || !lods_[level].mesh.id()) {
+    return nullptr;
+  }
+  return &lods_[level].mesh;
+}
+
+void GenericMeshData::generateLods(int levels) {
+  lods_.clear();
+  if (levels <= 0 || !meshData_ ||
+      meshData_->primitive() != Mn::MeshPrimitive::Triangles ||
+      !meshData_->isIndexed()) {
+    return;
+  }
+  // below this many triangles a mesh costs less than its draw call
+  constexpr std::size_t MinTriangles = 256;
+  const std::size_t fullIndexCount = collisionMeshData_.indices.size();
+  if (fullIndexCount < 2 * 3 * MinTriangles) {
+    return;
+  }
+
+  Cr::Containers::ArrayView<const Mn::UnsignedInt> previous =
+      collisionMeshData_.indices;
+  for (int level = 0; level < levels; ++level) {
+    std::vector<Mn::UnsignedInt> simplified =
+        geo::simplifyMesh(positionData_, previous, previous.size() / 2);
+    // stop once locked seams or flip checks keep the mesh from shrinking
+    if (simplified.size() * 4 > previous.size() * 3 ||
+        simplified.size() < 3 * MinTriangles) {
+      break;
+    }
+    Lod lod;
+    lod.indices = Cr::Containers::Array<Mn::UnsignedInt>{Cr::NoInit,
+                                                         simplified.size()};
+    Cr::Utility::copy(simplified, lod.indices);
+    lod.triangleRatio = float(simplified.size()) / float(fullIndexCount);
+    lods_.push_back(std::move(lod));
+    previous = lods_.back().indices;
+  }
+  if (!lods_.empty()) {
+    buffersOnGPU_ = false;
+  }
+}  // generateLods
+
 Magnum::GL::Mesh* GenericMeshData::getMagnumGLMesh() {
   if (renderingBuffer_ == nullptr) {
     return nullptr;
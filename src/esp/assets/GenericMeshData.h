@@ -10,7 +10,11 @@
  * esp::assets::GenericMeshData::RenderingBuffer
  */
 
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
@@ -34,6 +38,32 @@ class GenericMeshData : public BaseMesh {
      * @brief Compiled openGL render data for the mesh.
      */
     Magnum::GL::Mesh mesh;
+    /**
+     * @brief Vertex buffer shared by @ref mesh and the meshes of the levels
+     * of detail. Only created when there are any, otherwise @ref mesh owns
+     * its buffers.
+     */
+    Magnum::GL::Buffer vertexBuffer{Magnum::NoCreate};
+  };
+
+  /**
+   * @brief A simplified version of the mesh, see @ref generateLods.
+   */
+  struct Lod {
+    /**
+     * @brief Triangle indices into the vertices of the full mesh.
+     */
+    Corrade::Containers::Array<Magnum::UnsignedInt> indices;
+    /**
+     * @brief Triangle count relative to the full mesh.
+     */
+    float triangleRatio;
+    /**
+     * @brief Compiled openGL render data, see @ref uploadBuffersToGPU. Owns
+     * only its index buffer; the vertex buffer is @ref
+     * RenderingBuffer::vertexBuffer.
+     */
+    Magnum::GL::Mesh mesh{Magnum::NoCreate};
   };
 
   /** @brief Constructor. Sets @ref SupportedMeshType::GENERIC_MESH to identify
@@ -82,6 +112,29 @@ class GenericMeshData : public BaseMesh {
   void importAndSetMeshData(Magnum::Trade::AbstractImporter& importer,
                             const std::string& meshName);
 
+  /**
+   * @brief Generate up to @p levels simplified versions of the mesh, each
+   * with about half the triangles of the previous one, using @ref
+   * esp::geo::simplifyMesh. Levels stop early once the mesh does not simplify
+   * any further or gets too coarse to be worth a draw call of its own. Only
+   * indexed triangle meshes are simplified. Call before @ref
+   * uploadBuffersToGPU for the levels to be compiled.
+   * @param levels The maximum number of levels to generate.
+   */
+  void generateLods(int levels);
+
+  /**
+   * @brief The simplified versions of the mesh, finest first.
+   */
+  const std::vector<Lod>& getLods() const { return lods_; }
+
+  /**
+   * @brief Returns a pointer to the compiled mesh of a level of detail, or
+   * nullptr if not uploaded.
+   * @param level Index into @ref getLods.
+   */
+  Magnum::GL::Mesh* getLodGLMesh(std::size_t level);
+
   /**
    * @brief Returns a pointer to the compiled render data storage structure.
    * @return Pointer to the @ref renderingBuffer_.
@@ -107,6 +160,12 @@ class GenericMeshData : public BaseMesh {
 
   bool needsNormals_ = true;
 
+  /**
+   * @brief Simplified versions of the mesh, finest first. See @ref
+   * generateLods.
+   */
+  std::vector<Lod> lods_;
+
  private:
   /* Internal; can store data referenced by positions / indices if the original
      MeshData doesn't have them in desired type */
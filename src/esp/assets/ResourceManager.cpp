@@ -832,6 +832,11 @@ bool ResourceManager::loadRenderAsset(const AssetInfo& info) {
   bool registerMaterialOverride =
       (info.overridePhongMaterial != Cr::Containers::NullOpt);
   bool fileAssetIsLoaded = resourceDict_.count(info.filepath) > 0;
+  if (fileAssetIsLoaded) {
+    ++numAssetCacheHits_;
+  } else {
+    ++numAssetCacheMisses_;
+  }
 
   bool meshSuccess = fileAssetIsLoaded;
   // first load the file asset as-is if necessary
@@ -2411,6 +2416,7 @@ void ResourceManager::loadMeshes(Importer& importer,
     // compute the mesh bounding box
     gltfMeshData->BB = computeMeshBB(gltfMeshData.get());
     if (getCreateRenderer()) {
+      gltfMeshData->generateLods(meshLodLevels_);
       gltfMeshData->uploadBuffersToGPU(false);
     }
     meshes_.emplace(meshStart + iMesh, std::move(gltfMeshData));
@@ -2759,12 +2765,28 @@ void ResourceManager::addComponent(
       }
     }
 
-    createDrawable(mesh,                // render mesh
-                   meshAttributeFlags,  // mesh attribute flags
-                   node,                // scene node
-                   lightSetupKey,       // lightSetup Key
-                   materialKey,         // material key
-                   drawables);          // drawable group
+    gfx::Drawable& drawable =
+        createDrawable(mesh,                // render mesh
+                       meshAttributeFlags,  // mesh attribute flags
+                       node,                // scene node
+                       lightSetupKey,       // lightSetup Key
+                       materialKey,         // material key
+                       drawables);          // drawable group
+
+    // simplified meshes generated at load, see loadMeshes()
+    auto* genericMeshData =
+        dynamic_cast<GenericMeshData*>(meshes_.at(meshID).get());
+    if (mesh && genericMeshData && !genericMeshData->getLods().empty()) {
+      std::vector<gfx::Drawable::Lod> lods;
+      for (std::size_t i = 0; i < genericMeshData->getLods().size(); ++i) {
+        Mn::GL::Mesh* lodMesh = genericMeshData->getLodGLMesh(i);
+        if (lodMesh) {
+          lods.push_back(
+              {lodMesh, genericMeshData->getLods()[i].triangleRatio});
+        }
+      }
+      drawable.setLods(std::move(lods));
+    }
 
     // compute the bounding box for the mesh we are adding
     if (computeAbsoluteAABBs) {
@@ -2811,29 +2833,28 @@ void ResourceManager::removePrimitiveMesh(int primitiveID) {
   primitive_meshes_.erase(primMeshIter);
 }
 
-void ResourceManager::createDrawable(Mn::GL::Mesh* mesh,
-                                     gfx::Drawable::Flags& meshAttributeFlags,
-                                     scene::SceneNode& node,
-                                     const Mn::ResourceKey& lightSetupKey,
-                                     const Mn::ResourceKey& materialKey,
-                                     DrawableGroup* group /* = nullptr */) {
+gfx::Drawable& ResourceManager::createDrawable(
+    Mn::GL::Mesh* mesh,
+    gfx::Drawable::Flags& meshAttributeFlags,
+    scene::SceneNode& node,
+    const Mn::ResourceKey& lightSetupKey,
+    const Mn::ResourceKey& materialKey,
+    DrawableGroup* group /* = nullptr */) {
   const auto& materialDataType =
       shaderManager_.get<gfx::MaterialData>(materialKey)->type;
   switch (materialDataType) {
     case gfx::MaterialDataType::None:
-      CORRADE_INTERNAL_ASSERT_UNREACHABLE();
       break;
     case gfx::MaterialDataType::Phong:
-      node.addFeature<gfx::GenericDrawable>(
+      return node.addFeature<gfx::GenericDrawable>(
           mesh,                // render mesh
           meshAttributeFlags,  // mesh attribute flags
           shaderManager_,      // shader manager
           lightSetupKey,       // lightSetup key
           materialKey,         // material key
           group);              // drawable group
-      break;
     case gfx::MaterialDataType::Pbr:
-      node.addFeature<gfx::PbrDrawable>(
+      return node.addFeature<gfx::PbrDrawable>(
           mesh,                // render mesh
           meshAttributeFlags,  // mesh attribute flags
           shaderManager_,      // shader manager
@@ -2842,8 +2863,8 @@ void ResourceManager::createDrawable(Mn::GL::Mesh* mesh,
           group,               // drawable group
           activePbrIbl_ >= 0 ? pbrImageBasedLightings_[activePbrIbl_].get()
                              : nullptr);  // pbr image based lighting
-      break;
   }
+  CORRADE_INTERNAL_ASSERT_UNREACHABLE();
 }  // ResourceManager::createDrawable
 
 void ResourceManager::initDefaultLightSetups() {
@@ -551,9 +551,10 @@ class ResourceManager {
    * for the drawable.
    * @param group Optional @ref DrawableGroup with which the render the @ref
    * gfx::Drawable.
+   * @return The new drawable, owned by @p node.
    */
 
-  void createDrawable(Mn::GL::Mesh* mesh,
+  gfx::Drawable& createDrawable(Mn::GL::Mesh* mesh,
                       gfx::Drawable::Flags& meshAttributeFlags,
                       scene::SceneNode& node,
                       const Mn::ResourceKey& lightSetupKey,
@@ -629,6 +630,13 @@ class ResourceManager {
    */
   inline void setRequiresTextures(bool newVal) { requiresTextures_ = newVal; }
 
+  /**
+   * @brief Sets the number of simplified levels of detail generated for each
+   * render mesh loaded from now on. See @ref
+   * GenericMeshData::generateLods.
+   */
+  void setMeshLodLevels(int levels) { meshLodLevels_ = levels; }
+
   /**
    * @brief Set a replay recorder so that ResourceManager can notify it about
    * render assets.
@@ -704,6 +712,26 @@ class ResourceManager {
    */
   bool loadRenderAsset(const AssetInfo& info);
 
+  /**
+   * @brief Get the number of @ref loadRenderAsset calls that were served from
+   * already loaded asset data.
+   */
+  size_t getNumAssetCacheHits() const { return numAssetCacheHits_; }
+
+  /**
+   * @brief Get the number of @ref loadRenderAsset calls that required loading
+   * the asset from disk or building it.
+   */
+  size_t getNumAssetCacheMisses() const { return numAssetCacheMisses_; }
+
+  /**
+   * @brief Reset the asset cache hit and miss counters.
+   */
+  void resetAssetCacheStats() {
+    numAssetCacheHits_ = 0;
+    numAssetCacheMisses_ = 0;
+  }
+
   /**
    * @brief get the shader manager
    */
@@ -1247,6 +1275,12 @@ class ResourceManager {
    */
   std::map<std::string, LoadedAssetData> resourceDict_;
 
+  /**
+   * @brief Counters for @ref loadRenderAsset lookups into @ref resourceDict_.
+   */
+  size_t numAssetCacheHits_ = 0;
+  size_t numAssetCacheMisses_ = 0;
+
   /**
    * @brief The @ref ShaderManager used to store shader information for
    * drawables created by this ResourceManager
@@ -1320,6 +1354,11 @@ class ResourceManager {
    */
   bool requiresTextures_ = true;
 
+  /**
+   * @brief Number of levels of detail generated for loaded render meshes
+   */
+  int meshLodLevels_ = 0;
+
   /**
    * @brief See @ref setRecorder.
    */
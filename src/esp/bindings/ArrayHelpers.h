@@ -0,0 +1,69 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_BINDINGS_ARRAYHELPERS_H_
+#define ESP_BINDINGS_ARRAYHELPERS_H_
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <Corrade/Containers/ArrayView.h>
+
+#include "esp/core/Check.h"
+
+namespace esp {
+namespace bindings {
+
+/**
+ * @brief NumPy array type accepted for read-only float input. Arrays of other
+ * dtypes or layouts are converted, which copies them.
+ */
+typedef pybind11::array_t<float,
+                          pybind11::array::c_style | pybind11::array::forcecast>
+    FloatInputArray;
+
+/**
+ * @brief Return @p out as a float32 NumPy array of @p size elements, or
+ * allocate a new one if @p out is None.
+ *
+ * A provided array is used in place, never copied, so it must already be
+ * a writeable, C-contiguous float32 array of the right size. This lets tight
+ * Python loops reuse one buffer across calls.
+ */
+inline pybind11::array_t<float> floatOutputArray(const pybind11::object& out,
+                                                 size_t size) {
+  if (out.is_none()) {
+    return pybind11::array_t<float>(size);
+  }
+  ESP_CHECK(
+      (pybind11::array_t<float, pybind11::array::c_style>::check_(out)),
+      "Output array must be a C-contiguous numpy array of dtype float32");
+  auto array = pybind11::reinterpret_borrow<pybind11::array_t<float>>(out);
+  ESP_CHECK(array.writeable(), "Output array must be writeable");
+  ESP_CHECK(size_t(array.size()) == size,
+            "Output array must have" << size << "elements, got"
+                                     << array.size());
+  return array;
+}
+
+/**
+ * @brief View the contents of a float NumPy array as a mutable array view.
+ */
+inline Corrade::Containers::ArrayView<float> mutableFloatView(
+    pybind11::array_t<float>& array) {
+  return {array.mutable_data(), size_t(array.size())};
+}
+
+/**
+ * @brief View the contents of a float NumPy array as a read-only array view.
+ */
+inline Corrade::Containers::ArrayView<const float> floatView(
+    const FloatInputArray& array) {
+  return {array.data(), size_t(array.size())};
+}
+
+}  // namespace bindings
+}  // namespace esp
+
+#endif  // ESP_BINDINGS_ARRAYHELPERS_H_
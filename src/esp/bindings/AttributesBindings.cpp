@@ -447,7 +447,17 @@ void initAttributesBindings(py::module& m) {
           &PhysicsManagerAttributes::getRestitutionCoefficient,
           &PhysicsManagerAttributes::setRestitutionCoefficient,
           R"(Default restitution coefficient for contact modeling.  Can be overridden by
-          stage and object values.)");
+          stage and object values.)")
+      .def_property(
+          "num_threads", &PhysicsManagerAttributes::getNumThreads,
+          &PhysicsManagerAttributes::setNumThreads,
+          R"(Number of threads the physics engine may use to step the world.  1 steps
+          single-threaded.  Requires Bullet built with multi-threading support.)")
+      .def_property(
+          "deterministic", &PhysicsManagerAttributes::getDeterministic,
+          &PhysicsManagerAttributes::setDeterministic,
+          R"(Whether multi-threaded stepping must reproduce the same results run to
+          run.  Costs a sort of the contact manifolds every substep.)");
 
   // ==== AbstractPrimitiveAttributes ====
   py::class_<AbstractPrimitiveAttributes, AbstractAttributes,
@@ -53,6 +53,9 @@ void initGfxBindings(py::module& m) {
 
   flags.value("FRUSTUM_CULLING", RenderCamera::Flag::FrustumCulling)
       .value("OBJECTS_ONLY", RenderCamera::Flag::ObjectsOnly)
+      .value("SORT_BY_STATE", RenderCamera::Flag::SortByState)
+      .value("INSTANCING", RenderCamera::Flag::Instancing)
+      .value("COLLECT_STATE_STATS", RenderCamera::Flag::CollectStateStats)
       .value("NONE", RenderCamera::Flag{});
   pybindEnumOperators(flags);
 
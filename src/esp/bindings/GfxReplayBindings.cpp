@@ -7,6 +7,7 @@
 #include <Magnum/PythonBindings.h>
 #include <Magnum/SceneGraph/PythonBindings.h>
 
+#include "esp/gfx/replay/KeyframeStream.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/ReplayManager.h"
 
@@ -45,6 +46,18 @@ void initGfxReplayBindings(py::module& m) {
           "close", &Player::close,
           R"(Unload all keyframes. The Player is unusable after it is closed.)");
 
+  py::class_<KeyframeStreamClient, KeyframeStreamClient::ptr>(
+      m, "KeyframeStreamClient",
+      R"(Receives keyframes streamed by ReplayManager.start_keyframe_stream.)")
+      .def(py::init<int>(), "port"_a,
+           R"(Connect to a keyframe stream on localhost.)")
+      .def("is_connected", &KeyframeStreamClient::isConnected,
+           R"(Whether the stream is still connected.)")
+      .def(
+          "receive_keyframes", &KeyframeStreamClient::receiveKeyframes,
+          R"(Append the keyframes received so far to a Player without blocking, and return how many were appended. Keyframes only hold changes, so set the Player's keyframe index to the last one rather than skipping frames.)",
+          "player"_a);
+
   py::class_<ReplayManager, ReplayManager::ptr>(m, "ReplayManager")
       .def(
           "save_keyframe",
@@ -97,6 +110,44 @@ void initGfxReplayBindings(py::module& m) {
           },
           R"(Write all saved keyframes to a string, then discard the keyframes.)")
 
+      .def(
+          "set_transform_quantization",
+          [](ReplayManager& self, float translationStep, int rotationBits) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            self.getRecorder()->setTransformQuantization(
+                {translationStep, rotationBits});
+          },
+          R"(Quantize instance transforms in saved keyframes: translations to multiples of translation_step (e.g. 0.001 for millimeters) and rotations to 3 * rotation_bits + 2 bits. Per-instance changes are delta-encoded when written. A translation_step of 0 disables quantization.)",
+          "translation_step"_a, "rotation_bits"_a = 10)
+
+      .def(
+          "start_keyframe_stream",
+          [](ReplayManager& self, int port) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            auto server = std::make_shared<KeyframeStreamServer>(port);
+            self.getRecorder()->setKeyframeStreamServer(server);
+            return server->getPort();
+          },
+          R"(Stream every saved keyframe to viewers connecting on localhost, see KeyframeStreamClient. Pass port 0 to pick a free port. Returns the port.)",
+          "port"_a = 0)
+
+      .def(
+          "stop_keyframe_stream",
+          [](ReplayManager& self) {
+            if (self.getRecorder()) {
+              self.getRecorder()->setKeyframeStreamServer(nullptr);
+            }
+          },
+          R"(Stop streaming keyframes and disconnect all viewers.)")
+
       .def("read_keyframes_from_file", &ReplayManager::readKeyframesFromFile,
            R"(Create a Player object from a replay file.)");
 }
@@ -1,5 +1,8 @@
 #include "esp/bindings/Bindings.h"
 #include "esp/bindings/EnumOperators.h"
+
+#include <pybind11/numpy.h>
+
 #include "esp/physics/PhysicsManager.h"
 
 namespace py = pybind11;
@@ -146,6 +149,50 @@ void initPhysicsBindings(py::module& m) {
       .def_readonly("ray", &RaycastResults::ray)
       .def("has_hits", &RaycastResults::hasHits);
 
+  // ==== struct object RaycastBatchResults ====
+  py::class_<RaycastBatchResults, RaycastBatchResults::ptr>(
+      m, "RaycastBatchResults")
+      .def(py::init(&RaycastBatchResults::create<>))
+      .def_property_readonly(
+          "hit_offsets",
+          [](const RaycastBatchResults& self) {
+            return py::array_t<std::size_t>(self.hitOffsets.size(),
+                                            self.hitOffsets.data());
+          },
+          R"(Per-ray offsets into the hit arrays. The hits of ray i are in [hit_offsets[i], hit_offsets[i + 1]).)")
+      .def_property_readonly(
+          "object_ids",
+          [](const RaycastBatchResults& self) {
+            return py::array_t<int>(self.objectIds.size(),
+                                    self.objectIds.data());
+          },
+          R"(The id of the object hit by each hit. Stage hits are -1.)")
+      .def_property_readonly(
+          "points",
+          [](const RaycastBatchResults& self) {
+            return py::array_t<float>(
+                {self.points.size(), std::size_t{3}},
+                self.points.empty() ? nullptr : self.points.front().data());
+          },
+          R"((num_hits, 3) array of impact points in world space.)")
+      .def_property_readonly(
+          "normals",
+          [](const RaycastBatchResults& self) {
+            return py::array_t<float>(
+                {self.normals.size(), std::size_t{3}},
+                self.normals.empty() ? nullptr : self.normals.front().data());
+          },
+          R"((num_hits, 3) array of collision normals at the points of impact.)")
+      .def_property_readonly(
+          "ray_distances",
+          [](const RaycastBatchResults& self) {
+            return py::array_t<float>(self.rayDistances.size(),
+                                      self.rayDistances.data());
+          },
+          R"(Distance of each hit along its ray direction in units of ray length.)")
+      .def_property_readonly("num_rays", &RaycastBatchResults::numRays)
+      .def("num_hits", &RaycastBatchResults::numHits, "ray_index"_a);
+
   // ==== struct object ContactPointData ====
   py::class_<ContactPointData, ContactPointData::ptr>(m, "ContactPointData")
       .def(py::init(&ContactPointData::create<>))
@@ -2,6 +2,7 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include "esp/bindings/ArrayHelpers.h"
 #include "esp/bindings/Bindings.h"
 #include "esp/physics/PhysicsObjectBase.h"
 #include "esp/physics/RigidBase.h"
@@ -382,30 +383,122 @@ void declareArticulatedObjectWrapper(py::module& m,
           &ManagedArticulatedObject::setRootAngularVelocity,
           ("The angular velocity (omega) of the " + objType + "'s root.")
               .c_str())
-      .def_property("joint_forces", &ManagedArticulatedObject::getJointForces,
-                    &ManagedArticulatedObject::setJointForces,
-                    ("Get or set the joint forces/torques (indexed by DoF id) "
-                     "currently acting on this " +
-                     objType + ".")
-                        .c_str())
-      .def("add_joint_forces", &ManagedArticulatedObject::addJointForces,
+      .def_property_readonly(
+          "num_dofs", &ManagedArticulatedObject::getNumDofs,
+          ("The number of degrees of freedom of this " + objType +
+           ", i.e. the length of its joint force and velocity arrays.")
+              .c_str())
+      .def_property_readonly(
+          "num_joint_positions",
+          &ManagedArticulatedObject::getNumJointPositions,
+          ("The number of joint position variables of this " + objType + ".")
+              .c_str())
+      .def_property(
+          "joint_forces",
+          py::overload_cast<>(&ManagedArticulatedObject::getJointForces),
+          py::overload_cast<const std::vector<float>&>(
+              &ManagedArticulatedObject::setJointForces),
+          ("Get or set the joint forces/torques (indexed by DoF id) "
+           "currently acting on this " +
+           objType + ".")
+              .c_str())
+      .def("add_joint_forces",
+           py::overload_cast<const std::vector<float>&>(
+               &ManagedArticulatedObject::addJointForces),
            ("Add joint forces/torques (indexed by DoF id) to this " + objType +
             ".")
                .c_str(),
            "forces"_a)
-      .def_property("joint_velocities",
-                    &ManagedArticulatedObject::getJointVelocities,
-                    &ManagedArticulatedObject::setJointVelocities,
-                    ("Get or set this " + objType +
-                     "'s joint velocities, indexed by DOF id.")
-                        .c_str())
-      .def_property("joint_positions",
-                    &ManagedArticulatedObject::getJointPositions,
-                    &ManagedArticulatedObject::setJointPositions,
-                    ("Get or set this " + objType +
-                     "'s joint positions. For link to index mapping see "
-                     "get_link_joint_pos_offset and get_link_num_joint_pos.")
-                        .c_str())
+      .def_property(
+          "joint_velocities",
+          py::overload_cast<>(&ManagedArticulatedObject::getJointVelocities),
+          py::overload_cast<const std::vector<float>&>(
+              &ManagedArticulatedObject::setJointVelocities),
+          ("Get or set this " + objType +
+           "'s joint velocities, indexed by DOF id.")
+              .c_str())
+      .def_property(
+          "joint_positions",
+          py::overload_cast<>(&ManagedArticulatedObject::getJointPositions),
+          py::overload_cast<const std::vector<float>&>(
+              &ManagedArticulatedObject::setJointPositions),
+          ("Get or set this " + objType +
+           "'s joint positions. For link to index mapping see "
+           "get_link_joint_pos_offset and get_link_num_joint_pos.")
+              .c_str())
+      .def(
+          "get_joint_forces_array",
+          [](ManagedArticulatedObject& self, const py::object& out) {
+            py::array_t<float> forces =
+                bindings::floatOutputArray(out, self.getNumDofs());
+            self.getJointForces(bindings::mutableFloatView(forces));
+            return forces;
+          },
+          ("Get this " + objType +
+           "'s joint forces/torques as a float32 numpy array. If 'out' is "
+           "given, the values are written into it in place and it is "
+           "returned.")
+              .c_str(),
+          "out"_a = py::none())
+      .def(
+          "set_joint_forces_array",
+          [](ManagedArticulatedObject& self,
+             const bindings::FloatInputArray& forces) {
+            self.setJointForces(bindings::floatView(forces));
+          },
+          ("Set this " + objType +
+           "'s joint forces/torques from a numpy array without converting "
+           "it to a list.")
+              .c_str(),
+          "forces"_a)
+      .def(
+          "get_joint_velocities_array",
+          [](ManagedArticulatedObject& self, const py::object& out) {
+            py::array_t<float> vels =
+                bindings::floatOutputArray(out, self.getNumDofs());
+            self.getJointVelocities(bindings::mutableFloatView(vels));
+            return vels;
+          },
+          ("Get this " + objType +
+           "'s joint velocities as a float32 numpy array. If 'out' is given, "
+           "the values are written into it in place and it is returned.")
+              .c_str(),
+          "out"_a = py::none())
+      .def(
+          "set_joint_velocities_array",
+          [](ManagedArticulatedObject& self,
+             const bindings::FloatInputArray& vels) {
+            self.setJointVelocities(bindings::floatView(vels));
+          },
+          ("Set this " + objType +
+           "'s joint velocities from a numpy array without converting it to "
+           "a list.")
+              .c_str(),
+          "velocities"_a)
+      .def(
+          "get_joint_positions_array",
+          [](ManagedArticulatedObject& self, const py::object& out) {
+            py::array_t<float> positions =
+                bindings::floatOutputArray(out, self.getNumJointPositions());
+            self.getJointPositions(bindings::mutableFloatView(positions));
+            return positions;
+          },
+          ("Get this " + objType +
+           "'s joint positions as a float32 numpy array. If 'out' is given, "
+           "the values are written into it in place and it is returned.")
+              .c_str(),
+          "out"_a = py::none())
+      .def(
+          "set_joint_positions_array",
+          [](ManagedArticulatedObject& self,
+             const bindings::FloatInputArray& positions) {
+            self.setJointPositions(bindings::floatView(positions));
+          },
+          ("Set this " + objType +
+           "'s joint positions from a numpy array without converting it to "
+           "a list.")
+              .c_str(),
+          "positions"_a)
       .def("get_joint_motor_torques",
            &ManagedArticulatedObject::getJointMotorTorques,
            ("Get " + objType +
@@ -2,6 +2,7 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include "esp/bindings/ArrayHelpers.h"
 #include "esp/bindings/Bindings.h"
 
 #include "esp/physics/bullet/objectWrappers/ManagedBulletArticulatedObject.h"
@@ -290,7 +291,45 @@ void initPhysicsWrapperManagerBindings(pybind11::module& m) {
           "light_setup_key"_a = DEFAULT_LIGHTING_KEY,
           R"(Load and parse a URDF file using the given 'filepath' into a model,
           then use this model to instantiate an Articulated Object in the world.
-          Returns a reference to the created object.)");
+          Returns a reference to the created object.)")
+      .def("get_num_dofs", &ArticulatedObjectManager::getNumDofs,
+           "object_ids"_a,
+           R"(Get the summed number of degrees of freedom of the articulated
+          objects with the given ids.)")
+      .def("get_num_joint_positions",
+           &ArticulatedObjectManager::getNumJointPositions, "object_ids"_a,
+           R"(Get the summed number of joint positions of the articulated
+          objects with the given ids.)")
+      .def(
+          "get_joint_positions",
+          [](ArticulatedObjectManager& self, const std::vector<int>& objectIds,
+             const py::object& out) {
+            py::array_t<float> positions = bindings::floatOutputArray(
+                out, self.getNumJointPositions(objectIds));
+            self.gatherJointPositions(objectIds,
+                                      bindings::mutableFloatView(positions));
+            return positions;
+          },
+          "object_ids"_a, "out"_a = py::none(),
+          R"(Gather the joint positions of the articulated objects with the
+          given ids into one contiguous float32 numpy array, object after
+          object. If 'out' is given, the values are written into it in place
+          and it is returned.)")
+      .def(
+          "get_joint_velocities",
+          [](ArticulatedObjectManager& self, const std::vector<int>& objectIds,
+             const py::object& out) {
+            py::array_t<float> velocities =
+                bindings::floatOutputArray(out, self.getNumDofs(objectIds));
+            self.gatherJointVelocities(objectIds,
+                                       bindings::mutableFloatView(velocities));
+            return velocities;
+          },
+          "object_ids"_a, "out"_a = py::none(),
+          R"(Gather the joint velocities of the articulated objects with the
+          given ids into one contiguous float32 numpy array, object after
+          object. If 'out' is given, the values are written into it in place
+          and it is returned.)");
 }  // initPhysicsWrapperManagerBindings
 
 }  // namespace physics
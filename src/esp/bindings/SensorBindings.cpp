@@ -2,6 +2,7 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include "esp/bindings/ArrayHelpers.h"
 #include "esp/bindings/Bindings.h"
 
 #include <Corrade/Containers/OptionalPythonBindings.h>
@@ -17,6 +18,7 @@
 #include "esp/sensor/CubeMapSensorBase.h"
 #include "esp/sensor/EquirectangularSensor.h"
 #include "esp/sensor/FisheyeSensor.h"
+#include "esp/sensor/LidarSensor.h"
 #include "esp/sensor/VisualSensor.h"
 #ifdef ESP_BUILD_WITH_CUDA
 #include "esp/sensor/RedwoodNoiseModel.h"
@@ -57,7 +59,8 @@ void initSensorBindings(py::module& m) {
       .value("COLOR", SensorType::Color)
       .value("DEPTH", SensorType::Depth)
       .value("SEMANTIC", SensorType::Semantic)
-      .value("AUDIO", SensorType::Audio);
+      .value("AUDIO", SensorType::Audio)
+      .value("LIDAR", SensorType::Lidar);
 
   py::enum_<SensorSubType>(m, "SensorSubType")
       .value("NONE", SensorSubType::None)
@@ -65,7 +68,8 @@ void initSensorBindings(py::module& m) {
       .value("ORTHOGRAPHIC", SensorSubType::Orthographic)
       .value("FISHEYE", SensorSubType::Fisheye)
       .value("EQUIRECTANGULAR", SensorSubType::Equirectangular)
-      .value("IMPULSERESPONSE", SensorSubType::ImpulseResponse);
+      .value("IMPULSERESPONSE", SensorSubType::ImpulseResponse)
+      .value("RAYCAST", SensorSubType::Raycast);
   ;
 
   py::enum_<FisheyeSensorModelType>(m, "FisheyeSensorModelType")
@@ -105,7 +109,11 @@ void initSensorBindings(py::module& m) {
       .def_readwrite("resolution", &VisualSensorSpec::resolution)
       .def_readwrite("gpu2gpu_transfer", &VisualSensorSpec::gpu2gpuTransfer)
       .def_readwrite("channels", &VisualSensorSpec::channels)
-      .def_readwrite("clear_color", &CameraSensorSpec::clearColor);
+      .def_readwrite("clear_color", &CameraSensorSpec::clearColor)
+      .def_readwrite(
+          "lod_threshold", &VisualSensorSpec::lodThreshold,
+          R"(On-screen size in pixels below which simplified meshes are drawn,
+          if the simulator generated them (mesh_lod_levels). 0 disables.)");
 
   // ====CameraSensorSpec ====
   py::class_<CameraSensorSpec, CameraSensorSpec::ptr, VisualSensorSpec>(
@@ -154,6 +162,49 @@ void initSensorBindings(py::module& m) {
       .def_readwrite("alpha", &FisheyeSensorDoubleSphereSpec::alpha)
       .def_readwrite("xi", &FisheyeSensorDoubleSphereSpec::xi);
 
+  // ==== LidarSensorSpec ====
+  py::class_<LidarSensorSpec, LidarSensorSpec::ptr, SensorSpec>(
+      m, "LidarSensorSpec", py::dynamic_attr())
+      .def(py::init(&LidarSensorSpec::create<>))
+      .def_readwrite("horizontal_resolution",
+                     &LidarSensorSpec::horizontalResolution,
+                     R"(Number of beams per ring.)")
+      .def_readwrite("vertical_resolution",
+                     &LidarSensorSpec::verticalResolution,
+                     R"(Number of rings. 1 gives a planar scan.)")
+      .def_property(
+          "horizontal_fov",
+          [](LidarSensorSpec& self) { return Mn::Degd(self.horizontalFov); },
+          [](LidarSensorSpec& self, const py::object& angle) {
+            auto PyDeg = py::module_::import("magnum").attr("Deg");
+            self.horizontalFov = Mn::Deg(PyDeg(angle).cast<Mn::Degd>());
+          },
+          R"(Horizontal field of view of each ring, centered on the forward direction.)")
+      .def_property(
+          "vertical_fov_min",
+          [](LidarSensorSpec& self) { return Mn::Degd(self.verticalFovMin); },
+          [](LidarSensorSpec& self, const py::object& angle) {
+            auto PyDeg = py::module_::import("magnum").attr("Deg");
+            self.verticalFovMin = Mn::Deg(PyDeg(angle).cast<Mn::Degd>());
+          },
+          R"(Elevation of the lowest ring.)")
+      .def_property(
+          "vertical_fov_max",
+          [](LidarSensorSpec& self) { return Mn::Degd(self.verticalFovMax); },
+          [](LidarSensorSpec& self, const py::object& angle) {
+            auto PyDeg = py::module_::import("magnum").attr("Deg");
+            self.verticalFovMax = Mn::Deg(PyDeg(angle).cast<Mn::Degd>());
+          },
+          R"(Elevation of the highest ring.)")
+      .def_readwrite("min_range", &LidarSensorSpec::minRange,
+                     R"(Hits closer than this distance are ignored.)")
+      .def_readwrite("max_range", &LidarSensorSpec::maxRange,
+                     R"(Maximum distance of a return.)")
+      .def_readwrite("no_return_value", &LidarSensorSpec::noReturnValue,
+                     R"(Range reported for beams without a return.)")
+      .def_property_readonly("num_beams", &LidarSensorSpec::numBeams)
+      .def("__eq__", &LidarSensorSpec::operator==);
+
   // ==== SensorFactory ====
   py::class_<SensorFactory>(m, "SensorFactory")
       .def("create_sensors", &SensorFactory::createSensors)
@@ -274,6 +325,35 @@ void initSensorBindings(py::module& m) {
       .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
                           const FisheyeSensorSpec::ptr&>());
 
+  // === LidarSensor ====
+  py::class_<LidarSensor, Magnum::SceneGraph::PyFeature<LidarSensor>, Sensor,
+             Magnum::SceneGraph::PyFeatureHolder<LidarSensor>>(m, "LidarSensor")
+      .def(py::init_alias<std::reference_wrapper<scene::SceneNode>,
+                          const LidarSensorSpec::ptr&>())
+      .def(
+          "scan",
+          [](LidarSensor& self, sim::Simulator& sim, const py::object& out) {
+            const LidarSensorSpec& spec = *self.specification();
+            auto ranges = bindings::floatOutputArray(out, spec.numBeams());
+            self.scan(sim, bindings::mutableFloatView(ranges));
+            return ranges.attr("reshape")(spec.verticalResolution,
+                                          spec.horizontalResolution);
+          },
+          "sim"_a, "out"_a = py::none(),
+          R"(Cast all beams from the current sensor pose into the collision world of sim and return a (vertical_resolution, horizontal_resolution) array of ranges. Rings are ordered top to bottom. Physics must be enabled. Pass a float32 array as out to reuse it.)")
+      .def("update_beam_directions", &LidarSensor::updateBeamDirections,
+           R"(Recompute the beam pattern after modifying the specification.)")
+      .def_property_readonly(
+          "beam_directions",
+          [](LidarSensor& self) {
+            const std::vector<Mn::Vector3>& directions =
+                self.getBeamDirections();
+            return py::array_t<float>(
+                {directions.size(), std::size_t{3}},
+                directions.empty() ? nullptr : directions.front().data());
+          },
+          R"((num_beams, 3) array of unit beam directions in the sensor frame.)");
+
 #ifdef ESP_BUILD_WITH_CUDA
   py::class_<RedwoodNoiseModelGPUImpl, RedwoodNoiseModelGPUImpl::uptr>(
       m, "RedwoodNoiseModelGPUImpl")
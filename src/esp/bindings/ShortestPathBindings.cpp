@@ -6,6 +6,7 @@
 
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 #include <Corrade/Containers/OptionalPythonBindings.h>
@@ -13,9 +14,11 @@
 
 #include "esp/assets/MeshData.h"
 #include "esp/core/Esp.h"
+#include "esp/nav/Crowd.h"
 #include "esp/nav/GreedyFollower.h"
 #include "esp/nav/PathFinder.h"
 #include "esp/scene/ObjectControls.h"
+#include "esp/scene/SceneNode.h"
 
 namespace py = pybind11;
 namespace Mn = Magnum;
@@ -82,7 +85,35 @@ void initShortestPathBindings(py::module& m) {
            R"(Returns the topdown view of the PathFinder's navmesh.)",
            "meters_per_pixel"_a, "height"_a)
       .def("get_random_navigable_point", &PathFinder::getRandomNavigablePoint,
+           R"(Returns a random navigable point. max_tries is ignored, sampling
+          never retries.)",
            "max_tries"_a = 10)
+      .def(
+          "get_random_navigable_points",
+          [](PathFinder& self, int numPoints, float minIslandRadius) {
+            const std::vector<vec3f> points =
+                self.getRandomNavigablePoints(numPoints, minIslandRadius);
+            return py::array_t<float>(
+                {points.size(), std::size_t{3}},
+                points.empty() ? nullptr : points.front().data());
+          },
+          R"(Returns a (num_points, 3) array of points sampled uniformly over
+          the navmesh area, on islands with at least min_island_radius. Empty
+          if no island qualifies.)",
+          "num_points"_a, "min_island_radius"_a = 0.0)
+      .def(
+          "get_random_navigable_points_on_island",
+          [](PathFinder& self, int numPoints, const vec3f& islandPoint) {
+            const std::vector<vec3f> points =
+                self.getRandomNavigablePointsOnIsland(numPoints, islandPoint);
+            return py::array_t<float>(
+                {points.size(), std::size_t{3}},
+                points.empty() ? nullptr : points.front().data());
+          },
+          R"(Returns a (num_points, 3) array of points sampled uniformly over
+          the island island_point is on. Empty if island_point isn't on the
+          navmesh.)",
+          "num_points"_a, "island_point"_a)
       .def("get_random_navigable_point_near",
            &PathFinder::getRandomNavigablePointAroundSphere, "circle_center"_a,
            "radius"_a, "max_tries"_a = 100)
@@ -107,7 +138,11 @@ void initShortestPathBindings(py::module& m) {
            [](PathFinder& self) { return self.getNavMeshData()->vbo; })
       .def("build_navmesh_vertex_indices",
            [](PathFinder& self) { return self.getNavMeshData()->ibo; })
-      .def("load_nav_mesh", &PathFinder::loadNavMesh, "path"_a)
+      .def("load_nav_mesh", &PathFinder::loadNavMesh,
+           R"(Loads a navmesh saved by save_nav_mesh. With memory_map, the file
+          is mapped copy-on-write and its unmodified pages are shared by all
+          processes loading it.)",
+           "path"_a, "memory_map"_a = false)
       .def("save_nav_mesh", &PathFinder::saveNavMesh, "path"_a)
       .def("distance_to_closest_obstacle",
            &PathFinder::distanceToClosestObstacle,
@@ -118,6 +153,14 @@ void initShortestPathBindings(py::module& m) {
            R"(Returns the hit_pos, hit_normal and hit_dist of the surface point
           on the closest obstacle.)",
            "pt"_a, "max_search_radius"_a = 2.0)
+      .def("build_clearance_field", &PathFinder::buildClearanceField,
+           R"(Precomputes obstacle distances up to max_radius on a grid, making
+          distance_to_closest_obstacle a lookup. The grid uses the navmesh
+          cell size if cell_size is 0 and is rebuilt with the navmesh.)",
+           "max_radius"_a = 2.0, "cell_size"_a = 0.0)
+      .def("clear_clearance_field", &PathFinder::clearClearanceField)
+      .def_property_readonly("has_clearance_field",
+                             &PathFinder::hasClearanceField)
       .def("is_navigable", &PathFinder::isNavigable,
            R"(Checks to see if the agent can stand at the specified point.)",
            "pt"_a, "max_y_delta"_a = 0.5)
@@ -162,7 +205,66 @@ void initShortestPathBindings(py::module& m) {
            py::overload_cast<const core::RigidState&, const Mn::Vector3&>(
                &GreedyGeodesicFollowerImpl::findPath),
            py::return_value_policy::move)
+      .def("build_action_table", &GreedyGeodesicFollowerImpl::buildActionTable,
+           R"(Precomputes the action towards end from every pose of a lattice
+          with cells of cell_size, making next_action_along and find_path
+          towards end table lookups. Returns the number of lattice cells.)",
+           "end"_a, "cell_size"_a = 0.0)
+      .def("clear_action_table", &GreedyGeodesicFollowerImpl::clearActionTable)
+      .def("has_action_table", &GreedyGeodesicFollowerImpl::hasActionTable,
+           "end"_a)
       .def("reset", &GreedyGeodesicFollowerImpl::reset);
+
+  py::class_<CrowdAgentParams>(m, "CrowdAgentParams")
+      .def(py::init<>())
+      .def_readwrite("radius", &CrowdAgentParams::radius)
+      .def_readwrite("height", &CrowdAgentParams::height)
+      .def_readwrite("max_acceleration", &CrowdAgentParams::maxAcceleration)
+      .def_readwrite("max_speed", &CrowdAgentParams::maxSpeed)
+      .def_readwrite("separation_weight", &CrowdAgentParams::separationWeight)
+      .def_readwrite("avoid_obstacles", &CrowdAgentParams::avoidObstacles)
+      .def_readwrite("anticipate_turns", &CrowdAgentParams::anticipateTurns);
+
+  py::class_<Crowd, Crowd::ptr>(
+      m, "Crowd",
+      R"(Moves many agents on the navmesh of a PathFinder at once, steering
+      them around each other. All agents are advanced by a single update().)")
+      .def(py::init(&Crowd::create<const PathFinder::ptr&, int, float>),
+           "pathfinder"_a, "max_agents"_a, "max_agent_radius"_a = 0.5)
+      .def_property_readonly("max_agents", &Crowd::getMaxAgents)
+      .def_property_readonly("num_agents", &Crowd::getNumAgents)
+      .def_property_readonly(
+          "has_valid_navmesh", &Crowd::hasValidNavMesh,
+          R"(Whether the pathfinder still has the navmesh the crowd was
+          created on. Create a new crowd after recomputing or loading one.)")
+      .def("add_agent", &Crowd::addAgent,
+           R"(Adds an agent at position, snapped to the navmesh. Returns its
+          id, or -1 if the crowd is full or position isn't near the navmesh.)",
+           "position"_a, "params"_a = CrowdAgentParams{})
+      .def("remove_agent", &Crowd::removeAgent, "agent_id"_a)
+      .def("is_agent_active", &Crowd::isAgentActive, "agent_id"_a)
+      .def("set_agent_target", &Crowd::setAgentTarget, "agent_id"_a,
+           "target"_a)
+      .def("reset_agent_target", &Crowd::resetAgentTarget, "agent_id"_a)
+      .def("update", &Crowd::update, "dt"_a)
+      .def_property_readonly(
+          "agent_positions",
+          [](const Crowd& self) {
+            const auto& positions = self.getAgentPositions();
+            return py::array_t<float>({positions.size(), std::size_t{3}},
+                                      positions.front().data());
+          },
+          R"((max_agents, 3) array of agent positions, indexed by agent id)")
+      .def_property_readonly(
+          "agent_velocities",
+          [](const Crowd& self) {
+            const auto& velocities = self.getAgentVelocities();
+            return py::array_t<float>({velocities.size(), std::size_t{3}},
+                                      velocities.front().data());
+          },
+          R"((max_agents, 3) array of agent velocities, indexed by agent id)")
+      .def_property_readonly("agent_rotations", &Crowd::getAgentRotations)
+      .def("update_scene_nodes", &Crowd::updateSceneNodes, "nodes"_a);
 }
 
 }  // namespace nav
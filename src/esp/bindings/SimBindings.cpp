@@ -2,6 +2,7 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include "esp/bindings/ArrayHelpers.h"
 #include "esp/bindings/Bindings.h"
 
 #include <Magnum/ImageView.h>
@@ -49,6 +50,9 @@ void initSimBindings(py::module& m) {
       .def_readwrite(
           "allow_sliding", &SimulatorConfiguration::allowSliding,
           R"(Whether or not the agent can slide on NavMesh collisions.)")
+      .def_readwrite(
+          "memory_map_navmesh", &SimulatorConfiguration::memoryMapNavMesh,
+          R"(Map the scene's navmesh file copy-on-write instead of reading it, so processes loading the same navmesh share its memory.)")
       .def_readwrite(
           "create_renderer", &SimulatorConfiguration::createRenderer,
           R"(Optimisation for non-visual simulation. If false, no renderer will be created and no materials or textures loaded.)")
@@ -58,6 +62,19 @@ void initSimBindings(py::module& m) {
           R"(See tutorials/async_rendering.py)")
       .def_readwrite("frustum_culling", &SimulatorConfiguration::frustumCulling,
                      R"(Enable or disable the frustum culling optimisation.)")
+      .def_readwrite(
+          "sort_draws_by_state", &SimulatorConfiguration::sortDrawsByState,
+          R"(Order draws by shader, material and mesh to reduce GL state changes.)")
+      .def_readwrite(
+          "enable_instancing", &SimulatorConfiguration::enableInstancing,
+          R"(Draw drawables sharing mesh and material with instanced draw calls.)")
+      .def_readwrite(
+          "collect_draw_state_stats",
+          &SimulatorConfiguration::collectDrawStateStats,
+          R"(Count the GL state changes of unsorted draws into the sensor perf stats.)")
+      .def_readwrite(
+          "mesh_lod_levels", &SimulatorConfiguration::meshLodLevels,
+          R"(Number of simplified levels of detail generated for each render mesh when it is loaded. Sensors draw them below their lod_threshold. 0 generates none.)")
       .def_readwrite(
           "enable_physics", &SimulatorConfiguration::enablePhysics,
           R"(Specifies whether or not dynamics is supported by the simulation if a suitable library (i.e. Bullet) has been installed. Install with --bullet to enable.)")
@@ -94,6 +111,59 @@ void initSimBindings(py::module& m) {
       .def(py::self == py::self)
       .def(py::self != py::self);
 
+  // ==== VisualSensorStats ====
+  py::class_<sensor::VisualSensorStats>(m, "VisualSensorStats")
+      .def(py::init<>())
+      .def_readonly(
+          "drawables_submitted", &sensor::VisualSensorStats::drawablesSubmitted,
+          R"(Number of drawables handed to the render camera, before culling.)")
+      .def_readonly("drawables_culled",
+                    &sensor::VisualSensorStats::drawablesCulled,
+                    R"(Number of drawables removed by frustum culling.)")
+      .def_readonly("triangles_drawn",
+                    &sensor::VisualSensorStats::trianglesDrawn,
+                    R"(Number of triangles drawn.)")
+      .def_readonly(
+          "state_changes", &sensor::VisualSensorStats::stateChanges,
+          R"(Number of shader, material and mesh switches between consecutive draws.)")
+      .def_readonly(
+          "state_changes_unsorted",
+          &sensor::VisualSensorStats::stateChangesUnsorted,
+          R"(Number of such switches the same draws would have caused in scene graph order.)")
+      .def_readonly(
+          "draw_calls", &sensor::VisualSensorStats::drawCalls,
+          R"(Number of draw calls issued; an instanced draw counts once.)")
+      .def_readonly(
+          "readback_bytes", &sensor::VisualSensorStats::readbackBytes,
+          R"(Number of bytes read back from the sensor's render target.)")
+      .def_readonly(
+          "readback_time_ms", &sensor::VisualSensorStats::readbackTimeMs,
+          R"(Wall-clock time spent reading back from the render target, in milliseconds.)");
+
+  // ==== PerfStats ====
+  py::class_<PerfStats>(m, "PerfStats")
+      .def(py::init<>())
+      .def_readonly(
+          "physics_num_sub_steps", &PerfStats::physicsNumSubSteps,
+          R"(Number of fixed-size physics substeps taken by the most recent step_world, or -1 if unavailable.)")
+      .def_readonly(
+          "physics_step_time_ms", &PerfStats::physicsStepTimeMs,
+          R"(Wall-clock time of the most recent step_world, in milliseconds.)")
+      .def_readonly(
+          "sensor_stats", &PerfStats::sensorStats,
+          R"(Per visual sensor counters from its most recent observation, keyed by sensor uuid.)")
+      .def_readonly("total_sensor_stats", &PerfStats::totalSensorStats,
+                    R"(Sum of sensor_stats over all visual sensors.)")
+      .def_readonly(
+          "navmesh_queries", &PerfStats::navMeshQueries,
+          R"(Number of navmesh queries answered by the active PathFinder since the last reset.)")
+      .def_readonly(
+          "asset_cache_hits", &PerfStats::assetCacheHits,
+          R"(Number of render asset loads served from the asset cache since the last reset.)")
+      .def_readonly(
+          "asset_cache_misses", &PerfStats::assetCacheMisses,
+          R"(Number of render asset loads that missed the asset cache since the last reset.)");
+
   // ==== Simulator ====
   py::class_<Simulator, Simulator::ptr>(m, "Simulator")
       // modify constructor to pass MetadataMediator
@@ -144,6 +214,16 @@ void initSimBindings(py::module& m) {
       .def_property("frustum_culling", &Simulator::isFrustumCullingEnabled,
                     &Simulator::setFrustumCullingEnabled,
                     R"(Enable or disable the frustum culling)")
+      .def_property("sort_draws_by_state",
+                    &Simulator::isDrawStateSortingEnabled,
+                    &Simulator::setDrawStateSortingEnabled,
+                    R"(Enable or disable ordering draws by GL state)")
+      .def_property("instancing", &Simulator::isInstancingEnabled,
+                    &Simulator::setInstancingEnabled,
+                    R"(Enable or disable instanced drawing of repeated meshes)")
+      .def_property("draw_state_stats", &Simulator::isDrawStateStatsEnabled,
+                    &Simulator::setDrawStateStatsEnabled,
+                    R"(Enable or disable counting unsorted state changes)")
       .def_property(
           "active_dataset", &Simulator::getActiveSceneDatasetName,
           &Simulator::setActiveSceneDatasetName,
@@ -240,6 +320,12 @@ void initSimBindings(py::module& m) {
           "get_physics_num_active_overlapping_pairs",
           &Simulator::getPhysicsNumActiveOverlappingPairs,
           R"(The number of active overlapping pairs during the last step. When object bounding boxes overlap and either object is active, additional "narrowphase" collision-detection must be run. This count is a proxy for complexity/cost of collision-handling in the current scene.)")
+      .def(
+          "get_perf_stats", &Simulator::getPerfStats,
+          R"(Get counters and timings for the most recent physics step and sensor observations, along with navmesh query and asset cache counters accumulated since the last reset_perf_stats.)")
+      .def(
+          "reset_perf_stats", &Simulator::resetPerfStats,
+          R"(Reset the accumulated navmesh query and asset cache counters reported by get_perf_stats.)")
       .def(
           "get_physics_step_collision_summary",
           &Simulator::getPhysicsStepCollisionSummary,
@@ -255,6 +341,39 @@ void initSimBindings(py::module& m) {
           "cast_ray", &Simulator::castRay, "ray"_a, "max_distance"_a = 100.0,
           "scene_id"_a = 0,
           R"(Cast a ray into the collidable scene and return hit results. Physics must be enabled. max_distance in units of ray length.)")
+      .def(
+          "cast_rays",
+          [](Simulator& self, const bindings::FloatInputArray& origins,
+             const bindings::FloatInputArray& directions, double maxDistance,
+             bool allHits, int sceneID) {
+            ESP_CHECK(origins.ndim() == 2 && origins.shape(1) == 3,
+                      "origins must be an (N, 3) array");
+            ESP_CHECK(directions.ndim() == 2 && directions.shape(1) == 3 &&
+                          directions.shape(0) == origins.shape(0),
+                      "directions must be an (N, 3) array matching origins");
+            std::vector<geo::Ray> rays;
+            rays.reserve(origins.shape(0));
+            for (size_t i = 0; i < size_t(origins.shape(0)); ++i) {
+              rays.emplace_back(
+                  Mn::Vector3{origins.at(i, 0), origins.at(i, 1),
+                              origins.at(i, 2)},
+                  Mn::Vector3{directions.at(i, 0), directions.at(i, 1),
+                              directions.at(i, 2)});
+            }
+            py::gil_scoped_release release;
+            return self.castRays(rays, maxDistance, allHits, sceneID);
+          },
+          "origins"_a, "directions"_a, "max_distance"_a = 100.0,
+          "all_hits"_a = false, "scene_id"_a = 0,
+          R"(Cast a batch of rays given as (N, 3) origin and direction arrays into the collidable scene and return the hits in flat arrays. Physics must be enabled. max_distance in units of ray length. If all_hits is False only the closest hit of each ray is reported.)")
+      .def(
+          "get_drawable_ids_in_box", &Simulator::getDrawableIdsInBox, "box"_a,
+          "scene_id"_a = 0,
+          R"(Return the ids of the drawables whose world bounding boxes overlap the given world space box, in increasing order.)")
+      .def(
+          "get_drawable_ids_at_point", &Simulator::getDrawableIdsAtPoint,
+          "point"_a, "scene_id"_a = 0,
+          R"(Return the ids of the drawables whose world bounding boxes contain the given world space point, in increasing order.)")
       .def("set_object_bb_draw", &Simulator::setObjectBBDraw, "draw_bb"_a,
            "object_id"_a, "scene_id"_a = 0,
            R"(Enable or disable bounding box visualization for an object.)")
@@ -0,0 +1,294 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "AabbTree.h"
+
+#include <algorithm>
+
+#include <Corrade/Utility/Assert.h>
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace geo {
+
+namespace {
+
+//! surface area, the cost of a node in the insertion heuristic
+float surfaceArea(const Mn::Range3D& box) {
+  const Mn::Vector3 size = box.size();
+  return 2.0f * (size.x() * size.y() + size.y() * size.z() +
+                 size.z() * size.x());
+}
+
+bool contains(const Mn::Range3D& outer, const Mn::Range3D& inner) {
+  return (outer.min() <= inner.min()).all() &&
+         (outer.max() >= inner.max()).all();
+}
+
+}  // namespace
+
+AabbTree::AabbTree(float margin) : margin_(margin) {}
+
+int AabbTree::allocateNode() {
+  if (freeList_ == Null) {
+    nodes_.emplace_back();
+    return int(nodes_.size()) - 1;
+  }
+  const int node = freeList_;
+  freeList_ = nodes_[node].parent;
+  nodes_[node] = Node{};
+  return node;
+}
+
+void AabbTree::freeNode(int node) {
+  nodes_[node] = Node{};
+  nodes_[node].parent = freeList_;
+  freeList_ = node;
+}
+
+int AabbTree::insert(const Mn::Range3D& box) {
+  const int leaf = allocateNode();
+  nodes_[leaf].box = {box.min() - Mn::Vector3{margin_},
+                      box.max() + Mn::Vector3{margin_}};
+  nodes_[leaf].height = 0;
+  insertLeaf(leaf);
+  ++leafCount_;
+  return leaf;
+}
+
+void AabbTree::remove(int leaf) {
+  CORRADE_ASSERT(leaf >= 0 && leaf < int(nodes_.size()) &&
+                     nodes_[leaf].height == 0,
+                 "AabbTree::remove(): invalid leaf" << leaf, );
+  removeLeaf(leaf);
+  freeNode(leaf);
+  --leafCount_;
+}
+
+bool AabbTree::update(int leaf, const Mn::Range3D& box) {
+  CORRADE_ASSERT(leaf >= 0 && leaf < int(nodes_.size()) &&
+                     nodes_[leaf].height == 0,
+                 "AabbTree::update(): invalid leaf" << leaf, false);
+  if (contains(nodes_[leaf].box, box)) {
+    return false;
+  }
+  removeLeaf(leaf);
+  nodes_[leaf].box = {box.min() - Mn::Vector3{margin_},
+                      box.max() + Mn::Vector3{margin_}};
+  insertLeaf(leaf);
+  return true;
+}
+
+void AabbTree::clear() {
+  nodes_.clear();
+  root_ = Null;
+  freeList_ = Null;
+  leafCount_ = 0;
+}
+
+void AabbTree::insertLeaf(int leaf) {
+  if (root_ == Null) {
+    root_ = leaf;
+    nodes_[leaf].parent = Null;
+    return;
+  }
+
+  // descend to the sibling which enlarges the total surface area the least
+  const Mn::Range3D box = nodes_[leaf].box;
+  int index = root_;
+  while (!nodes_[index].isLeaf()) {
+    const Node& node = nodes_[index];
+    const float area = surfaceArea(node.box);
+    const float combinedArea = surfaceArea(Mn::Math::join(node.box, box));
+
+    // cost of making a new parent for this node and the new leaf
+    const float cost = 2.0f * combinedArea;
+    // minimum cost of pushing the leaf further down the tree
+    const float inheritanceCost = 2.0f * (combinedArea - area);
+
+    auto descendCost = [&](int child) {
+      const Node& childNode = nodes_[child];
+      const float enlargedArea =
+          surfaceArea(Mn::Math::join(childNode.box, box));
+      return childNode.isLeaf()
+                 ? enlargedArea + inheritanceCost
+                 : enlargedArea - surfaceArea(childNode.box) + inheritanceCost;
+    };
+    const float cost1 = descendCost(node.child1);
+    const float cost2 = descendCost(node.child2);
+
+    if (cost < cost1 && cost < cost2) {
+      break;
+    }
+    index = cost1 < cost2 ? node.child1 : node.child2;
+  }
+  const int sibling = index;
+
+  // may reallocate nodes_, so no references are held across it
+  const int newParent = allocateNode();
+  const int oldParent = nodes_[sibling].parent;
+  nodes_[newParent].parent = oldParent;
+  nodes_[newParent].box = Mn::Math::join(box, nodes_[sibling].box);
+  nodes_[newParent].height = nodes_[sibling].height + 1;
+  nodes_[newParent].child1 = sibling;
+  nodes_[newParent].child2 = leaf;
+  nodes_[sibling].parent = newParent;
+  nodes_[leaf].parent = newParent;
+
+  if (oldParent == Null) {
+    root_ = newParent;
+  } else if (nodes_[oldParent].child1 == sibling) {
+    nodes_[oldParent].child1 = newParent;
+  } else {
+    nodes_[oldParent].child2 = newParent;
+  }
+
+  refit(newParent);
+}
+
+void AabbTree::removeLeaf(int leaf) {
+  if (leaf == root_) {
+    root_ = Null;
+    return;
+  }
+
+  const int parent = nodes_[leaf].parent;
+  const int grandParent = nodes_[parent].parent;
+  const int sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2
+                                                    : nodes_[parent].child1;
+
+  if (grandParent == Null) {
+    root_ = sibling;
+    nodes_[sibling].parent = Null;
+    freeNode(parent);
+    return;
+  }
+
+  // replace the parent by the sibling
+  if (nodes_[grandParent].child1 == parent) {
+    nodes_[grandParent].child1 = sibling;
+  } else {
+    nodes_[grandParent].child2 = sibling;
+  }
+  nodes_[sibling].parent = grandParent;
+  freeNode(parent);
+
+  refit(grandParent);
+}
+
+void AabbTree::refit(int node) {
+  while (node != Null) {
+    node = balance(node);
+    Node& n = nodes_[node];
+    const Node& child1 = nodes_[n.child1];
+    const Node& child2 = nodes_[n.child2];
+    n.height = 1 + std::max(child1.height, child2.height);
+    n.box = Mn::Math::join(child1.box, child2.box);
+    node = n.parent;
+  }
+}
+
+int AabbTree::balance(int iA) {
+  Node& A = nodes_[iA];
+  if (A.isLeaf() || A.height < 2) {
+    return iA;
+  }
+
+  const int iB = A.child1;
+  const int iC = A.child2;
+  Node& B = nodes_[iB];
+  Node& C = nodes_[iC];
+
+  const int balance = C.height - B.height;
+
+  // rotate C up
+  if (balance > 1) {
+    const int iF = C.child1;
+    const int iG = C.child2;
+    Node& F = nodes_[iF];
+    Node& G = nodes_[iG];
+
+    // swap A and C
+    C.child1 = iA;
+    C.parent = A.parent;
+    A.parent = iC;
+
+    // A's old parent should point to C
+    if (C.parent == Null) {
+      root_ = iC;
+    } else if (nodes_[C.parent].child1 == iA) {
+      nodes_[C.parent].child1 = iC;
+    } else {
+      nodes_[C.parent].child2 = iC;
+    }
+
+    // the higher grandchild stays under C, the lower one moves under A
+    if (F.height > G.height) {
+      C.child2 = iF;
+      A.child2 = iG;
+      G.parent = iA;
+      A.box = Mn::Math::join(B.box, G.box);
+      C.box = Mn::Math::join(A.box, F.box);
+      A.height = 1 + std::max(B.height, G.height);
+      C.height = 1 + std::max(A.height, F.height);
+    } else {
+      C.child2 = iG;
+      A.child2 = iF;
+      F.parent = iA;
+      A.box = Mn::Math::join(B.box, F.box);
+      C.box = Mn::Math::join(A.box, G.box);
+      A.height = 1 + std::max(B.height, F.height);
+      C.height = 1 + std::max(A.height, G.height);
+    }
+    return iC;
+  }
+
+  // rotate B up
+  if (balance < -1) {
+    const int iD = B.child1;
+    const int iE = B.child2;
+    Node& D = nodes_[iD];
+    Node& E = nodes_[iE];
+
+    // swap A and B
+    B.child1 = iA;
+    B.parent = A.parent;
+    A.parent = iB;
+
+    // A's old parent should point to B
+    if (B.parent == Null) {
+      root_ = iB;
+    } else if (nodes_[B.parent].child1 == iA) {
+      nodes_[B.parent].child1 = iB;
+    } else {
+      nodes_[B.parent].child2 = iB;
+    }
+
+    // the higher grandchild stays under B, the lower one moves under A
+    if (D.height > E.height) {
+      B.child2 = iD;
+      A.child1 = iE;
+      E.parent = iA;
+      A.box = Mn::Math::join(C.box, E.box);
+      B.box = Mn::Math::join(A.box, D.box);
+      A.height = 1 + std::max(C.height, E.height);
+      B.height = 1 + std::max(A.height, D.height);
+    } else {
+      B.child2 = iE;
+      A.child1 = iD;
+      D.parent = iA;
+      A.box = Mn::Math::join(C.box, D.box);
+      B.box = Mn::Math::join(A.box, E.box);
+      A.height = 1 + std::max(C.height, D.height);
+      B.height = 1 + std::max(A.height, E.height);
+    }
+    return iB;
+  }
+
+  return iA;
+}
+
+}  // namespace geo
+}  // namespace esp
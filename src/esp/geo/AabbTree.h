@@ -0,0 +1,230 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GEO_AABBTREE_H_
+#define ESP_GEO_AABBTREE_H_
+
+#include <utility>
+#include <vector>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Range.h>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace geo {
+
+/**
+ * @brief Dynamic bounding volume hierarchy over axis-aligned boxes.
+ *
+ * Each leaf stores its box enlarged by a margin ("fat" box), so that a leaf
+ * whose box moves a little only needs a containment check in @ref update;
+ * only leaves leaving their fat box are reinserted. Inner nodes are kept
+ * balanced by tree rotations, so insertion, removal and queries visit
+ * O(log n) nodes plus the ones which overlap the query.
+ *
+ * Leaves are referred to by the id returned from @ref insert, which stays
+ * valid until the leaf is removed. Ids are small integers and are reused, so
+ * they can index user-side arrays.
+ */
+class AabbTree {
+ public:
+  /**
+   * @brief Constructor
+   * @param margin Distance by which leaf boxes are enlarged on every side
+   */
+  explicit AabbTree(float margin = 0.1f);
+
+  /**
+   * @brief Insert a box
+   * @return id of the new leaf
+   */
+  int insert(const Magnum::Range3D& box);
+
+  /**
+   * @brief Remove a leaf
+   * @param leaf id returned by @ref insert
+   */
+  void remove(int leaf);
+
+  /**
+   * @brief Move a leaf to a new box
+   * @param leaf id returned by @ref insert
+   * @param box the new box
+   * @return true if the leaf had to be reinserted, false if @p box still fits
+   * in its fat box
+   */
+  bool update(int leaf, const Magnum::Range3D& box);
+
+  /**
+   * @brief Enlarged box stored for a leaf
+   */
+  const Magnum::Range3D& getFatBox(int leaf) const {
+    return nodes_[leaf].box;
+  }
+
+  /**
+   * @brief Number of leaves
+   */
+  size_t size() const { return leafCount_; }
+
+  /**
+   * @brief Height of the tree; 0 for a single leaf, -1 if empty
+   */
+  int height() const { return root_ == Null ? -1 : nodes_[root_].height; }
+
+  /**
+   * @brief Remove all leaves
+   */
+  void clear();
+
+  /**
+   * @brief Call @p callback with the id of every leaf whose fat box overlaps
+   * @p box
+   */
+  template <class Callback>
+  void query(const Magnum::Range3D& box, Callback&& callback) const;
+
+  /**
+   * @brief Call @p callback with the id of every leaf whose fat box contains
+   * @p point
+   */
+  template <class Callback>
+  void query(const Magnum::Vector3& point, Callback&& callback) const {
+    query(Magnum::Range3D{point, point}, callback);
+  }
+
+  /**
+   * @brief Call @p callback(leaf, contained) for every leaf whose fat box is
+   * not entirely outside @p frustum
+   *
+   * @p contained is true if the fat box, and so anything inside it, lies
+   * entirely inside the frustum. Whole subtrees inside the frustum are
+   * reported without testing their leaves.
+   */
+  template <class Callback>
+  void query(const Magnum::Frustum& frustum, Callback&& callback) const;
+
+ private:
+  static constexpr int Null = -1;
+
+  struct Node {
+    Magnum::Range3D box;
+    //! parent node, or the next free node when on the free list
+    int parent = Null;
+    int child1 = Null;
+    int child2 = Null;
+    //! 0 for leaves, -1 for free nodes
+    int height = -1;
+
+    bool isLeaf() const { return child1 == Null; }
+  };
+
+  int allocateNode();
+  void freeNode(int node);
+  void insertLeaf(int leaf);
+  void removeLeaf(int leaf);
+  int balance(int node);
+  //! refit boxes and heights from @p node up to the root, rebalancing
+  void refit(int node);
+
+  std::vector<Node> nodes_;
+  int root_ = Null;
+  int freeList_ = Null;
+  size_t leafCount_ = 0;
+  float margin_;
+
+  ESP_SMART_POINTERS(AabbTree)
+};
+
+template <class Callback>
+void AabbTree::query(const Magnum::Range3D& box, Callback&& callback) const {
+  if (root_ == Null) {
+    return;
+  }
+  std::vector<int> stack{root_};
+  while (!stack.empty()) {
+    const int id = stack.back();
+    stack.pop_back();
+    const Node& node = nodes_[id];
+    if ((node.box.min() > box.max()).any() ||
+        (node.box.max() < box.min()).any()) {
+      continue;
+    }
+    if (node.isLeaf()) {
+      callback(id);
+    } else {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+}
+
+template <class Callback>
+void AabbTree::query(const Magnum::Frustum& frustum,
+                     Callback&& callback) const {
+  if (root_ == Null) {
+    return;
+  }
+  // each entry carries the planes its parent was not yet entirely inside of
+  std::vector<std::pair<int, int>> stack{{root_, 0x3f}};
+  std::vector<int> containedStack;
+  while (!stack.empty()) {
+    const int id = stack.back().first;
+    int planes = stack.back().second;
+    stack.pop_back();
+    const Node& node = nodes_[id];
+
+    const Magnum::Vector3 center = node.box.center();
+    const Magnum::Vector3 halfExtent = node.box.size() * 0.5f;
+    bool outside = false;
+    for (int iPlane = 0; iPlane < 6; ++iPlane) {
+      if (!(planes & (1 << iPlane))) {
+        continue;
+      }
+      const Magnum::Vector4& plane = frustum[iPlane];
+      const float d = Magnum::Math::dot(center, plane.xyz()) + plane.w();
+      const float r =
+          Magnum::Math::dot(halfExtent, Magnum::Math::abs(plane.xyz()));
+      if (d + r < 0.0f) {
+        outside = true;
+        break;
+      }
+      if (d - r >= 0.0f) {
+        planes &= ~(1 << iPlane);
+      }
+    }
+    if (outside) {
+      continue;
+    }
+
+    if (planes == 0) {
+      // the whole subtree is inside, report its leaves untested
+      containedStack.push_back(id);
+      while (!containedStack.empty()) {
+        const int containedId = containedStack.back();
+        containedStack.pop_back();
+        const Node& contained = nodes_[containedId];
+        if (contained.isLeaf()) {
+          callback(containedId, true);
+        } else {
+          containedStack.push_back(contained.child1);
+          containedStack.push_back(contained.child2);
+        }
+      }
+    } else if (node.isLeaf()) {
+      callback(id, false);
+    } else {
+      stack.emplace_back(node.child1, planes);
+      stack.emplace_back(node.child2, planes);
+    }
+  }
+}
+
+}  // namespace geo
+}  // namespace esp
+
+#endif  // ESP_GEO_AABBTREE_H_
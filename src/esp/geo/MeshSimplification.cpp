@@ -0,0 +1,291 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "MeshSimplification.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+#include <Magnum/Math/Functions.h>
+
+namespace Mn = Magnum;
+namespace Cr = Corrade;
+
+namespace esp {
+namespace geo {
+
+namespace {
+
+/**
+ * @brief Symmetric 4x4 matrix measuring the sum of squared distances of a
+ * point to a set of planes, stored as its upper triangle
+ */
+struct Quadric {
+  double q[10]{};
+
+  static Quadric fromPlane(const Mn::Vector3& normal, float offset) {
+    const double a = normal.x(), b = normal.y(), c = normal.z(), d = offset;
+    Quadric result;
+    result.q[0] = a * a;
+    result.q[1] = a * b;
+    result.q[2] = a * c;
+    result.q[3] = a * d;
+    result.q[4] = b * b;
+    result.q[5] = b * c;
+    result.q[6] = b * d;
+    result.q[7] = c * c;
+    result.q[8] = c * d;
+    result.q[9] = d * d;
+    return result;
+  }
+
+  Quadric& operator+=(const Quadric& other) {
+    for (int i = 0; i < 10; ++i) {
+      q[i] += other.q[i];
+    }
+    return *this;
+  }
+
+  double evaluate(const Mn::Vector3& p) const {
+    const double x = p.x(), y = p.y(), z = p.z();
+    return q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z +
+           2.0 * q[3] * x + q[4] * y * y + 2.0 * q[5] * y * z +
+           2.0 * q[6] * y + q[7] * z * z + 2.0 * q[8] * z + q[9];
+  }
+};
+
+/**
+ * @brief Candidate collapse of vertex @ref from onto vertex @ref to, valid
+ * while neither vertex changed since it was queued
+ */
+struct Collapse {
+  //! quadric error plus a small edge length term, the order of collapses
+  double cost;
+  //! quadric error alone
+  double error;
+  Mn::UnsignedInt from;
+  Mn::UnsignedInt to;
+  Mn::UnsignedInt fromVersion;
+  Mn::UnsignedInt toVersion;
+
+  bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+//! weight of the squared edge length in the collapse order
+constexpr double EdgeLengthWeight = 1.0e-3;
+
+std::uint64_t edgeKey(Mn::UnsignedInt a, Mn::UnsignedInt b) {
+  return std::uint64_t(std::min(a, b)) << 32 | std::max(a, b);
+}
+
+}  // namespace
+
+std::vector<Mn::UnsignedInt> simplifyMesh(
+    Cr::Containers::ArrayView<const Mn::Vector3> positions,
+    Cr::Containers::ArrayView<const Mn::UnsignedInt> indices,
+    std::size_t targetIndexCount,
+    float maxError,
+    float* resultError) {
+  const std::size_t vertexCount = positions.size();
+
+  // drop degenerate triangles up front, they never show
+  std::vector<Mn::UnsignedInt> triangles;
+  triangles.reserve(indices.size());
+  for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const Mn::UnsignedInt a = indices[i], b = indices[i + 1],
+                          c = indices[i + 2];
+    if (a != b && b != c && c != a) {
+      triangles.insert(triangles.end(), {a, b, c});
+    }
+  }
+  const std::size_t triangleCount = triangles.size() / 3;
+  std::vector<bool> triangleAlive(triangleCount, true);
+  std::size_t aliveTriangles = triangleCount;
+
+  std::vector<std::vector<Mn::UnsignedInt>> vertexTriangles(vertexCount);
+  std::vector<Quadric> quadrics(vertexCount);
+  std::unordered_map<std::uint64_t, int> edgeUses;
+  for (std::size_t t = 0; t < triangleCount; ++t) {
+    const Mn::UnsignedInt* tri = &triangles[3 * t];
+    const Mn::Vector3 normal =
+        Mn::Math::cross(positions[tri[1]] - positions[tri[0]],
+                        positions[tri[2]] - positions[tri[0]]);
+    const float length = normal.length();
+    Quadric plane;
+    if (length > 0.0f) {
+      const Mn::Vector3 unitNormal = normal / length;
+      plane = Quadric::fromPlane(
+          unitNormal, -Mn::Math::dot(unitNormal, positions[tri[0]]));
+    }
+    for (int i = 0; i < 3; ++i) {
+      vertexTriangles[tri[i]].push_back(t);
+      quadrics[tri[i]] += plane;
+      ++edgeUses[edgeKey(tri[i], tri[(i + 1) % 3])];
+    }
+  }
+
+  // vertices on open or non-manifold edges stay where they are
+  std::vector<bool> locked(vertexCount, false);
+  for (const auto& edge : edgeUses) {
+    if (edge.second != 2) {
+      locked[edge.first >> 32] = true;
+      locked[edge.first & 0xffffffffu] = true;
+    }
+  }
+
+  std::vector<bool> vertexAlive(vertexCount, true);
+  std::vector<Mn::UnsignedInt> versions(vertexCount, 0);
+  std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>>
+      queue;
+
+  auto neighbors = [&](Mn::UnsignedInt v, std::vector<Mn::UnsignedInt>& out) {
+    out.clear();
+    for (Mn::UnsignedInt t : vertexTriangles[v]) {
+      if (!triangleAlive[t]) {
+        continue;
+      }
+      for (int i = 0; i < 3; ++i) {
+        const Mn::UnsignedInt w = triangles[3 * t + i];
+        if (w != v && std::find(out.begin(), out.end(), w) == out.end()) {
+          out.push_back(w);
+        }
+      }
+    }
+  };
+  auto push = [&](Mn::UnsignedInt from, Mn::UnsignedInt to) {
+    if (locked[from]) {
+      return;
+    }
+    Quadric merged = quadrics[from];
+    merged += quadrics[to];
+    const double error = merged.evaluate(positions[to]);
+    // on flat areas every error is zero; preferring short edges there keeps
+    // the triangles even instead of growing fans around a few vertices
+    const double cost =
+        error + EdgeLengthWeight * (positions[to] - positions[from]).dot();
+    queue.push({cost, error, from, to, versions[from], versions[to]});
+  };
+
+  std::vector<Mn::UnsignedInt> fromNeighbors;
+  std::vector<Mn::UnsignedInt> toNeighbors;
+  for (Mn::UnsignedInt v = 0; v < vertexCount; ++v) {
+    neighbors(v, fromNeighbors);
+    for (Mn::UnsignedInt w : fromNeighbors) {
+      push(v, w);
+    }
+  }
+
+  const double maxSquaredError = double(maxError) * double(maxError);
+  double largestSquaredError = 0.0;
+  while (aliveTriangles * 3 > targetIndexCount && !queue.empty()) {
+    const Collapse collapse = queue.top();
+    queue.pop();
+    const Mn::UnsignedInt from = collapse.from;
+    const Mn::UnsignedInt to = collapse.to;
+    if (!vertexAlive[from] || !vertexAlive[to] ||
+        versions[from] != collapse.fromVersion ||
+        versions[to] != collapse.toVersion) {
+      continue;
+    }
+    if (collapse.error > maxSquaredError) {
+      // the order mostly follows the error, later collapses may still fit
+      continue;
+    }
+
+    // the two vertices may only share the neighbors opposite to their edge,
+    // otherwise the collapse pinches the surface
+    neighbors(from, fromNeighbors);
+    neighbors(to, toNeighbors);
+    std::size_t shared = 0;
+    for (Mn::UnsignedInt w : fromNeighbors) {
+      shared += std::count(toNeighbors.begin(), toNeighbors.end(), w);
+    }
+    std::size_t edgeTriangles = 0;
+    bool flips = false;
+    for (Mn::UnsignedInt t : vertexTriangles[from]) {
+      if (!triangleAlive[t]) {
+        continue;
+      }
+      const Mn::UnsignedInt* tri = &triangles[3 * t];
+      if (tri[0] == to || tri[1] == to || tri[2] == to) {
+        ++edgeTriangles;
+        continue;
+      }
+      Mn::Vector3 moved[3];
+      for (int i = 0; i < 3; ++i) {
+        moved[i] = positions[tri[i] == from ? to : tri[i]];
+      }
+      const Mn::Vector3 before =
+          Mn::Math::cross(positions[tri[1]] - positions[tri[0]],
+                          positions[tri[2]] - positions[tri[0]]);
+      const Mn::Vector3 after =
+          Mn::Math::cross(moved[1] - moved[0], moved[2] - moved[0]);
+      if (Mn::Math::dot(before, after) <= 0.0f) {
+        flips = true;
+        break;
+      }
+    }
+    if (flips || shared != edgeTriangles) {
+      continue;
+    }
+
+    // move every triangle of `from` onto `to`, the ones on the edge vanish
+    for (Mn::UnsignedInt t : vertexTriangles[from]) {
+      if (!triangleAlive[t]) {
+        continue;
+      }
+      Mn::UnsignedInt* tri = &triangles[3 * t];
+      if (tri[0] == to || tri[1] == to || tri[2] == to) {
+        triangleAlive[t] = false;
+        --aliveTriangles;
+        continue;
+      }
+      for (int i = 0; i < 3; ++i) {
+        if (tri[i] == from) {
+          tri[i] = to;
+        }
+      }
+      vertexTriangles[to].push_back(t);
+    }
+    vertexTriangles[from].clear();
+    auto& toTriangles = vertexTriangles[to];
+    toTriangles.erase(
+        std::remove_if(toTriangles.begin(), toTriangles.end(),
+                       [&](Mn::UnsignedInt t) { return !triangleAlive[t]; }),
+        toTriangles.end());
+
+    quadrics[to] += quadrics[from];
+    vertexAlive[from] = false;
+    ++versions[to];
+    largestSquaredError = std::max(largestSquaredError, collapse.error);
+
+    // every collapse touching `to` changed cost
+    neighbors(to, toNeighbors);
+    for (Mn::UnsignedInt w : toNeighbors) {
+      push(to, w);
+      push(w, to);
+    }
+  }
+
+  if (resultError) {
+    *resultError = float(std::sqrt(largestSquaredError));
+  }
+
+  std::vector<Mn::UnsignedInt> result;
+  result.reserve(aliveTriangles * 3);
+  for (std::size_t t = 0; t < triangleCount; ++t) {
+    if (triangleAlive[t]) {
+      result.insert(result.end(), triangles.begin() + 3 * t,
+                    triangles.begin() + 3 * t + 3);
+    }
+  }
+  return result;
+}
+
+}  // namespace geo
+}  // namespace esp
@@ -0,0 +1,50 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GEO_MESHSIMPLIFICATION_H_
+#define ESP_GEO_MESHSIMPLIFICATION_H_
+
+#include <limits>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/core/Esp.h"
+
+namespace esp {
+namespace geo {
+
+/**
+ * @brief Simplify an indexed triangle mesh by quadric error edge collapses.
+ *
+ * Edges are collapsed, cheapest first, by moving one vertex onto the other,
+ * so the result references a subset of the input vertices and every vertex
+ * attribute stays valid. The cost of a collapse is the sum of squared
+ * distances of the kept vertex to the planes of the triangles merged into it
+ * (Garland and Heckbert). Vertices on open or non-manifold edges, which
+ * include seams where vertices are split by attributes, never move, and
+ * collapses which would flip a triangle are skipped.
+ *
+ * @param positions Vertex positions
+ * @param indices Triangle indices into @p positions
+ * @param targetIndexCount Stop once at most this many indices are left
+ * @param maxError Stop before a collapse would move the surface by more than
+ * about this distance
+ * @param[out] resultError If not null, set to the largest error of the
+ * collapses performed, as a distance
+ * @return Indices of the simplified triangles
+ */
+std::vector<Magnum::UnsignedInt> simplifyMesh(
+    Corrade::Containers::ArrayView<const Magnum::Vector3> positions,
+    Corrade::Containers::ArrayView<const Magnum::UnsignedInt> indices,
+    std::size_t targetIndexCount,
+    float maxError = std::numeric_limits<float>::infinity(),
+    float* resultError = nullptr);
+
+}  // namespace geo
+}  // namespace esp
+
+#endif  // ESP_GEO_MESHSIMPLIFICATION_H_
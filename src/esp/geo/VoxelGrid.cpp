@@ -6,6 +6,7 @@
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector.h>
 #include <Magnum/MeshTools/Interleave.h>
 #include <Magnum/MeshTools/Reference.h>
@@ -15,6 +16,7 @@
 
 #include "VoxelGrid.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Check.h"
 
 namespace Mn = Magnum;
 namespace Cr = Corrade;
@@ -22,14 +24,231 @@ namespace Cr = Corrade;
 namespace esp {
 namespace geo {
 
-#ifdef ESP_BUILD_WITH_VHACD
+namespace {
+
+// voxels are binned and filled in cubes of this many voxels per side
+constexpr int BrickSize = 8;
+
+// half the side of a voxel, grown a bit so triangles along voxel faces mark
+// both voxels
+constexpr float HalfSize = 0.5f + 1e-4f;
+
+struct VoxelTriangle {
+  // vertices in voxel units, relative to the center of voxel 0
+  Mn::Vector3 v[3];
+  // the range of voxels the triangle's bounding box overlaps, inclusive, which
+  // is the box axis part of the separating axis test
+  Mn::Vector3i min, max;
+};
+
+/**
+ * @brief Whether @p triangle overlaps the voxel centered at @p center, by the
+ * separating axis theorem. Only the triangle normal and edge axes are tested;
+ * the box axes are covered by only calling this for voxels in the triangle's
+ * voxel range.
+ */
+bool triangleOverlapsVoxel(const VoxelTriangle& triangle,
+                           const Mn::Vector3& center) {
+  const Mn::Vector3 v[3]{triangle.v[0] - center, triangle.v[1] - center,
+                         triangle.v[2] - center};
+  const auto separates = [&](const Mn::Vector3& axis) {
+    const float p0 = Mn::Math::dot(v[0], axis);
+    const float p1 = Mn::Math::dot(v[1], axis);
+    const float p2 = Mn::Math::dot(v[2], axis);
+    const float r = HalfSize * Mn::Math::abs(axis).sum();
+    return Mn::Math::min(p0, Mn::Math::min(p1, p2)) > r ||
+           Mn::Math::max(p0, Mn::Math::max(p1, p2)) < -r;
+  };
+
+  const Mn::Vector3 edges[3]{v[1] - v[0], v[2] - v[1], v[0] - v[2]};
+  if (separates(Mn::Math::cross(edges[0], edges[1]))) {
+    return false;
+  }
+  for (const Mn::Vector3& edge : edges) {
+    if (separates(Mn::Math::cross(Mn::Vector3::xAxis(), edge)) ||
+        separates(Mn::Math::cross(Mn::Vector3::yAxis(), edge)) ||
+        separates(Mn::Math::cross(Mn::Vector3::zAxis(), edge))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+constexpr int VoxelGrid::SparseBlockSize;
+
 VoxelGrid::VoxelGrid(const assets::MeshData& meshData,
                      const std::string& renderAssetHandle,
-                     int resolution)
+                     int resolution,
+                     VoxelizationMethod method)
     : m_renderAssetHandle(renderAssetHandle) {
-  VHACD::IVHACD* interfaceVHACD = VHACD::CreateVHACD();
-
   ESP_DEBUG() << "Voxelizing mesh..";
+  if (method == VoxelizationMethod::VHACD) {
+#ifdef ESP_BUILD_WITH_VHACD
+    voxelizeMeshWithVHACD(meshData, resolution);
+#else
+    ESP_CHECK(false,
+              "VoxelGrid: VHACD voxelization requires building with VHACD");
+#endif
+  } else {
+    voxelizeMesh(meshData, resolution);
+  }
+}
+
+void VoxelGrid::voxelizeMesh(const assets::MeshData& meshData,
+                             int resolution) {
+  ESP_CHECK(resolution > 0,
+            "VoxelGrid: resolution must be positive, got" << resolution);
+  ESP_CHECK(!meshData.vbo.empty() && meshData.ibo.size() >= 3,
+            "VoxelGrid: can't voxelize an empty mesh");
+
+  Mn::Vector3 min{Mn::Constants::inf()};
+  Mn::Vector3 max{-Mn::Constants::inf()};
+  for (const vec3f& vertex : meshData.vbo) {
+    min = Mn::Math::min(min, Mn::Vector3::from(vertex.data()));
+    max = Mn::Math::max(max, Mn::Vector3::from(vertex.data()));
+  }
+
+  // pick cubic voxels so the bounding box holds about resolution of them,
+  // giving flat meshes at least one voxel of thickness
+  const Mn::Vector3 size = max - min;
+  float scale = size.max() > 0.0f ? size.max() / std::cbrt(float(resolution))
+                                  : 1.0f;
+  scale = std::cbrt(Mn::Math::max(size, Mn::Vector3{scale}).product() /
+                    float(resolution));
+  m_voxelSize = Mn::Vector3{scale};
+  // a layer of empty voxels around the mesh, from which the outside is filled
+  m_voxelGridDimensions =
+      Mn::Vector3i{Mn::Math::ceil(size / scale)} + Mn::Vector3i{3};
+  m_offset = min - m_voxelSize;
+  m_BBMaxOffset = m_offset + Mn::Vector3(m_voxelGridDimensions) * scale;
+
+  const Mn::Vector3i dims = m_voxelGridDimensions;
+  const Mn::Vector3i brickDims =
+      (dims + Mn::Vector3i{BrickSize - 1}) / BrickSize;
+  const int numTriangles = int(meshData.ibo.size() / 3);
+
+  std::vector<VoxelTriangle> triangles(numTriangles);
+#pragma omp parallel for
+  for (int t = 0; t < numTriangles; ++t) {
+    VoxelTriangle& triangle = triangles[t];
+    Mn::Vector3 triangleMin{Mn::Constants::inf()};
+    Mn::Vector3 triangleMax{-Mn::Constants::inf()};
+    for (int i = 0; i < 3; ++i) {
+      const vec3f& vertex = meshData.vbo[meshData.ibo[3 * t + i]];
+      triangle.v[i] = (Mn::Vector3::from(vertex.data()) - m_offset) / scale;
+      triangleMin = Mn::Math::min(triangleMin, triangle.v[i]);
+      triangleMax = Mn::Math::max(triangleMax, triangle.v[i]);
+    }
+    triangle.min = Mn::Math::max(
+        Mn::Vector3i{Mn::Math::ceil(triangleMin - Mn::Vector3{HalfSize})}, 0);
+    triangle.max = Mn::Math::min(
+        Mn::Vector3i{Mn::Math::floor(triangleMax + Mn::Vector3{HalfSize})},
+        dims - Mn::Vector3i{1});
+  }
+
+  // bin the triangles into the bricks their bounding boxes overlap
+  const int numBricks = brickDims.product();
+  std::vector<int> brickOffsets(numBricks + 1, 0);
+  const auto forEachBrick = [&](const VoxelTriangle& triangle, auto&& f) {
+    const Mn::Vector3i first = triangle.min / BrickSize;
+    const Mn::Vector3i last = triangle.max / BrickSize;
+    for (int i = first[0]; i <= last[0]; ++i) {
+      for (int j = first[1]; j <= last[1]; ++j) {
+        for (int k = first[2]; k <= last[2]; ++k) {
+          f((i * brickDims[1] + j) * brickDims[2] + k);
+        }
+      }
+    }
+  };
+  for (const VoxelTriangle& triangle : triangles) {
+    forEachBrick(triangle, [&](int brick) { ++brickOffsets[brick + 1]; });
+  }
+  for (int b = 0; b < numBricks; ++b) {
+    brickOffsets[b + 1] += brickOffsets[b];
+  }
+  std::vector<int> brickTriangles(brickOffsets.back());
+  {
+    std::vector<int> cursor(brickOffsets.begin(), brickOffsets.end() - 1);
+    for (int t = 0; t < numTriangles; ++t) {
+      forEachBrick(triangles[t],
+                   [&](int brick) { brickTriangles[cursor[brick]++] = t; });
+    }
+  }
+
+  // bricks don't share voxels, so they are filled independently
+  enum : char { Unknown, Surface, Outside };
+  std::vector<char> state(std::size_t(dims.product()), Unknown);
+#pragma omp parallel for schedule(dynamic)
+  for (int b = 0; b < numBricks; ++b) {
+    const Mn::Vector3i brick{b / (brickDims[1] * brickDims[2]),
+                             (b / brickDims[2]) % brickDims[1],
+                             b % brickDims[2]};
+    const Mn::Vector3i brickMin = brick * BrickSize;
+    const Mn::Vector3i brickMax =
+        Mn::Math::min(brickMin + Mn::Vector3i{BrickSize}, dims) -
+        Mn::Vector3i{1};
+    for (int t = brickOffsets[b]; t < brickOffsets[b + 1]; ++t) {
+      const VoxelTriangle& triangle = triangles[brickTriangles[t]];
+      const Mn::Vector3i first = Mn::Math::max(triangle.min, brickMin);
+      const Mn::Vector3i last = Mn::Math::min(triangle.max, brickMax);
+      for (int i = first[0]; i <= last[0]; ++i) {
+        for (int j = first[1]; j <= last[1]; ++j) {
+          for (int k = first[2]; k <= last[2]; ++k) {
+            char& voxel = state[(std::size_t(i) * dims[1] + j) * dims[2] + k];
+            if (voxel != Surface &&
+                triangleOverlapsVoxel(triangle, Mn::Vector3(i, j, k))) {
+              voxel = Surface;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // flood the outside from the empty layer around the mesh; what it doesn't
+  // reach is enclosed by the mesh
+  std::vector<Mn::Vector3i> pending;
+  const auto reach = [&](const Mn::Vector3i& voxel) {
+    char& voxelState =
+        state[(std::size_t(voxel[0]) * dims[1] + voxel[1]) * dims[2] +
+              voxel[2]];
+    if (voxelState == Unknown) {
+      voxelState = Outside;
+      pending.push_back(voxel);
+    }
+  };
+  reach({0, 0, 0});
+  const Mn::Vector3i neighbors[]{{1, 0, 0},  {-1, 0, 0}, {0, 1, 0},
+                                 {0, -1, 0}, {0, 0, 1},  {0, 0, -1}};
+  while (!pending.empty()) {
+    const Mn::Vector3i voxel = pending.back();
+    pending.pop_back();
+    for (const Mn::Vector3i& offset : neighbors) {
+      if (isValidIndex(voxel + offset)) {
+        reach(voxel + offset);
+      }
+    }
+  }
+
+  addGrid<bool>("Boundary");
+  Cr::Containers::StridedArrayView3D<bool> boundaryGrid =
+      getGrid<bool>("Boundary");
+  std::size_t index = 0;
+  for (int i = 0; i < dims[0]; ++i) {
+    for (int j = 0; j < dims[1]; ++j) {
+      for (int k = 0; k < dims[2]; ++k) {
+        boundaryGrid[i][j][k] = state[index++] != Outside;
+      }
+    }
+  }
+}
+
+#ifdef ESP_BUILD_WITH_VHACD
+void VoxelGrid::voxelizeMeshWithVHACD(const assets::MeshData& meshData,
+                                      int resolution) {
+  VHACD::IVHACD* interfaceVHACD = VHACD::CreateVHACD();
 
   // run VHACD
   interfaceVHACD->computeVoxelField(&meshData.vbo[0][0], meshData.vbo.size(),
@@ -131,14 +350,13 @@ Mn::Vector3 VoxelGrid::getGlobalCoords(const Mn::Vector3i& coords) {
 }
 
 void VoxelGrid::fillBoolGridNeighborhood(std::vector<bool>& neighbors,
-                                         const std::string& gridName,
+                                         const GridHandle<bool>& grid,
                                          const Mn::Vector3i& index) {
   Mn::Vector3i increments[] = {{0, 0, 1},  {1, 0, 0},  {0, 1, 0},
                                {0, 0, -1}, {0, -1, 0}, {-1, 0, 0}};
-  Cr::Containers::StridedArrayView3D<bool> grid = getGrid<bool>(gridName);
   for (int i = 0; i < 6; ++i) {
     auto n = index + increments[i];
-    neighbors.push_back(isValidIndex(n) ? grid[n[0]][n[1]][n[2]] : false);
+    neighbors.push_back(isValidIndex(n) ? grid.get(n) : false);
   }
 }
 
@@ -299,21 +517,28 @@ void VoxelGrid::generateMesh(const std::string& gridName) {
   Cr::Containers::Array<Mn::UnsignedInt> indices;
   int num_filled = 0;
   VoxelGridType type = grids_[gridName].type;
+  GridHandle<Mn::Vector3> vectorGrid;
+  GridHandle<bool> boolGrid;
+  if (type == VoxelGridType::Vector3) {
+    vectorGrid = getGridHandle<Mn::Vector3>(gridName);
+  } else {
+    boolGrid = getGridHandle<bool>(gridName);
+  }
   // iterate through each voxel grid cell
   for (int i = 0; i < m_voxelGridDimensions[0]; ++i) {
     for (int j = 0; j < m_voxelGridDimensions[1]; ++j) {
       for (int k = 0; k < m_voxelGridDimensions[2]; ++k) {
         Mn::Vector3i local_coords(i, j, k);
         if (type == VoxelGridType::Vector3) {
-          Mn::Vector3 vec = getVoxel<Mn::Vector3>(local_coords, gridName);
+          Mn::Vector3 vec = vectorGrid.get(local_coords);
           if (vec != Mn::Vector3(0, 0, 0))
             addVectorToMeshPrimitives(vertices, indices, local_coords, vec);
         } else {
-          bool val = getVoxel<bool>(local_coords, gridName);
+          bool val = boolGrid.get(local_coords);
           if (val) {
             num_filled++;
             std::vector<bool> neighbors{};
-            fillBoolGridNeighborhood(neighbors, gridName, local_coords);
+            fillBoolGridNeighborhood(neighbors, boolGrid, local_coords);
             addVoxelToMeshPrimitives(vertices, indices, local_coords,
                                      neighbors);
           }
@@ -5,10 +5,13 @@
 #ifndef ESP_GEO_VOXEL_GRID_H_
 #define ESP_GEO_VOXEL_GRID_H_
 
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/GL/PixelFormat.h>
 #include <Magnum/Image.h>
@@ -33,6 +36,33 @@ namespace geo {
 
 enum class VoxelGridType { Bool, Int, Float, Vector3 };
 
+/**
+ * @brief How a mesh is turned into a "Boundary" voxel grid
+ */
+enum class VoxelizationMethod {
+  /**
+   * Conservative triangle/box overlap tests, run in parallel over bricks of
+   * voxels. Always available.
+   */
+  Builtin,
+  /**
+   * VHACD's voxelization. Only available when built with VHACD.
+   */
+  VHACD
+};
+
+/**
+ * @brief The voxelizer used when none is requested: @ref
+ * VoxelizationMethod::VHACD when built with VHACD, @ref
+ * VoxelizationMethod::Builtin otherwise
+ */
+constexpr VoxelizationMethod DefaultVoxelizationMethod =
+#ifdef ESP_BUILD_WITH_VHACD
+    VoxelizationMethod::VHACD;
+#else
+    VoxelizationMethod::Builtin;
+#endif
+
 // Used for generating voxel meshes
 struct VoxelVertex {
   Mn::Vector3 position;
@@ -45,21 +75,133 @@ class VoxelGrid {
     VoxelGridType type;
     Corrade::Containers::Array<char> data;
     Corrade::Containers::StridedArrayView3D<void> view;
+    // Sparse grids keep blocks of SparseBlockSize^3 voxels, by block index,
+    // and the value of all voxels outside of them in background. data and
+    // view are empty.
+    bool sparse = false;
+    std::unordered_map<int, Corrade::Containers::Array<char>> blocks;
+    Corrade::Containers::Array<char> background;
   };
 
  public:
-#ifdef ESP_BUILD_WITH_VHACD
+  //! The number of voxels along each side of a block of a sparse grid
+  static constexpr int SparseBlockSize = 8;
+
+  /**
+   * @brief Typed access to a single grid, looked up by name once.
+   *
+   * Obtain with @ref getGridHandle and use it in place of passing the grid
+   * name to @ref getVoxel and @ref setVoxel for every voxel. Dense grids also
+   * expose their voxels as one contiguous array with @ref data, which the
+   * bulk operations in VoxelUtils.h work on. A handle is invalidated when its
+   * grid is removed or replaced.
+   */
+  template <typename T>
+  class GridHandle {
+   public:
+    //! An invalid handle
+    GridHandle() = default;
+
+    //! Whether the handle refers to a grid
+    explicit operator bool() const { return entry_ != nullptr; }
+
+    //! Whether the grid uses sparse block storage
+    bool isSparse() const { return entry_->sparse; }
+
+    //! The dimensions of the grid
+    Magnum::Vector3i getDimensions() const {
+      return voxelGrid_->m_voxelGridDimensions;
+    }
+
+    //! The number of voxels of the grid
+    std::size_t size() const { return std::size_t(voxelGrid_->gridSize()); }
+
+    /**
+     * @brief The voxels of a dense grid in [i][j][k] order, nullptr for
+     * sparse grids.
+     */
+    T* data() const {
+      return entry_->sparse ? nullptr
+                            : static_cast<T*>(entry_->view.data());
+    }
+
+    /**
+     * @brief The voxels of the grid in [i][j][k] order. For a sparse grid the
+     * voxels are expanded into @p storage, which has to outlive the result.
+     */
+    const T* denseData(Corrade::Containers::Array<char>& storage) const {
+      if (!entry_->sparse) {
+        return data();
+      }
+      storage = Corrade::Containers::Array<char>(Corrade::NoInit,
+                                                 size() * sizeof(T));
+      const Magnum::Vector3i dims = getDimensions();
+      voxelGrid_->copyEntryTo<T>(
+          *entry_, Corrade::Containers::StridedArrayView3D<T>{
+                       Corrade::Containers::arrayCast<T>(storage),
+                       {std::size_t(dims[0]), std::size_t(dims[1]),
+                        std::size_t(dims[2])}});
+      return reinterpret_cast<const T*>(storage.data());
+    }
+
+    //! The value of voxels outside the allocated blocks of a sparse grid
+    const T& getBackground() const { return backgroundOf<T>(*entry_); }
+
+    //! The voxel at @p index
+    T get(const Magnum::Vector3i& index) const {
+      if (entry_->sparse) {
+        const T* voxel = voxelGrid_->sparseVoxel<T>(*entry_, index, false);
+        return voxel != nullptr ? *voxel : getBackground();
+      }
+      return data()[voxelGrid_->linearIndex(index)];
+    }
+
+    //! Sets the voxel at @p index to @p value
+    void set(const Magnum::Vector3i& index, const T& value) const {
+      if (entry_->sparse) {
+        // voxels of missing blocks already have the background value
+        const bool allocate = !(value == getBackground());
+        T* voxel = voxelGrid_->sparseVoxel<T>(*entry_, index, allocate);
+        if (voxel != nullptr) {
+          *voxel = value;
+        }
+        return;
+      }
+      data()[voxelGrid_->linearIndex(index)] = value;
+    }
+
+    /**
+     * @brief Calls @p f with the index of the first voxel and a view of each
+     * allocated block, see @ref VoxelGrid::forEachAllocatedBlock.
+     */
+    template <typename F>
+    void forEachAllocatedBlock(F&& f) const {
+      voxelGrid_->forEachAllocatedBlockOf<T>(*entry_, f);
+    }
+
+   private:
+    friend VoxelGrid;
+    GridHandle(VoxelGrid* voxelGrid, GridEntry* entry)
+        : voxelGrid_{voxelGrid}, entry_{entry} {}
+
+    VoxelGrid* voxelGrid_ = nullptr;
+    GridEntry* entry_ = nullptr;
+  };
+
   /**
-   * @brief Generates a Boundary voxel grid using VHACD's voxelization
-   * framework.
+   * @brief Generates a Boundary voxel grid from a mesh. Voxels the mesh
+   * passes through are filled, as are voxels enclosed by the mesh.
    * @param meshData The mesh that will be voxelized
    * @param renderAssetHandle The handle for the render asset.
    * @param resolution The approximate number of voxels in the voxel grid.
+   * @param method The voxelizer to use, see @ref DefaultVoxelizationMethod.
+   * The grids of both methods have slightly different dimensions and
+   * offsets.
    */
   VoxelGrid(const assets::MeshData& meshData,
             const std::string& renderAssetHandle,
-            int resolution);
-#endif
+            int resolution,
+            VoxelizationMethod method = DefaultVoxelizationMethod);
 
   /**
    * @brief Generates an empty voxel grid given some voxel size and voxel
@@ -110,15 +252,7 @@ class VoxelGrid {
     if (grids_.find(gridName) != grids_.end()) {
       // grid exists, simply overwrite
       ESP_DEBUG() << gridName << "exists, overwriting.";
-
-      grids_[gridName].data = Corrade::Containers::Array<char>(
-          Corrade::ValueInit, gridSize() * sizeof(T));
-
-      Corrade::Containers::StridedArrayView3D<void> view{grids_[gridName].data,
-                                                         dims, strides};
-      grids_[gridName].view = view;
-      grids_[gridName].type = type;
-      return;
+      grids_.erase(gridName);
     }
 
     GridEntry new_grid;
@@ -133,6 +267,161 @@ class VoxelGrid {
     grids_.insert(std::make_pair(gridName, std::move(new_grid)));
   }
 
+  /**
+   * @brief Generates a new sparse voxel grid of a specified type, with all
+   * voxels set to @p background.
+   *
+   * Only blocks of @ref SparseBlockSize^3 voxels containing a voxel set to a
+   * value other than @p background take memory, so sparse grids suit large
+   * voxelizations which are mostly empty. Access voxels with @ref getVoxel and
+   * @ref setVoxel, or visit the allocated blocks with
+   * @ref forEachAllocatedBlock; @ref getGrid is only available for dense
+   * grids.
+   * @param gridName The key under which the grid will be registered and
+   * accessed.
+   * @param background The value of voxels which were never set.
+   */
+  template <typename T>
+  void addSparseGrid(const std::string& gridName, const T& background = T{}) {
+    if (grids_.find(gridName) != grids_.end()) {
+      ESP_DEBUG() << gridName << "exists, overwriting.";
+      grids_.erase(gridName);
+    }
+
+    GridEntry new_grid;
+    new_grid.type = voxelGridTypeFor<T>();
+    new_grid.sparse = true;
+    setBackground(new_grid, background);
+    grids_.insert(std::make_pair(gridName, std::move(new_grid)));
+  }
+
+  /**
+   * @brief Converts a dense grid to a sparse one, dropping the blocks in which
+   * all voxels equal @p background.
+   * @param gridName The name of the grid.
+   * @param background The value of voxels outside the allocated blocks.
+   */
+  template <typename T>
+  void makeGridSparse(const std::string& gridName, const T& background = T{}) {
+    Corrade::Containers::StridedArrayView3D<const T> dense =
+        getGrid<T>(gridName);
+    GridEntry sparse_grid;
+    sparse_grid.type = voxelGridTypeFor<T>();
+    sparse_grid.sparse = true;
+    setBackground(sparse_grid, background);
+
+    forEachBlockOrigin([&](const Magnum::Vector3i& origin) {
+      const auto block = denseBlock(dense, origin);
+      bool isBackground = true;
+      for (std::size_t i = 0; i != block.size()[0] && isBackground; ++i) {
+        for (std::size_t j = 0; j != block.size()[1] && isBackground; ++j) {
+          for (std::size_t k = 0; k != block.size()[2]; ++k) {
+            if (!(block[i][j][k] == background)) {
+              isBackground = false;
+              break;
+            }
+          }
+        }
+      }
+      if (!isBackground) {
+        Corrade::Utility::copy(
+            block,
+            sparseBlock<T>(allocateBlock<T>(sparse_grid, origin), origin));
+      }
+    });
+    grids_[gridName] = std::move(sparse_grid);
+  }
+
+  /**
+   * @brief Whether a grid was created by @ref addSparseGrid or converted by
+   * @ref makeGridSparse.
+   * @param gridName The name of the grid.
+   */
+  bool isSparseGrid(const std::string& gridName) {
+    assert(grids_.find(gridName) != grids_.end());
+    return grids_[gridName].sparse;
+  }
+
+  /**
+   * @brief The number of allocated blocks of a sparse grid, 0 for dense grids.
+   * @param gridName The name of the grid.
+   */
+  std::size_t getNumAllocatedBlocks(const std::string& gridName) {
+    assert(grids_.find(gridName) != grids_.end());
+    return grids_[gridName].blocks.size();
+  }
+
+  /**
+   * @brief Returns the value of voxels outside of the allocated blocks of a
+   * sparse grid.
+   * @param gridName The name of the sparse grid.
+   */
+  template <typename T>
+  T getBackground(const std::string& gridName) {
+    const GridEntry& grid = checkedGridEntry<T>(gridName);
+    CORRADE_ASSERT(grid.sparse,
+                   "VoxelGrid::getBackground(\"" + gridName +
+                       "\") - Error: the grid isn't sparse.",
+                   {});
+    return backgroundOf<T>(grid);
+  }
+
+  /**
+   * @brief Calls @p f with the index of the first voxel and a view of each
+   * allocated block of a grid, clipped to the grid dimensions. Dense grids
+   * consist of allocated blocks only, so all their voxels are visited. The
+   * order of the blocks is unspecified.
+   * @param gridName The name of the grid.
+   * @param f Called as f(const Magnum::Vector3i& origin,
+   * const Corrade::Containers::StridedArrayView3D<T>& block).
+   */
+  template <typename T, typename F>
+  void forEachAllocatedBlock(const std::string& gridName, F&& f) {
+    forEachAllocatedBlockOf<T>(checkedGridEntry<T>(gridName), f);
+  }
+
+  /**
+   * @brief Copies all voxels of a grid, dense or sparse, into @p out, which
+   * has to have the grid dimensions.
+   * @param gridName The name of the grid.
+   * @param out The destination.
+   */
+  template <typename T>
+  void copyGridTo(const std::string& gridName,
+                  const Corrade::Containers::StridedArrayView3D<T>& out) {
+    copyEntryTo<T>(checkedGridEntry<T>(gridName), out);
+  }
+
+  /**
+   * @brief Returns a contiguous dense read-only view of a grid. Dense grids
+   * are returned as is, sparse ones are expanded into @p storage first. Write
+   * to dense grids through @ref getGrid.
+   * @param gridName The name of the grid.
+   * @param storage Holds the expanded voxels of a sparse grid, has to outlive
+   * the returned view.
+   */
+  template <typename T>
+  Corrade::Containers::StridedArrayView3D<const T> getDenseGrid(
+      const std::string& gridName,
+      Corrade::Containers::Array<char>& storage) {
+    const T* data = getGridHandle<T>(gridName).denseData(storage);
+    return Corrade::Containers::StridedArrayView3D<const T>{
+        Corrade::Containers::ArrayView<const T>{data, std::size_t(gridSize())},
+        {std::size_t(m_voxelGridDimensions[0]),
+         std::size_t(m_voxelGridDimensions[1]),
+         std::size_t(m_voxelGridDimensions[2])}};
+  }
+
+  /**
+   * @brief Returns a typed handle to a grid, to access many of its voxels
+   * without looking the grid up each time.
+   * @param gridName The name of the grid.
+   */
+  template <typename T>
+  GridHandle<T> getGridHandle(const std::string& gridName) {
+    return GridHandle<T>{this, &checkedGridEntry<T>(gridName)};
+  }
+
   /**
    * @brief Returns a list of existing voxel grids and their types.
    * @return A vector of pairs, where the first element is the voxel grid's
@@ -167,12 +456,13 @@ class VoxelGrid {
   template <typename T>
   Corrade::Containers::StridedArrayView3D<T> getGrid(
       const std::string& gridName) {
-    VoxelGridType type = voxelGridTypeFor<T>();
-    CORRADE_ASSERT(grids_[gridName].type == type,
+    const GridEntry& grid = checkedGridEntry<T>(gridName);
+    CORRADE_ASSERT(!grid.sparse,
                    "VoxelGrid::getGrid(\"" + gridName +
-                       "\") - Error: incorrect grid type cast requested.",
+                       "\") - Error: the grid is sparse, use getVoxel() or "
+                       "forEachAllocatedBlock().",
                    {});
-    return Corrade::Containers::arrayCast<T>(grids_[gridName].view);
+    return Corrade::Containers::arrayCast<T>(grid.view);
   }
 
   /**
@@ -198,9 +488,7 @@ class VoxelGrid {
   void setVoxel(const Magnum::Vector3i& index,
                 const std::string& gridName,
                 const T& value) {
-    Corrade::Containers::StridedArrayView3D<T> arrayView3D =
-        getGrid<T>(gridName);
-    arrayView3D[index[0]][index[1]][index[2]] = value;
+    getGridHandle<T>(gridName).set(index, value);
   }
 
   /**
@@ -212,9 +500,7 @@ class VoxelGrid {
    */
   template <typename T>
   T getVoxel(const Magnum::Vector3i& index, const std::string& gridName) {
-    Corrade::Containers::StridedArrayView3D<T> arrayView3D =
-        getGrid<T>(gridName);
-    return arrayView3D[index[0]][index[1]][index[2]];
+    return getGridHandle<T>(gridName).get(index);
   }
 
   /**
@@ -310,15 +596,15 @@ class VoxelGrid {
     assert(minVal != maxVal);
     Corrade::Containers::Array<VoxelVertex> vertices;
     Corrade::Containers::Array<Mn::UnsignedInt> indices;
-    Corrade::Containers::StridedArrayView3D<T> grid = getGrid<T>(gridName);
+    const GridHandle<T> grid = getGridHandle<T>(gridName);
 
     // iterate through each voxel grid cell
     for (int j = 0; j < m_voxelGridDimensions[1]; ++j) {
       for (int k = 0; k < m_voxelGridDimensions[2]; ++k) {
-        T val = clamp(grid[ind][j][k], minVal, maxVal);
+        Magnum::Vector3i local_coords(ind, j, k);
+        T val = clamp(grid.get(local_coords), minVal, maxVal);
         val -= minVal;
         float colorVal = float(val) / float(maxVal - minVal);
-        Magnum::Vector3i local_coords(ind, j, k);
         Magnum::Color3 col = Magnum::Color3(1 - colorVal, colorVal, 0);
         std::vector<bool> neighbors{false, false, false, false, false, false};
         addVoxelToMeshPrimitives(vertices, indices, local_coords, neighbors,
@@ -335,11 +621,11 @@ class VoxelGrid {
    * bottom (x+1), right (y+1), left (y-1), back (z-1) and front (x-1)
    * neighboring voxel's status.
    * @param [in] neighbors The vector of booleans to be filled.
-   * @param gridName The name of the boolean grid to be checked.
+   * @param grid The boolean grid to be checked.
    * @param index The index of the voxel.
    */
   void fillBoolGridNeighborhood(std::vector<bool>& neighbors,
-                                const std::string& gridName,
+                                const GridHandle<bool>& grid,
                                 const Magnum::Vector3i& index);
 
   /**
@@ -392,6 +678,203 @@ class VoxelGrid {
       const Magnum::Vector3& vec);
 
  private:
+  /**
+   * @brief Sets the grid dimensions, voxel size and offset to fit the mesh,
+   * then fills the Boundary grid with the built-in voxelizer.
+   */
+  void voxelizeMesh(const assets::MeshData& meshData, int resolution);
+
+#ifdef ESP_BUILD_WITH_VHACD
+  /**
+   * @brief Same as @ref voxelizeMesh, using VHACD.
+   */
+  void voxelizeMeshWithVHACD(const assets::MeshData& meshData,
+                             int resolution);
+#endif
+
+  /**
+   * @brief Returns the entry of a grid, asserting it exists and is of type T.
+   * When the assert doesn't abort, a missing grid gets an empty entry which
+   * isn't added to the grids.
+   */
+  template <typename T>
+  GridEntry& checkedGridEntry(const std::string& gridName) {
+    auto it = grids_.find(gridName);
+    CORRADE_ASSERT(it != grids_.end(),
+                   "VoxelGrid: no grid named \"" + gridName + "\".",
+                   missingGridEntry());
+    CORRADE_ASSERT(it->second.type == voxelGridTypeFor<T>(),
+                   "VoxelGrid(\"" + gridName +
+                       "\") - Error: incorrect grid type cast requested.",
+                   it->second);
+    return it->second;
+  }
+
+  static GridEntry& missingGridEntry() {
+    static GridEntry entry{};
+    entry = GridEntry{};
+    return entry;
+  }
+
+  template <typename T>
+  static void setBackground(GridEntry& grid, const T& value) {
+    grid.background =
+        Corrade::Containers::Array<char>(Corrade::NoInit, sizeof(T));
+    *reinterpret_cast<T*>(grid.background.data()) = value;
+  }
+
+  template <typename T>
+  static const T& backgroundOf(const GridEntry& grid) {
+    return *reinterpret_cast<const T*>(grid.background.data());
+  }
+
+  // The index of a voxel in the [i][j][k] order of dense grids
+  std::size_t linearIndex(const Magnum::Vector3i& index) const {
+    return (std::size_t(index[0]) * m_voxelGridDimensions[1] + index[1]) *
+               m_voxelGridDimensions[2] +
+           index[2];
+  }
+
+  template <typename T, typename F>
+  void forEachAllocatedBlockOf(GridEntry& grid, F&& f) {
+    if (!grid.sparse) {
+      const auto dense = Corrade::Containers::arrayCast<T>(grid.view);
+      forEachBlockOrigin([&](const Magnum::Vector3i& origin) {
+        f(origin, denseBlock(dense, origin));
+      });
+      return;
+    }
+    for (auto& block : grid.blocks) {
+      const Magnum::Vector3i origin = blockOrigin(block.first);
+      f(origin, sparseBlock<T>(block.second, origin));
+    }
+  }
+
+  template <typename T>
+  void copyEntryTo(GridEntry& grid,
+                   const Corrade::Containers::StridedArrayView3D<T>& out) {
+    if (grid.sparse) {
+      const T value = backgroundOf<T>(grid);
+      for (std::size_t i = 0; i != out.size()[0]; ++i) {
+        for (std::size_t j = 0; j != out.size()[1]; ++j) {
+          for (std::size_t k = 0; k != out.size()[2]; ++k) {
+            out[i][j][k] = value;
+          }
+        }
+      }
+    }
+    forEachAllocatedBlockOf<T>(
+        grid, [&](const Magnum::Vector3i& origin,
+                  const Corrade::Containers::StridedArrayView3D<T>& block) {
+          Corrade::Utility::copy(block, denseBlock(out, origin));
+        });
+  }
+
+  // The number of blocks along each dimension of a sparse grid
+  Magnum::Vector3i numBlocks() const {
+    return (m_voxelGridDimensions + Magnum::Vector3i{SparseBlockSize - 1}) /
+           SparseBlockSize;
+  }
+
+  // The key of the block containing the voxel at index
+  int blockKey(const Magnum::Vector3i& index) const {
+    const Magnum::Vector3i block = index / SparseBlockSize;
+    const Magnum::Vector3i counts = numBlocks();
+    return (block[0] * counts[1] + block[1]) * counts[2] + block[2];
+  }
+
+  // The index of the first voxel of the block with the given key
+  Magnum::Vector3i blockOrigin(int key) const {
+    const Magnum::Vector3i counts = numBlocks();
+    return Magnum::Vector3i{key / (counts[1] * counts[2]),
+                            (key / counts[2]) % counts[1], key % counts[2]} *
+           SparseBlockSize;
+  }
+
+  // Calls f with the index of the first voxel of every block of the grid
+  template <typename F>
+  void forEachBlockOrigin(F&& f) const {
+    for (int i = 0; i < m_voxelGridDimensions[0]; i += SparseBlockSize) {
+      for (int j = 0; j < m_voxelGridDimensions[1]; j += SparseBlockSize) {
+        for (int k = 0; k < m_voxelGridDimensions[2]; k += SparseBlockSize) {
+          f(Magnum::Vector3i{i, j, k});
+        }
+      }
+    }
+  }
+
+  // The block of a dense view starting at origin, clipped to the grid
+  template <typename T>
+  Corrade::Containers::StridedArrayView3D<T> denseBlock(
+      const Corrade::Containers::StridedArrayView3D<T>& view,
+      const Magnum::Vector3i& origin) const {
+    const Magnum::Vector3i end =
+        Magnum::Math::min(origin + Magnum::Vector3i{SparseBlockSize},
+                          m_voxelGridDimensions);
+    return view.slice({std::size_t(origin[0]), std::size_t(origin[1]),
+                       std::size_t(origin[2])},
+                      {std::size_t(end[0]), std::size_t(end[1]),
+                       std::size_t(end[2])});
+  }
+
+  // A view of the data of a sparse block starting at origin, clipped to the
+  // grid
+  template <typename T>
+  Corrade::Containers::StridedArrayView3D<T> sparseBlock(
+      Corrade::Containers::Array<char>& data,
+      const Magnum::Vector3i& origin) const {
+    constexpr std::size_t Size = SparseBlockSize;
+    const Corrade::Containers::StridedArrayView3D<T> block{
+        Corrade::Containers::arrayCast<T>(data), {Size, Size, Size}};
+    const Magnum::Vector3i size = Magnum::Math::min(
+        Magnum::Vector3i{SparseBlockSize}, m_voxelGridDimensions - origin);
+    return block.prefix({std::size_t(size[0]), std::size_t(size[1]),
+                         std::size_t(size[2])});
+  }
+
+  // Returns the block containing the voxel at index, allocating it filled
+  // with the background value if missing
+  template <typename T>
+  Corrade::Containers::Array<char>& allocateBlock(
+      GridEntry& grid,
+      const Magnum::Vector3i& index) {
+    constexpr std::size_t Size = SparseBlockSize;
+    auto inserted = grid.blocks.emplace(blockKey(index),
+                                        Corrade::Containers::Array<char>{});
+    Corrade::Containers::Array<char>& data = inserted.first->second;
+    if (inserted.second) {
+      data = Corrade::Containers::Array<char>(Corrade::NoInit,
+                                              Size * Size * Size * sizeof(T));
+      const T value = backgroundOf<T>(grid);
+      for (T& voxel : Corrade::Containers::arrayCast<T>(data)) {
+        voxel = value;
+      }
+    }
+    return data;
+  }
+
+  // The voxel at index of a sparse grid, or nullptr if its block is missing
+  // and allocate is false
+  template <typename T>
+  T* sparseVoxel(GridEntry& grid,
+                 const Magnum::Vector3i& index,
+                 bool allocate) {
+    Corrade::Containers::Array<char>* data = nullptr;
+    if (allocate) {
+      data = &allocateBlock<T>(grid, index);
+    } else {
+      auto it = grid.blocks.find(blockKey(index));
+      if (it == grid.blocks.end()) {
+        return nullptr;
+      }
+      data = &it->second;
+    }
+    const Magnum::Vector3i local = index % SparseBlockSize;
+    return reinterpret_cast<T*>(data->data()) +
+           (local[0] * SparseBlockSize + local[1]) * SparseBlockSize +
+           local[2];
+  }
+
   // The number of voxels on the x, y, and z dimensions of the grid
   Magnum::Vector3i m_voxelGridDimensions;
 
@@ -1,90 +1,135 @@
 
 #include "VoxelUtils.h"
 #include <Corrade/Utility/Algorithms.h>
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 namespace esp {
 namespace geo {
 
+std::size_t getNumVoxelChunks(std::size_t count, std::size_t grain) {
+  // enough chunks to balance the threads, few enough to keep them cheap
+  constexpr std::size_t MaxChunks = 256;
+  grain = std::max(grain, std::size_t(1));
+  return std::max(std::size_t(1),
+                  std::min((count + grain - 1) / grain, MaxChunks));
+}
+
+std::size_t forEachVoxelChunk(
+    std::size_t count,
+    const std::function<void(std::size_t, std::size_t, std::size_t)>& f,
+    std::size_t grain) {
+  const std::size_t numChunks = getNumVoxelChunks(count, grain);
+  const int numChunksInt = int(numChunks);
+#pragma omp parallel for schedule(dynamic) if (numChunksInt > 1)
+  for (int chunk = 0; chunk < numChunksInt; ++chunk) {
+    f(chunk, count * chunk / numChunks, count * (chunk + 1) / numChunks);
+  }
+  return numChunks;
+}
+
 void generateInteriorExteriorVoxelGrid(
     std::shared_ptr<esp::geo::VoxelWrapper>& voxelWrapper) {
   // create 6 bool grids
   auto v_grid = voxelWrapper->getVoxelGrid();
-  auto boundaryGrid = v_grid->getGrid<bool>("Boundary");
+  Cr::Containers::Array<char> boundaryStorage;
+  const bool* boundary =
+      v_grid->getGridHandle<bool>("Boundary").denseData(boundaryStorage);
 
   auto m_voxelGridDimensions = v_grid->getVoxelGridDimensions();
+  const std::size_t strides[3]{
+      std::size_t(m_voxelGridDimensions[1]) * m_voxelGridDimensions[2],
+      std::size_t(m_voxelGridDimensions[2]), 1};
   // Create a temporary grid (unregistered) to hold 6 booleans for each cell -
   // each for a specified direction of raycasts
-  std::size_t dims[3]{static_cast<std::size_t>(m_voxelGridDimensions[0]),
-                      static_cast<std::size_t>(m_voxelGridDimensions[1]),
-                      static_cast<std::size_t>(m_voxelGridDimensions[2])};
-  Corrade::Containers::Array<char> cr_grid{
-      Corrade::ValueInit, v_grid->gridSize() * sizeof(Mn::Math::BitVector<6>)};
-  auto shadowGrid_ =
-      Cr::Containers::StridedArrayView<3, Mn::Math::BitVector<6>>{
-          Cr::Containers::arrayCast<Mn::Math::BitVector<6>>(cr_grid), dims};
-
-  // fill each grid with ray cast
-  bool hit = false;
-  int ind = 0;
-  int increment = 0;
-  Mn::Vector3i indices;
+  Corrade::Containers::Array<Mn::Math::BitVector<6>> shadow{
+      Corrade::ValueInit, std::size_t(v_grid->gridSize())};
+
+  // fill each grid with ray cast, the lines along an axis are independent
   for (int castAxis = 0; castAxis < 3; ++castAxis) {
     int a1 = castAxis != 0 ? 0 : 1;
     int a2 = castAxis == 2 ? 1 : 2;
-    for (int j = 0; j < m_voxelGridDimensions[a1]; ++j) {
-      for (int k = 0; k < m_voxelGridDimensions[a2]; ++k) {
-        indices[a1] = j;
-        indices[a2] = k;
-        // fill from front and back of each 1D slice
-        for (int direction = -1; direction < 2; direction += 2) {  //-1 and 1
-          hit = false;
-          ind = (direction > 0 ? 0 : m_voxelGridDimensions[castAxis] - 1);
-          while (ind >= 0 && ind < m_voxelGridDimensions[castAxis]) {
-            indices[castAxis] = ind;
-            hit = (hit || boundaryGrid[indices[0]][indices[1]][indices[2]]);
-            if (hit)
-              shadowGrid_[indices[0]][indices[1]][indices[2]].set(
-                  castAxis * 2 + (direction < 0 ? 0 : 1), true);
-            ind += direction;
+    const int length = m_voxelGridDimensions[castAxis];
+    const std::size_t stride = strides[castAxis];
+    forEachVoxelChunk(
+        std::size_t(m_voxelGridDimensions[a1]) * m_voxelGridDimensions[a2],
+        [&](std::size_t, std::size_t begin, std::size_t end) {
+          for (std::size_t line = begin; line != end; ++line) {
+            const std::size_t first =
+                line / m_voxelGridDimensions[a2] * strides[a1] +
+                line % m_voxelGridDimensions[a2] * strides[a2];
+            // fill from front and back of each 1D slice
+            bool hit = false;
+            for (int ind = 0; ind < length; ++ind) {
+              const std::size_t v = first + ind * stride;
+              hit = hit || boundary[v];
+              if (hit)
+                shadow[v].set(castAxis * 2 + 1, true);
+            }
+            hit = false;
+            for (int ind = length - 1; ind >= 0; --ind) {
+              const std::size_t v = first + ind * stride;
+              hit = hit || boundary[v];
+              if (hit)
+                shadow[v].set(castAxis * 2, true);
+            }
           }
-        }
-      }
-    }
+        },
+        // a line is worth many voxels of work
+        64);
   }
 
-  // create int grid
-  std::string gridName = "InteriorExterior";
-  v_grid->addGrid<int>(gridName);
-  auto intExtGrid = v_grid->getGrid<int>(gridName);
-  bool nX = false, pX = false, nY = false, pY = false, nZ = false, pZ = false;
   // fill in int grid with voting approach
-  for (int i = 0; i < m_voxelGridDimensions[0]; ++i) {
-    for (int j = 0; j < m_voxelGridDimensions[1]; ++j) {
-      for (int k = 0; k < m_voxelGridDimensions[2]; ++k) {
-        Mn::Vector3i index = Mn::Vector3i(i, j, k);
-        if (boundaryGrid[i][j][k]) {
-          intExtGrid[i][j][k] = 0;
-          continue;
-        }
-        nX = !shadowGrid_[i][j][k][0];
-        pX = !shadowGrid_[i][j][k][1];
-        nY = !shadowGrid_[i][j][k][2];
-        pY = !shadowGrid_[i][j][k][3];
-        nZ = !shadowGrid_[i][j][k][4];
-        pZ = !shadowGrid_[i][j][k][5];
-        // || ((nX || pX) && (nY || pY) && (nZ || pZ))
-        if (((nX && pX) || (nY && pY) || (nZ && pZ)) ||
-            ((nX || pX) && (nY || pY) && (nZ || pZ))) {
-          // Exterior (+inf)
-          intExtGrid[i][j][k] = INT_MAX;
-        } else {
-          // Interior (-inf)
-          intExtGrid[i][j][k] = INT_MIN;
+  const auto vote = [&](std::size_t v) {
+    if (boundary[v]) {
+      return 0;
+    }
+    const bool nX = !shadow[v][0];
+    const bool pX = !shadow[v][1];
+    const bool nY = !shadow[v][2];
+    const bool pY = !shadow[v][3];
+    const bool nZ = !shadow[v][4];
+    const bool pZ = !shadow[v][5];
+    // || ((nX || pX) && (nY || pY) && (nZ || pZ))
+    if (((nX && pX) || (nY && pY) || (nZ && pZ)) ||
+        ((nX || pX) && (nY || pY) && (nZ || pZ))) {
+      // Exterior (+inf)
+      return INT_MAX;
+    }
+    // Interior (-inf)
+    return INT_MIN;
+  };
+
+  // create int grid, sparse with mostly exterior voxels for a sparse boundary
+  std::string gridName = "InteriorExterior";
+  if (v_grid->isSparseGrid("Boundary")) {
+    v_grid->addSparseGrid<int>(gridName, INT_MAX);
+    const auto intExtGrid = v_grid->getGridHandle<int>(gridName);
+    // allocating blocks isn't thread safe, keep this serial
+    std::size_t v = 0;
+    for (int i = 0; i < m_voxelGridDimensions[0]; ++i) {
+      for (int j = 0; j < m_voxelGridDimensions[1]; ++j) {
+        for (int k = 0; k < m_voxelGridDimensions[2]; ++k, ++v) {
+          const int value = vote(v);
+          if (value != INT_MAX) {
+            intExtGrid.set({i, j, k}, value);
+          }
         }
       }
     }
+    return;
   }
+
+  v_grid->addGrid<int>(gridName);
+  int* intExt = v_grid->getGridHandle<int>(gridName).data();
+  forEachVoxelChunk(v_grid->gridSize(),
+                    [&](std::size_t, std::size_t begin, std::size_t end) {
+                      for (std::size_t v = begin; v != end; ++v) {
+                        intExt[v] = vote(v);
+                      }
+                    });
 }
 
 void generateManhattanDistanceSDF(
@@ -100,10 +145,11 @@ void generateManhattanDistanceSDF(
 
   // create new intGrid and copy data from interior/exterior grid
   v_grid->addGrid<int>(gridName);
-  auto intExtGrid = v_grid->getGrid<int>("InteriorExterior");
   auto sdfGrid = v_grid->getGrid<int>(gridName);
 
-  Cr::Utility::copy(intExtGrid, sdfGrid);
+  transformGrid(v_grid->getGridHandle<int>("InteriorExterior"),
+                v_grid->getGridHandle<int>(gridName),
+                [](int value) { return value; });
 
   // 1st sweep
   for (int i = 0; i < m_voxelGridDimensions[0]; ++i) {
@@ -184,6 +230,55 @@ void generateManhattanDistanceSDF(
   }
 }
 
+namespace {
+
+// Stands in for the distance to a boundary where there is none. Finite, so
+// the envelope intersections below stay finite as well.
+constexpr float FarAway = 1e20f;
+
+/**
+ * @brief Felzenszwalb and Huttenlocher's exact 1D squared distance transform,
+ * d[q] = min_p (q - p)^2 + f[p], as the lower envelope of parabolas.
+ * @param f The n input values
+ * @param d The n outputs
+ * @param v Scratch for n parabola locations
+ * @param z Scratch for n + 1 envelope boundaries
+ */
+void squaredDistanceTransform1D(const float* f,
+                                float* d,
+                                int* v,
+                                float* z,
+                                int n) {
+  int k = 0;
+  v[0] = 0;
+  z[0] = -std::numeric_limits<float>::infinity();
+  z[1] = std::numeric_limits<float>::infinity();
+  for (int q = 1; q < n; ++q) {
+    float s = 0.0f;
+    while (true) {
+      const int p = v[k];
+      s = ((f[q] + float(q * q)) - (f[p] + float(p * p))) / float(2 * (q - p));
+      if (s > z[k]) {
+        break;
+      }
+      --k;
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = std::numeric_limits<float>::infinity();
+  }
+  k = 0;
+  for (int q = 0; q < n; ++q) {
+    while (z[k + 1] < float(q)) {
+      ++k;
+    }
+    d[q] = float((q - v[k]) * (q - v[k])) + f[v[k]];
+  }
+}
+
+}  // namespace
+
 void generateEuclideanDistanceSDF(
     std::shared_ptr<esp::geo::VoxelWrapper>& voxelWrapper,
     const std::string& gridName) {
@@ -195,68 +290,50 @@ void generateEuclideanDistanceSDF(
     generateInteriorExteriorVoxelGrid(voxelWrapper);
   }
 
-  // create float grid for distances, will be filled in the sweep.
+  // create float grid for distances, holding squared distances until the end
   v_grid->addGrid<float>(gridName);
-  auto sdfGrid = v_grid->getGrid<float>(gridName);
-
-  auto intExtGrid = v_grid->getGrid<int>("InteriorExterior");
-
-  // create new vector3Grid to track closest boundaries
-  v_grid->addGrid<Mn::Vector3>("ClosestBoundaryCell");
-  auto closestCellGrid = v_grid->getGrid<Mn::Vector3>("ClosestBoundaryCell");
-
-  // initialize non-boundaries with some far away point which will be overridden
-  // by any valid boundary cell
-  Mn::Vector3 farAway = Mn::Vector3(m_voxelGridDimensions) * 3;
-  Mn::Vector3i bestNeighbor;
-  Mn::Vector3i behind;
-  Mn::Vector3i curIndex;
-  float bestDistance = std::numeric_limits<float>::max();
-  float neighborDistance = std::numeric_limits<float>::max();
-  for (int sweep = 1; sweep > -2; sweep -= 2) {  // 1, -1
-    Mn::Vector3i start =
-        sweep > 0 ? Mn::Vector3i(0) : m_voxelGridDimensions - Mn::Vector3i(1);
-    Mn::Vector3i end = sweep < 0 ? Mn::Vector3i(-1) : m_voxelGridDimensions;
-    for (int i = start[0]; i != end[0]; i += sweep) {
-      for (int j = start[1]; j != end[1]; j += sweep) {
-        for (int k = start[2]; k != end[2]; k += sweep) {
-          curIndex = {i, j, k};
-          if (sweep == 1) {
-            // initialize the SDF
-            closestCellGrid[i][j][k] =
-                intExtGrid[i][j][k] == 0 ? Mn::Vector3(i, j, k) : farAway;
-            sdfGrid[i][j][k] =
-                (closestCellGrid[i][j][k] - Mn::Vector3(curIndex)).length();
-          }
-          // find the best neighbor "behind" the current voxel
-          bestDistance = std::numeric_limits<float>::max();
-          for (int bAxis = 0; bAxis < 3; ++bAxis) {
-            behind = curIndex;
-            behind[bAxis] -= sweep;  // check
-            if (v_grid->isValidIndex(behind)) {
-              // distance check
-              neighborDistance =
-                  (closestCellGrid[behind[0]][behind[1]][behind[2]] -
-                   Mn::Vector3(curIndex))
-                      .length();
-              if (neighborDistance < bestDistance) {
-                bestDistance = neighborDistance;
-                bestNeighbor = behind;
-              }
-            }
-          }
-          // set best values
-          if (bestDistance < std::abs(sdfGrid[i][j][k])) {
-            sdfGrid[i][j][k] =
-                intExtGrid[i][j][k] < 0 ? -bestDistance : bestDistance;
-            closestCellGrid[i][j][k] =
-                closestCellGrid[bestNeighbor[0]][bestNeighbor[1]]
-                               [bestNeighbor[2]];
-          }
+  const auto sdfGrid = v_grid->getGridHandle<float>(gridName);
+  const auto intExtGrid = v_grid->getGridHandle<int>("InteriorExterior");
+
+  transformGrid(intExtGrid, sdfGrid,
+                [](int intExt) { return intExt == 0 ? 0.0f : FarAway; });
+
+  // the grid is dense, index it linearly
+  float* sdf = sdfGrid.data();
+  const int numVoxels = v_grid->gridSize();
+  const int strides[3]{m_voxelGridDimensions[1] * m_voxelGridDimensions[2],
+                       m_voxelGridDimensions[2], 1};
+
+  // the squared distance is separable, so transform the lines along each axis
+  // in turn
+  for (int axis = 2; axis >= 0; --axis) {
+    const int n = m_voxelGridDimensions[axis];
+    const int numLines = n > 0 ? numVoxels / n : 0;
+    const int stride = strides[axis];
+#pragma omp parallel
+    {
+      std::vector<float> f(n), d(n), z(n + 1);
+      std::vector<int> v(n);
+#pragma omp for
+      for (int line = 0; line < numLines; ++line) {
+        // skip the coordinates before the axis, keep the ones after it
+        const int first = (line / stride) * stride * n + line % stride;
+        for (int q = 0; q < n; ++q) {
+          f[q] = sdf[first + q * stride];
+        }
+        squaredDistanceTransform1D(f.data(), d.data(), v.data(), z.data(), n);
+        for (int q = 0; q < n; ++q) {
+          sdf[first + q * stride] = d[q];
         }
       }
     }
   }
+
+  combineGrids(sdfGrid, intExtGrid, sdfGrid,
+               [](float squaredDistance, int intExt) {
+                 const float distance = std::sqrt(squaredDistance);
+                 return intExt < 0 ? -distance : distance;
+               });
 }
 
 void generateScalarGradientField(
@@ -277,22 +354,9 @@ void generateScalarGradientField(
 std::vector<Mn::Vector3i> getVoxelSetFromBoolGrid(
     std::shared_ptr<esp::geo::VoxelWrapper>& voxelWrapper,
     const std::string& boolGridName) {
-  std::vector<Mn::Vector3i> voxelSet = std::vector<Mn::Vector3i>();
-  auto v_grid = voxelWrapper->getVoxelGrid();
-  auto m_voxelGridDimensions = v_grid->getVoxelGridDimensions();
-
-  assert(v_grid->gridExists(boolGridName));
-  auto boolGrid = v_grid->getGrid<bool>(boolGridName);
-  for (int i = 0; i < m_voxelGridDimensions[0]; ++i) {
-    for (int j = 0; j < m_voxelGridDimensions[1]; ++j) {
-      for (int k = 0; k < m_voxelGridDimensions[2]; ++k) {
-        if (boolGrid[i][j][k]) {
-          voxelSet.emplace_back(i, j, k);
-        }
-      }
-    }
-  }
-  return voxelSet;
+  assert(voxelWrapper->gridExists(boolGridName));
+  return getVoxelSetWhere(voxelWrapper->getGridHandle<bool>(boolGridName),
+                          [](bool value) { return value; });
 }
 
 std::vector<Mn::Vector3i> getVoxelSetFromIntGrid(
@@ -300,22 +364,10 @@ std::vector<Mn::Vector3i> getVoxelSetFromIntGrid(
     const std::string& intGridName,
     int lb,
     int ub) {
-  std::vector<Mn::Vector3i> voxelSet = std::vector<Mn::Vector3i>();
-  auto v_grid = voxelWrapper->getVoxelGrid();
-  auto m_voxelGridDimensions = v_grid->getVoxelGridDimensions();
-
-  assert(v_grid->gridExists(intGridName));
-  auto intGrid = v_grid->getGrid<int>(intGridName);
-  for (int i = 0; i < m_voxelGridDimensions[0]; ++i) {
-    for (int j = 0; j < m_voxelGridDimensions[1]; ++j) {
-      for (int k = 0; k < m_voxelGridDimensions[2]; ++k) {
-        if (intGrid[i][j][k] >= lb && intGrid[i][j][k] <= ub) {
-          voxelSet.emplace_back(i, j, k);
-        }
-      }
-    }
-  }
-  return voxelSet;
+  assert(voxelWrapper->gridExists(intGridName));
+  return getVoxelSetWhere(
+      voxelWrapper->getGridHandle<int>(intGridName),
+      [lb, ub](int value) { return value >= lb && value <= ub; });
 }
 
 std::vector<Mn::Vector3i> getVoxelSetFromFloatGrid(
@@ -323,22 +375,10 @@ std::vector<Mn::Vector3i> getVoxelSetFromFloatGrid(
     const std::string& floatGridName,
     float lb,
     float ub) {
-  std::vector<Mn::Vector3i> voxelSet = std::vector<Mn::Vector3i>();
-  auto v_grid = voxelWrapper->getVoxelGrid();
-  auto m_voxelGridDimensions = v_grid->getVoxelGridDimensions();
-
-  assert(v_grid->gridExists(floatGridName));
-  auto floatGrid = v_grid->getGrid<float>(floatGridName);
-  for (int i = 0; i < m_voxelGridDimensions[0]; ++i) {
-    for (int j = 0; j < m_voxelGridDimensions[1]; ++j) {
-      for (int k = 0; k < m_voxelGridDimensions[2]; ++k) {
-        if (floatGrid[i][j][k] >= lb && floatGrid[i][j][k] <= ub) {
-          voxelSet.emplace_back(i, j, k);
-        }
-      }
-    }
-  }
-  return voxelSet;
+  assert(voxelWrapper->gridExists(floatGridName));
+  return getVoxelSetWhere(
+      voxelWrapper->getGridHandle<float>(floatGridName),
+      [lb, ub](float value) { return value >= lb && value <= ub; });
 }
 
 }  // namespace geo
@@ -6,6 +6,10 @@
 #ifndef ESP_GEO_VOXEL_UTILITY_H_
 #define ESP_GEO_VOXEL_UTILITY_H_
 
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
 #include "VoxelWrapper.h"
 #include "esp/core/Esp.h"
 #include "esp/geo/Geo.h"
@@ -13,10 +17,167 @@
 namespace esp {
 namespace geo {
 
+// --== BULK OPERATIONS ==--
+
+/**
+ * @brief Splits [0, count) into ranges of at least @p grain items and calls
+ * f(chunk, begin, end) for each, in parallel when built with OpenMP. The
+ * ranges only depend on @p count and @p grain, so per-chunk results combine
+ * deterministically.
+ * @return The number of chunks.
+ */
+std::size_t forEachVoxelChunk(
+    std::size_t count,
+    const std::function<void(std::size_t, std::size_t, std::size_t)>& f,
+    std::size_t grain = 4096);
+
+/**
+ * @brief The number of chunks @ref forEachVoxelChunk splits @p count items
+ * into.
+ */
+std::size_t getNumVoxelChunks(std::size_t count, std::size_t grain = 4096);
+
+/**
+ * @brief Sets each voxel of @p dst to f(v), v being the voxel of @p src at
+ * the same index. @p dst has to be dense and may be @p src.
+ */
+template <typename T, typename U, typename F>
+void transformGrid(const VoxelGrid::GridHandle<T>& src,
+                   const VoxelGrid::GridHandle<U>& dst,
+                   F f) {
+  CORRADE_ASSERT(!dst.isSparse(),
+                 "geo::transformGrid(): the destination has to be dense", );
+  Cr::Containers::Array<char> storage;
+  const T* in = src.denseData(storage);
+  U* out = dst.data();
+  forEachVoxelChunk(dst.size(),
+                    [&](std::size_t, std::size_t begin, std::size_t end) {
+                      for (std::size_t i = begin; i != end; ++i) {
+                        out[i] = f(in[i]);
+                      }
+                    });
+}
+
+/**
+ * @brief Sets each voxel of @p dst to f(a, b), a and b being the voxels of
+ * @p srcA and @p srcB at the same index. @p dst has to be dense and may be
+ * one of the sources.
+ */
+template <typename A, typename B, typename U, typename F>
+void combineGrids(const VoxelGrid::GridHandle<A>& srcA,
+                  const VoxelGrid::GridHandle<B>& srcB,
+                  const VoxelGrid::GridHandle<U>& dst,
+                  F f) {
+  CORRADE_ASSERT(!dst.isSparse(),
+                 "geo::combineGrids(): the destination has to be dense", );
+  Cr::Containers::Array<char> storageA;
+  Cr::Containers::Array<char> storageB;
+  const A* inA = srcA.denseData(storageA);
+  const B* inB = srcB.denseData(storageB);
+  U* out = dst.data();
+  forEachVoxelChunk(dst.size(),
+                    [&](std::size_t, std::size_t begin, std::size_t end) {
+                      for (std::size_t i = begin; i != end; ++i) {
+                        out[i] = f(inA[i], inB[i]);
+                      }
+                    });
+}
+
+/**
+ * @brief Folds all voxels of @p src into a value. Each chunk of voxels is
+ * folded with r = f(r, v) starting from @p identity, then the chunk results
+ * are folded in order with r = combine(r, chunkResult).
+ */
+template <typename T, typename R, typename F, typename C>
+R reduceGrid(const VoxelGrid::GridHandle<T>& src,
+             const R& identity,
+             F f,
+             C combine) {
+  Cr::Containers::Array<char> storage;
+  const T* in = src.denseData(storage);
+  Cr::Containers::Array<R> partial{Cr::DirectInit,
+                                   getNumVoxelChunks(src.size()), identity};
+  forEachVoxelChunk(src.size(), [&](std::size_t chunk, std::size_t begin,
+                                    std::size_t end) {
+    R result = identity;
+    for (std::size_t i = begin; i != end; ++i) {
+      result = f(result, in[i]);
+    }
+    partial[chunk] = result;
+  });
+  R result = identity;
+  for (const R& chunkResult : partial) {
+    result = combine(result, chunkResult);
+  }
+  return result;
+}
+
+/**
+ * @brief Returns the indices of the voxels of @p src for which @p predicate
+ * holds, in [i][j][k] order. Only the allocated blocks of a sparse grid are
+ * visited, unless its background satisfies @p predicate as well.
+ */
+template <typename T, typename P>
+std::vector<Mn::Vector3i> getVoxelSetWhere(const VoxelGrid::GridHandle<T>& src,
+                                           P predicate) {
+  std::vector<Mn::Vector3i> voxelSet;
+  if (src.isSparse() && !predicate(src.getBackground())) {
+    src.forEachAllocatedBlock(
+        [&](const Mn::Vector3i& origin,
+            const Cr::Containers::StridedArrayView3D<T>& block) {
+          for (std::size_t i = 0; i != block.size()[0]; ++i) {
+            for (std::size_t j = 0; j != block.size()[1]; ++j) {
+              for (std::size_t k = 0; k != block.size()[2]; ++k) {
+                if (predicate(block[i][j][k])) {
+                  voxelSet.push_back(origin +
+                                     Mn::Vector3i{int(i), int(j), int(k)});
+                }
+              }
+            }
+          }
+        });
+    // blocks are visited in no particular order
+    std::sort(voxelSet.begin(), voxelSet.end(),
+              [](const Mn::Vector3i& a, const Mn::Vector3i& b) {
+                return std::make_tuple(a[0], a[1], a[2]) <
+                       std::make_tuple(b[0], b[1], b[2]);
+              });
+    return voxelSet;
+  }
+
+  Cr::Containers::Array<char> storage;
+  const T* in = src.denseData(storage);
+  const Mn::Vector3i dims = src.getDimensions();
+  const std::size_t sliceSize = std::size_t(dims[1]) * dims[2];
+  std::vector<std::vector<Mn::Vector3i>> chunkSets(
+      getNumVoxelChunks(src.size()));
+  forEachVoxelChunk(src.size(), [&](std::size_t chunk, std::size_t begin,
+                                    std::size_t end) {
+    for (std::size_t i = begin; i != end; ++i) {
+      if (predicate(in[i])) {
+        chunkSets[chunk].emplace_back(int(i / sliceSize),
+                                      int(i % sliceSize / dims[2]),
+                                      int(i % dims[2]));
+      }
+    }
+  });
+  for (const auto& chunkSet : chunkSets) {
+    voxelSet.insert(voxelSet.end(), chunkSet.begin(), chunkSet.end());
+  }
+  return voxelSet;
+}
+
+// --== GRID GENERATION ==--
+
 /**
  * @brief Generates an integer grid registered under "InteriorExterior" which
  * stores +inf for exterior cells, -inf for interior cells, and 0 for Boundary
  * cells.
+ *
+ * The grid is sparse, with exterior cells in the background, if the Boundary
+ * grid is sparse. Note the ray casts still work on a dense copy of the
+ * Boundary grid and a dense temporary with 6 bits per cell, so peak memory
+ * grows with the full grid size for sparse inputs too.
  * @param voxelWrapper The voxelization for the SDF.
  */
 void generateInteriorExteriorVoxelGrid(
@@ -35,8 +196,14 @@ void generateManhattanDistanceSDF(
 
 /**
  * @brief Generates a signed distance field using euclidean distance as a
- * distance metric. Also created a "ClosestBoundaryCell" vector3 grid which
- * holds the index of the closest Boundary grid.
+ * distance metric. Distances are exact, in voxels, to the center of the
+ * closest Boundary cell, and negative for interior cells. Computed with a
+ * separable distance transform, parallel over the lines of each axis.
+ *
+ * The distance grid is dense, as every cell has its own distance. A sparse
+ * InteriorExterior grid is expanded into a dense temporary copy for reading,
+ * and generating it costs dense temporaries too, see @ref
+ * generateInteriorExteriorVoxelGrid.
  * @param voxelWrapper The voxelization for the SDF.
  * @param gridName The name underwhich to register the newly created euclidean
  * SDF.
@@ -74,37 +241,52 @@ void generateScalarGradientField(
     const std::string& scalarGridName,
     const std::string& gradientGridName) {
   auto v_grid = voxelWrapper->getVoxelGrid();
-  auto m_voxelGridDimensions = v_grid->getVoxelGridDimensions();
+  const Mn::Vector3i dims = v_grid->getVoxelGridDimensions();
 
   // generate the ESDF if not already created
   assert(v_grid->gridExists(scalarGridName));
 
   v_grid->addGrid<Mn::Vector3>(gradientGridName);
-  auto gradientGrid = v_grid->getGrid<Mn::Vector3>(gradientGridName);
-  auto scalarGrid = v_grid->getGrid<T>(scalarGridName);
-  std::vector<Mn::Vector3i> neighbors{
-      Mn::Vector3i(1, 0, 0),  Mn::Vector3i(-1, 0, 0), Mn::Vector3i(0, 1, 0),
-      Mn::Vector3i(0, -1, 0), Mn::Vector3i(0, 0, 1),  Mn::Vector3i(0, 0, -1)};
-  for (int i = 0; i < m_voxelGridDimensions[0]; ++i) {
-    for (int j = 0; j < m_voxelGridDimensions[1]; ++j) {
-      for (int k = 0; k < m_voxelGridDimensions[2]; ++k) {
-        Mn::Vector3i index = Mn::Vector3i(i, j, k);
-        Mn::Vector3 result(0, 0, 0);
-        int validVectors = 0;
-        for (auto neighbor : neighbors) {
-          if (v_grid->isValidIndex(neighbor + index)) {
-            float diff =
-                scalarGrid[i + neighbor[0]][j + neighbor[1]][k + neighbor[2]] -
-                scalarGrid[i][j][k];
-            result += Mn::Vector3(neighbor) * diff;
-            validVectors++;
+  Mn::Vector3* gradient =
+      v_grid->getGridHandle<Mn::Vector3>(gradientGridName).data();
+  Cr::Containers::Array<char> scalarStorage;
+  const T* scalar =
+      v_grid->getGridHandle<T>(scalarGridName).denseData(scalarStorage);
+  const std::size_t strides[3]{std::size_t(dims[1]) * dims[2],
+                               std::size_t(dims[2]), 1};
+  forEachVoxelChunk(
+      v_grid->gridSize(),
+      [&](std::size_t, std::size_t begin, std::size_t end) {
+        Mn::Vector3i index{int(begin / strides[0]),
+                           int(begin % strides[0] / strides[1]),
+                           int(begin % strides[1])};
+        for (std::size_t v = begin; v != end; ++v) {
+          Mn::Vector3 result(0, 0, 0);
+          int validVectors = 0;
+          for (int axis = 0; axis < 3; ++axis) {
+            if (index[axis] + 1 < dims[axis]) {
+              float diff = scalar[v + strides[axis]] - scalar[v];
+              result[axis] += diff;
+              validVectors++;
+            }
+            if (index[axis] > 0) {
+              float diff = scalar[v - strides[axis]] - scalar[v];
+              result[axis] -= diff;
+              validVectors++;
+            }
           }
-        }
+          gradient[v] = result / validVectors;
 
-        gradientGrid[i][j][k] = result / validVectors;
-      }
-    }
-  }
+          // step to the next voxel in [i][j][k] order
+          if (++index[2] == dims[2]) {
+            index[2] = 0;
+            if (++index[1] == dims[1]) {
+              index[1] = 0;
+              ++index[0];
+            }
+          }
+        }
+      });
 }
 
 /**
@@ -9,14 +9,18 @@ namespace Cr = Corrade;
 namespace esp {
 namespace geo {
 
-#ifdef ESP_BUILD_WITH_VHACD
 VoxelWrapper::VoxelWrapper(const std::string& renderAssetHandle,
                            esp::scene::SceneNode* sceneNode,
                            esp::assets::ResourceManager& resourceManager_,
-                           int resolution = 1000000)
+                           int resolution,
+                           VoxelizationMethod method)
     : SceneNode(sceneNode) {
   std::string voxelGridHandle =
       renderAssetHandle + "_" + std::to_string(resolution);
+  // the grids of the two voxelizers differ, don't share them
+  if (method == VoxelizationMethod::Builtin) {
+    voxelGridHandle += "_builtin";
+  }
   // check for existence of specified VoxelGrid
   if (resourceManager_.voxelGridExists(
           voxelGridHandle)) {  // if it exists, simply point the wrapper to it.
@@ -25,12 +29,11 @@ VoxelWrapper::VoxelWrapper(const std::string& renderAssetHandle,
     std::unique_ptr<esp::assets::MeshData> objMesh =
         esp::assets::MeshData::create_unique();
     objMesh = resourceManager_.createJoinedCollisionMesh(renderAssetHandle);
-    voxelGrid =
-        std::make_shared<VoxelGrid>(*objMesh, renderAssetHandle, resolution);
+    voxelGrid = std::make_shared<VoxelGrid>(*objMesh, renderAssetHandle,
+                                            resolution, method);
     assert(resourceManager_.registerVoxelGrid(voxelGridHandle, voxelGrid));
   }
 }
-#endif
 
 VoxelWrapper::VoxelWrapper(const std::string& handle,
                            esp::scene::SceneNode* sceneNode,
@@ -22,21 +22,21 @@ class VoxelWrapper {
   std::shared_ptr<VoxelGrid> voxelGrid;
 
  public:
-#ifdef ESP_BUILD_WITH_VHACD
   /**
-   * @brief Generates (using VHACD's voxelization functionality) or retrieves a
-   * voxelization of a render asset mesh depending on whether it exists or not.
+   * @brief Generates or retrieves a voxelization of a render asset mesh
+   * depending on whether it exists or not.
    * @param renderAssetHandle The handle for the render asset to which the voxel
    * grid corresponds.
    * @param sceneNode The scene node the voxel wrapper will be pointing to.
    * @param resourceManager Used for retrieving or registering the voxel grid.
    * @param resolution The approximate number of voxels for the voxelization.
+   * @param method The voxelizer to use.
    */
   VoxelWrapper(const std::string& renderAssetHandle,
                esp::scene::SceneNode* sceneNode,
                esp::assets::ResourceManager& resourceManager,
-               int resolution);
-#endif
+               int resolution,
+               VoxelizationMethod method = DefaultVoxelizationMethod);
 
   /**
    * @brief Generates a voxelization with a specified size and dimensions. The
@@ -107,6 +107,26 @@ class VoxelWrapper {
     voxelGrid->addGrid<T>(gridName);
   }
 
+  /**
+   * @brief Generates a new sparse voxel grid of a specified type, storing only
+   * the blocks with voxels other than @p background.
+   * @param gridName The key under which the grid will be registered and
+   * accessed.
+   * @param background The value of voxels which were never set.
+   */
+  template <typename T>
+  void addSparseGrid(const std::string& gridName, const T& background = T{}) {
+    voxelGrid->addSparseGrid<T>(gridName, background);
+  }
+
+  /**
+   * @brief Returns whether a grid uses sparse block storage.
+   * @param gridName The name of the grid.
+   */
+  bool isSparseGrid(const std::string& gridName) {
+    return voxelGrid->isSparseGrid(gridName);
+  }
+
   /**
    * @brief Removes a grid and frees up memory.
    * @param gridName The name of the grid to be removed.
@@ -126,6 +146,16 @@ class VoxelWrapper {
     return voxelGrid->getGrid<T>(gridName);
   }
 
+  /**
+   * @brief Returns a typed handle to a grid, to get and set many voxels
+   * without looking the grid up by name for each of them.
+   * @param gridName The name of the grid.
+   */
+  template <typename T>
+  VoxelGrid::GridHandle<T> getGridHandle(const std::string& gridName) {
+    return voxelGrid->getGridHandle<T>(gridName);
+  }
+
   //  --== GETTERS AND SETTERS FOR VOXELS ==--
 
   /**
@@ -138,8 +168,7 @@ class VoxelWrapper {
   void setVoxel(const Mn::Vector3i& index,
                 const std::string& gridName,
                 const T& value) {
-    auto arrayView3D = getGrid<T>(gridName);
-    arrayView3D[index[0]][index[1]][index[2]] = value;
+    voxelGrid->setVoxel<T>(index, gridName, value);
   }
 
   /**
@@ -151,8 +180,7 @@ class VoxelWrapper {
    */
   template <typename T>
   T getVoxel(const Mn::Vector3i& index, const std::string& gridName) {
-    auto arrayView3D = getGrid<T>(gridName);
-    return arrayView3D[index[0]][index[1]][index[2]];
+    return voxelGrid->getVoxel<T>(index, gridName);
   }
 
   /**
@@ -609,7 +609,8 @@ void CubeMap::copySubImage(unsigned int cubeSideIndex,
 void CubeMap::renderToTexture(CubeMapCamera& camera,
                               scene::SceneGraph& sceneGraph,
                               const char* drawableGroupName,
-                              RenderCamera::Flags renderCameraFlags) {
+                              RenderCamera::Flags renderCameraFlags,
+                              Faces faces) {
   CORRADE_ASSERT(camera.isInSceneGraph(sceneGraph),
                  "CubeMap::renderToTexture(): camera is NOT attached to the "
                  "current scene graph.", );
@@ -632,17 +633,28 @@ void CubeMap::renderToTexture(CubeMapCamera& camera,
   // the camera MUST be updated as well.
   camera.updateOriginalViewingMatrix();
 
+  // Low-poly meshes come from the camera's LOD threshold (see
+  // RenderCamera::setLodThreshold), which the cube map sensors set per spec.
+  // TODO:
+  // should have different drawable groups that can do "low quality"
+  // rendering, e.g., no normal maps, no specular lighting, low-quality
+  // textures.
+  DrawableGroup& group = sceneGraph.getDrawables(drawableGroupName);
+
+  // The drawables do not move between the faces, so walk the scene graph and
+  // compute the transformations and bounding boxes only once. Each face then
+  // just culls against its own frustum.
+  camera.gatherWorldDrawables(group, worldDrawables_, renderCameraFlags);
+
   for (int iFace = 0; iFace < 6; ++iFace) {
+    if (!faces[iFace]) {
+      continue;
+    }
     camera.switchToFace(iFace);
     prepareToDraw(iFace, renderCameraFlags);
 
-    // TODO:
-    // should have different drawable groups that can do "low quality"
-    // rendering, e.g., no normal maps, no specular lighting, low-poly meshes,
-    // low-quality textures.
-    DrawableGroup& group = sceneGraph.getDrawables(drawableGroupName);
     group.prepareForDraw(camera);
-    camera.draw(group, renderCameraFlags);
+    camera.draw(worldDrawables_, renderCameraFlags);
   }  // iFace
 
   // CAREFUL!!!
@@ -13,6 +13,7 @@
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/BitVector.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/ResourceManager.h>
 #include <Magnum/Shaders/GenericGL.h>
@@ -205,18 +206,27 @@ class CubeMap {
                    const std::string& imageFilePrefix,
                    const std::string& imageFileExtension);
 
+  /**
+   * @brief A set of cube faces, bit i being the face with index i, i.e.
+   * @ref CubeMapCamera::cubeMapCoordinate(i)
+   */
+  typedef Magnum::Math::BitVector<6> Faces;
+
   /**
    * @brief Render to cubemap texture using the camera
    * @param camera a cubemap camera
+   * @param faces the faces to render; the others keep their previous content,
+   * which is fine as long as the caller never samples them
    * NOTE: It will NOT automatically generate the mipmap for the user
    */
   void renderToTexture(CubeMapCamera& camera,
                        scene::SceneGraph& sceneGraph,
                        const char* drawableGroupName = "",
-                       RenderCamera::Flags flags = {
-                           RenderCamera::Flag::FrustumCulling |
-                           RenderCamera::Flag::ClearColor |
-                           RenderCamera::Flag::ClearDepth});
+                       RenderCamera::Flags flags =
+                           {RenderCamera::Flag::FrustumCulling |
+                            RenderCamera::Flag::ClearColor |
+                            RenderCamera::Flag::ClearDepth},
+                       Faces faces = Faces{Magnum::UnsignedByte(0x3f)});
 
   /**
    * @brief copy the texture from a specified cube face to a given texture
@@ -292,6 +302,10 @@ class CubeMap {
   Corrade::Containers::StaticArray<6, Magnum::GL::Renderbuffer>
       optionalDepthBuffer_{Corrade::DirectInit, Magnum::NoCreate};
 
+  // drawables gathered once per renderToTexture() and shared by all six
+  // faces, kept to reuse the allocations
+  RenderCamera::WorldDrawables worldDrawables_;
+
   /**
    * @brief recreate the frame buffer
    * @param cubeSideIndex the index of the cube side, can be 0,
@@ -6,6 +6,7 @@
 
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Reference.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Resource.h>
 #include <Magnum/GL/Shader.h>
 #include <Magnum/GL/Texture.h>
@@ -13,6 +14,15 @@
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix4.h>
 
+#include <cstdint>
+#include <unordered_map>
+
+#if defined(CORRADE_TARGET_X86) && defined(__GNUC__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
@@ -104,27 +114,192 @@ Mn::Vector2 calculateDepthUnprojection(const Mn::Matrix4& projectionMatrix) {
          0.5f;
 }
 
+namespace {
+
+/* The far plane depth is compared to the unprojected value rather than the
+   input being compared to 1.0f, so values which round to the far plane are
+   zeroed as well. Division is exact in all kernels, so they all give the same
+   bit-exact results. */
+
 /* Clang doesn't have target_clones yet: https://reviews.llvm.org/D51650 */
 #if defined(CORRADE_TARGET_X86) && defined(__GNUC__) && __GNUC__ >= 6
 __attribute__((target_clones("default", "sse4.2", "avx2")))
 #endif
+void unprojectDepthScalar(const Mn::Vector2& unprojection,
+                          Mn::Float farDepth,
+                          Mn::Float* depth,
+                          std::size_t count) {
+  for (std::size_t i = 0; i != count; ++i) {
+    const Mn::Float d = unprojection[1] / (depth[i] + unprojection[0]);
+    /* A select rather than a branch, so it vectorizes */
+    depth[i] = d == farDepth ? 0.0f : d;
+  }
+}
+
+#if defined(CORRADE_TARGET_X86) && defined(__GNUC__)
+#define ESP_DEPTH_UNPROJECTION_AVX
+/* All operations used are in AVX already, AVX2 only adds integer ones */
+__attribute__((target("avx"))) void unprojectDepthAvx(
+    const Mn::Vector2& unprojection,
+    Mn::Float farDepth,
+    Mn::Float* depth,
+    std::size_t count) {
+  const __m256 a = _mm256_set1_ps(unprojection[0]);
+  const __m256 b = _mm256_set1_ps(unprojection[1]);
+  const __m256 far = _mm256_set1_ps(farDepth);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256 d =
+        _mm256_div_ps(b, _mm256_add_ps(_mm256_loadu_ps(depth + i), a));
+    const __m256 isFar = _mm256_cmp_ps(d, far, _CMP_EQ_OQ);
+    _mm256_storeu_ps(depth + i, _mm256_andnot_ps(isFar, d));
+  }
+  unprojectDepthScalar(unprojection, farDepth, depth + i, count - i);
+}
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define ESP_DEPTH_UNPROJECTION_NEON
+/* 32-bit NEON has no division, only AArch64 does */
+void unprojectDepthNeon(const Mn::Vector2& unprojection,
+                        Mn::Float farDepth,
+                        Mn::Float* depth,
+                        std::size_t count) {
+  const float32x4_t a = vdupq_n_f32(unprojection[0]);
+  const float32x4_t b = vdupq_n_f32(unprojection[1]);
+  const float32x4_t far = vdupq_n_f32(farDepth);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const float32x4_t d = vdivq_f32(b, vaddq_f32(vld1q_f32(depth + i), a));
+    const uint32x4_t isFar = vceqq_f32(d, far);
+    vst1q_f32(depth + i, vreinterpretq_f32_u32(
+                             vbicq_u32(vreinterpretq_u32_f32(d), isFar)));
+  }
+  unprojectDepthScalar(unprojection, farDepth, depth + i, count - i);
+}
+#endif
+
+using UnprojectDepthKernel = void (*)(const Mn::Vector2&,
+                                      Mn::Float,
+                                      Mn::Float*,
+                                      std::size_t);
+
+UnprojectDepthKernel selectUnprojectDepthKernel() {
+#ifdef ESP_DEPTH_UNPROJECTION_AVX
+  if (__builtin_cpu_supports("avx")) {
+    return unprojectDepthAvx;
+  }
+#endif
+#ifdef ESP_DEPTH_UNPROJECTION_NEON
+  return unprojectDepthNeon;
+#else
+  return unprojectDepthScalar;
+#endif
+}
+
+}  // namespace
+
 void unprojectDepth(const Mn::Vector2& unprojection,
                     Cr::Containers::ArrayView<Mn::Float> depth) {
-  for (Mn::Float& d : depth) {
-    d = unprojection[1] / (d + unprojection[0]);
+  static const UnprojectDepthKernel kernel = selectUnprojectDepthKernel();
+  /* We can afford using == for comparison as 1.0f has an exact
+     representation, the depth was cleared to exactly this value and the
+     calculation is done exactly the same way in both cases -- thus the
+     result should be bit-exact. */
+  const Mn::Float farDepth = unprojection[1] / (1.0f + unprojection[0]);
+  kernel(unprojection, farDepth, depth.data(), depth.size());
+}
+
+std::vector<Mn::Vector3> unprojectDepthToPoints(
+    const Cr::Containers::StridedArrayView2D<const Mn::Float>& depth,
+    const Mn::Matrix4& projectionMatrix,
+    const Mn::Matrix4& transformation,
+    Mn::Float voxelSize) {
+  const std::size_t rows = depth.size()[0];
+  const std::size_t cols = depth.size()[1];
+
+  /* With z = -d, the projection gives x_ndc = (P00 x + P20 z) / -z, so
+     x = d (x_ndc + P20) / P00 and the same for y. The factors only depend on
+     the column or the row. */
+  std::vector<Mn::Float> xFactors(cols);
+  for (std::size_t col = 0; col != cols; ++col) {
+    const Mn::Float ndc = 2.0f * (Mn::Float(col) + 0.5f) / Mn::Float(cols) -
+                          1.0f;
+    xFactors[col] = (ndc + projectionMatrix[2][0]) / projectionMatrix[0][0];
+  }
+  std::vector<Mn::Float> yFactors(rows);
+  for (std::size_t row = 0; row != rows; ++row) {
+    const Mn::Float ndc = 2.0f * (Mn::Float(row) + 0.5f) / Mn::Float(rows) -
+                          1.0f;
+    yFactors[row] = (ndc + projectionMatrix[2][1]) / projectionMatrix[1][1];
   }
 
-  /* Change pixels on the far plane to be 0. Done in a separate loop to allow
-     the optimizer to vectorize the above better.  */
-  const Mn::Float farDepth = unprojection[1] / (1.0f + unprojection[0]);
-  for (Mn::Float& d : depth) {
-    /* We can afford using == for comparison as 1.0f has an exact
-       representation, the depth was cleared to exactly this value and the
-       calculation is done exactly the same way in both cases -- thus the
-       result should be bit-exact. */
-    if (d == farDepth)
-      d = 0.0f;
+  /* Count the points of each row first, so the rows can be written in
+     parallel to their place in the output */
+  std::vector<std::size_t> rowOffsets(rows + 1, 0);
+#pragma omp parallel for
+  for (long row = 0; row < long(rows); ++row) {
+    std::size_t count = 0;
+    for (const Mn::Float d : depth[row]) {
+      count += d > 0.0f;
+    }
+    rowOffsets[row + 1] = count;
+  }
+  for (std::size_t row = 0; row != rows; ++row) {
+    rowOffsets[row + 1] += rowOffsets[row];
+  }
+
+  std::vector<Mn::Vector3> points(rowOffsets[rows]);
+#pragma omp parallel for
+  for (long row = 0; row < long(rows); ++row) {
+    Mn::Vector3* out = points.data() + rowOffsets[row];
+    const Cr::Containers::StridedArrayView1D<const Mn::Float> depthRow =
+        depth[row];
+    for (std::size_t col = 0; col != cols; ++col) {
+      const Mn::Float d = depthRow[col];
+      if (d > 0.0f) {
+        *out++ = transformation.transformPoint(
+            {d * xFactors[col], d * yFactors[row], -d});
+      }
+    }
+  }
+
+  if (voxelSize <= 0.0f) {
+    return points;
+  }
+
+  /* Keep the centroid of the points in each voxel, in the order the voxels
+     are first hit */
+  struct Voxel {
+    Mn::Vector3 sum;
+    Mn::UnsignedInt count;
+  };
+  std::unordered_map<std::uint64_t, std::size_t> voxelIndices;
+  std::vector<Voxel> voxels;
+  const Mn::Float inverseVoxelSize = 1.0f / voxelSize;
+  for (const Mn::Vector3& point : points) {
+    const Mn::Vector3i cell{Mn::Math::floor(point * inverseVoxelSize)};
+    /* 21 bits per axis is about 2 km at 1 mm voxels */
+    const std::uint64_t key =
+        (std::uint64_t(cell.x() & 0x1fffff) << 42) |
+        (std::uint64_t(cell.y() & 0x1fffff) << 21) |
+        std::uint64_t(cell.z() & 0x1fffff);
+    auto inserted = voxelIndices.emplace(key, voxels.size());
+    if (inserted.second) {
+      voxels.push_back({point, 1});
+    } else {
+      Voxel& voxel = voxels[inserted.first->second];
+      voxel.sum += point;
+      ++voxel.count;
+    }
+  }
+
+  std::vector<Mn::Vector3> downsampled;
+  downsampled.reserve(voxels.size());
+  for (const Voxel& voxel : voxels) {
+    downsampled.push_back(voxel.sum / Mn::Float(voxel.count));
   }
+  return downsampled;
 }
 
 }  // namespace gfx
@@ -5,8 +5,12 @@
 #ifndef ESP_GFX_DEPTHUNPROJECTION_H_
 #define ESP_GFX_DEPTHUNPROJECTION_H_
 
+#include <vector>
+
 #include <Corrade/Containers/EnumSet.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/Math/Matrix4.h>
 
 namespace esp {
 namespace gfx {
@@ -146,11 +150,34 @@ Magnum::Vector2 calculateDepthUnprojection(
 See @ref calculateDepthUnprojection() for the full algorithm explanation.
 Additionally to applying that calculation, if the input depth is at the far
 plane (of value @cpp 1.0f @ce), it's set to @cpp 0.0f @ce on output as
-consumers expect zeros for things that are too far.
+consumers expect zeros for things that are too far. Both are done in a single
+pass, with AVX or NEON if the CPU supports them.
 */
 void unprojectDepth(const Magnum::Vector2& unprojection,
                     Corrade::Containers::ArrayView<Magnum::Float> depth);
 
+/**
+@brief Convert unprojected depth values to a point cloud
+@param[in] depth            Depth image as output by @ref unprojectDepth(),
+    indexed by row and column, with the first row at the bottom as in
+    @ref Magnum::Image2D. Pixels of zero depth are skipped.
+@param[in] projectionMatrix The projection matrix the depth was rendered
+    with, which holds the camera intrinsics
+@param[in] transformation   Transformation applied to the camera-space
+    points, for example the camera's absolute transformation to get points in
+    world space
+@param[in] voxelSize        If positive, the points in each cube of this
+    size are replaced by their centroid
+
+The point of a pixel is at its center, at distance @f$ d @f$ along the
+camera's -Z axis. Rows are processed in parallel with OpenMP, if available.
+*/
+std::vector<Magnum::Vector3> unprojectDepthToPoints(
+    const Corrade::Containers::StridedArrayView2D<const Magnum::Float>& depth,
+    const Magnum::Matrix4& projectionMatrix,
+    const Magnum::Matrix4& transformation = Magnum::Matrix4{},
+    Magnum::Float voxelSize = 0.0f);
+
 }  // namespace gfx
 }  // namespace esp
 
@@ -4,11 +4,15 @@
 
 #include "Drawable.h"
 #include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/Shaders/GenericGL.h>
 #include "DrawableGroup.h"
 #include "esp/scene/SceneNode.h"
 
 namespace esp {
 namespace gfx {
+
 uint64_t Drawable::drawableIdCounter = 0;
 Drawable::Drawable(scene::SceneNode& node,
                    Magnum::GL::Mesh* mesh,
@@ -18,6 +22,7 @@ Drawable::Drawable(scene::SceneNode& node,
       type_(type),
       node_(node),
       mesh_(mesh),
+      activeMesh_(mesh),
       drawableId_(drawableIdCounter++) {
   if (group) {
     group->registerDrawable(*this);
@@ -41,5 +46,50 @@ DrawableGroup* Drawable::drawables() {
                  {});
   return static_cast<DrawableGroup*>(group);
 }
+
+void Drawable::markDirty() {
+  DrawableGroup* group = drawables();
+  if (group) {
+    group->markBoundsDirty(*this);
+  }
+}
+
+void Drawable::setLods(std::vector<Lod> lods) {
+  lods_ = std::move(lods);
+  activeMesh_ = mesh_;
+}
+
+void Drawable::selectLod(float relativeScreenSize) {
+  activeMesh_ = mesh_;
+  const float minRatio = relativeScreenSize * relativeScreenSize;
+  for (const Lod& lod : lods_) {
+    if (lod.triangleRatio <= minRatio) {
+      break;
+    }
+    activeMesh_ = lod.mesh;
+  }
+}
+
+void Drawable::drawMeshInstanced(
+    Magnum::GL::AbstractShaderProgram& shader,
+    Corrade::Containers::ArrayView<const InstanceData> instanceData) {
+  Magnum::GL::Mesh& mesh = getMesh();
+  if (!instanceBuffer_.id()) {
+    instanceBuffer_ = Magnum::GL::Buffer{};
+  }
+  instanceBuffer_.setData(instanceData, Magnum::GL::BufferUsage::StreamDraw);
+  // drawables sharing the mesh lead its instanced draws in turn, so point the
+  // attributes at this drawable's buffer every time. That is only a few
+  // attribute pointer calls, and needs no bookkeeping that could outlive the
+  // mesh or mix up meshes of different GL contexts.
+  mesh.addVertexBufferInstanced(
+      instanceBuffer_, 1, 0,
+      Magnum::Shaders::GenericGL3D::TransformationMatrix{},
+      Magnum::Shaders::GenericGL3D::NormalMatrix{},
+      Magnum::Shaders::GenericGL3D::ObjectId{});
+  mesh.setInstanceCount(instanceData.size());
+  shader.draw(mesh);
+  mesh.setInstanceCount(1);
+}
 }  // namespace gfx
 }  // namespace esp
@@ -5,8 +5,15 @@
 #ifndef ESP_GFX_DRAWABLE_H_
 #define ESP_GFX_DRAWABLE_H_
 
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/EnumSet.h>
 #include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/GL.h>
+#include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Matrix4.h>
 
 #include "esp/core/Esp.h"
 #include "magnum.h"
@@ -100,18 +107,117 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
    */
   virtual scene::SceneNode& getSceneNode() const { return node_; }
 
-  /** @brief get the GL mesh */
+  /** @brief get the GL mesh, at the level of detail selected last */
   Magnum::GL::Mesh& getMesh() const {
     CORRADE_ASSERT(
-        mesh_ != nullptr,
+        activeMesh_ != nullptr,
         "Drawable::getMesh() : Attempting to get the GL mesh when none exists",
-        *mesh_);
-    return *mesh_;
+        *activeMesh_);
+    return *activeMesh_;
   }
 
+  /** @brief whether this drawable has a GL mesh */
+  bool glMeshExists() const { return mesh_ != nullptr; }
+
   /** @brief get the drawable type */
   DrawableType getDrawableType() const { return type_; }
 
+  /**
+   * @brief A simplified version of the drawable's mesh
+   */
+  struct Lod {
+    /** @brief Compiled mesh, sharing the vertex layout of the full mesh */
+    Magnum::GL::Mesh* mesh = nullptr;
+    /** @brief Triangle count relative to the full mesh, in (0, 1) */
+    float triangleRatio = 1.0f;
+  };
+
+  /**
+   * @brief Set the levels of detail @ref selectLod chooses from, finest first.
+   * The full mesh is always the finest level and is not part of @p lods.
+   */
+  void setLods(std::vector<Lod> lods);
+
+  /** @brief get the levels of detail, finest first */
+  const std::vector<Lod>& getLods() const { return lods_; }
+
+  /**
+   * @brief Select the mesh @ref getMesh returns from the on-screen size of
+   * the drawable.
+   *
+   * @param relativeScreenSize Projected size of the drawable divided by the
+   * size at which the full mesh is needed. A level with a fraction r of the
+   * triangles keeps about sqrt(r) of the full mesh's edge resolution, so the
+   * coarsest level with r above @p relativeScreenSize squared is used; any
+   * value >= 1 selects the full mesh.
+   */
+  void selectLod(float relativeScreenSize);
+
+  /**
+   * @brief Opaque handles of the GL state a drawable binds when drawn.
+   *
+   * Drawables binding the same shader program (or material, or mesh) return
+   * the same handle; nullptr means unknown.
+   */
+  struct DrawState {
+    const void* shader = nullptr;
+    const void* material = nullptr;
+    const void* mesh = nullptr;
+  };
+
+  /**
+   * @brief Get the GL state this drawable binds, used by @ref RenderCamera to
+   * order draws so that consecutive ones share as much state as possible.
+   * NOTE: sub-class should override this function to report its shader and
+   * material; the default only reports the mesh
+   */
+  virtual DrawState getDrawState() {
+    DrawState state;
+    state.mesh = activeMesh_;
+    return state;
+  }
+
+  /**
+   * @brief Per-instance vertex data of an instanced draw, laid out as the
+   * generic TransformationMatrix, NormalMatrix and ObjectId shader attributes.
+   */
+  struct InstanceData {
+    Magnum::Matrix4 transformationMatrix;
+    Magnum::Matrix3x3 normalMatrix;
+    Magnum::UnsignedInt objectId;
+  };
+
+  /**
+   * @brief Whether @p other can be drawn in the same instanced draw call as
+   * this drawable, i.e. the two only differ by their transformation and
+   * object id.
+   * NOTE: sub-class should override this function to support instancing; the
+   * default never batches
+   */
+  virtual bool isInstanceCompatible(CORRADE_UNUSED Drawable& other) {
+    return false;
+  }
+
+  /**
+   * @brief Draw several instance-compatible drawables with one draw call,
+   * using the shader, material and mesh of this one
+   *
+   * @param instances             Drawables to draw, this one included. All
+   *                              of them must be instance-compatible with it.
+   * @param transformations       Transformation of each drawable relative to
+   *                              camera
+   * @param camera                Camera to draw from.
+   * @return false if the drawable does not support instancing, in which case
+   * nothing was drawn
+   */
+  virtual bool drawInstanced(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<Drawable* const> instances,
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const Magnum::Matrix4>
+          transformations,
+      CORRADE_UNUSED Magnum::SceneGraph::Camera3D& camera) {
+    return false;
+  }
+
   /**
    * @brief Get the Magnum GL mesh for visualization, highlighting (e.g., used
    * in object picking)
@@ -139,6 +245,26 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   void draw(CORRADE_UNUSED const Magnum::Matrix4& transformationMatrix,
             CORRADE_UNUSED Magnum::SceneGraph::Camera3D& camera) override = 0;
 
+  /**
+   * @brief Upload the per-instance data to the instance buffer of this
+   * drawable and draw the mesh once per instance with the given shader. The
+   * buffer is attached to the mesh on every call, as drawables sharing a mesh
+   * take turns leading its instanced draws.
+   *
+   * @param shader          Shader program reading the instanced attributes
+   * @param instanceData    Data of each instance
+   */
+  void drawMeshInstanced(
+      Magnum::GL::AbstractShaderProgram& shader,
+      Corrade::Containers::ArrayView<const InstanceData> instanceData);
+
+  /**
+   * @brief Called by the scene graph when the node (or one of its parents)
+   * is moved, or its bounding box changes; queues the drawable for a bounds
+   * update in its group's bounding volume hierarchy
+   */
+  void markDirty() override;
+
   DrawableType type_ = DrawableType::None;
 
   scene::SceneNode& node_;
@@ -146,10 +272,23 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
   static uint64_t drawableIdCounter;
   uint64_t drawableId_;
 
-  bool glMeshExists() const { return mesh_ != nullptr; }
-
  private:
+  // DrawableGroup keeps the two members below in sync with its hierarchy
+  friend class DrawableGroup;
+
   Magnum::GL::Mesh* mesh_ = nullptr;
+  //! mesh drawn, either mesh_ or one of lods_
+  Magnum::GL::Mesh* activeMesh_ = nullptr;
+  std::vector<Lod> lods_;
+
+  //! per-instance data of the instanced draws this drawable leads, created
+  //! on first use
+  Magnum::GL::Buffer instanceBuffer_{Magnum::NoCreate};
+
+  //! leaf of the drawable in its group's hierarchy, -1 if not inserted yet
+  int bvhLeaf_ = -1;
+  //! whether the drawable is queued for a bounds update in its group
+  bool boundsDirty_ = false;
 };
 
 CORRADE_ENUMSET_OPERATORS(Drawable::Flags)
@@ -2,13 +2,25 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 #include "DrawableGroup.h"
+
+#include <algorithm>
+
 #include "Drawable.h"
+#include "esp/scene/SceneNode.h"
+
+namespace Mn = Magnum;
 
 namespace esp {
 namespace gfx {
 
 class Drawable;
 DrawableGroup& DrawableGroup::add(Drawable& drawable) {
+  // Magnum moves the drawable out of its previous group behind that group's
+  // back, so unregister it there first
+  DrawableGroup* previous = drawable.drawables();
+  if (previous && previous != this) {
+    previous->unregisterDrawable(drawable);
+  }
   if (registerDrawable(drawable)) {
     this->Magnum::SceneGraph::DrawableGroup3D::add(drawable);
   }
@@ -39,11 +51,82 @@ Drawable* DrawableGroup::getDrawable(uint64_t id) const {
 
 bool DrawableGroup::registerDrawable(Drawable& drawable) {
   // if it is already registered, emplace will do nothing
-  return idToDrawable_.emplace(drawable.getDrawableId(), &drawable).second;
+  if (!idToDrawable_.emplace(drawable.getDrawableId(), &drawable).second) {
+    return false;
+  }
+  markBoundsDirty(drawable);
+  return true;
 }
 bool DrawableGroup::unregisterDrawable(Drawable& drawable) {
   // if it is not registered, erase will do nothing
-  return idToDrawable_.erase(drawable.getDrawableId()) != 0;
+  if (idToDrawable_.erase(drawable.getDrawableId()) == 0) {
+    return false;
+  }
+  if (drawable.bvhLeaf_ != -1) {
+    bvh_.remove(drawable.bvhLeaf_);
+    leafDrawables_[drawable.bvhLeaf_] = nullptr;
+    drawable.bvhLeaf_ = -1;
+  }
+  drawable.boundsDirty_ = false;
+  return true;
+}
+
+void DrawableGroup::markBoundsDirty(Drawable& drawable) {
+  if (!drawable.boundsDirty_) {
+    drawable.boundsDirty_ = true;
+    boundsDirtyIds_.push_back(drawable.getDrawableId());
+  }
+}
+
+void DrawableGroup::updateBvh() {
+  for (uint64_t id : boundsDirtyIds_) {
+    Drawable* drawable = getDrawable(id);
+    if (!drawable || !drawable->boundsDirty_) {
+      continue;
+    }
+    drawable->boundsDirty_ = false;
+
+    scene::SceneNode& node = drawable->getSceneNode();
+    // This updates the AABB for dynamic objects if needed, and lets the next
+    // move of the node notify the drawable again
+    node.setClean();
+    const Mn::Range3D& aabb = node.getAbsoluteAABB();
+
+    if (drawable->bvhLeaf_ == -1) {
+      drawable->bvhLeaf_ = bvh_.insert(aabb);
+      if (leafDrawables_.size() <= size_t(drawable->bvhLeaf_)) {
+        leafDrawables_.resize(drawable->bvhLeaf_ + 1, nullptr);
+      }
+      leafDrawables_[drawable->bvhLeaf_] = drawable;
+    } else {
+      // leaf ids are stable across updates, only the box may be reinserted
+      bvh_.update(drawable->bvhLeaf_, aabb);
+    }
+  }
+  boundsDirtyIds_.clear();
+}
+
+std::vector<Drawable*> DrawableGroup::getDrawablesInBox(
+    const Mn::Range3D& box) {
+  updateBvh();
+  std::vector<Drawable*> result;
+  bvh_.query(box, [&](int leaf) {
+    Drawable* drawable = leafDrawables_[leaf];
+    const Mn::Range3D& aabb = drawable->getSceneNode().getAbsoluteAABB();
+    if (!(aabb.min() > box.max()).any() && !(aabb.max() < box.min()).any()) {
+      result.push_back(drawable);
+    }
+  });
+  // report in a stable order rather than in hierarchy order
+  std::sort(result.begin(), result.end(), [](Drawable* a, Drawable* b) {
+    return a->getDrawableId() < b->getDrawableId();
+  });
+  return result;
+}
+
+std::vector<Drawable*> DrawableGroup::getDrawablesAtPoint(
+    const Mn::Vector3& point) {
+  return getDrawablesInBox(Mn::Range3D{point, point});
 }
 
 }  // namespace gfx
@@ -5,13 +5,16 @@
 #ifndef ESP_GFX_DRAWABLEGROUP_H_
 #define ESP_GFX_DRAWABLEGROUP_H_
 
+#include <Magnum/Math/Range.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include <Magnum/SceneGraph/FeatureGroup.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
 #include <unordered_map>
+#include <vector>
 
 #include <functional>
 #include "esp/core/Esp.h"
+#include "esp/geo/AabbTree.h"
 
 namespace esp {
 namespace gfx {
@@ -64,6 +67,39 @@ class DrawableGroup : public Magnum::SceneGraph::DrawableGroup3D {
    */
   virtual bool prepareForDraw(const RenderCamera&) { return true; }
 
+  /**
+   * @brief Bring the bounding volume hierarchy up to date with the world
+   * bounding boxes of the drawables' nodes
+   *
+   * Only drawables added, or whose nodes moved or changed bounds, since the
+   * last call are visited; their nodes are cleaned on the way.
+   */
+  void updateBvh();
+
+  /**
+   * @brief Get the bounding volume hierarchy over the world bounding boxes of
+   * the drawables' nodes, call @ref updateBvh first. Leaves hold enlarged
+   * boxes; map them back with @ref getBvhDrawable.
+   */
+  const geo::AabbTree& getBvh() const { return bvh_; }
+
+  /**
+   * @brief Get the drawable of a leaf of @ref getBvh
+   */
+  Drawable* getBvhDrawable(int leaf) const { return leafDrawables_[leaf]; }
+
+  /**
+   * @brief Get the drawables whose node's world bounding box overlaps a box
+   * @param box the box, in world space
+   */
+  std::vector<Drawable*> getDrawablesInBox(const Magnum::Range3D& box);
+
+  /**
+   * @brief Get the drawables whose node's world bounding box contains a point
+   * @param point the point, in world space
+   */
+  std::vector<Drawable*> getDrawablesAtPoint(const Magnum::Vector3& point);
+
  protected:
   /**
    * Why a friend class here?
@@ -83,10 +119,27 @@ class DrawableGroup : public Magnum::SceneGraph::DrawableGroup3D {
    * @return return true, if the drawable was in the group, otherwise false
    */
   bool unregisterDrawable(Drawable& drawable);
+  /**
+   * @brief Queue the drawable for a bounds update by @ref updateBvh
+   */
+  void markBoundsDirty(Drawable& drawable);
   /**
    * a lookup table, that maps a drawable id to the drawable object
    */
   std::unordered_map<uint64_t, Drawable*> idToDrawable_;
+  /**
+   * hierarchy over the world bounding boxes of the drawables' nodes
+   */
+  geo::AabbTree bvh_;
+  /**
+   * the drawable of each leaf of bvh_, indexed by leaf id
+   */
+  std::vector<Drawable*> leafDrawables_;
+  /**
+   * ids of the drawables queued for a bounds update; a drawable removed from
+   * the group in the meantime is skipped
+   */
+  std::vector<uint64_t> boundsDirtyIds_;
   ESP_SMART_POINTERS(DrawableGroup)
 };
 
@@ -4,6 +4,7 @@
 
 #include "GenericDrawable.h"
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Magnum/Math/Color.h>
@@ -12,6 +13,7 @@
 #include "esp/scene/SceneNode.h"
 
 namespace Mn = Magnum;
+namespace Cr = Corrade;
 
 namespace esp {
 namespace gfx {
@@ -77,6 +79,7 @@ void GenericDrawable::setLightSetup(const Mn::ResourceKey& resourceKey) {
 }
 
 void GenericDrawable::updateShaderLightingParameters(
+    Mn::Shaders::PhongGL& shader,
     const Mn::Matrix4& transformationMatrix,
     Mn::SceneGraph::Camera3D& camera) {
   const Mn::Matrix4 cameraMatrix = camera.cameraMatrix();
@@ -107,8 +110,7 @@ void GenericDrawable::updateShaderLightingParameters(
   }
 
   // See documentation in src/deps/magnum/src/Magnum/Shaders/Phong.h
-  (*shader_)
-      .setAmbientColor(materialData_->ambientColor * ambientLightColor)
+  shader.setAmbientColor(materialData_->ambientColor * ambientLightColor)
       .setDiffuseColor(materialData_->diffuseColor)
       .setSpecularColor(materialData_->specularColor)
       .setShininess(materialData_->shininess)
@@ -117,6 +119,39 @@ void GenericDrawable::updateShaderLightingParameters(
       .setLightRanges(lightRanges);
 }
 
+void GenericDrawable::bindShaderTextures(Mn::Shaders::PhongGL& shader) {
+  if ((flags_ & Mn::Shaders::PhongGL::Flag::TextureTransformation) &&
+      materialData_->textureMatrix != Mn::Matrix3{}) {
+    shader.setTextureMatrix(materialData_->textureMatrix);
+  }
+
+  if (flags_ & Mn::Shaders::PhongGL::Flag::AmbientTexture) {
+    shader.bindAmbientTexture(*(materialData_->ambientTexture));
+  }
+  if (flags_ & Mn::Shaders::PhongGL::Flag::DiffuseTexture) {
+    shader.bindDiffuseTexture(*(materialData_->diffuseTexture));
+  }
+  if (flags_ & Mn::Shaders::PhongGL::Flag::SpecularTexture) {
+    shader.bindSpecularTexture(*(materialData_->specularTexture));
+  }
+  if (flags_ & Mn::Shaders::PhongGL::Flag::NormalTexture) {
+    shader.bindNormalTexture(*(materialData_->normalTexture));
+  }
+  if (flags_ >= Mn::Shaders::PhongGL::Flag::ObjectIdTexture) {
+    shader.bindObjectIdTexture(*(materialData_->objectIdTexture));
+  }
+}
+
+Mn::UnsignedInt GenericDrawable::getObjectId(Mn::SceneGraph::Camera3D& camera) {
+  // e.g., semantic mesh has its own per vertex annotation, which has been
+  // uploaded to GPU so simply pass 0 to the uniform "objectId" in the
+  // fragment shader
+  return static_cast<RenderCamera&>(camera).useDrawableIds() ? drawableId_
+         : (materialData_->perVertexObjectId || materialData_->textureObjectId)
+             ? 0
+             : node_.getSemanticId();
+}
+
 void GenericDrawable::draw(const Mn::Matrix4& transformationMatrix,
                            Mn::SceneGraph::Camera3D& camera) {
   CORRADE_ASSERT(glMeshExists(),
@@ -124,65 +159,111 @@ void GenericDrawable::draw(const Mn::Matrix4& transformationMatrix,
 
   updateShader();
 
-  updateShaderLightingParameters(transformationMatrix, camera);
+  updateShaderLightingParameters(*shader_, transformationMatrix, camera);
 
   (*shader_)
-      // e.g., semantic mesh has its own per vertex annotation, which has been
-      // uploaded to GPU so simply pass 0 to the uniform "objectId" in the
-      // fragment shader
-      .setObjectId(
-          static_cast<RenderCamera&>(camera).useDrawableIds() ? drawableId_
-          : (materialData_->perVertexObjectId || materialData_->textureObjectId)
-              ? 0
-              : node_.getSemanticId())
+      .setObjectId(getObjectId(camera))
       .setTransformationMatrix(transformationMatrix)
       .setProjectionMatrix(camera.projectionMatrix())
       .setNormalMatrix(transformationMatrix.normalMatrix());
 
-  if ((flags_ & Mn::Shaders::PhongGL::Flag::TextureTransformation) &&
-      materialData_->textureMatrix != Mn::Matrix3{}) {
-    shader_->setTextureMatrix(materialData_->textureMatrix);
-  }
+  bindShaderTextures(*shader_);
 
-  if (flags_ & Mn::Shaders::PhongGL::Flag::AmbientTexture) {
-    shader_->bindAmbientTexture(*(materialData_->ambientTexture));
+  shader_->draw(getMesh());
+}
+
+bool GenericDrawable::isInstanceCompatible(Drawable& other) {
+  if (other.getDrawableType() != DrawableType::Generic || !glMeshExists() ||
+      !other.glMeshExists() || &other.getMesh() != &getMesh()) {
+    return false;
   }
-  if (flags_ & Mn::Shaders::PhongGL::Flag::DiffuseTexture) {
-    shader_->bindDiffuseTexture(*(materialData_->diffuseTexture));
+  auto& generic = static_cast<GenericDrawable&>(other);
+  if (generic.flags_ != flags_ ||
+      generic.materialData_.key() != materialData_.key() ||
+      generic.lightSetup_.key() != lightSetup_.key()) {
+    return false;
   }
-  if (flags_ & Mn::Shaders::PhongGL::Flag::SpecularTexture) {
-    shader_->bindSpecularTexture(*(materialData_->specularTexture));
+  // per-vertex object ids and bitangents occupy the attribute location of the
+  // per-instance object id. Both object id flags include the ObjectId bit
+  // every drawable has, so they are tested as a whole.
+  if (flags_ >= Mn::Shaders::PhongGL::Flag::InstancedObjectId ||
+      flags_ >= Mn::Shaders::PhongGL::Flag::ObjectIdTexture ||
+      (flags_ & Mn::Shaders::PhongGL::Flag::Bitangent)) {
+    return false;
   }
-  if (flags_ & Mn::Shaders::PhongGL::Flag::NormalTexture) {
-    shader_->bindNormalTexture(*(materialData_->normalTexture));
+  // lights following the object are positioned per draw
+  for (Mn::UnsignedInt i = 0; i < lightSetup_->size(); ++i) {
+    if ((*lightSetup_)[i].model == LightPositionModel::Object) {
+      return false;
+    }
   }
-  if (flags_ >= Mn::Shaders::PhongGL::Flag::ObjectIdTexture) {
-    shader_->bindObjectIdTexture(*(materialData_->objectIdTexture));
+  return true;
+}
+
+bool GenericDrawable::drawInstanced(
+    Cr::Containers::ArrayView<Drawable* const> instances,
+    Cr::Containers::ArrayView<const Mn::Matrix4> transformations,
+    Mn::SceneGraph::Camera3D& camera) {
+  CORRADE_ASSERT(glMeshExists(),
+                 "GenericDrawable::drawInstanced() : GL mesh doesn't exist",
+                 false);
+  CORRADE_INTERNAL_ASSERT(instances.size() == transformations.size());
+
+  updateShader(instancedShader_,
+               flags_ | Mn::Shaders::PhongGL::Flag::InstancedTransformation |
+                   Mn::Shaders::PhongGL::Flag::InstancedObjectId);
+
+  // no light depends on the transformation, see isInstanceCompatible()
+  updateShaderLightingParameters(*instancedShader_, transformations[0],
+                                 camera);
+
+  Cr::Containers::Array<InstanceData> instanceData{Cr::NoInit,
+                                                   instances.size()};
+  for (std::size_t i = 0; i != instances.size(); ++i) {
+    instanceData[i].transformationMatrix = transformations[i];
+    instanceData[i].normalMatrix = transformations[i].normalMatrix();
+    instanceData[i].objectId =
+        static_cast<GenericDrawable*>(instances[i])->getObjectId(camera);
   }
 
-  shader_->draw(getMesh());
+  // the instanced attributes are multiplied with (or added to) the uniforms
+  (*instancedShader_)
+      .setObjectId(0)
+      .setTransformationMatrix(Mn::Matrix4{})
+      .setProjectionMatrix(camera.projectionMatrix())
+      .setNormalMatrix(Mn::Matrix3x3{});
+
+  bindShaderTextures(*instancedShader_);
+
+  drawMeshInstanced(*instancedShader_, instanceData);
+  return true;
 }
 
 void GenericDrawable::updateShader() {
+  updateShader(shader_, flags_);
+}
+
+void GenericDrawable::updateShader(ShaderResource& shader,
+                                   Mn::Shaders::PhongGL::Flags flags) {
   Mn::UnsignedInt lightCount = lightSetup_->size();
 
-  if (!shader_ || shader_->lightCount() != lightCount ||
-      shader_->flags() != flags_) {
+  if (!shader || shader->lightCount() != lightCount ||
+      shader->flags() != flags) {
     // if the number of lights or flags have changed, we need to fetch a
     // compatible shader
-    shader_ =
+    shader =
         shaderManager_.get<Mn::GL::AbstractShaderProgram, Mn::Shaders::PhongGL>(
-            getShaderKey(lightCount, flags_));
+            getShaderKey(lightCount, flags));
 
     // if no shader with desired number of lights and flags exists, create one
-    if (!shader_) {
+    if (!shader) {
       shaderManager_.set<Mn::GL::AbstractShaderProgram>(
-          shader_.key(), new Mn::Shaders::PhongGL{flags_, lightCount},
+          shader.key(), new Mn::Shaders::PhongGL{flags, lightCount},
           Mn::ResourceDataState::Final, Mn::ResourcePolicy::ReferenceCounted);
     }
 
-    CORRADE_INTERNAL_ASSERT(shader_ && shader_->lightCount() == lightCount &&
-                            shader_->flags() == flags_);
+    CORRADE_INTERNAL_ASSERT(shader && shader->lightCount() == lightCount &&
+                            shader->flags() == flags);
   }
 }
 
@@ -194,5 +275,12 @@ Mn::ResourceKey GenericDrawable::getShaderKey(
       static_cast<Mn::Shaders::PhongGL::Flags::UnderlyingType>(flags));
 }
 
+Drawable::DrawState GenericDrawable::getDrawState() {
+  DrawState state = Drawable::getDrawState();
+  state.shader = static_cast<Mn::Shaders::PhongGL*>(shader_);
+  state.material = static_cast<PhongMaterialData*>(materialData_);
+  return state;
+}
+
 }  // namespace gfx
 }  // namespace esp
@@ -29,22 +29,53 @@ class GenericDrawable : public Drawable {
   void setLightSetup(const Magnum::ResourceKey& lightSetupKey) override;
   static constexpr const char* SHADER_KEY_TEMPLATE = "Phong-lights={}-flags={}";
 
+  /**
+   * @brief Get the shader and material this drawable binds when drawn
+   */
+  DrawState getDrawState() override;
+
+  /**
+   * @brief Whether @p other shares the mesh, material, light setup and shader
+   * flags of this drawable. Drawables with per-vertex or textured object ids,
+   * separate bitangents or lights attached to the object are never batched.
+   */
+  bool isInstanceCompatible(Drawable& other) override;
+
+  bool drawInstanced(
+      Corrade::Containers::ArrayView<Drawable* const> instances,
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> transformations,
+      Magnum::SceneGraph::Camera3D& camera) override;
+
  protected:
+  typedef Magnum::Resource<Magnum::GL::AbstractShaderProgram,
+                           Magnum::Shaders::PhongGL>
+      ShaderResource;
+
   void draw(const Magnum::Matrix4& transformationMatrix,
             Magnum::SceneGraph::Camera3D& camera) override;
 
   void updateShader();
+  void updateShader(ShaderResource& shader,
+                    Magnum::Shaders::PhongGL::Flags flags);
   void updateShaderLightingParameters(
+      Magnum::Shaders::PhongGL& shader,
       const Magnum::Matrix4& transformationMatrix,
       Magnum::SceneGraph::Camera3D& camera);
+  void bindShaderTextures(Magnum::Shaders::PhongGL& shader);
+
+  /**
+   * @brief The object id this drawable writes when drawn by @p camera
+   */
+  Magnum::UnsignedInt getObjectId(Magnum::SceneGraph::Camera3D& camera);
 
   Magnum::ResourceKey getShaderKey(Magnum::UnsignedInt lightCount,
                                    Magnum::Shaders::PhongGL::Flags flags) const;
 
   // shader parameters
   ShaderManager& shaderManager_;
-  Magnum::Resource<Magnum::GL::AbstractShaderProgram, Magnum::Shaders::PhongGL>
-      shader_;
+  ShaderResource shader_;
+  //! variant of shader_ reading transformations and object ids per instance
+  ShaderResource instancedShader_;
   Magnum::Resource<MaterialData, PhongMaterialData> materialData_;
   Magnum::Resource<LightSetup> lightSetup_;
 
@@ -35,5 +35,12 @@ void MeshVisualizerDrawable::draw(const Magnum::Matrix4& transformationMatrix,
   Mn::GL::Renderer::setPolygonOffset(0.0f, 0.0f);
   Mn::GL::Renderer::disable(Mn::GL::Renderer::Feature::PolygonOffsetFill);
 }
+
+Drawable::DrawState MeshVisualizerDrawable::getDrawState() {
+  DrawState state = Drawable::getDrawState();
+  state.shader = &shader_;
+  return state;
+}
+
 }  // namespace gfx
 }  // namespace esp
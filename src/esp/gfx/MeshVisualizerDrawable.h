@@ -28,6 +28,11 @@ class MeshVisualizerDrawable : public Drawable {
                                   Magnum::GL::Mesh& mesh,
                                   gfx::DrawableGroup* group);
 
+  /**
+   * @brief Get the shader and material this drawable binds when drawn
+   */
+  DrawState getDrawState() override;
+
  protected:
   /**
    * @brief Draw the object using given camera
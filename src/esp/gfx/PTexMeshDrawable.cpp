@@ -66,5 +66,12 @@ void PTexMeshDrawable::draw(const Magnum::Matrix4& transformationMatrix,
       .draw(getMesh());
 }
 
+Drawable::DrawState PTexMeshDrawable::getDrawState() {
+  DrawState state = Drawable::getDrawState();
+  state.shader = shader_;
+  state.material = &atlasTexture_;
+  return state;
+}
+
 }  // namespace gfx
 }  // namespace esp
@@ -29,6 +29,11 @@ class PTexMeshDrawable : public Drawable {
     return visualizerTriangleMesh_;
   }
 
+  /**
+   * @brief Get the shader and material this drawable binds when drawn
+   */
+  DrawState getDrawState() override;
+
  protected:
   void draw(const Magnum::Matrix4& transformationMatrix,
             Magnum::SceneGraph::Camera3D& camera) override;
@@ -4,11 +4,13 @@
 
 #include "PbrDrawable.h"
 
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Magnum/GL/Renderer.h>
 
 namespace Mn = Magnum;
+namespace Cr = Corrade;
 
 namespace esp {
 namespace gfx {
@@ -84,14 +86,24 @@ void PbrDrawable::setLightSetup(const Mn::ResourceKey& lightSetupKey) {
   lightSetup_ = shaderManager_.get<LightSetup>(lightSetupKey);
 }
 
+Mn::UnsignedInt PbrDrawable::getObjectId(Mn::SceneGraph::Camera3D& camera) {
+  // e.g., semantic mesh has its own per vertex annotation, which has been
+  // uploaded to GPU so simply pass 0 to the uniform "objectId" in the
+  // fragment shader
+  return static_cast<RenderCamera&>(camera).useDrawableIds()
+             ? drawableId_
+             : (materialData_->perVertexObjectId ? 0 : node_.getSemanticId());
+}
+
 void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
                        Mn::SceneGraph::Camera3D& camera) {
   CORRADE_ASSERT(glMeshExists(),
                  "PbrDrawable::draw() : GL mesh doesn't exist", );
 
   updateShader()
-      .updateShaderLightParameters()
-      .updateShaderLightDirectionParameters(transformationMatrix, camera);
+      .updateShaderLightParameters(*shader_)
+      .updateShaderLightDirectionParameters(*shader_, transformationMatrix,
+                                            camera);
 
   // ABOUT PbrShader::Flag::DoubleSided:
   //
@@ -115,17 +127,95 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
       camera.cameraMatrix().inverted() * transformationMatrix;
 
   (*shader_)
-      // e.g., semantic mesh has its own per vertex annotation, which has been
-      // uploaded to GPU so simply pass 0 to the uniform "objectId" in the
-      // fragment shader
-      .setObjectId(
-          static_cast<RenderCamera&>(camera).useDrawableIds()
-              ? drawableId_
-              : (materialData_->perVertexObjectId ? 0 : node_.getSemanticId()))
-      .setProjectionMatrix(camera.projectionMatrix())
-      .setViewMatrix(camera.cameraMatrix())
+      .setObjectId(getObjectId(camera))
       .setModelMatrix(modelMatrix)  // NOT modelview matrix!
-      .setNormalMatrix(modelMatrix.normalMatrix())
+      .setNormalMatrix(modelMatrix.normalMatrix());
+
+  updateShaderMaterialParameters(*shader_, camera);
+
+  shader_->draw(getMesh());
+
+  // WE stopped supporting doubleSided material due to lighting artifacts on
+  // hard edges. See comments at the beginning of this function.
+  /*
+  if ((flags_ & PbrShader::Flag::DoubleSided) && !glIsEnabled(GL_CULL_FACE)) {
+    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
+  }
+  */
+}
+
+bool PbrDrawable::isInstanceCompatible(Drawable& other) {
+  if (other.getDrawableType() != DrawableType::Pbr || !glMeshExists() ||
+      !other.glMeshExists() || &other.getMesh() != &getMesh()) {
+    return false;
+  }
+  auto& pbr = static_cast<PbrDrawable&>(other);
+  if (pbr.flags_ != flags_ || pbr.materialData_.key() != materialData_.key() ||
+      pbr.lightSetup_.key() != lightSetup_.key() || pbr.pbrIbl_ != pbrIbl_ ||
+      pbr.shadowMapManger_ != shadowMapManger_ ||
+      pbr.shadowMapKeys_ != shadowMapKeys_) {
+    return false;
+  }
+  // per-vertex object ids occupy the attribute location of the per-instance
+  // object id
+  if (materialData_->perVertexObjectId) {
+    return false;
+  }
+  // lights following the object are positioned per draw
+  for (unsigned int iLight = 0; iLight < lightSetup_->size(); ++iLight) {
+    if ((*lightSetup_)[iLight].model == LightPositionModel::Object) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PbrDrawable::drawInstanced(
+    Cr::Containers::ArrayView<Drawable* const> instances,
+    Cr::Containers::ArrayView<const Mn::Matrix4> transformations,
+    Mn::SceneGraph::Camera3D& camera) {
+  CORRADE_ASSERT(glMeshExists(),
+                 "PbrDrawable::drawInstanced() : GL mesh doesn't exist",
+                 false);
+  CORRADE_INTERNAL_ASSERT(instances.size() == transformations.size());
+
+  // no light depends on the transformation, see isInstanceCompatible()
+  updateShader(instancedShader_,
+               flags_ | PbrShader::Flag::InstancedTransformation |
+                   PbrShader::Flag::InstancedObjectId)
+      .updateShaderLightParameters(*instancedShader_)
+      .updateShaderLightDirectionParameters(*instancedShader_,
+                                            transformations[0], camera);
+
+  // per-instance model matrices, NOT modelview matrices
+  const Mn::Matrix4 inverseCameraMatrix = camera.cameraMatrix().inverted();
+  Cr::Containers::Array<InstanceData> instanceData{Cr::NoInit,
+                                                   instances.size()};
+  for (std::size_t i = 0; i != instances.size(); ++i) {
+    const Mn::Matrix4 modelMatrix = inverseCameraMatrix * transformations[i];
+    instanceData[i].transformationMatrix = modelMatrix;
+    instanceData[i].normalMatrix = modelMatrix.normalMatrix();
+    instanceData[i].objectId =
+        static_cast<PbrDrawable*>(instances[i])->getObjectId(camera);
+  }
+
+  // the instanced attributes are multiplied with (or added to) the uniforms
+  (*instancedShader_)
+      .setObjectId(0)
+      .setModelMatrix(Mn::Matrix4{})
+      .setNormalMatrix(Mn::Matrix3x3{});
+
+  updateShaderMaterialParameters(*instancedShader_, camera);
+
+  drawMeshInstanced(*instancedShader_, instanceData);
+  return true;
+}
+
+void PbrDrawable::updateShaderMaterialParameters(
+    PbrShader& shader,
+    Mn::SceneGraph::Camera3D& camera) {
+  shader.setProjectionMatrix(camera.projectionMatrix())
+      .setViewMatrix(camera.cameraMatrix())
       .setCameraWorldPosition(
           camera.object().absoluteTransformationMatrix().translation())
       .setBaseColor(materialData_->baseColor)
@@ -140,7 +230,7 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
 
   if ((flags_ & PbrShader::Flag::BaseColorTexture) &&
       (materialData_->baseColorTexture != nullptr)) {
-    shader_->bindBaseColorTexture(*materialData_->baseColorTexture);
+    shader.bindBaseColorTexture(*materialData_->baseColorTexture);
   }
 
   if (flags_ &
@@ -153,34 +243,34 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
     CORRADE_ASSERT(metallicRoughnessTexture,
                    "PbrDrawable::draw(): texture pointer cannot be nullptr if "
                    "RoughnessTexture or MetallicTexture is enabled.", );
-    shader_->bindMetallicRoughnessTexture(*metallicRoughnessTexture);
+    shader.bindMetallicRoughnessTexture(*metallicRoughnessTexture);
   }
 
   if ((flags_ & PbrShader::Flag::NormalTexture) &&
       (materialData_->normalTexture != nullptr)) {
-    shader_->bindNormalTexture(*materialData_->normalTexture);
+    shader.bindNormalTexture(*materialData_->normalTexture);
   }
 
   if ((flags_ & PbrShader::Flag::EmissiveTexture) &&
       (materialData_->emissiveTexture != nullptr)) {
-    shader_->bindEmissiveTexture(*materialData_->emissiveTexture);
+    shader.bindEmissiveTexture(*materialData_->emissiveTexture);
   }
 
   if ((flags_ & PbrShader::Flag::TextureTransformation) &&
       (materialData_->textureMatrix != Mn::Matrix3{})) {
-    shader_->setTextureMatrix(materialData_->textureMatrix);
+    shader.setTextureMatrix(materialData_->textureMatrix);
   }
 
   // setup image based lighting for the shader
   if (flags_ & PbrShader::Flag::ImageBasedLighting) {
     CORRADE_INTERNAL_ASSERT(pbrIbl_);
-    shader_->bindIrradianceCubeMap(  // TODO: HDR Color
+    shader.bindIrradianceCubeMap(  // TODO: HDR Color
         pbrIbl_->getIrradianceMap().getTexture(CubeMap::TextureType::Color));
-    shader_->bindBrdfLUT(pbrIbl_->getBrdfLookupTable());
-    shader_->bindPrefilteredMap(
+    shader.bindBrdfLUT(pbrIbl_->getBrdfLookupTable());
+    shader.bindPrefilteredMap(
         // TODO: HDR Color
         pbrIbl_->getPrefilteredMap().getTexture(CubeMap::TextureType::Color));
-    shader_->setPrefilteredMapMipLevels(
+    shader.setPrefilteredMapMipLevels(
         pbrIbl_->getPrefilteredMap().getMipmapLevels());
   }
 
@@ -196,22 +286,12 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
       CORRADE_INTERNAL_ASSERT(shadowMap);
 
       if (flags_ & PbrShader::Flag::ShadowsVSM) {
-        shader_->bindPointShadowMap(
+        shader.bindPointShadowMap(
             iShadow,
             shadowMap->getTexture(CubeMap::TextureType::VarianceShadowMap));
       }
     }
   }
-
-  shader_->draw(getMesh());
-
-  // WE stopped supporting doubleSided material due to lighting artifacts on
-  // hard edges. See comments at the beginning of this function.
-  /*
-  if ((flags_ & PbrShader::Flag::DoubleSided) && !glIsEnabled(GL_CULL_FACE)) {
-    Mn::GL::Renderer::enable(Mn::GL::Renderer::Feature::FaceCulling);
-  }
-  */
 }
 
 Mn::ResourceKey PbrDrawable::getShaderKey(Mn::UnsignedInt lightCount,
@@ -222,30 +302,35 @@ Mn::ResourceKey PbrDrawable::getShaderKey(Mn::UnsignedInt lightCount,
 }
 
 PbrDrawable& PbrDrawable::updateShader() {
+  return updateShader(shader_, flags_);
+}
+
+PbrDrawable& PbrDrawable::updateShader(ShaderResource& shader,
+                                       PbrShader::Flags flags) {
   unsigned int lightCount = lightSetup_->size();
-  if (!shader_ || shader_->lightCount() != lightCount ||
-      shader_->flags() != flags_) {
+  if (!shader || shader->lightCount() != lightCount ||
+      shader->flags() != flags) {
     // if the number of lights or flags have changed, we need to fetch a
     // compatible shader
-    shader_ = shaderManager_.get<Mn::GL::AbstractShaderProgram, PbrShader>(
-        getShaderKey(lightCount, flags_));
+    shader = shaderManager_.get<Mn::GL::AbstractShaderProgram, PbrShader>(
+        getShaderKey(lightCount, flags));
 
     // if no shader with desired number of lights and flags exists, create one
-    if (!shader_) {
+    if (!shader) {
       shaderManager_.set<Mn::GL::AbstractShaderProgram>(
-          shader_.key(), new PbrShader{flags_, lightCount},
+          shader.key(), new PbrShader{flags, lightCount},
           Mn::ResourceDataState::Final, Mn::ResourcePolicy::ReferenceCounted);
     }
 
-    CORRADE_INTERNAL_ASSERT(shader_ && shader_->lightCount() == lightCount &&
-                            shader_->flags() == flags_);
+    CORRADE_INTERNAL_ASSERT(shader && shader->lightCount() == lightCount &&
+                            shader->flags() == flags);
   }
 
   return *this;
 }
 
 // update every light's color, intensity, range etc.
-PbrDrawable& PbrDrawable::updateShaderLightParameters() {
+PbrDrawable& PbrDrawable::updateShaderLightParameters(PbrShader& shader) {
   // light range has been initialized to Mn::Constants::inf()
   // in the PbrShader's constructor.
   // No need to reset it at this point.
@@ -256,12 +341,13 @@ PbrDrawable& PbrDrawable::updateShaderLightParameters() {
     colors.emplace_back((*lightSetup_)[iLight].color);
   }
 
-  shader_->setLightColors(colors);
+  shader.setLightColors(colors);
   return *this;
 }
 
 // update light direction (or position) in *world* space to the shader
 PbrDrawable& PbrDrawable::updateShaderLightDirectionParameters(
+    PbrShader& shader,
     const Magnum::Matrix4& transformationMatrix,
     Magnum::SceneGraph::Camera3D& camera) {
   std::vector<Mn::Vector4> lightPositions;
@@ -275,7 +361,7 @@ PbrDrawable& PbrDrawable::updateShaderLightDirectionParameters(
     lightPositions.emplace_back(pos);
   }
 
-  shader_->setLightVectors(lightPositions);
+  shader.setLightVectors(lightPositions);
 
   return *this;
 }
@@ -293,5 +379,12 @@ void PbrDrawable::setShadowData(ShadowMapManager& manager,
   flags_ |= shadowFlag;
 }
 
+Drawable::DrawState PbrDrawable::getDrawState() {
+  DrawState state = Drawable::getDrawState();
+  state.shader = static_cast<PbrShader*>(shader_);
+  state.material = static_cast<PbrMaterialData*>(materialData_);
+  return state;
+}
+
 }  // namespace gfx
 }  // namespace esp
@@ -49,7 +49,27 @@ class PbrDrawable : public Drawable {
 
   static constexpr const char* SHADER_KEY_TEMPLATE = "PBR-lights={}-flags={}";
 
+  /**
+   * @brief Get the shader and material this drawable binds when drawn
+   */
+  DrawState getDrawState() override;
+
+  /**
+   * @brief Whether @p other shares the mesh, material, light setup, image
+   * based lighting and shadow maps of this drawable. Drawables with
+   * per-vertex object ids or lights attached to the object are never batched.
+   */
+  bool isInstanceCompatible(Drawable& other) override;
+
+  bool drawInstanced(
+      Corrade::Containers::ArrayView<Drawable* const> instances,
+      Corrade::Containers::ArrayView<const Magnum::Matrix4> transformations,
+      Magnum::SceneGraph::Camera3D& camera) override;
+
  protected:
+  typedef Magnum::Resource<Magnum::GL::AbstractShaderProgram, PbrShader>
+      ShaderResource;
+
   /**
    * @brief overload draw function, see here for more details:
    * https://doc.magnum.graphics/magnum/classMagnum_1_1SceneGraph_1_1Drawable.html#aca0d0a219aa4d7712316de55d67f2134
@@ -67,24 +87,48 @@ class PbrDrawable : public Drawable {
    */
   PbrDrawable& updateShader();
 
+  /**
+   *  @brief Update @p shader so it matches @p flags and the current light
+   *         setup
+   *  @return Reference to self (for method chaining)
+   */
+  PbrDrawable& updateShader(ShaderResource& shader, PbrShader::Flags flags);
+
   /**
    *  @brief Update every light's color, intensity, range etc.
+   *  @param shader the shader to update
    *  @return Reference to self (for method chaining)
    */
-  PbrDrawable& updateShaderLightParameters();
+  PbrDrawable& updateShaderLightParameters(PbrShader& shader);
 
   /**
    *  @brief Update light direction (or position) in *camera* space to the
    * shader
+   *  @param shader the shader to update
    *  @param transformationMatrix describes a tansformation from object
    * (model) space to camera space
    *  @param camera the camera, which views and renders the world
    *  @return Reference to self (for method chaining)
    */
   PbrDrawable& updateShaderLightDirectionParameters(
+      PbrShader& shader,
       const Magnum::Matrix4& transformationMatrix,
       Magnum::SceneGraph::Camera3D& camera);
 
+  /**
+   *  @brief Upload the camera, material, texture, image based lighting and
+   *  shadow map parameters to the shader
+   *  @param shader the shader to update
+   *  @param camera the camera, which views and renders the world
+   */
+  void updateShaderMaterialParameters(PbrShader& shader,
+                                      Magnum::SceneGraph::Camera3D& camera);
+
+  /**
+   * @brief The object id this drawable writes when drawn by @p camera
+   */
+  Magnum::UnsignedInt getObjectId(Magnum::SceneGraph::Camera3D& camera);
+
   /**
    * @brief get the key for the shader
    * @param lightCount the number of the lights;
@@ -96,7 +140,9 @@ class PbrDrawable : public Drawable {
   // shader parameters
   PbrShader::Flags flags_;
   ShaderManager& shaderManager_;
-  Magnum::Resource<Magnum::GL::AbstractShaderProgram, PbrShader> shader_;
+  ShaderResource shader_;
+  //! variant of shader_ reading transformations and object ids per instance
+  ShaderResource instancedShader_;
   Magnum::Resource<MaterialData, PbrMaterialData> materialData_;
   Magnum::Resource<LightSetup> lightSetup_;
   PbrImageBasedLighting* pbrIbl_ = nullptr;
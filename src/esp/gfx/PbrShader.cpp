@@ -86,6 +86,19 @@ PbrShader::PbrShader(Flags originalFlags, unsigned int lightCount)
                                      TextureCoordinates::Location);
   }
 
+  if (flags_ & Flag::InstancedTransformation) {
+    attributeLocationsStream << Cr::Utility::formatString(
+        "#define ATTRIBUTE_LOCATION_TRANSFORMATION_MATRIX {}\n",
+        TransformationMatrix::Location);
+    attributeLocationsStream << Cr::Utility::formatString(
+        "#define ATTRIBUTE_LOCATION_NORMAL_MATRIX {}\n",
+        NormalMatrix::Location);
+  }
+  if (flags_ & Flag::InstancedObjectId) {
+    attributeLocationsStream << Cr::Utility::formatString(
+        "#define ATTRIBUTE_LOCATION_OBJECT_ID {}\n", ObjectId::Location);
+  }
+
   // Add macros
   vert.addSource(attributeLocationsStream.str())
       .addSource(isTextured ? "#define TEXTURED\n" : "")
@@ -96,6 +109,12 @@ PbrShader::PbrShader(Flags originalFlags, unsigned int lightCount)
       .addSource(flags_ & Flag::TextureTransformation
                      ? "#define TEXTURE_TRANSFORMATION\n"
                      : "")
+      .addSource(flags_ & Flag::InstancedTransformation
+                     ? "#define INSTANCED_TRANSFORMATION\n"
+                     : "")
+      .addSource(flags_ & Flag::InstancedObjectId
+                     ? "#define INSTANCED_OBJECT_ID\n"
+                     : "")
       .addSource(rs.getString("pbr.vert"));
 
   std::stringstream outputAttributeLocationsStream;
@@ -120,6 +139,9 @@ PbrShader::PbrShader(Flags originalFlags, unsigned int lightCount)
                      ? "#define NORMAL_TEXTURE_SCALE\n"
                      : "")
       .addSource(flags_ & Flag::ObjectId ? "#define OBJECT_ID\n" : "")
+      .addSource(flags_ & Flag::InstancedObjectId
+                     ? "#define INSTANCED_OBJECT_ID\n"
+                     : "")
       .addSource(flags_ & Flag::PrecomputedTangent
                      ? "#define PRECOMPUTED_TANGENT\n"
                      : "")
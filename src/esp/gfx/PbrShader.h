@@ -52,6 +52,28 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
    */
   typedef Magnum::Shaders::GenericGL3D::Tangent4 Tangent4;
 
+  /**
+   * @brief Per-instance model matrix
+   *
+   * Used only if @ref Flag::InstancedTransformation is set.
+   */
+  typedef Magnum::Shaders::GenericGL3D::TransformationMatrix
+      TransformationMatrix;
+
+  /**
+   * @brief Per-instance normal matrix
+   *
+   * Used only if @ref Flag::InstancedTransformation is set.
+   */
+  typedef Magnum::Shaders::GenericGL3D::NormalMatrix NormalMatrix;
+
+  /**
+   * @brief Per-instance object id
+   *
+   * Used only if @ref Flag::InstancedObjectId is set.
+   */
+  typedef Magnum::Shaders::GenericGL3D::ObjectId ObjectId;
+
   enum : Magnum::UnsignedInt {
     /**
      * Color shader output. @ref shaders-generic "Generic output",
@@ -193,6 +215,18 @@ class PbrShader : public Magnum::GL::AbstractShaderProgram {
      * PbrDebugDisplay in the fragment shader for debugging
      */
     DebugDisplay = 1 << 15,
+
+    /**
+     * Multiply the model matrix and the normal matrix with the per-instance
+     * @ref TransformationMatrix and @ref NormalMatrix attributes.
+     */
+    InstancedTransformation = 1 << 16,
+
+    /**
+     * Add the per-instance @ref ObjectId attribute to the object id set in
+     * @ref setObjectId(). Requires @ref Flag::ObjectId.
+     */
+    InstancedObjectId = 1 << 17,
     /*
      * TODO: alphaMask
      */
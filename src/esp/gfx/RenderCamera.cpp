@@ -4,7 +4,14 @@
 
 #include "RenderCamera.h"
 
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/GL/Mesh.h>
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
@@ -49,6 +56,105 @@ Cr::Containers::Optional<int> rangeFrustum(const Mn::Range3D& range,
   return Cr::Containers::NullOpt;
 }
 
+namespace {
+
+//! shader, material and mesh changes
+typedef Mn::Math::Vector3<size_t> StateChanges;
+
+/**
+ * @brief Count the state changes between consecutive draws
+ * @param states the draw state of every drawable
+ * @param order the draw order, as indices into @p states
+ * @return the number of shader, material and mesh changes
+ */
+StateChanges countStateChanges(const std::vector<Drawable::DrawState>& states,
+                               const std::vector<std::uint32_t>& order) {
+  StateChanges changes;
+  const Drawable::DrawState* previous = nullptr;
+  for (std::uint32_t i : order) {
+    const Drawable::DrawState& state = states[i];
+    if (!previous || previous->shader != state.shader) {
+      ++changes[0];
+    }
+    if (!previous || previous->material != state.material) {
+      ++changes[1];
+    }
+    if (!previous || previous->mesh != state.mesh) {
+      ++changes[2];
+    }
+    previous = &state;
+  }
+  return changes;
+}
+
+/**
+ * @brief Stable LSD radix sort of @p order by @p keys, one byte per pass
+ */
+void radixSort(const std::vector<std::uint64_t>& keys,
+               std::vector<std::uint32_t>& order) {
+  const size_t n = order.size();
+  std::vector<std::uint32_t> scratch(n);
+  for (int shift = 0; shift < 64; shift += 8) {
+    size_t offsets[257] = {};
+    for (std::uint32_t i : order) {
+      ++offsets[((keys[i] >> shift) & 0xff) + 1];
+    }
+    // all keys share this byte, the pass would not change anything
+    if (offsets[((keys[order[0]] >> shift) & 0xff) + 1] == n) {
+      continue;
+    }
+    for (int bucket = 0; bucket < 256; ++bucket) {
+      offsets[bucket + 1] += offsets[bucket];
+    }
+    for (std::uint32_t i : order) {
+      scratch[offsets[(keys[i] >> shift) & 0xff]++] = i;
+    }
+    order.swap(scratch);
+  }
+}
+
+/**
+ * @brief Map a state handle to a small id, in order of first appearance,
+ * saturating at @p maxId
+ */
+std::uint64_t denseId(std::unordered_map<const void*, std::uint64_t>& ids,
+                      const void* handle,
+                      std::uint64_t maxId) {
+  auto result = ids.emplace(handle, ids.size());
+  return std::min(result.first->second, maxId);
+}
+
+/**
+ * @brief Compute the draw order sorted by state and depth
+ *
+ * The 64-bit key packs, from the most significant bit, a 10-bit shader id, an
+ * 18-bit material id, a 20-bit mesh id and the 16 high bits of the view
+ * depth. Positive floats compare like their bit patterns, so the latter sorts
+ * front-to-back.
+ */
+void sortByState(const RenderCamera::DrawableTransforms& drawableTransforms,
+                 const std::vector<Drawable::DrawState>& states,
+                 std::vector<std::uint32_t>& order) {
+  std::unordered_map<const void*, std::uint64_t> shaderIds;
+  std::unordered_map<const void*, std::uint64_t> materialIds;
+  std::unordered_map<const void*, std::uint64_t> meshIds;
+  std::vector<std::uint64_t> keys(states.size());
+  for (size_t i = 0; i < states.size(); ++i) {
+    const float depth =
+        Mn::Math::max(-drawableTransforms[i].second.translation().z(), 0.0f);
+    std::uint32_t depthBits;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    keys[i] = denseId(shaderIds, states[i].shader, (1ull << 10) - 1) << 54 |
+              denseId(materialIds, states[i].material, (1ull << 18) - 1)
+                  << 36 |
+              denseId(meshIds, states[i].mesh, (1ull << 20) - 1) << 16 |
+              depthBits >> 16;
+  }
+  radixSort(keys, order);
+}
+
+}  // namespace
+
 RenderCamera::RenderCamera(scene::SceneNode& node) : MagnumCamera{node} {
   node.setType(scene::SceneNodeType::CAMERA);
   setAspectRatioPolicy(Mn::SceneGraph::AspectRatioPolicy::NotPreserved);
@@ -149,12 +255,61 @@ size_t RenderCamera::removeNonObjects(DrawableTransforms& drawableTransforms) {
 uint32_t RenderCamera::draw(DrawableTransforms& drawableTransforms,
                             Flags flags) {
   previousNumVisibleDrawables_ = drawableTransforms.size();
+  // before the state sort, which groups drawables by the mesh they draw
+  selectLods(drawableTransforms);
+
+  const bool sort = (flags & (Flag::SortByState | Flag::Instancing)) &&
+                    !drawableTransforms.empty();
+  if (sort || (flags & Flag::CollectStateStats)) {
+    std::vector<Drawable::DrawState> states;
+    states.reserve(drawableTransforms.size());
+    for (const auto& item : drawableTransforms) {
+      states.push_back(static_cast<Drawable&>(item.first.get()).getDrawState());
+    }
+    std::vector<std::uint32_t> order(drawableTransforms.size());
+    std::iota(order.begin(), order.end(), 0);
+    const StateChanges unsortedChanges = countStateChanges(states, order);
+    drawStats_.stateChangesUnsorted += unsortedChanges.sum();
+
+    StateChanges changes = unsortedChanges;
+    if (sort) {
+      sortByState(drawableTransforms, states, order);
+      changes = countStateChanges(states, order);
+      DrawableTransforms sorted;
+      sorted.reserve(drawableTransforms.size());
+      for (std::uint32_t i : order) {
+        sorted.push_back(drawableTransforms[i]);
+      }
+      drawableTransforms.swap(sorted);
+    }
+    drawStats_.shaderChanges += changes[0];
+    drawStats_.materialChanges += changes[1];
+    drawStats_.meshChanges += changes[2];
+  }
+
+  drawStats_.drawablesDrawn += drawableTransforms.size();
+  for (const auto& item : drawableTransforms) {
+    const Drawable& drawable = static_cast<const Drawable&>(item.first.get());
+    if (!drawable.glMeshExists()) {
+      continue;
+    }
+    const Mn::GL::Mesh& mesh = drawable.getMesh();
+    if (mesh.primitive() == Mn::GL::MeshPrimitive::Triangles) {
+      const size_t instances = Mn::Math::max(mesh.instanceCount(), 1);
+      drawStats_.trianglesDrawn += size_t(mesh.count()) / 3 * instances;
+    }
+  }
 
   if (flags & Flag::UseDrawableIdAsObjectId) {
     useDrawableIds_ = true;
   }
 
-  MagnumCamera::draw(drawableTransforms);
+  if (flags & Flag::Instancing) {
+    drawInstanced(drawableTransforms);
+  } else {
+    drawStats_.drawCalls += drawableTransforms.size();
+    MagnumCamera::draw(drawableTransforms);
+  }
 
   if (useDrawableIds_) {
     useDrawableIds_ = false;
@@ -163,18 +318,257 @@ uint32_t RenderCamera::draw(DrawableTransforms& drawableTransforms,
   return drawableTransforms.size();
 }
 
+void RenderCamera::selectLods(const DrawableTransforms& drawableTransforms) {
+  const Mn::Matrix4& proj = projectionMatrix();
+  // pixels covered by a unit length at w = 1 in clip space
+  const float pixelsPerUnit = proj[1][1] * 0.5f * float(viewport().y());
+  for (const auto& item : drawableTransforms) {
+    Drawable& drawable = static_cast<Drawable&>(item.first.get());
+    if (drawable.getLods().empty()) {
+      continue;
+    }
+    if (lodThreshold_ <= 0.0f) {
+      drawable.selectLod(1.0f);
+      continue;
+    }
+    const Mn::Matrix4& transform = item.second;
+    const Mn::Range3D& meshBB = drawable.getSceneNode().getMeshBB();
+    const Mn::Vector3 center = transform.transformPoint(meshBB.center());
+    const float scale = Mn::Math::max(Mn::Vector3{
+        transform[0].xyz().length(), transform[1].xyz().length(),
+        transform[2].xyz().length()});
+    const float radius = 0.5f * meshBB.size().length() * scale;
+    // w of the sphere's center; 1 for orthographic projections
+    const float w = proj[2][3] * center.z() + proj[3][3];
+    if (w <= radius * Mn::Math::abs(proj[2][3])) {
+      // the camera is inside (or behind the near side of) the sphere
+      drawable.selectLod(1.0f);
+      continue;
+    }
+    const float pixels = 2.0f * radius * pixelsPerUnit / w;
+    drawable.selectLod(pixels / lodThreshold_);
+  }
+}
+
+void RenderCamera::drawInstanced(const DrawableTransforms& drawableTransforms) {
+  // drawables not batched are collected here and drawn, in order, before the
+  // next instanced draw
+  DrawableTransforms single;
+  auto drawSingle = [&]() {
+    if (single.empty()) {
+      return;
+    }
+    drawStats_.drawCalls += single.size();
+    MagnumCamera::draw(single);
+    single.clear();
+  };
+
+  std::vector<Drawable*> instances;
+  std::vector<Mn::Matrix4> transformations;
+  const size_t count = drawableTransforms.size();
+  for (size_t begin = 0, end; begin < count; begin = end) {
+    Drawable& first =
+        static_cast<Drawable&>(drawableTransforms[begin].first.get());
+    end = begin + 1;
+    while (end < count &&
+           first.isInstanceCompatible(
+               static_cast<Drawable&>(drawableTransforms[end].first.get()))) {
+      ++end;
+    }
+
+    if (end - begin > 1) {
+      instances.clear();
+      transformations.clear();
+      for (size_t i = begin; i != end; ++i) {
+        instances.push_back(
+            &static_cast<Drawable&>(drawableTransforms[i].first.get()));
+        transformations.push_back(drawableTransforms[i].second);
+      }
+      drawSingle();
+      if (first.drawInstanced(instances, transformations, *this)) {
+        ++drawStats_.drawCalls;
+        drawStats_.drawablesInstanced += instances.size();
+        continue;
+      }
+    }
+
+    single.insert(single.end(), drawableTransforms.begin() + begin,
+                  drawableTransforms.begin() + end);
+  }
+  drawSingle();
+}
+
+size_t RenderCamera::cull(DrawableGroup& drawables,
+                          DrawableTransforms& drawableTransforms,
+                          Flags flags) {
+  drawStats_.drawablesSubmitted += drawables.size();
+  drawables.updateBvh();
+
+  // camera frustum relative to world origin; cleaning the camera's node
+  // updates the camera matrix, as Magnum does when drawing
+  node().setClean();
+  const Mn::Matrix4 cameraMat = cameraMatrix();
+  const Mn::Frustum frustum =
+      Mn::Frustum::fromMatrix(projectionMatrix() * cameraMat);
+
+  std::vector<Drawable*> visible;
+  size_t nonObjects = 0;
+  drawables.getBvh().query(frustum, [&](int leaf, bool contained) {
+    Drawable* drawable = drawables.getBvhDrawable(leaf);
+    scene::SceneNode& node = drawable->getSceneNode();
+    if ((flags & Flag::ObjectsOnly) &&
+        node.getType() != scene::SceneNodeType::OBJECT) {
+      ++nonObjects;
+      return;
+    }
+    // the leaf holds an enlarged box, so unless that is entirely inside the
+    // frustum, test the node's own box
+    if (!contained) {
+      Cr::Containers::Optional<int> culledPlane =
+          rangeFrustum(node.getAbsoluteAABB(), frustum,
+                       node.getFrustumPlaneIndex());
+      if (culledPlane) {
+        node.setFrustumPlaneIndex(*culledPlane);
+        return;
+      }
+    }
+    visible.push_back(drawable);
+  });
+  // the hierarchy order changes as drawables move, creation order does not
+  std::sort(visible.begin(), visible.end(), [](Drawable* a, Drawable* b) {
+    return a->getDrawableId() < b->getDrawableId();
+  });
+
+  std::vector<std::reference_wrapper<Mn::SceneGraph::AbstractObject3D>>
+      objects;
+  objects.reserve(visible.size());
+  for (Drawable* drawable : visible) {
+    objects.emplace_back(drawable->object());
+  }
+  Mn::SceneGraph::AbstractObject3D* scene = node().scene();
+  CORRADE_INTERNAL_ASSERT(scene);
+  const std::vector<Mn::Matrix4> transformations =
+      scene->transformationMatrices(objects, cameraMat);
+
+  drawableTransforms.clear();
+  drawableTransforms.reserve(visible.size());
+  for (size_t i = 0; i < visible.size(); ++i) {
+    drawableTransforms.emplace_back(*visible[i], transformations[i]);
+  }
+
+  drawStats_.drawablesCulled += drawables.size() - nonObjects - visible.size();
+  return drawableTransforms.size();
+}
+
 uint32_t RenderCamera::draw(MagnumDrawableGroup& drawables, Flags flags) {
+  auto* group = dynamic_cast<DrawableGroup*>(&drawables);
+  if (group && (flags & Flag::FrustumCulling)) {
+    DrawableTransforms drawableTransforms;
+    previousNumVisibleDrawables_ = cull(*group, drawableTransforms, flags);
+    return draw(drawableTransforms, flags);
+  }
+
   auto drawableTransforms = drawableTransformations(drawables);
   filterTransforms(drawableTransforms, flags);
   return draw(drawableTransforms, flags);
 }
 
+size_t RenderCamera::gatherWorldDrawables(MagnumDrawableGroup& drawables,
+                                          WorldDrawables& worldDrawables,
+                                          Flags flags) {
+  // collect the objects the same way Magnum's Camera does, but relative to
+  // the scene root instead of the camera, so the transformations can be
+  // shared by every viewpoint
+  std::vector<std::reference_wrapper<Mn::SceneGraph::AbstractObject3D>>
+      objects;
+  objects.reserve(drawables.size());
+  for (size_t i = 0; i < drawables.size(); ++i) {
+    objects.emplace_back(drawables[i].object());
+  }
+  Mn::SceneGraph::AbstractObject3D* scene = node().scene();
+  CORRADE_INTERNAL_ASSERT(scene);
+  const std::vector<Mn::Matrix4> transformations =
+      scene->transformationMatrices(objects);
+
+  worldDrawables.transforms.clear();
+  worldDrawables.centers.clear();
+  worldDrawables.halfExtents.clear();
+  worldDrawables.transforms.reserve(drawables.size());
+  worldDrawables.centers.reserve(drawables.size());
+  worldDrawables.halfExtents.reserve(drawables.size());
+  for (size_t i = 0; i < drawables.size(); ++i) {
+    auto& node = static_cast<scene::SceneNode&>(drawables[i].object());
+    if ((flags & Flag::ObjectsOnly) &&
+        node.getType() != scene::SceneNodeType::OBJECT) {
+      continue;
+    }
+    // This updates the AABB for dynamic objects if needed
+    node.setClean();
+    const Mn::Range3D& aabb = node.getAbsoluteAABB();
+    worldDrawables.transforms.emplace_back(drawables[i], transformations[i]);
+    worldDrawables.centers.push_back(aabb.center());
+    worldDrawables.halfExtents.push_back(aabb.size() * 0.5f);
+  }
+  return worldDrawables.transforms.size();
+}
+
+uint32_t RenderCamera::draw(const WorldDrawables& worldDrawables,
+                            Flags flags) {
+  const size_t numDrawables = worldDrawables.transforms.size();
+  drawStats_.drawablesSubmitted += numDrawables;
+
+  const Mn::Matrix4 cameraMat = cameraMatrix();
+  DrawableTransforms visibleTransforms;
+  visibleTransforms.reserve(numDrawables);
+
+  if (!(flags & Flag::FrustumCulling)) {
+    for (const auto& item : worldDrawables.transforms) {
+      visibleTransforms.emplace_back(item.first, cameraMat * item.second);
+    }
+    return draw(visibleTransforms, flags);
+  }
+
+  // camera frustum relative to world origin; the planes are unpacked once so
+  // the per-drawable test below is a fixed, branch-free loop
+  const Mn::Frustum frustum =
+      Mn::Frustum::fromMatrix(projectionMatrix() * cameraMat);
+  Mn::Vector3 planeNormals[6];
+  Mn::Vector3 absPlaneNormals[6];
+  float planeOffsets[6];
+  for (int iPlane = 0; iPlane < 6; ++iPlane) {
+    planeNormals[iPlane] = frustum[iPlane].xyz();
+    absPlaneNormals[iPlane] = Mn::Math::abs(planeNormals[iPlane]);
+    planeOffsets[iPlane] = frustum[iPlane].w();
+  }
+
+  const Mn::Vector3* centers = worldDrawables.centers.data();
+  const Mn::Vector3* halfExtents = worldDrawables.halfExtents.data();
+  for (size_t i = 0; i < numDrawables; ++i) {
+    bool visible = true;
+    for (int iPlane = 0; iPlane < 6; ++iPlane) {
+      const float d = Mn::Math::dot(centers[i], planeNormals[iPlane]);
+      const float r = Mn::Math::dot(halfExtents[i], absPlaneNormals[iPlane]);
+      visible &= (d + r >= -planeOffsets[iPlane]);
+    }
+    if (visible) {
+      const auto& item = worldDrawables.transforms[i];
+      visibleTransforms.emplace_back(item.first, cameraMat * item.second);
+    }
+  }
+
+  previousNumVisibleDrawables_ = visibleTransforms.size();
+  drawStats_.drawablesCulled += numDrawables - visibleTransforms.size();
+  return draw(visibleTransforms, flags);
+}
+
 size_t RenderCamera::filterTransforms(DrawableTransforms& drawableTransforms,
                                       Flags flags) {
   if (flags & Flag::UseDrawableIdAsObjectId) {
     useDrawableIds_ = true;
   }
 
+  drawStats_.drawablesSubmitted += drawableTransforms.size();
+
   if (flags & Flag::ObjectsOnly) {
     // draw just the OBJECTS
     size_t numObjects = removeNonObjects(drawableTransforms);
@@ -185,6 +579,8 @@ size_t RenderCamera::filterTransforms(DrawableTransforms& drawableTransforms,
   if (flags & Flag::FrustumCulling) {
     // draw just the visible part
     previousNumVisibleDrawables_ = cull(drawableTransforms);
+    drawStats_.drawablesCulled +=
+        drawableTransforms.size() - previousNumVisibleDrawables_;
     // erase all items that did not pass the frustum visibility test
     drawableTransforms.erase(
         drawableTransforms.begin() + previousNumVisibleDrawables_,
@@ -14,6 +14,8 @@
 namespace esp {
 namespace gfx {
 
+class DrawableGroup;
+
 class RenderCamera : public MagnumCamera {
  public:
   /**
@@ -53,6 +55,26 @@ class RenderCamera : public MagnumCamera {
      * Clear object id, used in the sub-class CubeMapCamera
      */
     ClearObjectId = 1 << 5,
+
+    /**
+     * Order the draws by shader, material and mesh, and front-to-back among
+     * draws sharing all three, to reduce GL state changes.
+     */
+    SortByState = 1 << 6,
+
+    /**
+     * Draw consecutive drawables sharing mesh and material with a single
+     * instanced draw call. Implies @ref Flag::SortByState, which brings such
+     * drawables together.
+     */
+    Instancing = 1 << 7,
+
+    /**
+     * Count the shader, material and mesh switches of the draws into @ref
+     * DrawStats even when the draws are not sorted. Without this flag, @ref
+     * Flag::SortByState or @ref Flag::Instancing, those counters stay at 0.
+     */
+    CollectStateStats = 1 << 8,
   };
 
   typedef Corrade::Containers::EnumSet<Flag> Flags;
@@ -63,6 +85,82 @@ class RenderCamera : public MagnumCamera {
                 Magnum::Matrix4>>
       DrawableTransforms;
 
+  /**
+   * @brief Counters accumulated by @ref filterTransforms and @ref draw since
+   * the last call to @ref resetDrawStats.
+   */
+  struct DrawStats {
+    /**
+     * @brief Number of drawables handed to @ref filterTransforms, before any
+     * culling.
+     */
+    size_t drawablesSubmitted = 0;
+    /**
+     * @brief Number of drawables removed by frustum culling. When culling
+     * through the group's hierarchy with @ref Flag::ObjectsOnly, non-object
+     * drawables outside the frustum are counted here too.
+     */
+    size_t drawablesCulled = 0;
+    /**
+     * @brief Number of drawables actually drawn.
+     */
+    size_t drawablesDrawn = 0;
+    /**
+     * @brief Number of triangles drawn, estimated from the index or vertex
+     * count of each drawn triangle mesh.
+     */
+    size_t trianglesDrawn = 0;
+    /**
+     * @brief Number of shader program switches between consecutive draws, in
+     * the order they were submitted. Only counted with @ref
+     * Flag::CollectStateStats, @ref Flag::SortByState or @ref
+     * Flag::Instancing, as are the state counters below.
+     */
+    size_t shaderChanges = 0;
+    /**
+     * @brief Number of material switches between consecutive draws.
+     */
+    size_t materialChanges = 0;
+    /**
+     * @brief Number of mesh switches between consecutive draws.
+     */
+    size_t meshChanges = 0;
+    /**
+     * @brief Sum of the three counters above in scene graph order, i.e. as
+     * they would be without @ref Flag::SortByState.
+     */
+    size_t stateChangesUnsorted = 0;
+    /**
+     * @brief Number of draw calls issued; an instanced draw counts once.
+     */
+    size_t drawCalls = 0;
+    /**
+     * @brief Number of drawables drawn as part of an instanced draw call.
+     */
+    size_t drawablesInstanced = 0;
+  };
+
+  /**
+   * @brief Drawables of a group together with their world transformations and
+   * world-space bounding boxes, gathered once by @ref gatherWorldDrawables and
+   * then culled and drawn from several viewpoints, e.g. the six faces of a
+   * @ref CubeMapCamera.
+   */
+  struct WorldDrawables {
+    /**
+     * @brief Drawables and their transformations relative to the scene root
+     */
+    DrawableTransforms transforms;
+    /**
+     * @brief Center of the absolute AABB of each drawable's node
+     */
+    std::vector<Magnum::Vector3> centers;
+    /**
+     * @brief Half size of the absolute AABB of each drawable's node
+     */
+    std::vector<Magnum::Vector3> halfExtents;
+  };
+
   /**
    * @brief Constructor
    * @param node the scene node to which the camera is attached
@@ -185,11 +283,40 @@ class RenderCamera : public MagnumCamera {
    * @param drawables a drawable group containing all the drawables
    * @param flags state flags to direct drawing
    * @return the number of drawables that are drawn
+   *
+   * With @ref Flag::FrustumCulling, drawables of a @ref DrawableGroup are
+   * culled through its bounding volume hierarchy, see @ref cull(DrawableGroup&,
+   * DrawableTransforms&, Flags).
    */
   uint32_t draw(MagnumDrawableGroup& drawables, Flags flags = {});
 
   uint32_t draw(DrawableTransforms& drawableTransforms, Flags flags = {});
 
+  /**
+   * @brief Cull the pre-gathered drawables against the current view frustum
+   * and render the visible ones
+   * @param worldDrawables drawables gathered by @ref gatherWorldDrawables
+   * @param flags state flags to direct drawing
+   * @return the number of drawables that are drawn
+   *
+   * Unlike @ref draw(MagnumDrawableGroup&, Flags), this does not walk the
+   * scene graph, so it is cheap to call once per viewpoint.
+   */
+  uint32_t draw(const WorldDrawables& worldDrawables, Flags flags = {});
+
+  /**
+   * @brief Compute the world transformations and bounding boxes of a drawable
+   * group once, to be drawn by @ref draw(const WorldDrawables&, Flags) from
+   * several viewpoints.
+   * @param drawables a drawable group containing all the drawables
+   * @param[out] worldDrawables filled with the gathered drawables
+   * @param flags state flags; only @ref Flag::ObjectsOnly is applied here
+   * @return the number of drawables gathered
+   */
+  size_t gatherWorldDrawables(MagnumDrawableGroup& drawables,
+                              WorldDrawables& worldDrawables,
+                              Flags flags = {});
+
   /**
    * @brief performs the frustum culling
    * @param drawableTransforms a vector of pairs of Drawable3D object and its
@@ -202,6 +329,24 @@ class RenderCamera : public MagnumCamera {
    */
   size_t cull(DrawableTransforms& drawableTransforms);
 
+  /**
+   * @brief Collect the drawables of a group visible from the camera, using
+   * the group's bounding volume hierarchy
+   * @param drawables the drawable group
+   * @param[out] drawableTransforms filled with the visible drawables, in
+   * order of creation, and their transformations relative to the camera
+   * @param flags state flags; only @ref Flag::ObjectsOnly is applied here
+   * @return the number of drawables that are not culled
+   *
+   * Subtrees outside the frustum are skipped and subtrees inside it accepted
+   * whole, so only drawables near the frustum boundary are tested. Only the
+   * transformations of visible drawables are computed. Accumulates the
+   * submitted and culled counters of @ref getDrawStats.
+   */
+  size_t cull(DrawableGroup& drawables,
+              DrawableTransforms& drawableTransforms,
+              Flags flags = {});
+
   /**
    * @brief Cull Drawables for SceneNodes which are not OBJECT type.
    *
@@ -242,8 +387,52 @@ class RenderCamera : public MagnumCamera {
     return previousNumVisibleDrawables_;
   }
 
+  /**
+   * @brief Set the on-screen size, in pixels, below which drawables switch to
+   * a simplified level of detail of their mesh, see @ref Drawable::selectLod.
+   * A drawable is measured by the projected diameter of the bounding sphere
+   * of its mesh. 0 (the default) always draws the full meshes.
+   */
+  RenderCamera& setLodThreshold(float pixels) {
+    lodThreshold_ = pixels;
+    return *this;
+  }
+
+  /** @brief The on-screen size below which simplified meshes are drawn */
+  float getLodThreshold() const { return lodThreshold_; }
+
+  /**
+   * @brief Query the draw counters accumulated since the last call to @ref
+   * resetDrawStats.
+   */
+  const DrawStats& getDrawStats() const { return drawStats_; }
+
+  /**
+   * @brief Reset the accumulated draw counters, e.g. at the start of a sensor
+   * observation.
+   */
+  void resetDrawStats() { drawStats_ = DrawStats{}; }
+
  protected:
+  /**
+   * @brief Draw runs of instance-compatible drawables with one instanced
+   * draw call each, and the remaining drawables one by one, in order
+   * @param drawableTransforms drawables and their transformations relative
+   * to the camera
+   */
+  void drawInstanced(const DrawableTransforms& drawableTransforms);
+
+  /**
+   * @brief Select the level of detail of each drawable from its projected
+   * size, see @ref setLodThreshold
+   * @param drawableTransforms drawables and their transformations relative
+   * to the camera
+   */
+  void selectLods(const DrawableTransforms& drawableTransforms);
+
   size_t previousNumVisibleDrawables_ = 0;
+  float lodThreshold_ = 0.0f;
+  DrawStats drawStats_;
   bool useDrawableIds_ = false;
   ESP_SMART_POINTERS(RenderCamera)
 };
@@ -39,5 +39,11 @@ void VarianceShadowMapDrawable::draw(const Mn::Matrix4& transformationMatrix,
   shader_->draw(getMesh());
 }
 
+Drawable::DrawState VarianceShadowMapDrawable::getDrawState() {
+  DrawState state = Drawable::getDrawState();
+  state.shader = static_cast<VarianceShadowMapShader*>(shader_);
+  return state;
+}
+
 }  // namespace gfx
 }  // namespace esp
@@ -23,6 +23,11 @@ class VarianceShadowMapDrawable : public DepthMapDrawableBase {
                                      ShaderManager& shaderManager,
                                      DrawableGroup* group);
 
+  /**
+   * @brief Get the shader and material this drawable binds when drawn
+   */
+  DrawState getDrawState() override;
+
  protected:
   /**
    * @brief Draw the object using given camera
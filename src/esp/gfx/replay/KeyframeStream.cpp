@@ -0,0 +1,305 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "KeyframeStream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Player.h"
+#include "Recorder.h"
+#include "esp/core/Check.h"
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+namespace {
+
+// messages larger than this are treated as a corrupt stream
+constexpr std::size_t MaxMessageSize = 1u << 30;
+
+#ifdef MSG_NOSIGNAL
+// a viewer closing its socket must not raise SIGPIPE in the simulator
+constexpr int SendFlags = MSG_NOSIGNAL;
+#else
+constexpr int SendFlags = 0;
+#endif
+
+void setNonBlocking(int socket) {
+  fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+  int enable = 1;
+  setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+}
+
+sockaddr_in localhostAddress(int port) {
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  return address;
+}
+
+/**
+ * @brief Merge @p src, the keyframe following @p dest, into @p dest
+ */
+void mergeKeyframe(const Keyframe& src, Keyframe& dest) {
+  dest.loads.insert(dest.loads.end(), src.loads.begin(), src.loads.end());
+  dest.creations.insert(dest.creations.end(), src.creations.begin(),
+                        src.creations.end());
+  for (const auto instanceKey : src.deletions) {
+    auto& updates = dest.stateUpdates;
+    updates.erase(std::remove_if(updates.begin(), updates.end(),
+                                 [&](const auto& pair) {
+                                   return pair.first == instanceKey;
+                                 }),
+                  updates.end());
+    auto it = std::find_if(
+        dest.creations.begin(), dest.creations.end(),
+        [&](const auto& pair) { return pair.first == instanceKey; });
+    if (it != dest.creations.end()) {
+      // a creation and deletion cancel out
+      dest.creations.erase(it);
+    } else {
+      dest.deletions.push_back(instanceKey);
+    }
+  }
+
+  std::unordered_map<RenderAssetInstanceKey, std::size_t> updateIndices;
+  for (std::size_t i = 0; i < dest.stateUpdates.size(); ++i) {
+    updateIndices.emplace(dest.stateUpdates[i].first, i);
+  }
+  for (const auto& update : src.stateUpdates) {
+    auto it = updateIndices.find(update.first);
+    if (it != updateIndices.end()) {
+      dest.stateUpdates[it->second].second = update.second;
+    } else {
+      updateIndices.emplace(update.first, dest.stateUpdates.size());
+      dest.stateUpdates.push_back(update);
+    }
+  }
+
+  // user transforms only hold for their own keyframe
+  dest.userTransforms = src.userTransforms;
+}
+
+}  // namespace
+
+KeyframeStreamServer::KeyframeStreamServer(int port) {
+  listenSocket_ = socket(AF_INET, SOCK_STREAM, 0);
+  ESP_CHECK(listenSocket_ != -1, "KeyframeStreamServer: unable to create a "
+                                 "socket:" << std::strerror(errno));
+  int reuse = 1;
+  setsockopt(listenSocket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in address = localhostAddress(port);
+  const bool listening =
+      bind(listenSocket_, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) == 0 &&
+      listen(listenSocket_, SOMAXCONN) == 0;
+  if (!listening) {
+    const int error = errno;
+    close(listenSocket_);
+    ESP_CHECK(false, "KeyframeStreamServer: unable to listen on port"
+                         << port << ":" << std::strerror(error));
+  }
+  setNonBlocking(listenSocket_);
+
+  socklen_t length = sizeof(address);
+  getsockname(listenSocket_, reinterpret_cast<sockaddr*>(&address), &length);
+  port_ = ntohs(address.sin_port);
+}
+
+KeyframeStreamServer::~KeyframeStreamServer() {
+  for (const auto& client : clients_) {
+    close(client.socket);
+  }
+  close(listenSocket_);
+}
+
+void KeyframeStreamServer::pushKeyframe(
+    const Keyframe& keyframe,
+    const TransformQuantization& quantization) {
+  quantization_ = quantization;
+
+  // skip what the viewers already have
+  Keyframe filtered;
+  for (const auto& load : keyframe.loads) {
+    auto it = std::find_if(sceneState_.loads.begin(), sceneState_.loads.end(),
+                           [&](const esp::assets::AssetInfo& loaded) {
+                             return loaded.filepath == load.filepath;
+                           });
+    if (it == sceneState_.loads.end()) {
+      filtered.loads.push_back(load);
+    }
+  }
+  for (const auto& creation : keyframe.creations) {
+    if (liveInstances_.insert(creation.first).second) {
+      filtered.creations.push_back(creation);
+    }
+  }
+  for (const auto instanceKey : keyframe.deletions) {
+    if (liveInstances_.erase(instanceKey) > 0) {
+      filtered.deletions.push_back(instanceKey);
+    }
+  }
+  filtered.stateUpdates = keyframe.stateUpdates;
+  filtered.userTransforms = keyframe.userTransforms;
+  mergeKeyframe(filtered, sceneState_);
+
+  for (auto& client : clients_) {
+    if (client.hasPending) {
+      mergeKeyframe(filtered, client.pending);
+      ++numDroppedKeyframes_;
+    } else {
+      client.pending = filtered;
+      client.hasPending = true;
+    }
+  }
+
+  poll();
+}
+
+void KeyframeStreamServer::poll() {
+  acceptClients();
+  clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                [&](Client& client) {
+                                  if (sendToClient(client)) {
+                                    return false;
+                                  }
+                                  close(client.socket);
+                                  return true;
+                                }),
+                 clients_.end());
+}
+
+void KeyframeStreamServer::acceptClients() {
+  while (true) {
+    const int socket = accept(listenSocket_, nullptr, nullptr);
+    if (socket == -1) {
+      return;
+    }
+    setNonBlocking(socket);
+    Client client;
+    client.socket = socket;
+    // a late viewer starts from the current scene
+    if (!sceneState_.loads.empty() || !sceneState_.creations.empty()) {
+      client.pending = sceneState_;
+      client.hasPending = true;
+    }
+    clients_.emplace_back(std::move(client));
+  }
+}
+
+bool KeyframeStreamServer::sendToClient(Client& client) {
+  while (true) {
+    if (client.messageOffset == client.message.size()) {
+      if (!client.hasPending) {
+        return true;
+      }
+      const std::string json =
+          Recorder::keyframeToString(client.pending, quantization_);
+      const auto size = static_cast<uint32_t>(json.size());
+      client.message.clear();
+      for (int i = 0; i < 4; ++i) {
+        client.message.push_back(char((size >> (8 * i)) & 0xff));
+      }
+      client.message += json;
+      client.messageOffset = 0;
+      client.pending = Keyframe{};
+      client.hasPending = false;
+    }
+
+    const ssize_t sent = send(
+        client.socket, client.message.data() + client.messageOffset,
+        client.message.size() - client.messageOffset, SendFlags);
+    if (sent < 0) {
+      // a full socket buffer means a slow viewer; keep it
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    client.messageOffset += std::size_t(sent);
+  }
+}
+
+KeyframeStreamClient::KeyframeStreamClient(int port) {
+  socket_ = socket(AF_INET, SOCK_STREAM, 0);
+  ESP_CHECK(socket_ != -1, "KeyframeStreamClient: unable to create a socket:"
+                               << std::strerror(errno));
+  sockaddr_in address = localhostAddress(port);
+  if (connect(socket_, reinterpret_cast<sockaddr*>(&address),
+              sizeof(address)) != 0) {
+    const int error = errno;
+    disconnect();
+    ESP_CHECK(false, "KeyframeStreamClient: unable to connect to port"
+                         << port << ":" << std::strerror(error));
+  }
+  setNonBlocking(socket_);
+}
+
+KeyframeStreamClient::~KeyframeStreamClient() {
+  disconnect();
+}
+
+void KeyframeStreamClient::disconnect() {
+  if (socket_ != -1) {
+    close(socket_);
+    socket_ = -1;
+  }
+}
+
+int KeyframeStreamClient::receiveKeyframes(Player& player) {
+  char chunk[65536];
+  while (socket_ != -1) {
+    const ssize_t received = recv(socket_, chunk, sizeof(chunk), 0);
+    if (received > 0) {
+      buffer_.append(chunk, std::size_t(received));
+    } else if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK &&
+                                 errno != EINTR)) {
+      ESP_DEBUG() << "Keyframe stream closed by the server.";
+      disconnect();
+    } else if (errno != EINTR) {
+      break;
+    }
+  }
+
+  int numKeyframes = 0;
+  std::size_t offset = 0;
+  while (buffer_.size() - offset >= 4) {
+    uint32_t size = 0;
+    for (int i = 0; i < 4; ++i) {
+      size |= uint32_t(static_cast<unsigned char>(buffer_[offset + i]))
+              << (8 * i);
+    }
+    if (size > MaxMessageSize) {
+      ESP_ERROR() << "Invalid keyframe stream message of" << size
+                  << "bytes, disconnecting.";
+      disconnect();
+      buffer_.clear();
+      return numKeyframes;
+    }
+    if (buffer_.size() - offset - 4 < size) {
+      break;
+    }
+    player.appendJSONKeyframe(buffer_.substr(offset + 4, size));
+    offset += 4 + size;
+    ++numKeyframes;
+  }
+  buffer_.erase(0, offset);
+  return numKeyframes;
+}
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
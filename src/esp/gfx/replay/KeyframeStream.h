@@ -0,0 +1,155 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_REPLAY_KEYFRAMESTREAM_H_
+#define ESP_GFX_REPLAY_KEYFRAMESTREAM_H_
+
+#include "Keyframe.h"
+#include "StateQuantizer.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+class Player;
+
+/**
+ * @brief Streams render keyframes to viewers connected over TCP on localhost.
+ *
+ * Each message is a keyframe as written by @ref Recorder::keyframeToString,
+ * preceded by its length as a 4-byte little-endian integer. See @ref
+ * KeyframeStreamClient for the receiving side and @ref
+ * Recorder::setKeyframeStreamServer to stream the keyframes of a recorder.
+ *
+ * The server never blocks. A viewer which can't keep up doesn't queue
+ * keyframes: keyframes pushed while its previous message is still being sent
+ * are merged into a single pending keyframe, so intermediate frames are
+ * dropped while creations, deletions and the latest state of every instance
+ * still arrive. A viewer connecting late first receives the current state of
+ * the scene.
+ */
+class KeyframeStreamServer {
+ public:
+  /**
+   * @brief Listen on 127.0.0.1.
+   * @param port The port to listen on, or 0 to pick a free port. See @ref
+   * getPort.
+   */
+  explicit KeyframeStreamServer(int port = 0);
+
+  ~KeyframeStreamServer();
+
+  KeyframeStreamServer(const KeyframeStreamServer&) = delete;
+  KeyframeStreamServer& operator=(const KeyframeStreamServer&) = delete;
+
+  /**
+   * @brief The port the server listens on.
+   */
+  int getPort() const { return port_; }
+
+  /**
+   * @brief The number of connected viewers, as of the last @ref poll.
+   */
+  int getNumClients() const { return int(clients_.size()); }
+
+  /**
+   * @brief The number of keyframes merged into another one instead of being
+   * sent separately, over all viewers.
+   */
+  int getNumDroppedKeyframes() const { return numDroppedKeyframes_; }
+
+  /**
+   * @brief Send a keyframe to all viewers.
+   *
+   * Loads and creations the viewers already got are skipped, so keyframes
+   * consolidated by @ref Recorder::writeSavedKeyframesToFile can be pushed
+   * as they are.
+   * @param keyframe The keyframe
+   * @param quantization How to serialize instance states
+   */
+  void pushKeyframe(const Keyframe& keyframe,
+                    const TransformQuantization& quantization = {});
+
+  /**
+   * @brief Accept new viewers and keep sending pending keyframes. Called by
+   * @ref pushKeyframe; call it in between if keyframes are pushed rarely.
+   */
+  void poll();
+
+ private:
+  struct Client {
+    int socket = -1;
+    // keyframes pushed since the last message was serialized, merged
+    Keyframe pending;
+    bool hasPending = false;
+    // the message being sent
+    std::string message;
+    std::size_t messageOffset = 0;
+  };
+
+  void acceptClients();
+  bool sendToClient(Client& client);
+
+  int listenSocket_ = -1;
+  int port_ = 0;
+  // everything pushed so far merged into one keyframe, for late viewers
+  Keyframe sceneState_;
+  // instances created and not deleted in sceneState_
+  std::unordered_set<RenderAssetInstanceKey> liveInstances_;
+  TransformQuantization quantization_;
+  std::vector<Client> clients_;
+  int numDroppedKeyframes_ = 0;
+
+  ESP_SMART_POINTERS(KeyframeStreamServer)
+};
+
+/**
+ * @brief Receives render keyframes from a @ref KeyframeStreamServer.
+ */
+class KeyframeStreamClient {
+ public:
+  /**
+   * @brief Connect to a server on 127.0.0.1.
+   */
+  explicit KeyframeStreamClient(int port);
+
+  ~KeyframeStreamClient();
+
+  KeyframeStreamClient(const KeyframeStreamClient&) = delete;
+  KeyframeStreamClient& operator=(const KeyframeStreamClient&) = delete;
+
+  /**
+   * @brief Whether the server is still connected.
+   */
+  bool isConnected() const { return socket_ != -1; }
+
+  /**
+   * @brief Append the keyframes received since the last call to @p player,
+   * without blocking.
+   * @return The number of keyframes appended
+   *
+   * Keyframes only hold changes, so apply all of them in order, e.g. with
+   * @ref Player::setKeyframeIndex to the last one.
+   */
+  int receiveKeyframes(Player& player);
+
+ private:
+  void disconnect();
+
+  int socket_ = -1;
+  // bytes received but not yet parsed
+  std::string buffer_;
+
+  ESP_SMART_POINTERS(KeyframeStreamClient)
+};
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
+
+#endif
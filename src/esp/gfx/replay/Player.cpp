@@ -16,14 +16,45 @@ namespace replay {
 
 void Player::readKeyframesFromJsonDocument(const rapidjson::Document& d) {
   CORRADE_INTERNAL_ASSERT(keyframes_.empty());
-  esp::io::readMember(d, "keyframes", keyframes_);
+  TransformQuantization quantization;
+  if (!esp::io::readMember(d, "quantization", quantization)) {
+    esp::io::readMember(d, "keyframes", keyframes_);
+    return;
+  }
+
+  // delta-encoded states need the keyframes decoded in order
+  StateQuantizer quantizer{quantization};
+  auto itr = d.FindMember("keyframes");
+  if (itr == d.MemberEnd() || !itr->value.IsArray()) {
+    return;
+  }
+  keyframes_.reserve(itr->value.Size());
+  for (const auto& keyframeObj : itr->value.GetArray()) {
+    Keyframe keyframe;
+    if (!esp::io::keyframeFromJsonValue(keyframeObj, quantizer, keyframe)) {
+      ESP_ERROR() << "Failed to parse quantized keyframe"
+                  << keyframes_.size();
+      keyframes_.clear();
+      return;
+    }
+    keyframes_.emplace_back(std::move(keyframe));
+  }
 }
 
 Keyframe Player::keyframeFromString(const std::string& keyframe) {
   Keyframe res;
   rapidjson::Document d;
   d.Parse<0>(keyframe.c_str());
-  esp::io::readMember(d, "keyframe", res);
+  TransformQuantization quantization;
+  if (esp::io::readMember(d, "quantization", quantization)) {
+    StateQuantizer quantizer{quantization};
+    auto itr = d.FindMember("keyframe");
+    if (itr != d.MemberEnd()) {
+      esp::io::keyframeFromJsonValue(itr->value, quantizer, res);
+    }
+  } else {
+    esp::io::readMember(d, "keyframe", res);
+  }
   return res;
 }
 
@@ -45,6 +76,17 @@ void Player::readKeyframesFromFile(const std::string& filepath) {
   }
 }
 
+void Player::readKeyframesFromString(const std::string& keyframes) {
+  close();
+
+  try {
+    auto newDoc = esp::io::parseJsonString(keyframes);
+    readKeyframesFromJsonDocument(newDoc);
+  } catch (...) {
+    ESP_ERROR() << "Failed to parse keyframes from string.";
+  }
+}
+
 Player::~Player() {
   clearFrame();
 }
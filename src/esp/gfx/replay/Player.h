@@ -60,6 +60,13 @@ class Player {
    */
   void readKeyframesFromFile(const std::string& filepath);
 
+  /**
+   * @brief Read keyframes from a string. See also @ref
+   * Recorder::writeSavedKeyframesToString.
+   * @param keyframes
+   */
+  void readKeyframesFromString(const std::string& keyframes);
+
   /**
    * @brief Given a JSON string encoding a keyframe, returns the keyframe
    * itself.
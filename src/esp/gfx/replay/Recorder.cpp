@@ -4,34 +4,69 @@
 
 #include "Recorder.h"
 
+#include <algorithm>
+
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/core/Check.h"
 #include "esp/io/Json.h"
 #include "esp/io/JsonAllTypes.h"
 #include "esp/scene/SceneNode.h"
 
+#include "KeyframeStream.h"
+
 namespace esp {
 namespace gfx {
 namespace replay {
 
 /**
  * @brief Helper class to get notified when a SceneNode is about to be
- * destroyed.
+ * destroyed, or when it (or one of its parents) moves.
+ *
+ * The scene graph only notifies features of clean nodes, so the recorder
+ * cleans a node after reading its state. The absolute transformation computed
+ * when the node is cleaned, by the recorder or anyone else, is cached here.
  */
 class NodeDeletionHelper : public Magnum::SceneGraph::AbstractFeature3D {
  public:
   NodeDeletionHelper(scene::SceneNode& node_, Recorder* writer)
       : Magnum::SceneGraph::AbstractFeature3D(node_),
         node(&node_),
-        recorder_(writer) {}
+        recorder_(writer),
+        absoluteTransformation_(node_.absoluteTransformationMatrix()) {
+    setCachedTransformations(
+        Magnum::SceneGraph::CachedTransformation::Absolute);
+  }
 
   ~NodeDeletionHelper() override {
-    recorder_->onDeleteRenderAssetInstance(node);
+    if (recorder_) {
+      recorder_->onDeleteRenderAssetInstance(node);
+    }
+  }
+
+  /**
+   * @brief Stop notifying the recorder, which is about to be destroyed
+   */
+  void detach() { recorder_ = nullptr; }
+
+  /**
+   * @brief Absolute transformation of the node as of the last time it was
+   * cleaned
+   */
+  const Magnum::Matrix4& absoluteTransformation() const {
+    return absoluteTransformation_;
+  }
+
+ protected:
+  void markDirty() override { recorder_->onRenderAssetInstanceDirty(node); }
+
+  void clean(const Magnum::Matrix4& absoluteTransformationMatrix) override {
+    absoluteTransformation_ = absoluteTransformationMatrix;
   }
 
  private:
   Recorder* recorder_ = nullptr;
   const scene::SceneNode* node = nullptr;
+  Magnum::Matrix4 absoluteTransformation_;
 };
 
 Recorder::~Recorder() {
@@ -39,6 +74,7 @@ Recorder::~Recorder() {
   // pointers to this Recorder and these pointers would become dangling
   // (invalid) after this Recorder is destroyed.
   for (auto& instanceRecord : instanceRecords_) {
+    instanceRecord.deletionHelper->detach();
     delete instanceRecord.deletionHelper;
   }
 }
@@ -73,13 +109,19 @@ void Recorder::onCreateRenderAssetInstance(
   // manually later if necessary.
   NodeDeletionHelper* deletionHelper = new NodeDeletionHelper{*node, this};
 
+  instanceIndices_.emplace(node, int(instanceRecords_.size()));
   instanceRecords_.emplace_back(InstanceRecord{
       node, instanceKey, Corrade::Containers::NullOpt, deletionHelper});
+  // the first keyframe always records the state
+  markInstanceDirty(instanceRecords_.back());
 }
 
 void Recorder::saveKeyframe() {
   updateInstanceStates();
   advanceKeyframe();
+  if (streamServer_) {
+    streamServer_->pushKeyframe(savedKeyframes_.back(), quantization_);
+  }
 }
 
 const Keyframe& Recorder::getLatestKeyframe() {
@@ -135,7 +177,28 @@ void Recorder::onDeleteRenderAssetInstance(const scene::SceneNode* node) {
 
   checkAndAddDeletion(&getKeyframe(), instanceKey);
 
-  instanceRecords_.erase(instanceRecords_.begin() + index);
+  // move the last record into the gap; a stale entry of the node in
+  // dirtyNodes_ is skipped once the node is no longer found
+  instanceIndices_.erase(node);
+  if (index != int(instanceRecords_.size()) - 1) {
+    instanceRecords_[index] = instanceRecords_.back();
+    instanceIndices_[instanceRecords_[index].node] = index;
+  }
+  instanceRecords_.pop_back();
+}
+
+void Recorder::onRenderAssetInstanceDirty(const scene::SceneNode* node) {
+  int index = findInstance(node);
+  if (index != ID_UNDEFINED) {
+    markInstanceDirty(instanceRecords_[index]);
+  }
+}
+
+void Recorder::markInstanceDirty(InstanceRecord& record) {
+  if (!record.dirty) {
+    record.dirty = true;
+    dirtyNodes_.push_back(record.node);
+  }
 }
 
 Keyframe& Recorder::getKeyframe() {
@@ -147,28 +210,60 @@ RenderAssetInstanceKey Recorder::getNewInstanceKey() {
 }
 
 int Recorder::findInstance(const scene::SceneNode* queryNode) {
-  auto it = std::find_if(instanceRecords_.begin(), instanceRecords_.end(),
-                         [&queryNode](const InstanceRecord& record) {
-                           return record.node == queryNode;
-                         });
-
-  return it == instanceRecords_.end() ? ID_UNDEFINED
-                                      : int(it - instanceRecords_.begin());
+  auto it = instanceIndices_.find(queryNode);
+  return it == instanceIndices_.end() ? ID_UNDEFINED : it->second;
 }
 
 RenderAssetInstanceState Recorder::getInstanceState(
-    const scene::SceneNode* node) {
-  const auto absTransformMat = node->absoluteTransformation();
+    const InstanceRecord& record) {
+  // cleaning the node re-arms its dirty notification, and refreshes the
+  // transformation cached by its helper if it was not clean yet
+  record.node->setClean();
+  const auto& absTransformMat =
+      record.deletionHelper->absoluteTransformation();
   Transform absTransform{
       absTransformMat.translation(),
       Magnum::Quaternion::fromMatrix(absTransformMat.rotationShear())};
 
-  return RenderAssetInstanceState{absTransform, node->getSemanticId()};
+  return RenderAssetInstanceState{absTransform, record.node->getSemanticId()};
+}
+
+void Recorder::setTransformQuantization(
+    const TransformQuantization& quantization) {
+  if (quantization.isEnabled()) {
+    // validates the settings
+    StateQuantizer{quantization};
+  }
+  quantization_ = quantization;
 }
 
 void Recorder::updateInstanceStates() {
-  for (auto& instanceRecord : instanceRecords_) {
-    auto state = getInstanceState(instanceRecord.node);
+  Corrade::Containers::Optional<StateQuantizer> quantizer;
+  if (quantization_.isEnabled()) {
+    quantizer.emplace(quantization_);
+  }
+
+  // record in creation order, as the keys are handed out
+  std::vector<int> dirtyIndices;
+  dirtyIndices.reserve(dirtyNodes_.size());
+  for (const scene::SceneNode* node : dirtyNodes_) {
+    int index = findInstance(node);
+    if (index != ID_UNDEFINED && instanceRecords_[index].dirty) {
+      instanceRecords_[index].dirty = false;
+      dirtyIndices.push_back(index);
+    }
+  }
+  dirtyNodes_.clear();
+  std::sort(dirtyIndices.begin(), dirtyIndices.end(), [&](int a, int b) {
+    return instanceRecords_[a].instanceKey < instanceRecords_[b].instanceKey;
+  });
+
+  for (int index : dirtyIndices) {
+    auto& instanceRecord = instanceRecords_[index];
+    auto state = getInstanceState(instanceRecord);
+    if (quantizer) {
+      state = quantizer->roundTrip(state);
+    }
     if (!instanceRecord.recentState || state != instanceRecord.recentState) {
       getKeyframe().stateUpdates.emplace_back(instanceRecord.instanceKey,
                                               state);
@@ -203,12 +298,52 @@ std::string Recorder::writeSavedKeyframesToString() {
 }
 
 std::string Recorder::keyframeToString(const Keyframe& keyframe) {
+  return keyframeToString(keyframe, quantization_);
+}
+
+std::string Recorder::keyframeToString(
+    const Keyframe& keyframe,
+    const TransformQuantization& quantization) {
   rapidjson::Document d(rapidjson::kObjectType);
   rapidjson::Document::AllocatorType& allocator = d.GetAllocator();
-  esp::io::addMember(d, "keyframe", keyframe, allocator);
+  if (quantization.isEnabled()) {
+    // a standalone keyframe, so no deltas
+    StateQuantizer quantizer{quantization};
+    esp::io::addMember(d, "quantization", quantization, allocator);
+    auto keyframeObj =
+        esp::io::keyframeToJsonValue(keyframe, quantizer, allocator);
+    esp::io::addMember(d, "keyframe", keyframeObj, allocator);
+  } else {
+    esp::io::addMember(d, "keyframe", keyframe, allocator);
+  }
   return esp::io::jsonToString(d);
 }
 
+void Recorder::setKeyframeStreamServer(
+    std::shared_ptr<KeyframeStreamServer> server) {
+  streamServer_ = std::move(server);
+  if (!streamServer_ || savedKeyframes_.empty()) {
+    // anything else is still in the current keyframe
+    return;
+  }
+
+  Keyframe history;
+  addLoadsCreationsDeletions(savedKeyframes_.begin(), savedKeyframes_.end(),
+                             &history);
+  std::unordered_map<RenderAssetInstanceKey, int> recordIndices;
+  for (int i = 0; i < int(instanceRecords_.size()); ++i) {
+    recordIndices.emplace(instanceRecords_[i].instanceKey, i);
+  }
+  for (const auto& creation : history.creations) {
+    auto it = recordIndices.find(creation.first);
+    if (it != recordIndices.end() && instanceRecords_[it->second].recentState) {
+      history.stateUpdates.emplace_back(
+          creation.first, *instanceRecords_[it->second].recentState);
+    }
+  }
+  streamServer_->pushKeyframe(history, quantization_);
+}
+
 void Recorder::consolidateSavedKeyframes() {
   // consolidate saved keyframes into current keyframe
   addLoadsCreationsDeletions(savedKeyframes_.begin(), savedKeyframes_.end(),
@@ -217,6 +352,7 @@ void Recorder::consolidateSavedKeyframes() {
   // saved keyframe.
   for (auto& instanceRecord : instanceRecords_) {
     instanceRecord.recentState = Corrade::Containers::NullOpt;
+    markInstanceDirty(instanceRecord);
   }
   savedKeyframes_.clear();
 }
@@ -229,7 +365,21 @@ rapidjson::Document Recorder::writeKeyframesToJsonDocument() {
 
   rapidjson::Document d(rapidjson::kObjectType);
   rapidjson::Document::AllocatorType& allocator = d.GetAllocator();
-  esp::io::addMember(d, "keyframes", savedKeyframes_, allocator);
+  if (!quantization_.isEnabled()) {
+    esp::io::addMember(d, "keyframes", savedKeyframes_, allocator);
+    return d;
+  }
+
+  // each document starts without previous states, so it can be read alone
+  StateQuantizer quantizer{quantization_};
+  esp::io::addMember(d, "quantization", quantization_, allocator);
+  rapidjson::Value keyframesArray(rapidjson::kArrayType);
+  for (const auto& keyframe : savedKeyframes_) {
+    auto keyframeObj =
+        esp::io::keyframeToJsonValue(keyframe, quantizer, allocator);
+    keyframesArray.PushBack(keyframeObj, allocator);
+  }
+  esp::io::addMember(d, "keyframes", keyframesArray, allocator);
   return d;
 }
 
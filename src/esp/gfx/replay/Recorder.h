@@ -6,10 +6,13 @@
 #define ESP_GFX_REPLAY_RECORDER_H_
 
 #include "Keyframe.h"
+#include "StateQuantizer.h"
 
 #include <rapidjson/document.h>
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace esp {
 namespace assets {
@@ -22,6 +25,7 @@ class SceneNode;
 namespace gfx {
 namespace replay {
 
+class KeyframeStreamServer;
 class NodeDeletionHelper;
 
 /**
@@ -34,6 +38,11 @@ class NodeDeletionHelper;
  * transforms" which can be used to store cameras, agents, or other
  * application-specific objects. See also @ref Player. See
  * examples/replay_tutorial.py for usage of this class through bindings.
+ *
+ * Instance nodes notify the recorder when they (or one of their parents) move,
+ * so @ref saveKeyframe only revisits instances which moved since the previous
+ * keyframe and its cost scales with the number of moving instances rather than
+ * with the size of the scene.
  */
 class Recorder {
  public:
@@ -90,6 +99,20 @@ class Recorder {
                                   const Magnum::Vector3& translation,
                                   const Magnum::Quaternion& rotation);
 
+  /**
+   * @brief Quantize instance transforms when saving keyframes and delta-encode
+   * them when writing keyframes out. See @ref TransformQuantization.
+   *
+   * States are quantized as they are saved, so the saved keyframes hold what
+   * a @ref Player reads back, and motion below the quantization step records
+   * no state update. Only affects keyframes saved from now on.
+   */
+  void setTransformQuantization(const TransformQuantization& quantization);
+
+  const TransformQuantization& getTransformQuantization() const {
+    return quantization_;
+  }
+
   /**
    * @brief write saved keyframes to file.
    * @param filepath
@@ -110,6 +133,26 @@ class Recorder {
    */
   std::string keyframeToString(const Keyframe& keyframe);
 
+  /**
+   * @brief returns JSONized version of given keyframe, with instance states
+   * quantized as given.
+   */
+  static std::string keyframeToString(
+      const Keyframe& keyframe,
+      const TransformQuantization& quantization);
+
+  /**
+   * @brief Push every saved keyframe to @p server, or pass nullptr to stop.
+   *
+   * The server first gets the loads, creations and instance states of the
+   * keyframes saved so far, so its viewers can join a running recording.
+   */
+  void setKeyframeStreamServer(std::shared_ptr<KeyframeStreamServer> server);
+
+  std::shared_ptr<KeyframeStreamServer> getKeyframeStreamServer() const {
+    return streamServer_;
+  }
+
   /**
    * @brief Reserved for unit-testing.
    */
@@ -118,7 +161,8 @@ class Recorder {
   }
 
  private:
-  // NodeDeletionHelper calls onDeleteRenderAssetInstance
+  // NodeDeletionHelper calls onDeleteRenderAssetInstance and
+  // onRenderAssetInstanceDirty
   friend class NodeDeletionHelper;
 
   // Helper for tracking render asset instances
@@ -127,17 +171,21 @@ class Recorder {
     RenderAssetInstanceKey instanceKey = ID_UNDEFINED;
     Corrade::Containers::Optional<RenderAssetInstanceState> recentState;
     NodeDeletionHelper* deletionHelper = nullptr;
+    // whether the node is queued in dirtyNodes_
+    bool dirty = false;
   };
 
   using KeyframeIterator = std::vector<Keyframe>::const_iterator;
 
   rapidjson::Document writeKeyframesToJsonDocument();
   void onDeleteRenderAssetInstance(const scene::SceneNode* node);
+  void onRenderAssetInstanceDirty(const scene::SceneNode* node);
+  void markInstanceDirty(InstanceRecord& record);
   Keyframe& getKeyframe();
   void advanceKeyframe();
   RenderAssetInstanceKey getNewInstanceKey();
   int findInstance(const scene::SceneNode* queryNode);
-  RenderAssetInstanceState getInstanceState(const scene::SceneNode* node);
+  RenderAssetInstanceState getInstanceState(const InstanceRecord& record);
   void updateInstanceStates();
   void checkAndAddDeletion(Keyframe* keyframe,
                            RenderAssetInstanceKey instanceKey);
@@ -147,9 +195,15 @@ class Recorder {
   void consolidateSavedKeyframes();
 
   std::vector<InstanceRecord> instanceRecords_;
+  // index into instanceRecords_ of each instance's node
+  std::unordered_map<const scene::SceneNode*, int> instanceIndices_;
+  // nodes which moved since the last keyframe; may hold deleted nodes
+  std::vector<const scene::SceneNode*> dirtyNodes_;
   Keyframe currKeyframe_;
   std::vector<Keyframe> savedKeyframes_;
   RenderAssetInstanceKey nextInstanceKey_ = 0;
+  TransformQuantization quantization_;
+  std::shared_ptr<KeyframeStreamServer> streamServer_;
 
   ESP_SMART_POINTERS(Recorder)
 };
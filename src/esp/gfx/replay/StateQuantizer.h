@@ -0,0 +1,219 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_REPLAY_STATEQUANTIZER_H_
+#define ESP_GFX_REPLAY_STATEQUANTIZER_H_
+
+#include "Keyframe.h"
+
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Vector4.h>
+
+#include <cmath>
+#include <unordered_map>
+
+#include "esp/core/Check.h"
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+/**
+ * @brief How instance transforms are quantized when keyframes are serialized.
+ * See @ref StateQuantizer.
+ */
+struct TransformQuantization {
+  /**
+   * @brief Translations are rounded to multiples of this step (e.g. 0.001 for
+   * millimeters). 0 disables quantization and keyframes store full floats.
+   */
+  float translationStep = 0.0f;
+  /**
+   * @brief Bits per stored component of the "smallest three" rotation
+   * encoding, 2 to 10. The largest quaternion component is dropped and
+   * recomputed on load, so rotations take 3 * bits + 2 bits.
+   */
+  int rotationBits = 10;
+
+  bool isEnabled() const { return translationStep > 0.0f; }
+
+  bool operator==(const TransformQuantization& rhs) const {
+    return translationStep == rhs.translationStep &&
+           rotationBits == rhs.rotationBits;
+  }
+};
+
+/**
+ * @brief A @ref RenderAssetInstanceState with its transform quantized
+ */
+struct QuantizedInstanceState {
+  //! translation in multiples of @ref TransformQuantization::translationStep
+  Magnum::Vector3i translation;
+  //! rotation packed by @ref packRotation
+  Magnum::UnsignedInt rotation = 0;
+  int semanticId = ID_UNDEFINED;
+
+  bool operator==(const QuantizedInstanceState& rhs) const {
+    return translation == rhs.translation && rotation == rhs.rotation &&
+           semanticId == rhs.semanticId;
+  }
+};
+
+//! range of the three smallest components of a unit quaternion
+constexpr float SmallestThreeRange = 0.70710678f;
+
+/**
+ * @brief Pack a unit quaternion into 3 * @p bits + 2 bits with the "smallest
+ * three" encoding.
+ *
+ * The largest component (in absolute value) is dropped after flipping the
+ * quaternion's sign to make it positive, and the other three, which lie in
+ * [-1/sqrt(2), 1/sqrt(2)], are stored with @p bits bits each.
+ */
+inline Magnum::UnsignedInt packRotation(const Magnum::Quaternion& rotation,
+                                        int bits) {
+  const Magnum::Vector4 q{rotation.vector(), rotation.scalar()};
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (Magnum::Math::abs(q[i]) > Magnum::Math::abs(q[largest])) {
+      largest = i;
+    }
+  }
+  // q and -q are the same rotation; make the dropped component positive
+  const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+  const float maxValue = float((1u << bits) - 1);
+
+  Magnum::UnsignedInt packed = Magnum::UnsignedInt(largest);
+  for (int i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+    const float normalized = Magnum::Math::clamp(
+        (sign * q[i] + SmallestThreeRange) / (2.0f * SmallestThreeRange), 0.0f,
+        1.0f);
+    packed = (packed << bits) |
+             Magnum::UnsignedInt(Magnum::Math::round(normalized * maxValue));
+  }
+  return packed;
+}
+
+/**
+ * @brief Unpack a rotation packed by @ref packRotation
+ */
+inline Magnum::Quaternion unpackRotation(Magnum::UnsignedInt packed,
+                                         int bits) {
+  const Magnum::UnsignedInt mask = (1u << bits) - 1;
+  const int largest = int(packed >> (3 * bits)) & 3;
+
+  Magnum::Vector4 q;
+  float sumOfSquares = 0.0f;
+  int shift = 2 * bits;
+  for (int i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+    const float normalized = float((packed >> shift) & mask) / float(mask);
+    q[i] = (2.0f * normalized - 1.0f) * SmallestThreeRange;
+    sumOfSquares += q[i] * q[i];
+    shift -= bits;
+  }
+  q[largest] = std::sqrt(Magnum::Math::max(1.0f - sumOfSquares, 0.0f));
+  return Magnum::Quaternion{q.xyz(), q.w()}.normalized();
+}
+
+/**
+ * @brief Quantizes instance states and delta-encodes them per instance.
+ *
+ * Keyframes are serialized and read back in order through one quantizer,
+ * which remembers the last state of each instance; see @ref
+ * io::keyframeToJsonValue. Quantized values are integers, so deltas between
+ * them accumulate no error.
+ */
+class StateQuantizer {
+ public:
+  explicit StateQuantizer(const TransformQuantization& quantization)
+      : quantization_(quantization) {
+    ESP_CHECK(quantization_.translationStep > 0.0f,
+              "StateQuantizer: translation step must be positive, got"
+                  << quantization_.translationStep);
+    ESP_CHECK(
+        quantization_.rotationBits >= 2 && quantization_.rotationBits <= 10,
+        "StateQuantizer: rotation bits must be in [2, 10], got"
+            << quantization_.rotationBits);
+  }
+
+  const TransformQuantization& getQuantization() const {
+    return quantization_;
+  }
+
+  QuantizedInstanceState quantize(
+      const RenderAssetInstanceState& state) const {
+    QuantizedInstanceState result;
+    result.translation = Magnum::Vector3i{Magnum::Math::round(
+        state.absTransform.translation / quantization_.translationStep)};
+    result.rotation =
+        packRotation(state.absTransform.rotation, quantization_.rotationBits);
+    result.semanticId = state.semanticId;
+    return result;
+  }
+
+  RenderAssetInstanceState dequantize(
+      const QuantizedInstanceState& state) const {
+    RenderAssetInstanceState result;
+    result.absTransform.translation =
+        Magnum::Vector3{state.translation} * quantization_.translationStep;
+    result.absTransform.rotation =
+        unpackRotation(state.rotation, quantization_.rotationBits);
+    result.semanticId = state.semanticId;
+    return result;
+  }
+
+  /**
+   * @brief Quantize and dequantize @p state, giving the state a reader of the
+   * serialized keyframes sees
+   */
+  RenderAssetInstanceState roundTrip(
+      const RenderAssetInstanceState& state) const {
+    return dequantize(quantize(state));
+  }
+
+  /**
+   * @brief The state last stored for @p instanceKey, or nullptr
+   */
+  const QuantizedInstanceState* findPrevious(
+      RenderAssetInstanceKey instanceKey) const {
+    auto it = previousStates_.find(instanceKey);
+    return it == previousStates_.end() ? nullptr : &it->second;
+  }
+
+  /**
+   * @brief Store @p state as the state delta encodings of @p instanceKey are
+   * relative to
+   */
+  void setPrevious(RenderAssetInstanceKey instanceKey,
+                   const QuantizedInstanceState& state) {
+    previousStates_[instanceKey] = state;
+  }
+
+  /**
+   * @brief Forget the state of a deleted instance
+   */
+  void erasePrevious(RenderAssetInstanceKey instanceKey) {
+    previousStates_.erase(instanceKey);
+  }
+
+ private:
+  TransformQuantization quantization_;
+  std::unordered_map<RenderAssetInstanceKey, QuantizedInstanceState>
+      previousStates_;
+
+  ESP_SMART_POINTERS(StateQuantizer)
+};
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
+
+#endif
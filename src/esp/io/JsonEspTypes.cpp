@@ -7,8 +7,85 @@
 namespace esp {
 namespace io {
 
-JsonGenericValue toJsonValue(const gfx::replay::Keyframe& keyframe,
-                             JsonAllocator& allocator) {
+namespace {
+
+/**
+ * @brief Write a state update as the quantized state if the instance has no
+ * previous state in @p quantizer, otherwise as the changes to it. Returns
+ * false if nothing changed after quantization.
+ */
+bool addQuantizedStateMembers(
+    JsonGenericValue& stateObj,
+    gfx::replay::RenderAssetInstanceKey instanceKey,
+    const gfx::replay::RenderAssetInstanceState& state,
+    gfx::replay::StateQuantizer& quantizer,
+    JsonAllocator& allocator) {
+  const gfx::replay::QuantizedInstanceState quantized =
+      quantizer.quantize(state);
+  const gfx::replay::QuantizedInstanceState* previous =
+      quantizer.findPrevious(instanceKey);
+  if (!previous) {
+    io::addMember(stateObj, "t", quantized.translation, allocator);
+    io::addMember(stateObj, "r", quantized.rotation, allocator);
+    io::addMember(stateObj, "semanticId", quantized.semanticId, allocator);
+  } else {
+    if (*previous == quantized) {
+      return false;
+    }
+    // small integers, which take few characters
+    io::addMember(stateObj, "dt", quantized.translation - previous->translation,
+                  allocator);
+    if (quantized.rotation != previous->rotation) {
+      io::addMember(stateObj, "r", quantized.rotation, allocator);
+    }
+    if (quantized.semanticId != previous->semanticId) {
+      io::addMember(stateObj, "semanticId", quantized.semanticId, allocator);
+    }
+  }
+  quantizer.setPrevious(instanceKey, quantized);
+  return true;
+}
+
+bool readQuantizedStateMembers(
+    const JsonGenericValue& stateObj,
+    gfx::replay::RenderAssetInstanceKey instanceKey,
+    gfx::replay::StateQuantizer& quantizer,
+    gfx::replay::RenderAssetInstanceState& state) {
+  gfx::replay::QuantizedInstanceState quantized;
+  if (stateObj.HasMember("t")) {
+    bool success = true;
+    success &= io::readMember(stateObj, "t", quantized.translation);
+    success &= io::readMember(stateObj, "r", quantized.rotation);
+    success &= io::readMember(stateObj, "semanticId", quantized.semanticId);
+    if (!success) {
+      return false;
+    }
+  } else {
+    const gfx::replay::QuantizedInstanceState* previous =
+        quantizer.findPrevious(instanceKey);
+    if (!previous) {
+      ESP_ERROR() << "Delta-encoded state of instance" << instanceKey
+                  << "has no previous state";
+      return false;
+    }
+    quantized = *previous;
+    Magnum::Vector3i delta;
+    if (!io::readMember(stateObj, "dt", delta)) {
+      return false;
+    }
+    quantized.translation += delta;
+    io::readMember(stateObj, "r", quantized.rotation);
+    io::readMember(stateObj, "semanticId", quantized.semanticId);
+  }
+  quantizer.setPrevious(instanceKey, quantized);
+  state = quantizer.dequantize(quantized);
+  return true;
+}
+
+JsonGenericValue keyframeToJsonValueImpl(
+    const gfx::replay::Keyframe& keyframe,
+    gfx::replay::StateQuantizer* quantizer,
+    JsonAllocator& allocator) {
   JsonGenericValue obj(rapidjson::kObjectType);
 
   io::addMember(obj, "loads", keyframe.loads, allocator);
@@ -32,10 +109,22 @@ JsonGenericValue toJsonValue(const gfx::replay::Keyframe& keyframe,
     for (const auto& pair : keyframe.stateUpdates) {
       JsonGenericValue stateObj(rapidjson::kObjectType);
       io::addMember(stateObj, "instanceKey", pair.first, allocator);
-      io::addMember(stateObj, "state", pair.second, allocator);
+      if (!quantizer) {
+        io::addMember(stateObj, "state", pair.second, allocator);
+      } else if (!addQuantizedStateMembers(stateObj, pair.first, pair.second,
+                                           *quantizer, allocator)) {
+        continue;
+      }
       stateUpdatesArray.PushBack(stateObj, allocator);
     }
-    io::addMember(obj, "stateUpdates", stateUpdatesArray, allocator);
+    if (!stateUpdatesArray.Empty()) {
+      io::addMember(obj, "stateUpdates", stateUpdatesArray, allocator);
+    }
+  }
+  if (quantizer) {
+    for (const auto& instanceKey : keyframe.deletions) {
+      quantizer->erasePrevious(instanceKey);
+    }
   }
 
   if (!keyframe.userTransforms.empty()) {
@@ -52,8 +141,9 @@ JsonGenericValue toJsonValue(const gfx::replay::Keyframe& keyframe,
   return obj;
 }
 
-bool fromJsonValue(const JsonGenericValue& obj,
-                   gfx::replay::Keyframe& keyframe) {
+bool keyframeFromJsonValueImpl(const JsonGenericValue& obj,
+                               gfx::replay::StateQuantizer* quantizer,
+                               gfx::replay::Keyframe& keyframe) {
   io::readMember(obj, "loads", keyframe.loads);
 
   auto itr = obj.FindMember("creations");
@@ -81,10 +171,20 @@ bool fromJsonValue(const JsonGenericValue& obj,
                 gfx::replay::RenderAssetInstanceState>
           pair;
       io::readMember(stateObj, "instanceKey", pair.first);
-      io::readMember(stateObj, "state", pair.second);
+      if (!quantizer) {
+        io::readMember(stateObj, "state", pair.second);
+      } else if (!readQuantizedStateMembers(stateObj, pair.first, *quantizer,
+                                            pair.second)) {
+        return false;
+      }
       keyframe.stateUpdates.emplace_back(std::move(pair));
     }
   }
+  if (quantizer) {
+    for (const auto& instanceKey : keyframe.deletions) {
+      quantizer->erasePrevious(instanceKey);
+    }
+  }
 
   itr = obj.FindMember("userTransforms");
   if (itr != obj.MemberEnd()) {
@@ -101,6 +201,30 @@ bool fromJsonValue(const JsonGenericValue& obj,
   return true;
 }
 
+}  // namespace
+
+JsonGenericValue toJsonValue(const gfx::replay::Keyframe& keyframe,
+                             JsonAllocator& allocator) {
+  return keyframeToJsonValueImpl(keyframe, nullptr, allocator);
+}
+
+bool fromJsonValue(const JsonGenericValue& obj,
+                   gfx::replay::Keyframe& keyframe) {
+  return keyframeFromJsonValueImpl(obj, nullptr, keyframe);
+}
+
+JsonGenericValue keyframeToJsonValue(const gfx::replay::Keyframe& keyframe,
+                                     gfx::replay::StateQuantizer& quantizer,
+                                     JsonAllocator& allocator) {
+  return keyframeToJsonValueImpl(keyframe, &quantizer, allocator);
+}
+
+bool keyframeFromJsonValue(const JsonGenericValue& obj,
+                           gfx::replay::StateQuantizer& quantizer,
+                           gfx::replay::Keyframe& keyframe) {
+  return keyframeFromJsonValueImpl(obj, &quantizer, keyframe);
+}
+
 JsonGenericValue toJsonValue(const esp::assets::AssetInfo& x,
                              JsonAllocator& allocator) {
   JsonGenericValue obj(rapidjson::kObjectType);
@@ -15,6 +15,7 @@
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/core/Esp.h"
 #include "esp/gfx/replay/Keyframe.h"
+#include "esp/gfx/replay/StateQuantizer.h"
 
 namespace esp {
 namespace io {
@@ -175,6 +176,43 @@ JsonGenericValue toJsonValue(const esp::gfx::replay::Keyframe& x,
 bool fromJsonValue(const JsonGenericValue& keyframeObj,
                    esp::gfx::replay::Keyframe& keyframe);
 
+inline JsonGenericValue toJsonValue(
+    const esp::gfx::replay::TransformQuantization& x,
+    JsonAllocator& allocator) {
+  JsonGenericValue obj(rapidjson::kObjectType);
+  addMember(obj, "translationStep", x.translationStep, allocator);
+  addMember(obj, "rotationBits", x.rotationBits, allocator);
+  return obj;
+}
+
+inline bool fromJsonValue(const JsonGenericValue& obj,
+                          esp::gfx::replay::TransformQuantization& x) {
+  bool success = true;
+  success &= readMember(obj, "translationStep", x.translationStep);
+  success &= readMember(obj, "rotationBits", x.rotationBits);
+  return success;
+}
+
+/**
+ * @brief Serialize a keyframe with its state updates quantized by @p
+ * quantizer. An instance's first update stores its quantized state, later ones
+ * only what changed since the previous keyframe written through @p quantizer,
+ * so keyframes must be written and read back in the same order.
+ */
+JsonGenericValue keyframeToJsonValue(
+    const esp::gfx::replay::Keyframe& x,
+    esp::gfx::replay::StateQuantizer& quantizer,
+    JsonAllocator& allocator);
+
+/**
+ * @brief Read a keyframe written by @ref keyframeToJsonValue, with a @p
+ * quantizer of the same @ref gfx::replay::TransformQuantization that has read
+ * all previous keyframes.
+ */
+bool keyframeFromJsonValue(const JsonGenericValue& keyframeObj,
+                           esp::gfx::replay::StateQuantizer& quantizer,
+                           esp::gfx::replay::Keyframe& keyframe);
+
 }  // namespace io
 }  // namespace esp
 
@@ -65,6 +65,36 @@ inline bool fromJsonValue(const JsonGenericValue& obj, Magnum::Vector3& val) {
   return false;
 }
 
+inline JsonGenericValue toJsonValue(const Magnum::Vector3i& vec,
+                                    JsonAllocator& allocator) {
+  return toJsonArrayHelper(vec.data(), 3, allocator);
+}
+
+/**
+ * @brief Specialization to handle Magnum::Vector3i values. Populate passed @p
+ * val with value. Returns whether successfully populated, or not. Logs an error
+ * if inappropriate type.
+ *
+ * @param obj json value to parse
+ * @param val destination value to be populated
+ * @return whether successful or not
+ */
+inline bool fromJsonValue(const JsonGenericValue& obj, Magnum::Vector3i& val) {
+  if (obj.IsArray() && obj.Size() == 3) {
+    for (rapidjson::SizeType i = 0; i < 3; ++i) {
+      if (obj[i].IsInt()) {
+        val[i] = obj[i].GetInt();
+      } else {
+        ESP_ERROR() << "Invalid integer value specified in JSON Vec3i, index :"
+                    << i;
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
 inline JsonGenericValue toJsonValue(const Magnum::Color4& color,
                                     JsonAllocator& allocator) {
   return toJsonArrayHelper(color.data(), 4, allocator);
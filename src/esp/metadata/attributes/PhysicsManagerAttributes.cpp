@@ -15,6 +15,8 @@ PhysicsManagerAttributes::PhysicsManagerAttributes(const std::string& handle)
   setGravity({0, -9.8, 0});
   setFrictionCoefficient(0.4);
   setRestitutionCoefficient(0.1);
+  setNumThreads(1);
+  setDeterministic(true);
 }  // PhysicsManagerAttributes ctor
 
 void PhysicsManagerAttributes::writeValuesToJson(
@@ -25,6 +27,8 @@ void PhysicsManagerAttributes::writeValuesToJson(
   writeValueToJson("gravity", jsonObj, allocator);
   writeValueToJson("friction_coefficient", jsonObj, allocator);
   writeValueToJson("restitution_coefficient", jsonObj, allocator);
+  writeValueToJson("num_threads", jsonObj, allocator);
+  writeValueToJson("deterministic", jsonObj, allocator);
 }  // PhysicsManagerAttributes::writeValuesToJson
 
 }  // namespace attributes
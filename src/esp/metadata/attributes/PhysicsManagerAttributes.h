@@ -67,6 +67,33 @@ class PhysicsManagerAttributes : public AbstractAttributes {
     return get<double>("restitution_coefficient");
   }
 
+  /**
+   * @brief Set the number of threads the physics engine may use to step the
+   * world. 1 steps single-threaded. Only effective when Bullet is built with
+   * multi-threading support (BT_THREADSAFE).
+   */
+  void setNumThreads(int numThreads) { set("num_threads", numThreads); }
+
+  /**
+   * @brief Get the number of threads the physics engine may use to step the
+   * world.
+   */
+  int getNumThreads() const { return get<int>("num_threads"); }
+
+  /**
+   * @brief Set whether multi-threaded stepping must reproduce the same results
+   * run to run. Costs a sort of the contact manifolds every substep.
+   */
+  void setDeterministic(bool deterministic) {
+    set("deterministic", deterministic);
+  }
+
+  /**
+   * @brief Get whether multi-threaded stepping must reproduce the same results
+   * run to run.
+   */
+  bool getDeterministic() const { return get<bool>("deterministic"); }
+
   /**
    * @brief Populate a json object with all the first-level values held in this
    * configuration.  Default is overridden to handle special cases for
@@ -83,7 +110,7 @@ class PhysicsManagerAttributes : public AbstractAttributes {
 
   std::string getObjectInfoHeaderInternal() const override {
     return "Simulator Type,Timestep,Max Substeps,Gravity XYZ,Friction "
-           "Coefficient,Restitution Coefficient,";
+           "Coefficient,Restitution Coefficient,Num Threads,Deterministic,";
   }
 
   /**
@@ -92,10 +119,11 @@ class PhysicsManagerAttributes : public AbstractAttributes {
    */
   std::string getObjectInfoInternal() const override {
     return Cr::Utility::formatString(
-        "{},{},{},{},{},{}", getSimulator(), getAsString("timestep"),
+        "{},{},{},{},{},{},{},{}", getSimulator(), getAsString("timestep"),
         getAsString("max_substeps"), getAsString("gravity"),
         getAsString("friction_coefficient"),
-        getAsString("restitution_coefficient"));
+        getAsString("restitution_coefficient"), getAsString("num_threads"),
+        getAsString("deterministic"));
   }
 
  public:
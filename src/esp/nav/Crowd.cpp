@@ -0,0 +1,197 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Crowd.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <DetourCrowd.h>
+#include <DetourNavMesh.h>
+#include <DetourNavMeshQuery.h>
+
+#include "esp/core/Check.h"
+#include "esp/scene/SceneNode.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace nav {
+
+namespace {
+
+// below this speed an agent keeps facing where it last moved
+constexpr float MinTurnSpeed = 1e-3f;
+
+bool findNearestPoly(const dtCrowd& crowd,
+                     const Mn::Vector3& position,
+                     dtPolyRef& ref,
+                     Mn::Vector3& nearest) {
+  ref = 0;
+  const dtStatus status = crowd.getNavMeshQuery()->findNearestPoly(
+      position.data(), crowd.getQueryHalfExtents(), crowd.getFilter(0), &ref,
+      nearest.data());
+  return dtStatusSucceed(status) && ref != 0;
+}
+
+}  // namespace
+
+Crowd::Crowd(const PathFinder::ptr& pathFinder,
+             int maxAgents,
+             float maxAgentRadius)
+    : pathFinder_{pathFinder} {
+  ESP_CHECK(pathFinder_ && pathFinder_->getDetourNavMesh(),
+            "Crowd: the pathfinder has no navmesh loaded");
+  ESP_CHECK(maxAgents > 0,
+            "Crowd: maxAgents must be positive, got" << maxAgents);
+  navMeshGeneration_ = pathFinder_->getNavMeshGeneration();
+
+  crowd_ = dtAllocCrowd();
+  // the crowd only reads the navmesh, its query isn't const-correct
+  const bool initialized =
+      crowd_ != nullptr &&
+      crowd_->init(maxAgents, maxAgentRadius,
+                   const_cast<dtNavMesh*>(pathFinder_->getDetourNavMesh()));
+  if (!initialized) {
+    dtFreeCrowd(crowd_);
+    crowd_ = nullptr;
+    ESP_CHECK(false, "Crowd: unable to allocate a crowd of" << maxAgents
+                                                             << "agents");
+  }
+  *crowd_->getEditableFilter(0) = *pathFinder_->getDetourQueryFilter();
+
+  positions_.resize(maxAgents);
+  velocities_.resize(maxAgents);
+  rotations_.resize(maxAgents);
+}
+
+Crowd::~Crowd() {
+  dtFreeCrowd(crowd_);
+}
+
+bool Crowd::hasValidNavMesh() const {
+  return pathFinder_->getNavMeshGeneration() == navMeshGeneration_;
+}
+
+void Crowd::checkNavMesh(const char* caller) const {
+  ESP_CHECK(hasValidNavMesh(),
+            caller << "the navmesh of the pathfinder was rebuilt or reloaded "
+                      "since the crowd was created, create a new crowd");
+}
+
+int Crowd::getNumAgents() const {
+  checkNavMesh("Crowd::getNumAgents:");
+  int numAgents = 0;
+  for (int i = 0; i < crowd_->getAgentCount(); ++i) {
+    numAgents += crowd_->getAgent(i)->active ? 1 : 0;
+  }
+  return numAgents;
+}
+
+int Crowd::addAgent(const Mn::Vector3& position,
+                    const CrowdAgentParams& params) {
+  checkNavMesh("Crowd::addAgent:");
+  dtPolyRef ref = 0;
+  Mn::Vector3 nearest;
+  if (!findNearestPoly(*crowd_, position, ref, nearest)) {
+    return ID_UNDEFINED;
+  }
+
+  dtCrowdAgentParams agentParams{};
+  agentParams.radius = params.radius;
+  agentParams.height = params.height;
+  agentParams.maxAcceleration = params.maxAcceleration;
+  agentParams.maxSpeed = params.maxSpeed;
+  agentParams.collisionQueryRange = params.radius * 12.0f;
+  agentParams.pathOptimizationRange = params.radius * 30.0f;
+  agentParams.separationWeight = params.separationWeight;
+  agentParams.updateFlags = DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO;
+  if (params.anticipateTurns) {
+    agentParams.updateFlags |= DT_CROWD_ANTICIPATE_TURNS;
+  }
+  if (params.avoidObstacles) {
+    agentParams.updateFlags |= DT_CROWD_OBSTACLE_AVOIDANCE;
+  }
+  if (params.separationWeight > 0.0f) {
+    agentParams.updateFlags |= DT_CROWD_SEPARATION;
+  }
+  // the highest quality of the default avoidance presets
+  agentParams.obstacleAvoidanceType = 3;
+  agentParams.queryFilterType = 0;
+
+  const int id = crowd_->addAgent(nearest.data(), &agentParams);
+  if (id < 0) {
+    return ID_UNDEFINED;
+  }
+  positions_[id] = nearest;
+  velocities_[id] = {};
+  rotations_[id] = {};
+  return id;
+}
+
+void Crowd::removeAgent(int id) {
+  checkNavMesh("Crowd::removeAgent:");
+  if (isAgentActive(id)) {
+    crowd_->removeAgent(id);
+    velocities_[id] = {};
+  }
+}
+
+bool Crowd::isAgentActive(int id) const {
+  checkNavMesh("Crowd::isAgentActive:");
+  return id >= 0 && id < getMaxAgents() && crowd_->getAgent(id)->active;
+}
+
+bool Crowd::setAgentTarget(int id, const Mn::Vector3& target) {
+  checkNavMesh("Crowd::setAgentTarget:");
+  ESP_CHECK(isAgentActive(id), "Crowd::setAgentTarget: no agent with id" << id);
+  dtPolyRef ref = 0;
+  Mn::Vector3 nearest;
+  if (!findNearestPoly(*crowd_, target, ref, nearest)) {
+    return false;
+  }
+  return crowd_->requestMoveTarget(id, ref, nearest.data());
+}
+
+void Crowd::resetAgentTarget(int id) {
+  checkNavMesh("Crowd::resetAgentTarget:");
+  ESP_CHECK(isAgentActive(id),
+            "Crowd::resetAgentTarget: no agent with id" << id);
+  crowd_->resetMoveTarget(id);
+}
+
+void Crowd::update(float dt) {
+  checkNavMesh("Crowd::update:");
+  crowd_->update(dt, nullptr);
+
+  for (int i = 0; i < crowd_->getAgentCount(); ++i) {
+    const dtCrowdAgent* agent = crowd_->getAgent(i);
+    if (!agent->active) {
+      continue;
+    }
+    positions_[i] = Mn::Vector3::from(agent->npos);
+    velocities_[i] = Mn::Vector3::from(agent->vel);
+    const Mn::Vector2 planar{velocities_[i].x(), velocities_[i].z()};
+    if (planar.dot() > MinTurnSpeed * MinTurnSpeed) {
+      rotations_[i] = Mn::Quaternion::rotation(
+          Mn::Rad{std::atan2(-planar.x(), -planar.y())}, Mn::Vector3::yAxis());
+    }
+  }
+}
+
+void Crowd::updateSceneNodes(
+    const std::vector<scene::SceneNode*>& nodes) const {
+  checkNavMesh("Crowd::updateSceneNodes:");
+  const int numNodes = std::min(int(nodes.size()), getMaxAgents());
+  for (int i = 0; i < numNodes; ++i) {
+    if (nodes[i] == nullptr || !isAgentActive(i)) {
+      continue;
+    }
+    nodes[i]->setTranslation(positions_[i]);
+    nodes[i]->setRotation(rotations_[i]);
+  }
+}
+
+}  // namespace nav
+}  // namespace esp
@@ -0,0 +1,186 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_NAV_CROWD_H_
+#define ESP_NAV_CROWD_H_
+
+#include <memory>
+#include <vector>
+
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/core/Esp.h"
+#include "esp/nav/PathFinder.h"
+
+class dtCrowd;
+
+namespace esp {
+namespace scene {
+class SceneNode;
+}
+
+namespace nav {
+
+/**
+ * @brief Parameters of an agent of a @ref Crowd
+ */
+struct CrowdAgentParams {
+  //! Radius of the agent, at most the crowd's maximum agent radius
+  float radius = 0.2f;
+  //! Height of the agent
+  float height = 1.5f;
+  //! Maximum acceleration, in units per second squared
+  float maxAcceleration = 8.0f;
+  //! Maximum speed, in units per second
+  float maxSpeed = 1.0f;
+  //! How strongly the agent keeps its distance from its neighbours. 0
+  //! disables separation.
+  float separationWeight = 2.0f;
+  //! Steer around neighbours ahead of time instead of only separating
+  bool avoidObstacles = true;
+  //! Start turning before reaching corners of the path
+  bool anticipateTurns = true;
+};
+
+/**
+ * @brief Moves many agents on the navmesh of a @ref PathFinder at once.
+ *
+ * Agents follow paths to their targets, steering around each other, and are
+ * all advanced by a single @ref update. Path requests are queued and spread
+ * over updates, and agents keep path corridors which are only repaired
+ * locally as they move, so per agent cost is much lower than calling
+ * @ref PathFinder::findPath and @ref PathFinder::tryStep for each of them.
+ * Built on Detour's crowd.
+ *
+ * After each update the state of all agents is in flat arrays indexed by agent
+ * id, see @ref getAgentPositions, or can be written to scene nodes with
+ * @ref updateSceneNodes.
+ *
+ * The crowd uses the navmesh the pathfinder has when the crowd is created;
+ * create a new crowd after rebuilding or loading another navmesh. Using a
+ * crowd whose navmesh was replaced is an error, see @ref hasValidNavMesh.
+ */
+class Crowd {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * @param[in] pathFinder The pathfinder with the navmesh to move on
+   * @param[in] maxAgents The maximum number of agents at once
+   * @param[in] maxAgentRadius The largest radius of an agent
+   */
+  Crowd(const PathFinder::ptr& pathFinder,
+        int maxAgents,
+        float maxAgentRadius = 0.5f);
+
+  ~Crowd();
+
+  Crowd(const Crowd&) = delete;
+  Crowd& operator=(const Crowd&) = delete;
+
+  /**
+   * @brief The maximum number of agents, and the size of the state arrays
+   */
+  int getMaxAgents() const { return int(positions_.size()); }
+
+  /**
+   * @brief Whether the pathfinder still has the navmesh the crowd was created
+   * on. If not, all other functions except the state array getters fail.
+   */
+  bool hasValidNavMesh() const;
+
+  /**
+   * @brief The number of agents currently in the crowd
+   */
+  int getNumAgents() const;
+
+  /**
+   * @brief Add an agent
+   *
+   * @param[in] position Where to place the agent, snapped to the navmesh
+   * @param[in] params The agent's parameters
+   *
+   * @return The id of the agent, or @ref ID_UNDEFINED if the crowd is full or
+   * @p position isn't near the navmesh
+   */
+  int addAgent(const Magnum::Vector3& position,
+               const CrowdAgentParams& params = {});
+
+  /**
+   * @brief Remove an agent. Its id may be reused by @ref addAgent.
+   */
+  void removeAgent(int id);
+
+  /**
+   * @brief Whether @p id is an agent of the crowd
+   */
+  bool isAgentActive(int id) const;
+
+  /**
+   * @brief Make an agent move to @p target
+   *
+   * @return False if @p target isn't near the navmesh
+   */
+  bool setAgentTarget(int id, const Magnum::Vector3& target);
+
+  /**
+   * @brief Make an agent stop where it is
+   */
+  void resetAgentTarget(int id);
+
+  /**
+   * @brief Advance all agents by @p dt seconds
+   */
+  void update(float dt);
+
+  /**
+   * @brief Agent positions, indexed by agent id. Inactive agents keep their
+   * last position.
+   */
+  const std::vector<Magnum::Vector3>& getAgentPositions() const {
+    return positions_;
+  }
+
+  /**
+   * @brief Agent velocities, indexed by agent id
+   */
+  const std::vector<Magnum::Vector3>& getAgentVelocities() const {
+    return velocities_;
+  }
+
+  /**
+   * @brief Agent rotations facing along their velocity (agents face -Z),
+   * indexed by agent id. Agents keep their rotation while standing still.
+   */
+  const std::vector<Magnum::Quaternion>& getAgentRotations() const {
+    return rotations_;
+  }
+
+  /**
+   * @brief Set the translation and rotation of @p nodes[i] to the state of
+   * agent i. Null nodes and nodes of inactive agents are skipped.
+   */
+  void updateSceneNodes(const std::vector<scene::SceneNode*>& nodes) const;
+
+ private:
+  //! Fails if the navmesh of the pathfinder was replaced since construction
+  void checkNavMesh(const char* caller) const;
+
+  PathFinder::ptr pathFinder_;
+  //! @ref PathFinder::getNavMeshGeneration at construction
+  size_t navMeshGeneration_ = 0;
+  dtCrowd* crowd_ = nullptr;
+
+  std::vector<Magnum::Vector3> positions_;
+  std::vector<Magnum::Vector3> velocities_;
+  std::vector<Magnum::Quaternion> rotations_;
+
+  ESP_SMART_POINTERS(Crowd)
+};
+
+}  // namespace nav
+}  // namespace esp
+
+#endif  // ESP_NAV_CROWD_H_
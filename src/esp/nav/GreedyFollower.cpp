@@ -1,5 +1,8 @@
 #include "esp/nav/GreedyFollower.h"
 
+#include <cmath>
+#include <deque>
+
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
 #include <Magnum/EigenIntegration/Integration.h>
 
@@ -32,6 +35,41 @@ GreedyGeodesicFollowerImpl::GreedyGeodesicFollowerImpl(
       fixThrashing_{fixThrashing},
       thrashingThreshold_{thrashingThreshold} {};
 
+namespace {
+
+// Vertical extent of a lattice cell, well below the height of a storey
+constexpr float LatticeCellHeight = 0.5f;
+
+// Packs the cell of pos into 21 bits per axis
+uint64_t latticeKey(const Mn::Vector3& pos, const float cellSize) {
+  const auto quantize = [](const float value) {
+    return static_cast<uint64_t>(static_cast<int64_t>(std::floor(value)) +
+                                 (1 << 20)) &
+           0x1fffff;
+  };
+  return quantize(pos.x() / cellSize) |
+         quantize(pos.y() / LatticeCellHeight) << 21 |
+         quantize(pos.z() / cellSize) << 42;
+}
+
+// Heading of an agent rotated by rotation, facing -Z, in multiples of
+// 2*pi/numHeadings
+int headingIndex(const Mn::Quaternion& rotation, const int numHeadings) {
+  const Mn::Vector3 forward = rotation.transformVector(-Mn::Vector3::zAxis());
+  const float angle = std::atan2(-forward.x(), -forward.z());
+  const int index =
+      static_cast<int>(std::lround(angle * numHeadings / (2 * M_PI))) %
+      numHeadings;
+  return index < 0 ? index + numHeadings : index;
+}
+
+Mn::Quaternion headingRotation(const int index, const int numHeadings) {
+  return Mn::Quaternion::rotation(Mn::Rad(2 * M_PI * index / numHeadings),
+                                  Mn::Vector3::yAxis());
+}
+
+}  // namespace
+
 float GreedyGeodesicFollowerImpl::geoDist(const Mn::Vector3& start,
                                           const Mn::Vector3& end) {
   geoDistPath_.requestedStart = cast<vec3f>(start);
@@ -154,9 +192,168 @@ bool GreedyGeodesicFollowerImpl::isThrashing() {
   return thrashing;
 }
 
+int GreedyGeodesicFollowerImpl::buildActionTable(const Mn::Vector3& end,
+                                                 float cellSize) {
+  actionTable_.reset();
+  if (cellSize <= 0.0f)
+    cellSize = 0.5f * forwardAmount_;
+  const int numHeadings =
+      std::max(1, static_cast<int>(std::lround(2 * M_PI / turnAmount_)));
+
+  // Turns move between headings by a fixed number of steps
+  tryStepDummyNode_.setRotation(headingRotation(0, numHeadings));
+  turnLeft_(&tryStepDummyNode_);
+  const int leftSteps =
+      headingIndex(tryStepDummyNode_.rotation(), numHeadings);
+  tryStepDummyNode_.setRotation(headingRotation(0, numHeadings));
+  turnRight_(&tryStepDummyNode_);
+  const int rightSteps =
+      headingIndex(tryStepDummyNode_.rotation(), numHeadings);
+  if (leftSteps == 0 || rightSteps == 0) {
+    ESP_ERROR() << "The turn amount of" << turnAmount_
+                << "rad doesn't match the turn actions";
+    return 0;
+  }
+
+  const Mn::Vector3 goal = pathfinder_->snapPoint(end);
+  if (std::isnan(goal.x()))
+    return 0;
+
+  // Discover the lattice by moving forward in every heading from every cell,
+  // starting at the goal. The first position reaching a cell represents it.
+  std::unordered_map<uint64_t, uint32_t> cells;
+  std::vector<Mn::Vector3> positions;
+  const auto cellOf = [&](const Mn::Vector3& pos) {
+    const auto inserted =
+        cells.emplace(latticeKey(pos, cellSize), positions.size());
+    if (inserted.second)
+      positions.push_back(pos);
+    return inserted.first->second;
+  };
+  cellOf(goal);
+  // successor of heading h in cell c at c * numHeadings + h
+  std::vector<uint32_t> forwardCells;
+  for (uint32_t cell = 0; cell < positions.size(); ++cell) {
+    for (int heading = 0; heading < numHeadings; ++heading) {
+      tryStepDummyNode_.setTranslation(positions[cell]);
+      tryStepDummyNode_.setRotation(headingRotation(heading, numHeadings));
+      moveForward_(&tryStepDummyNode_);
+      forwardCells.push_back(
+          cellOf(tryStepDummyNode_.MagnumObject::translation()));
+    }
+  }
+
+  const uint32_t numStates = forwardCells.size();
+  const auto forwardState = [&](const uint32_t state) {
+    return forwardCells[state] * numHeadings + state % numHeadings;
+  };
+  const auto turnedState = [&](const uint32_t state, const int steps) {
+    const int heading = (state % numHeadings + steps) % numHeadings;
+    return state - state % numHeadings + heading;
+  };
+
+  // Forward moves into each state, as offsets into predecessors
+  std::vector<uint32_t> predecessorStarts(numStates + 1, 0);
+  for (uint32_t state = 0; state < numStates; ++state)
+    ++predecessorStarts[forwardState(state) + 1];
+  for (uint32_t state = 0; state < numStates; ++state)
+    predecessorStarts[state + 1] += predecessorStarts[state];
+  std::vector<uint32_t> predecessors(numStates);
+  {
+    std::vector<uint32_t> fill(predecessorStarts.begin(),
+                               predecessorStarts.end() - 1);
+    for (uint32_t state = 0; state < numStates; ++state)
+      predecessors[fill[forwardState(state)]++] = state;
+  }
+
+  // Breadth first search backwards from the poses within the goal distance
+  constexpr uint32_t Unreached = ~0u;
+  std::vector<uint32_t> steps(numStates, Unreached);
+  std::deque<uint32_t> queue;
+  for (uint32_t cell = 0; cell < positions.size(); ++cell) {
+    if ((positions[cell] - goal).length() < goalDist_ &&
+        geoDist(positions[cell], goal) < goalDist_) {
+      for (int heading = 0; heading < numHeadings; ++heading) {
+        steps[cell * numHeadings + heading] = 0;
+        queue.push_back(cell * numHeadings + heading);
+      }
+    }
+  }
+  const int inverseLeft = numHeadings - leftSteps;
+  const int inverseRight = numHeadings - rightSteps;
+  while (!queue.empty()) {
+    const uint32_t state = queue.front();
+    queue.pop_front();
+    const auto reach = [&](const uint32_t previous) {
+      if (steps[previous] == Unreached) {
+        steps[previous] = steps[state] + 1;
+        queue.push_back(previous);
+      }
+    };
+    for (uint32_t i = predecessorStarts[state];
+         i < predecessorStarts[state + 1]; ++i)
+      reach(predecessors[i]);
+    reach(turnedState(state, inverseLeft));
+    reach(turnedState(state, inverseRight));
+  }
+
+  auto table = std::make_unique<ActionTable>();
+  table->goal = end;
+  table->cellSize = cellSize;
+  table->numHeadings = numHeadings;
+  table->actions.resize(numStates, CODES::ERROR);
+  for (uint32_t state = 0; state < numStates; ++state) {
+    if (steps[state] == 0) {
+      table->actions[state] = CODES::STOP;
+      continue;
+    }
+    // moving forward wins ties, it makes progress on a continuous floor
+    uint32_t best = Unreached;
+    const std::pair<CODES, uint32_t> successors[]{
+        {CODES::FORWARD, forwardState(state)},
+        {CODES::LEFT, turnedState(state, leftSteps)},
+        {CODES::RIGHT, turnedState(state, rightSteps)}};
+    for (const auto& successor : successors) {
+      if (steps[successor.second] < best &&
+          steps[successor.second] < steps[state]) {
+        best = steps[successor.second];
+        table->actions[state] = successor.first;
+      }
+    }
+  }
+  table->cells = std::move(cells);
+  actionTable_ = std::move(table);
+
+  return positions.size();
+}
+
+bool GreedyGeodesicFollowerImpl::hasActionTable(const Mn::Vector3& end) const {
+  return actionTable_ && (actionTable_->goal - end).length() < 1e-3f;
+}
+
+GreedyGeodesicFollowerImpl::CODES GreedyGeodesicFollowerImpl::tableActionAlong(
+    const core::RigidState& state,
+    const Mn::Vector3& end) const {
+  if (!hasActionTable(end))
+    return CODES::ERROR;
+  const auto found = actionTable_->cells.find(
+      latticeKey(state.translation, actionTable_->cellSize));
+  if (found == actionTable_->cells.end())
+    return CODES::ERROR;
+  return actionTable_->actions[found->second * actionTable_->numHeadings +
+                               headingIndex(state.rotation,
+                                            actionTable_->numHeadings)];
+}
+
 GreedyGeodesicFollowerImpl::CODES GreedyGeodesicFollowerImpl::nextActionAlong(
     const core::RigidState& start,
     const Mn::Vector3& end) {
+  const CODES tableAction = tableActionAlong(start, end);
+  if (tableAction != CODES::ERROR) {
+    actions_.push_back(tableAction);
+    return tableAction;
+  }
+
   ShortestPath path;
   path.requestedStart = cast<vec3f>(start.translation);
   path.requestedEnd = cast<vec3f>(end);
@@ -194,11 +391,17 @@ GreedyGeodesicFollowerImpl::findPath(const core::RigidState& start,
   do {
     core::RigidState state{findPathDummyNode_.rotation(),
                            findPathDummyNode_.MagnumObject::translation()};
-    ShortestPath path;
-    path.requestedStart = cast<vec3f>(state.translation);
-    path.requestedEnd = cast<vec3f>(end);
-    pathfinder_->findPath(path);
-    const auto nextPrim = nextBestPrimAlong(state, path);
+    std::vector<CODES> nextPrim;
+    const CODES tableAction = tableActionAlong(state, end);
+    if (tableAction != CODES::ERROR) {
+      nextPrim = {tableAction};
+    } else {
+      ShortestPath path;
+      path.requestedStart = cast<vec3f>(state.translation);
+      path.requestedEnd = cast<vec3f>(end);
+      pathfinder_->findPath(path);
+      nextPrim = nextBestPrimAlong(state, path);
+    }
     if (nextPrim.empty()) {
       actions_.emplace_back(CODES::ERROR);
     } else {
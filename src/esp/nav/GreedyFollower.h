@@ -5,6 +5,9 @@
 #ifndef ESP_NAV_GREEDYFOLLOWER_H_
 #define ESP_NAV_GREEDYFOLLOWER_H_
 
+#include <memory>
+#include <unordered_map>
+
 #include "esp/core/Esp.h"
 #include "esp/core/RigidState.h"
 #include "esp/nav/PathFinder.h"
@@ -27,6 +30,9 @@ namespace nav {
  *
  * Once a primitive is selected, the first action in that primitives is selected
  * as the next action to take and this process is repeated
+ *
+ * For a goal reached from many starts, @ref buildActionTable precomputes the
+ * action of every pose instead, so planning becomes a table lookup.
  */
 class GreedyGeodesicFollowerImpl {
  public:
@@ -112,6 +118,38 @@ class GreedyGeodesicFollowerImpl {
   std::vector<CODES> findPath(const core::RigidState& start,
                               const Magnum::Vector3& end);
 
+  /**
+   * @brief Precomputes the action to take towards a goal from every pose of a
+   * (position, heading) lattice.
+   *
+   * The lattice is discovered by moving forward in every heading, starting at
+   * the goal, with positions bucketed into cells of @p cellSize and headings
+   * into multiples of the turn amount. A breadth first search backwards from
+   * the poses within the goal distance then gives every pose the action on a
+   * shortest action sequence. Afterwards @ref nextActionAlong and @ref
+   * findPath towards @p end look actions up, and only fall back to planning
+   * for poses off the lattice.
+   *
+   * Like @ref findPath, this assumes the move functions have no actuation
+   * noise while the table is built.
+   *
+   * @param[in] end The goal
+   * @param[in] cellSize The lattice resolution, 0 for half the forward amount
+   *
+   * @return The number of lattice cells, 0 if @p end isn't navigable
+   */
+  int buildActionTable(const Magnum::Vector3& end, float cellSize = 0.0f);
+
+  /**
+   * @brief Discard the table built by @ref buildActionTable
+   */
+  void clearActionTable() { actionTable_.reset(); }
+
+  /**
+   * @brief Whether actions towards @p end are looked up in a table
+   */
+  bool hasActionTable(const Magnum::Vector3& end) const;
+
   /**
    * @brief Reset the planner.
    *
@@ -132,6 +170,21 @@ class GreedyGeodesicFollowerImpl {
   std::vector<CODES> actions_;
   std::vector<CODES> thrashingActions_;
 
+  struct ActionTable {
+    Magnum::Vector3 goal;
+    float cellSize;
+    int numHeadings;
+    // lattice cell of each quantized position, see latticeKey()
+    std::unordered_map<uint64_t, uint32_t> cells;
+    // action of heading h in cell c at c * numHeadings + h
+    std::vector<CODES> actions;
+  };
+  std::unique_ptr<ActionTable> actionTable_;
+
+  //! The action of the table for @p state, ERROR if there is none
+  CODES tableActionAlong(const core::RigidState& state,
+                         const Magnum::Vector3& end) const;
+
   scene::SceneGraph dummyScene_;
   scene::SceneNode findPathDummyNode_{dummyScene_.getRootNode()},
       leftDummyNode_{dummyScene_.getRootNode()},
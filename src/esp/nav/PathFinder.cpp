@@ -3,12 +3,15 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PathFinder.h"
+#include <algorithm>
 #include <cstddef>
+#include <map>
 #include <numeric>
 #include <stack>
 #include <unordered_map>
 
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector3.h>
 
 #include <Magnum/EigenIntegration/GeometryIntegration.h>
@@ -22,8 +25,14 @@
 #include <cmath>
 #include <limits>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "esp/assets/MeshData.h"
 #include "esp/core/Esp.h"
+#include "esp/core/Random.h"
 
 #include "DetourNavMesh.h"
 #include "DetourNavMeshBuilder.h"
@@ -113,15 +122,21 @@ namespace impl {
 // are connected This gives O(1) lookup for if a path between two polygons
 // exists or not
 // Takes O(npolys) to construct
+//
+// Islands are stored densely, indexed by the tile and polygon indices decoded
+// from a polygon ref, and can be saved with the navmesh so that loading it
+// doesn't redo the analysis.
 class IslandSystem {
  public:
-  IslandSystem(const dtNavMesh* navMesh, const dtQueryFilter* filter) {
+  IslandSystem(const dtNavMesh* navMesh, const dtQueryFilter* filter)
+      : IslandSystem{navMesh} {
+    polyIslands_.assign(tilePolyOffsets_.back(), uint32_t{NoIsland});
     std::vector<vec3f> islandVerts;
 
     // Iterate over all tiles
     for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
       const dtMeshTile* tile = navMesh->getTile(iTile);
-      if (!tile)
+      if (!tile || !tile->header)
         continue;
 
       // Iterate over all polygons in a tile
@@ -132,7 +147,7 @@ class IslandSystem {
         // If the polygon ref is valid, and we haven't seen it yet,
         // start connected component analysis from this polygon
         if (navMesh->isValidPolyRef(startRef) &&
-            (polyToIsland_.find(startRef) == polyToIsland_.end())) {
+            island(startRef) == NoIsland) {
           uint32_t newIslandId = islandRadius_.size();
           expandFrom(navMesh, filter, newIslandId, startRef, islandVerts);
 
@@ -155,38 +170,106 @@ class IslandSystem {
     }
   }
 
+  // Reads islands written by write() for navMesh, nullptr if they don't
+  // match its polygons
+  static std::unique_ptr<IslandSystem> read(const dtNavMesh* navMesh,
+                                            FILE* fp) {
+    std::unique_ptr<IslandSystem> islands{new IslandSystem{navMesh}};
+    int32_t counts[2]{};  // polygons, islands
+    if (fread(counts, sizeof(counts), 1, fp) != 1 ||
+        counts[0] != static_cast<int32_t>(islands->tilePolyOffsets_.back()) ||
+        counts[1] < 0 || counts[1] > counts[0])
+      return nullptr;
+
+    islands->polyIslands_.resize(counts[0]);
+    islands->islandRadius_.resize(counts[1]);
+    if (fread(islands->polyIslands_.data(), sizeof(uint32_t), counts[0], fp) !=
+            static_cast<size_t>(counts[0]) ||
+        fread(islands->islandRadius_.data(), sizeof(float), counts[1], fp) !=
+            static_cast<size_t>(counts[1]))
+      return nullptr;
+
+    for (const uint32_t id : islands->polyIslands_) {
+      if (id != NoIsland && id >= static_cast<uint32_t>(counts[1]))
+        return nullptr;
+    }
+    return islands;
+  }
+
+  void write(FILE* fp) const {
+    const int32_t counts[2]{static_cast<int32_t>(polyIslands_.size()),
+                            static_cast<int32_t>(islandRadius_.size())};
+    fwrite(counts, sizeof(counts), 1, fp);
+    fwrite(polyIslands_.data(), sizeof(uint32_t), polyIslands_.size(), fp);
+    fwrite(islandRadius_.data(), sizeof(float), islandRadius_.size(), fp);
+  }
+
   inline bool hasConnection(dtPolyRef startRef, dtPolyRef endRef) const {
     // If both polygons are on the same island, there must be a path between
     // them
-    auto itStart = polyToIsland_.find(startRef);
-    if (itStart == polyToIsland_.end())
-      return false;
-
-    auto itEnd = polyToIsland_.find(endRef);
-    if (itEnd == polyToIsland_.end())
-      return false;
-
-    return itStart->second == itEnd->second;
+    const uint32_t startIsland = island(startRef);
+    return startIsland != NoIsland && startIsland == island(endRef);
   }
 
   inline float islandRadius(dtPolyRef ref) const {
-    auto itRef = polyToIsland_.find(ref);
-    if (itRef == polyToIsland_.end())
+    const uint32_t id = island(ref);
+    if (id == NoIsland)
       return 0.0;
 
-    return islandRadius_[itRef->second];
+    return islandRadius_[id];
+  }
+
+  static constexpr uint32_t NoIsland = ~0u;
+
+  // Island of a polygon, NoIsland if it isn't on one
+  inline uint32_t island(dtPolyRef ref) const {
+    if (!ref)
+      return NoIsland;
+    unsigned int salt = 0, iTile = 0, iPoly = 0;
+    navMesh_->decodePolyId(ref, salt, iTile, iPoly);
+    if (iTile + 1 >= tilePolyOffsets_.size())
+      return NoIsland;
+    const uint32_t index = tilePolyOffsets_[iTile] + iPoly;
+    if (index >= tilePolyOffsets_[iTile + 1])
+      return NoIsland;
+    return polyIslands_[index];
+  }
+
+  inline float islandRadiusById(uint32_t id) const {
+    return islandRadius_[id];
   }
 
  private:
-  std::unordered_map<dtPolyRef, uint32_t> polyToIsland_;
+
+  const dtNavMesh* navMesh_;
+  // polygons of tile i are [tilePolyOffsets_[i], tilePolyOffsets_[i + 1]) in
+  // polyIslands_
+  std::vector<uint32_t> tilePolyOffsets_;
+  std::vector<uint32_t> polyIslands_;
   std::vector<float> islandRadius_;
 
+  explicit IslandSystem(const dtNavMesh* navMesh) : navMesh_{navMesh} {
+    tilePolyOffsets_.assign(navMesh->getMaxTiles() + 1, 0);
+    for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+      const dtMeshTile* tile = navMesh->getTile(iTile);
+      const int polyCount =
+          tile && tile->header ? tile->header->polyCount : 0;
+      tilePolyOffsets_[iTile + 1] = tilePolyOffsets_[iTile] + polyCount;
+    }
+  }
+
+  inline uint32_t& islandOfValidRef(dtPolyRef ref) {
+    unsigned int salt = 0, iTile = 0, iPoly = 0;
+    navMesh_->decodePolyId(ref, salt, iTile, iPoly);
+    return polyIslands_[tilePolyOffsets_[iTile] + iPoly];
+  }
+
   void expandFrom(const dtNavMesh* navMesh,
                   const dtQueryFilter* filter,
                   const uint32_t newIslandId,
                   const dtPolyRef& startRef,
                   std::vector<vec3f>& islandVerts) {
-    polyToIsland_.emplace(startRef, newIslandId);
+    islandOfValidRef(startRef) = newIslandId;
     islandVerts.clear();
 
     // Force std::stack to be implemented via an std::vector as linked
@@ -213,7 +296,8 @@ class IslandSystem {
            iLink = tile->links[iLink].next) {
         dtPolyRef neighbourRef = tile->links[iLink].ref;
         // If we've already visited this poly, skip it!
-        if (polyToIsland_.find(neighbourRef) != polyToIsland_.end())
+        uint32_t& neighbourIsland = islandOfValidRef(neighbourRef);
+        if (neighbourIsland != NoIsland)
           continue;
 
         const dtMeshTile* neighbourTile = nullptr;
@@ -225,12 +309,139 @@ class IslandSystem {
         if (!filter->passFilter(neighbourRef, neighbourTile, neighbourPoly))
           continue;
 
-        polyToIsland_.emplace(neighbourRef, newIslandId);
+        neighbourIsland = newIslandId;
         stack.push(neighbourRef);
       }
     }
   }
 };
+
+// Samples points uniformly over the area of the walkable navmesh. Triangles of
+// the polygon detail meshes are picked with Vose's alias method, so drawing a
+// sample is O(1) and, unlike Detour's findRandomPoint, never fails. Tables
+// restricted to an island or to large islands are built on first use, at
+// most one per island and one per distinct island radius.
+class PointSampler {
+ public:
+  PointSampler(const dtNavMesh* navMesh,
+               const dtQueryFilter* filter,
+               const IslandSystem& islandSystem);
+
+  // Samples island, or every island at least minIslandRadius large if island
+  // is IslandSystem::NoIsland. False if there's nothing to sample.
+  bool sample(uint32_t island,
+              float minIslandRadius,
+              core::Random& random,
+              vec3f* points,
+              int numPoints);
+
+ private:
+  struct AliasTable {
+    std::vector<uint32_t> triangles;
+    std::vector<float> probabilities;
+    std::vector<uint32_t> aliases;
+  };
+
+  // three per triangle
+  std::vector<vec3f> vertices_;
+  std::vector<float> areas_;
+  std::vector<uint32_t> islands_;
+  std::vector<float> islandRadii_;
+  // radii of the islands with triangles, ascending and unique
+  std::vector<float> sortedIslandRadii_;
+  // keyed by island, or by NoIsland and the smallest island radius that is
+  // at least the requested minimum, so radii selecting the same islands share
+  // a table
+  std::map<std::pair<uint32_t, float>, AliasTable> tables_;
+
+  const AliasTable& table(uint32_t island, float minIslandRadius);
+};
+
+// A private read-write mapping of a file. Writes are copy-on-write and never
+// reach the file, pages nobody writes to are shared with other processes.
+class MappedFile {
+ public:
+  static std::unique_ptr<MappedFile> map(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+      return nullptr;
+    struct stat info {};
+    void* data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+      data = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                  fd, 0);
+    }
+    // the mapping stays valid after closing the file
+    close(fd);
+    if (data == MAP_FAILED)
+      return nullptr;
+    return std::unique_ptr<MappedFile>{
+        new MappedFile{static_cast<unsigned char*>(data),
+                       static_cast<size_t>(info.st_size)}};
+  }
+
+  ~MappedFile() { munmap(data_, size_); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  unsigned char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(unsigned char* data, size_t size) : data_{data}, size_{size} {}
+
+  unsigned char* data_;
+  size_t size_;
+};
+
+// Distance to the navmesh boundary, precomputed on a 2.5D grid. The navmesh
+// is rasterized at cell centers into columns of spans, one span per walkable
+// surface above the cell. Spans are grouped into height layers, holding at
+// most one span per column and connected where neighboring spans are within
+// climbing distance, and each layer gets an exact Euclidean distance
+// transform. Lookups are O(1) and interpolate bilinearly.
+class ClearanceField {
+ public:
+  ClearanceField(const dtNavMesh* navMesh,
+                 const dtQueryFilter* filter,
+                 float cellSize,
+                 float maxClimb,
+                 float maxRadius);
+
+  float maxRadius() const { return maxRadius_; }
+
+  // Distance from pt to the closest boundary of the navmesh surface below or
+  // above it, clamped to maxRadius(). NaN if pt isn't over a rasterized cell.
+  float distance(const vec3f& pt) const;
+
+  size_t numLayers() const { return layers_.size(); }
+
+ private:
+  struct Layer {
+    // grid origin in cells and size, with a one-cell margin of obstacles
+    int x0, z0, width, depth;
+    // distance at each cell center, negative outside the layer
+    std::vector<float> distances;
+  };
+
+  // vertical reach of lookups, as for projectToPoly()
+  static constexpr float MaxHeightOffset = 2.0f;
+
+  float cellSize_;
+  float maxRadius_;
+  float originX_ = 0.0f, originZ_ = 0.0f;
+  int width_ = 0, depth_ = 0;
+  // spans of column x + z*width_ are [columnStarts_[i], columnStarts_[i + 1])
+  std::vector<uint32_t> columnStarts_;
+  std::vector<float> spanHeights_;
+  std::vector<uint32_t> spanLayers_;
+  std::vector<Layer> layers_;
+
+  void computeDistances(Layer& layer,
+                        const std::vector<uint32_t>& layerSpans,
+                        const std::vector<int>& spanCells) const;
+};
 }  // namespace impl
 
 struct PathFinder::Impl {
@@ -250,6 +461,11 @@ struct PathFinder::Impl {
   vec3f getRandomNavigablePointAroundSphere(const vec3f& circleCenter,
                                             float radius,
                                             int maxTries);
+  std::vector<vec3f> getRandomNavigablePoints(int numPoints,
+                                              float minIslandRadius);
+  std::vector<vec3f> getRandomNavigablePointsOnIsland(
+      int numPoints,
+      const vec3f& islandPoint);
 
   bool findPath(ShortestPath& path);
   bool findPath(MultiGoalShortestPath& path);
@@ -260,7 +476,7 @@ struct PathFinder::Impl {
   template <typename T>
   T snapPoint(const T& pt);
 
-  bool loadNavMesh(const std::string& path);
+  bool loadNavMesh(const std::string& path, bool memoryMap);
 
   bool saveNavMesh(const std::string& path);
 
@@ -277,6 +493,10 @@ struct PathFinder::Impl {
   HitRecord closestObstacleSurfacePoint(const vec3f& pt,
                                         float maxSearchRadius = 2.0) const;
 
+  bool buildClearanceField(float maxRadius, float cellSize);
+  void clearClearanceField();
+  bool hasClearanceField() const { return clearanceField_ != nullptr; }
+
   bool isNavigable(const vec3f& pt, float maxYDelta = 0.5) const;
 
   std::pair<vec3f, vec3f> bounds() const { return bounds_; };
@@ -291,6 +511,10 @@ struct PathFinder::Impl {
     return navMeshSettings_;
   }
 
+  const dtNavMesh* navMesh() const { return navMesh_.get(); }
+  size_t navMeshGeneration() const { return navMeshGeneration_; }
+  const dtQueryFilter* filter() const { return filter_.get(); }
+
  private:
   struct NavMeshDeleter {
     void operator()(dtNavMesh* mesh) { dtFreeNavMesh(mesh); }
@@ -299,10 +523,23 @@ struct PathFinder::Impl {
     void operator()(dtNavMeshQuery* query) { dtFreeNavMeshQuery(query); }
   };
 
+  //! Backs the tiles of navMesh_ if it was loaded with memoryMap, so it must
+  //! outlive it
+  std::unique_ptr<impl::MappedFile> navMeshMapping_ = nullptr;
   std::unique_ptr<dtNavMesh, NavMeshDeleter> navMesh_ = nullptr;
+  //! Incremented every time navMesh_ is replaced
+  size_t navMeshGeneration_ = 0;
   std::unique_ptr<dtNavMeshQuery, NavQueryDeleter> navQuery_ = nullptr;
   std::unique_ptr<dtQueryFilter> filter_ = nullptr;
   std::unique_ptr<impl::IslandSystem> islandSystem_ = nullptr;
+  std::unique_ptr<impl::ClearanceField> clearanceField_ = nullptr;
+  //! Built from islandSystem_ on first use, reset with it
+  std::unique_ptr<impl::PointSampler> pointSampler_ = nullptr;
+  //! Generator of all sampling, see seed()
+  core::Random random_{0};
+  //! Parameters of clearanceField_, rebuilt with the navmesh. 0 if disabled.
+  float clearanceMaxRadius_ = 0;
+  float clearanceCellSize_ = 0;
 
   //! Holds triangulated geom/topo. Generated when queried. Reset with
   //! navQuery_.
@@ -319,6 +556,10 @@ struct PathFinder::Impl {
 
   bool initNavQuery();
 
+  void rebuildClearanceField();
+
+  impl::PointSampler& pointSampler();
+
   Cr::Containers::Optional<std::tuple<float, std::vector<vec3f>>>
   findPathInternal(const vec3f& start,
                    dtPolyRef startRef,
@@ -654,6 +895,8 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
     }
 
     navMesh_.reset(dtAllocNavMesh());
+    ++navMeshGeneration_;
+    navMeshMapping_.reset();
     if (!navMesh_) {
       dtFree(navData);
       ESP_ERROR() << "Could not allocate Detour navmesh";
@@ -677,6 +920,10 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
 
   // Added as we also need to remove these on navmesh recomputation
   removeZeroAreaPolys();
+  islandSystem_ =
+      std::make_unique<impl::IslandSystem>(navMesh_.get(), filter_.get());
+  pointSampler_.reset();
+  rebuildClearanceField();
 
   ESP_DEBUG() << "Created navmesh with" << ws.pmesh->nverts << "vertices"
               << ws.pmesh->npolys << "polygons";
@@ -695,9 +942,6 @@ bool PathFinder::Impl::initNavQuery() {
     return false;
   }
 
-  islandSystem_ =
-      std::make_unique<impl::IslandSystem>(navMesh_.get(), filter_.get());
-
   return true;
 }
 
@@ -728,7 +972,9 @@ bool PathFinder::Impl::build(const NavMeshSettings& bs,
 
 namespace {
 const int NAVMESHSET_MAGIC = 'M' << 24 | 'S' << 16 | 'E' << 8 | 'T';  //'MSET';
-const int NAVMESHSET_VERSION = 2;
+const int NAVMESHSET_VERSION = 3;
+const int NAVMESHISLANDS_MAGIC =
+    'I' << 24 | 'S' << 16 | 'L' << 8 | 'D';  //'ISLD';
 
 struct NavMeshSetHeader {
   int magic;
@@ -742,6 +988,13 @@ struct NavMeshTileHeader {
   int dataSize;
 };
 
+// Follows the tiles from version 3 on, with the zero area polygons already
+// disabled in the tiles
+struct NavMeshIslandsHeader {
+  int magic;
+  float navMeshArea;
+};
+
 struct Triangle {
   std::vector<vec3f> v;
   Triangle() { v.resize(3); }
@@ -788,8 +1041,455 @@ float polyArea(const dtPoly* poly, const dtMeshTile* tile) {
 
   return area;
 }
+
+// Squared Euclidean distance transform along a line of n values, in place
+// (Felzenszwalb and Huttenlocher). v, z and d are scratch space.
+void distanceTransform1D(float* f,
+                         int n,
+                         std::vector<int>& v,
+                         std::vector<float>& z,
+                         std::vector<float>& d) {
+  v.resize(n);
+  z.resize(n + 1);
+  d.resize(n);
+  int k = 0;
+  v[0] = 0;
+  z[0] = -std::numeric_limits<float>::infinity();
+  z[1] = std::numeric_limits<float>::infinity();
+  for (int q = 1; q < n; ++q) {
+    float s = 0;
+    while (true) {
+      const int p = v[k];
+      s = ((f[q] + float(q * q)) - (f[p] + float(p * p))) / float(2 * (q - p));
+      if (s > z[k] || k == 0) {
+        break;
+      }
+      --k;
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = std::numeric_limits<float>::infinity();
+  }
+  k = 0;
+  for (int q = 0; q < n; ++q) {
+    while (z[k + 1] < float(q)) {
+      ++k;
+    }
+    d[q] = float((q - v[k]) * (q - v[k])) + f[v[k]];
+  }
+  std::copy(d.begin(), d.end(), f);
+}
 }  // namespace
 
+namespace impl {
+
+ClearanceField::ClearanceField(const dtNavMesh* navMesh,
+                               const dtQueryFilter* filter,
+                               const float cellSize,
+                               const float maxClimb,
+                               const float maxRadius)
+    : cellSize_{cellSize}, maxRadius_{maxRadius} {
+  std::vector<Triangle> triangles;
+  float minX = std::numeric_limits<float>::max(), minZ = minX;
+  float maxX = -minX, maxZ = -minX;
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION ||
+          !filter->passFilter(ref, tile, poly))
+        continue;
+      for (Triangle& tri : getPolygonTriangles(poly, tile)) {
+        for (const vec3f& v : tri.v) {
+          minX = std::min(minX, v[0]);
+          maxX = std::max(maxX, v[0]);
+          minZ = std::min(minZ, v[2]);
+          maxZ = std::max(maxZ, v[2]);
+        }
+        triangles.emplace_back(std::move(tri));
+      }
+    }
+  }
+  if (triangles.empty())
+    return;
+
+  originX_ = minX;
+  originZ_ = minZ;
+  width_ = static_cast<int>(std::ceil((maxX - minX) / cellSize_)) + 1;
+  depth_ = static_cast<int>(std::ceil((maxZ - minZ) / cellSize_)) + 1;
+
+  // Heights of the triangles at the cell centers they cover
+  std::vector<std::pair<int, float>> samples;
+  for (const Triangle& tri : triangles) {
+    const vec3f& a = tri.v[0];
+    const vec3f& b = tri.v[1];
+    const vec3f& c = tri.v[2];
+    const float area = (b[0] - a[0]) * (c[2] - a[2]) -
+                       (c[0] - a[0]) * (b[2] - a[2]);
+    if (std::abs(area) < 1e-12f)
+      continue;
+    const float triMinX = std::min({a[0], b[0], c[0]});
+    const float triMaxX = std::max({a[0], b[0], c[0]});
+    const float triMinZ = std::min({a[2], b[2], c[2]});
+    const float triMaxZ = std::max({a[2], b[2], c[2]});
+    const int x0 = std::max(0, static_cast<int>(std::ceil(
+                                   (triMinX - originX_) / cellSize_ - 0.5f)));
+    const int x1 = std::min(
+        width_ - 1,
+        static_cast<int>(std::floor((triMaxX - originX_) / cellSize_ - 0.5f)));
+    const int z0 = std::max(0, static_cast<int>(std::ceil(
+                                   (triMinZ - originZ_) / cellSize_ - 0.5f)));
+    const int z1 = std::min(
+        depth_ - 1,
+        static_cast<int>(std::floor((triMaxZ - originZ_) / cellSize_ - 0.5f)));
+    for (int z = z0; z <= z1; ++z) {
+      const float pz = originZ_ + (z + 0.5f) * cellSize_;
+      for (int x = x0; x <= x1; ++x) {
+        const float px = originX_ + (x + 0.5f) * cellSize_;
+        // barycentric coordinates in the xz plane
+        const float wa = ((b[0] - px) * (c[2] - pz) -
+                          (c[0] - px) * (b[2] - pz)) / area;
+        const float wb = ((c[0] - px) * (a[2] - pz) -
+                          (a[0] - px) * (c[2] - pz)) / area;
+        const float wc = 1.0f - wa - wb;
+        constexpr float eps = -1e-5f;
+        if (wa < eps || wb < eps || wc < eps)
+          continue;
+        samples.emplace_back(x + z * width_, wa * a[1] + wb * b[1] + wc * c[1]);
+      }
+    }
+  }
+  std::sort(samples.begin(), samples.end());
+
+  // Samples of a column closer than half the climb height are one surface
+  std::vector<int> spanCells;
+  columnStarts_.assign(static_cast<size_t>(width_) * depth_ + 1, 0);
+  for (const auto& sample : samples) {
+    if (spanCells.empty() || spanCells.back() != sample.first ||
+        sample.second - spanHeights_.back() > 0.5f * maxClimb) {
+      spanCells.push_back(sample.first);
+      spanHeights_.push_back(sample.second);
+      ++columnStarts_[sample.first + 1];
+    }
+  }
+  std::partial_sum(columnStarts_.begin(), columnStarts_.end(),
+                   columnStarts_.begin());
+
+  // Flood fill the layers
+  constexpr uint32_t Unassigned = ~0u;
+  spanLayers_.assign(spanHeights_.size(), Unassigned);
+  std::vector<int> columnLayers(static_cast<size_t>(width_) * depth_, -1);
+  std::vector<uint32_t> layerSpans;
+  for (uint32_t start = 0; start < spanHeights_.size(); ++start) {
+    if (spanLayers_[start] != Unassigned)
+      continue;
+    const int layerId = layers_.size();
+    layerSpans.assign(1, start);
+    spanLayers_[start] = layerId;
+    columnLayers[spanCells[start]] = layerId;
+    int minCellX = width_, minCellZ = depth_, maxCellX = -1, maxCellZ = -1;
+    for (size_t i = 0; i < layerSpans.size(); ++i) {
+      const uint32_t span = layerSpans[i];
+      const int x = spanCells[span] % width_;
+      const int z = spanCells[span] / width_;
+      minCellX = std::min(minCellX, x);
+      maxCellX = std::max(maxCellX, x);
+      minCellZ = std::min(minCellZ, z);
+      maxCellZ = std::max(maxCellZ, z);
+      constexpr int offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+      for (const auto& offset : offsets) {
+        const int nx = x + offset[0];
+        const int nz = z + offset[1];
+        if (nx < 0 || nz < 0 || nx >= width_ || nz >= depth_)
+          continue;
+        const int column = nx + nz * width_;
+        if (columnLayers[column] == layerId)
+          continue;
+        uint32_t best = Unassigned;
+        float bestDelta = maxClimb;
+        for (uint32_t other = columnStarts_[column];
+             other < columnStarts_[column + 1]; ++other) {
+          const float delta =
+              std::abs(spanHeights_[other] - spanHeights_[span]);
+          if (spanLayers_[other] == Unassigned && delta <= bestDelta) {
+            best = other;
+            bestDelta = delta;
+          }
+        }
+        if (best != Unassigned) {
+          spanLayers_[best] = layerId;
+          columnLayers[column] = layerId;
+          layerSpans.push_back(best);
+        }
+      }
+    }
+
+    Layer layer;
+    layer.x0 = minCellX - 1;
+    layer.z0 = minCellZ - 1;
+    layer.width = maxCellX - minCellX + 3;
+    layer.depth = maxCellZ - minCellZ + 3;
+    computeDistances(layer, layerSpans, spanCells);
+    layers_.emplace_back(std::move(layer));
+  }
+}
+
+void ClearanceField::computeDistances(
+    Layer& layer,
+    const std::vector<uint32_t>& layerSpans,
+    const std::vector<int>& spanCells) const {
+  // everything but the layer is an obstacle
+  constexpr float Far = 1e20f;
+  std::vector<float>& grid = layer.distances;
+  grid.assign(static_cast<size_t>(layer.width) * layer.depth, 0.0f);
+  for (const uint32_t span : layerSpans) {
+    const int x = spanCells[span] % width_ - layer.x0;
+    const int z = spanCells[span] / width_ - layer.z0;
+    grid[x + z * layer.width] = Far;
+  }
+
+  std::vector<int> v;
+  std::vector<float> z, d, column(layer.depth);
+  for (int row = 0; row < layer.depth; ++row)
+    distanceTransform1D(&grid[static_cast<size_t>(row) * layer.width],
+                        layer.width, v, z, d);
+  for (int x = 0; x < layer.width; ++x) {
+    for (int row = 0; row < layer.depth; ++row)
+      column[row] = grid[x + row * layer.width];
+    distanceTransform1D(column.data(), layer.depth, v, z, d);
+    for (int row = 0; row < layer.depth; ++row)
+      grid[x + row * layer.width] = column[row];
+  }
+
+  // the boundary is halfway between a cell of the layer and an obstacle
+  for (float& value : grid)
+    value = std::min(std::sqrt(value) * cellSize_ - 0.5f * cellSize_,
+                     maxRadius_);
+}
+
+float ClearanceField::distance(const vec3f& pt) const {
+  const float fx = (pt[0] - originX_) / cellSize_ - 0.5f;
+  const float fz = (pt[2] - originZ_) / cellSize_ - 0.5f;
+  const int x = static_cast<int>(std::lround(fx));
+  const int z = static_cast<int>(std::lround(fz));
+  if (x < 0 || z < 0 || x >= width_ || z >= depth_)
+    return Mn::Constants::nan();
+
+  const int column = x + z * width_;
+  int best = -1;
+  float bestDelta = MaxHeightOffset;
+  for (uint32_t span = columnStarts_[column]; span < columnStarts_[column + 1];
+       ++span) {
+    const float delta = std::abs(spanHeights_[span] - pt[1]);
+    if (delta <= bestDelta) {
+      best = span;
+      bestDelta = delta;
+    }
+  }
+  if (best == -1)
+    return Mn::Constants::nan();
+
+  // The nearest cell is in the layer and the layer has a margin, so all four
+  // cells around the point are in the layer grid
+  const Layer& layer = layers_[spanLayers_[best]];
+  const float lx = fx - layer.x0;
+  const float lz = fz - layer.z0;
+  const int ix = Mn::Math::clamp(static_cast<int>(std::floor(lx)), 0,
+                                 layer.width - 2);
+  const int iz = Mn::Math::clamp(static_cast<int>(std::floor(lz)), 0,
+                                 layer.depth - 2);
+  const float tx = Mn::Math::clamp(lx - ix, 0.0f, 1.0f);
+  const float tz = Mn::Math::clamp(lz - iz, 0.0f, 1.0f);
+  const float* row0 = &layer.distances[ix + iz * layer.width];
+  const float* row1 = row0 + layer.width;
+  const float value = Mn::Math::lerp(Mn::Math::lerp(row0[0], row0[1], tx),
+                                     Mn::Math::lerp(row1[0], row1[1], tx), tz);
+  return std::max(value, 0.0f);
+}
+
+PointSampler::PointSampler(const dtNavMesh* navMesh,
+                           const dtQueryFilter* filter,
+                           const IslandSystem& islandSystem) {
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (!tile || !tile->header)
+      continue;
+    for (int jPoly = 0; jPoly < tile->header->polyCount; ++jPoly) {
+      const dtPoly* poly = &tile->polys[jPoly];
+      const dtPolyRef ref = navMesh->encodePolyId(tile->salt, iTile, jPoly);
+      const uint32_t island = islandSystem.island(ref);
+      if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION ||
+          island == IslandSystem::NoIsland ||
+          !filter->passFilter(ref, tile, poly))
+        continue;
+      for (const Triangle& tri : getPolygonTriangles(poly, tile)) {
+        const float area =
+            0.5f * (tri.v[1] - tri.v[0]).cross(tri.v[2] - tri.v[0]).norm();
+        if (area <= 0.0f)
+          continue;
+        vertices_.insert(vertices_.end(), tri.v.begin(), tri.v.end());
+        areas_.push_back(area);
+        islands_.push_back(island);
+      }
+    }
+  }
+
+  for (const uint32_t island : islands_) {
+    if (island >= islandRadii_.size())
+      islandRadii_.resize(island + 1, 0.0f);
+    islandRadii_[island] = islandSystem.islandRadiusById(island);
+    sortedIslandRadii_.push_back(islandRadii_[island]);
+  }
+  std::sort(sortedIslandRadii_.begin(), sortedIslandRadii_.end());
+  sortedIslandRadii_.erase(
+      std::unique(sortedIslandRadii_.begin(), sortedIslandRadii_.end()),
+      sortedIslandRadii_.end());
+}
+
+const PointSampler::AliasTable& PointSampler::table(
+    const uint32_t island,
+    const float minIslandRadius) {
+  float radiusKey = 0.0f;
+  if (island == IslandSystem::NoIsland) {
+    const auto bound = std::lower_bound(sortedIslandRadii_.begin(),
+                                        sortedIslandRadii_.end(),
+                                        minIslandRadius);
+    radiusKey = bound != sortedIslandRadii_.end()
+                    ? *bound
+                    : std::numeric_limits<float>::infinity();
+  }
+  const auto key = std::make_pair(island, radiusKey);
+  auto found = tables_.find(key);
+  if (found != tables_.end())
+    return found->second;
+
+  AliasTable& table = tables_[key];
+  double totalArea = 0.0;
+  for (uint32_t i = 0; i < areas_.size(); ++i) {
+    const bool included = island == IslandSystem::NoIsland
+                              ? islandRadii_[islands_[i]] >= radiusKey
+                              : islands_[i] == island;
+    if (included) {
+      table.triangles.push_back(i);
+      totalArea += areas_[i];
+    }
+  }
+
+  // Vose's alias method: every slot holds its own triangle with
+  // probabilities[slot] and its alias otherwise
+  const size_t n = table.triangles.size();
+  table.probabilities.resize(n);
+  table.aliases.resize(n);
+  std::vector<double> scaled(n);
+  std::vector<uint32_t> small, large;
+  for (uint32_t slot = 0; slot < n; ++slot) {
+    scaled[slot] = areas_[table.triangles[slot]] * n / totalArea;
+    (scaled[slot] < 1.0 ? small : large).push_back(slot);
+  }
+  while (!small.empty() && !large.empty()) {
+    const uint32_t less = small.back();
+    small.pop_back();
+    const uint32_t more = large.back();
+    table.probabilities[less] = scaled[less];
+    table.aliases[less] = more;
+    scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+    if (scaled[more] < 1.0) {
+      large.pop_back();
+      small.push_back(more);
+    }
+  }
+  // what remains is 1 up to rounding
+  for (const uint32_t slot : small) {
+    table.probabilities[slot] = 1.0f;
+    table.aliases[slot] = slot;
+  }
+  for (const uint32_t slot : large) {
+    table.probabilities[slot] = 1.0f;
+    table.aliases[slot] = slot;
+  }
+  return table;
+}
+
+bool PointSampler::sample(const uint32_t island,
+                          const float minIslandRadius,
+                          core::Random& random,
+                          vec3f* points,
+                          const int numPoints) {
+  const AliasTable& aliasTable = table(island, minIslandRadius);
+  const uint32_t n = aliasTable.triangles.size();
+  if (n == 0)
+    return false;
+
+  for (int i = 0; i < numPoints; ++i) {
+    uint32_t slot = random.uniform_uint() % n;
+    if (random.uniform_float_01() >= aliasTable.probabilities[slot])
+      slot = aliasTable.aliases[slot];
+    const vec3f* v = &vertices_[3 * size_t(aliasTable.triangles[slot])];
+
+    // uniform in the triangle, folding the far half of the parallelogram
+    float s = random.uniform_float_01();
+    float t = random.uniform_float_01();
+    if (s + t > 1.0f) {
+      s = 1.0f - s;
+      t = 1.0f - t;
+    }
+    points[i] = v[0] + s * (v[1] - v[0]) + t * (v[2] - v[0]);
+  }
+  return true;
+}
+
+}  // namespace impl
+
+bool PathFinder::Impl::buildClearanceField(const float maxRadius,
+                                           const float cellSize) {
+  if (!isLoaded() || maxRadius <= 0) {
+    ESP_ERROR() << "Can't build a clearance field of radius" << maxRadius
+                << "without a loaded navmesh";
+    return false;
+  }
+  clearanceMaxRadius_ = maxRadius;
+  clearanceCellSize_ = cellSize;
+  rebuildClearanceField();
+  return true;
+}
+
+void PathFinder::Impl::clearClearanceField() {
+  clearanceField_.reset();
+  clearanceMaxRadius_ = 0;
+}
+
+void PathFinder::Impl::rebuildClearanceField() {
+  clearanceField_.reset();
+  if (clearanceMaxRadius_ <= 0 || !isLoaded())
+    return;
+
+  const NavMeshSettings defaults;
+  float cellSize = clearanceCellSize_;
+  if (cellSize <= 0)
+    cellSize =
+        navMeshSettings_ ? navMeshSettings_->cellSize : defaults.cellSize;
+  float maxClimb = navMeshSettings_ ? navMeshSettings_->agentMaxClimb
+                                    : defaults.agentMaxClimb;
+  const dtNavMesh* navMesh = navMesh_.get();
+  for (int iTile = 0; iTile < navMesh->getMaxTiles(); ++iTile) {
+    const dtMeshTile* tile = navMesh->getTile(iTile);
+    if (tile && tile->header) {
+      maxClimb = tile->header->walkableClimb;
+      break;
+    }
+  }
+
+  clearanceField_ = std::make_unique<impl::ClearanceField>(
+      navMesh, filter_.get(), cellSize, maxClimb, clearanceMaxRadius_);
+  ESP_DEBUG() << "Built a clearance field with"
+              << clearanceField_->numLayers() << "layers of" << cellSize
+              << "m cells";
+}
+
 // Some polygons have zero area for some reason.  When we navigate into a zero
 // area polygon, things crash.  So we find all zero area polygons and mark
 // them as disabled/not navigable.
@@ -824,7 +1524,17 @@ void PathFinder::Impl::removeZeroAreaPolys() {
   }
 }
 
-bool PathFinder::Impl::loadNavMesh(const std::string& path) {
+bool PathFinder::Impl::loadNavMesh(const std::string& path,
+                                   const bool memoryMap) {
+  std::unique_ptr<impl::MappedFile> mapping;
+  if (memoryMap) {
+    mapping = impl::MappedFile::map(path);
+    if (!mapping) {
+      ESP_ERROR() << "Could not map" << path;
+      return false;
+    }
+  }
+
   FILE* fp = fopen(path.c_str(), "rb");
   if (!fp)
     return false;
@@ -878,20 +1588,38 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
     if ((tileHeader.tileRef == 0u) || (tileHeader.dataSize == 0))
       break;
 
-    unsigned char* data = static_cast<unsigned char*>(
-        dtAlloc(tileHeader.dataSize, DT_ALLOC_PERM));
-    if (!data)
-      break;
-    memset(data, 0, tileHeader.dataSize);
-    readLen = fread(data, tileHeader.dataSize, 1, fp);
-    if (readLen != 1) {
-      dtFree(data);
-      fclose(fp);
-      return false;
+    unsigned char* data = nullptr;
+    int tileFlags = DT_TILE_FREE_DATA;
+    if (mapping) {
+      // Point the tile into the mapping, which Detour mustn't free
+      const long offset = ftell(fp);
+      // Detour needs 4-byte aligned tile data, which saveNavMesh ensures
+      if (offset < 0 || offset % 4 != 0 ||
+          static_cast<size_t>(offset) + tileHeader.dataSize >
+              mapping->size()) {
+        ESP_ERROR() << "Can't map tile" << i << "of" << path;
+        fclose(fp);
+        return false;
+      }
+      data = mapping->data() + offset;
+      tileFlags = 0;
+      fseek(fp, tileHeader.dataSize, SEEK_CUR);
+    } else {
+      data = static_cast<unsigned char*>(
+          dtAlloc(tileHeader.dataSize, DT_ALLOC_PERM));
+      if (!data)
+        break;
+      memset(data, 0, tileHeader.dataSize);
+      readLen = fread(data, tileHeader.dataSize, 1, fp);
+      if (readLen != 1) {
+        dtFree(data);
+        fclose(fp);
+        return false;
+      }
     }
 
-    mesh->addTile(data, tileHeader.dataSize, DT_TILE_FREE_DATA,
-                  tileHeader.tileRef, nullptr);
+    mesh->addTile(data, tileHeader.dataSize, tileFlags, tileHeader.tileRef,
+                  nullptr);
     const dtMeshTile* tile = mesh->getTileByRef(tileHeader.tileRef);
     if (i == 0) {
       bmin = vec3f(tile->header->bmin);
@@ -902,14 +1630,41 @@ bool PathFinder::Impl::loadNavMesh(const std::string& path) {
     }
   }
 
+  std::unique_ptr<impl::IslandSystem> islandSystem;
+  NavMeshIslandsHeader islandsHeader{};
+  if (header.version >= 3 &&
+      fread(&islandsHeader, sizeof(islandsHeader), 1, fp) == 1 &&
+      islandsHeader.magic == NAVMESHISLANDS_MAGIC) {
+    islandSystem = impl::IslandSystem::read(mesh, fp);
+  }
+
   fclose(fp);
 
   navMesh_.reset(mesh);
+  ++navMeshGeneration_;
+  // only after the tiles of the previous navmesh are gone
+  navMeshMapping_ = std::move(mapping);
   bounds_ = std::make_pair(bmin, bmax);
 
-  removeZeroAreaPolys();
+  if (islandSystem) {
+    navMeshArea_ = islandsHeader.navMeshArea;
+    islandSystem_ = std::move(islandSystem);
+  } else {
+    if (header.version >= 3) {
+      ESP_WARNING() << "Islands stored in" << path
+                    << "don't match the navmesh, recomputing them";
+    }
+    removeZeroAreaPolys();
+    islandSystem_ =
+        std::make_unique<impl::IslandSystem>(navMesh_.get(), filter_.get());
+  }
+  pointSampler_.reset();
 
-  return initNavQuery();
+  if (!initNavQuery()) {
+    return false;
+  }
+  rebuildClearanceField();
+  return true;
 }
 
 bool PathFinder::Impl::saveNavMesh(const std::string& path) {
@@ -955,47 +1710,91 @@ bool PathFinder::Impl::saveNavMesh(const std::string& path) {
     fwrite(tile->data, tile->dataSize, 1, fp);
   }
 
+  // Store islands.
+  NavMeshIslandsHeader islandsHeader{};
+  islandsHeader.magic = NAVMESHISLANDS_MAGIC;
+  islandsHeader.navMeshArea = navMeshArea_;
+  fwrite(&islandsHeader, sizeof(islandsHeader), 1, fp);
+  islandSystem_->write(fp);
+
   fclose(fp);
 
   return true;
 }
 
 void PathFinder::Impl::seed(uint32_t newSeed) {
-  // TODO: this should be using core::Random instead, but passing function
-  // to navQuery_->findRandomPoint needs to be figured out first
-  srand(newSeed);
+  random_.seed(newSeed);
 }
 
-// Returns a random number [0..1]
-static float frand() {
-  return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+namespace {
+// Detour's random callbacks take no context, so the generator of the calling
+// PathFinder is passed through a thread local
+thread_local core::Random* detourRandom = nullptr;
+
+// Returns a random number [0..1)
+float frand() {
+  return detourRandom->uniform_float_01();
 }
+}  // namespace
 
-vec3f PathFinder::Impl::getRandomNavigablePoint(const int maxTries /*= 10*/) {
+impl::PointSampler& PathFinder::Impl::pointSampler() {
+  if (!pointSampler_) {
+    pointSampler_ = std::make_unique<impl::PointSampler>(
+        navMesh_.get(), filter_.get(), *islandSystem_);
+  }
+  return *pointSampler_;
+}
+
+vec3f PathFinder::Impl::getRandomNavigablePoint(const int /*maxTries*/) {
   if (getNavigableArea() <= 0.0)
     throw std::runtime_error(
         "NavMesh has no navigable area, this indicates an issue with the "
         "NavMesh");
 
   vec3f pt;
-
-  int i = 0;
-  for (i = 0; i < maxTries; ++i) {
-    dtPolyRef ref = 0;
-    dtStatus status =
-        navQuery_->findRandomPoint(filter_.get(), frand, &ref, pt.data());
-    if (dtStatusSucceed(status))
-      break;
-  }
-
-  if (i == maxTries) {
-    ESP_ERROR() << "Failed to getRandomNavigablePoint.  Try increasing max "
-                   "tries if the navmesh is fine but just hard to sample from";
+  if (!pointSampler().sample(impl::IslandSystem::NoIsland, 0.0f, random_, &pt,
+                             1)) {
+    ESP_ERROR() << "Failed to getRandomNavigablePoint. The navmesh has no "
+                   "walkable triangles";
     return vec3f::Constant(Mn::Constants::nan());
   }
   return pt;
 }
 
+std::vector<vec3f> PathFinder::Impl::getRandomNavigablePoints(
+    const int numPoints,
+    const float minIslandRadius) {
+  std::vector<vec3f> points(std::max(numPoints, 0));
+  if (!isLoaded() ||
+      !pointSampler().sample(impl::IslandSystem::NoIsland, minIslandRadius,
+                             random_, points.data(),
+                             static_cast<int>(points.size())))
+    return {};
+  return points;
+}
+
+std::vector<vec3f> PathFinder::Impl::getRandomNavigablePointsOnIsland(
+    const int numPoints,
+    const vec3f& islandPoint) {
+  if (!isLoaded())
+    return {};
+  dtPolyRef ref = 0;
+  dtStatus status = 0;
+  std::tie(status, ref, std::ignore) =
+      projectToPoly(islandPoint, navQuery_.get(), filter_.get());
+  const uint32_t island =
+      status == DT_SUCCESS ? islandSystem_->island(ref)
+                           : impl::IslandSystem::NoIsland;
+  if (island == impl::IslandSystem::NoIsland)
+    return {};
+
+  std::vector<vec3f> points(std::max(numPoints, 0));
+  if (!pointSampler().sample(island, 0.0f, random_, points.data(),
+                             static_cast<int>(points.size())))
+    return {};
+  return points;
+}
+
 vec3f PathFinder::Impl::getRandomNavigablePointAroundSphere(
     const vec3f& circleCenter,
     const float radius,
@@ -1015,6 +1814,7 @@ vec3f PathFinder::Impl::getRandomNavigablePointAroundSphere(
         << "Failed to getRandomNavigablePoint. No polygon found within radius";
     return vec3f::Constant(Mn::Constants::nan());
   }
+  detourRandom = &random_;
   int i = 0;
   for (; i < maxTries; ++i) {
     dtPolyRef rand_ref = 0;
@@ -1297,6 +2097,15 @@ float PathFinder::Impl::islandRadius(const vec3f& pt) const {
 float PathFinder::Impl::distanceToClosestObstacle(
     const vec3f& pt,
     const float maxSearchRadius /*= 2.0*/) const {
+  if (clearanceField_) {
+    const float distance = clearanceField_->distance(pt);
+    // beyond the field radius only the exact query knows the distance
+    if (!std::isnan(distance) &&
+        (distance < clearanceField_->maxRadius() ||
+         maxSearchRadius <= clearanceField_->maxRadius())) {
+      return std::min(distance, maxSearchRadius);
+    }
+  }
   return closestObstacleSurfacePoint(pt, maxSearchRadius).hitDist;
 }
 
@@ -1426,21 +2235,39 @@ bool PathFinder::build(const NavMeshSettings& bs,
 }
 
 vec3f PathFinder::getRandomNavigablePoint(const int maxTries /*= 10*/) {
+  ++numQueries_;
   return pimpl_->getRandomNavigablePoint(maxTries);
 }
 
+std::vector<vec3f> PathFinder::getRandomNavigablePoints(
+    const int numPoints,
+    const float minIslandRadius) {
+  ++numQueries_;
+  return pimpl_->getRandomNavigablePoints(numPoints, minIslandRadius);
+}
+
+std::vector<vec3f> PathFinder::getRandomNavigablePointsOnIsland(
+    const int numPoints,
+    const vec3f& islandPoint) {
+  ++numQueries_;
+  return pimpl_->getRandomNavigablePointsOnIsland(numPoints, islandPoint);
+}
+
 vec3f PathFinder::getRandomNavigablePointAroundSphere(const vec3f& circleCenter,
                                                       const float radius,
                                                       const int maxTries) {
+  ++numQueries_;
   return pimpl_->getRandomNavigablePointAroundSphere(circleCenter, radius,
                                                      maxTries);
 }
 
 bool PathFinder::findPath(ShortestPath& path) {
+  ++numQueries_;
   return pimpl_->findPath(path);
 }
 
 bool PathFinder::findPath(MultiGoalShortestPath& path) {
+  ++numQueries_;
   return pimpl_->findPath(path);
 }
 
@@ -1450,6 +2277,7 @@ template Mn::Vector3 PathFinder::tryStep<Mn::Vector3>(const Mn::Vector3&,
 
 template <typename T>
 T PathFinder::tryStep(const T& start, const T& end) {
+  ++numQueries_;
   return pimpl_->tryStep(start, end, /*allowSliding=*/true);
 }
 
@@ -1460,6 +2288,7 @@ template Mn::Vector3 PathFinder::tryStepNoSliding<Mn::Vector3>(
 
 template <typename T>
 T PathFinder::tryStepNoSliding(const T& start, const T& end) {
+  ++numQueries_;
   return pimpl_->tryStep(start, end, /*allowSliding=*/false);
 }
 
@@ -1468,11 +2297,12 @@ template Mn::Vector3 PathFinder::snapPoint<Mn::Vector3>(const Mn::Vector3& pt);
 
 template <typename T>
 T PathFinder::snapPoint(const T& pt) {
+  ++numQueries_;
   return pimpl_->snapPoint(pt);
 }
 
-bool PathFinder::loadNavMesh(const std::string& path) {
-  return pimpl_->loadNavMesh(path);
+bool PathFinder::loadNavMesh(const std::string& path, const bool memoryMap) {
+  return pimpl_->loadNavMesh(path, memoryMap);
 }
 
 bool PathFinder::saveNavMesh(const std::string& path) {
@@ -1488,24 +2318,53 @@ void PathFinder::seed(uint32_t newSeed) {
 }
 
 float PathFinder::islandRadius(const vec3f& pt) const {
+  ++numQueries_;
   return pimpl_->islandRadius(pt);
 }
 
 float PathFinder::distanceToClosestObstacle(const vec3f& pt,
                                             const float maxSearchRadius) const {
+  ++numQueries_;
   return pimpl_->distanceToClosestObstacle(pt, maxSearchRadius);
 }
 
 HitRecord PathFinder::closestObstacleSurfacePoint(
     const vec3f& pt,
     const float maxSearchRadius) const {
+  ++numQueries_;
   return pimpl_->closestObstacleSurfacePoint(pt, maxSearchRadius);
 }
 
 bool PathFinder::isNavigable(const vec3f& pt, const float maxYDelta) const {
+  ++numQueries_;
   return pimpl_->isNavigable(pt, maxYDelta);
 }
 
+const dtNavMesh* PathFinder::getDetourNavMesh() const {
+  return pimpl_->navMesh();
+}
+
+size_t PathFinder::getNavMeshGeneration() const {
+  return pimpl_->navMeshGeneration();
+}
+
+const dtQueryFilter* PathFinder::getDetourQueryFilter() const {
+  return pimpl_->filter();
+}
+
+bool PathFinder::buildClearanceField(const float maxRadius,
+                                     const float cellSize) {
+  return pimpl_->buildClearanceField(maxRadius, cellSize);
+}
+
+void PathFinder::clearClearanceField() {
+  pimpl_->clearClearanceField();
+}
+
+bool PathFinder::hasClearanceField() const {
+  return pimpl_->hasClearanceField();
+}
+
 float PathFinder::getNavigableArea() const {
   return pimpl_->getNavigableArea();
 }
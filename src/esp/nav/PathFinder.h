@@ -6,11 +6,15 @@
 #define ESP_NAV_PATHFINDER_H_
 
 #include <Corrade/Containers/Optional.h>
+#include <atomic>
 #include <string>
 #include <vector>
 
 #include "esp/core/Esp.h"
 
+class dtNavMesh;
+class dtQueryFilter;
+
 namespace esp {
 // forward declaration
 namespace assets {
@@ -183,17 +187,45 @@ class PathFinder {
   /**
    * @brief Returns a random navigable point
    *
-   * @param[in] maxTries The maximum number of tries sampling will be retried if
-   * it fails.
+   * Points are distributed uniformly over the navmesh area and drawn from the
+   * pathfinder's own generator, see @ref seed.
+   *
+   * @param[in] maxTries Ignored, sampling never retries. Kept for source
+   * compatibility.
    *
    * @return A random navigable point.
    *
-   * @note This method can fail.  If it does,
-   * the returned point will be `{NAN, NAN, NAN}`. Use @ref
-   * isNavigable to check if the point is navigable.
+   * @note This method fails if the navmesh has no walkable polygons. The
+   * returned point will then be `{NAN, NAN, NAN}`.
    */
   vec3f getRandomNavigablePoint(int maxTries = 10);
 
+  /**
+   * @brief Returns many random navigable points at once
+   *
+   * Same distribution as @ref getRandomNavigablePoint, optionally restricted
+   * to large islands. The area-weighted sampling table of each restriction is
+   * built on first use and reused.
+   *
+   * @param[in] numPoints The number of points
+   * @param[in] minIslandRadius Only sample islands with at least this @ref
+   * islandRadius
+   *
+   * @return The points, empty if no island qualifies
+   */
+  std::vector<vec3f> getRandomNavigablePoints(int numPoints,
+                                              float minIslandRadius = 0.0f);
+
+  /**
+   * @brief Same as @ref getRandomNavigablePoints but only samples the island
+   * @p islandPoint is on
+   *
+   * @return The points, empty if @p islandPoint isn't on the navmesh
+   */
+  std::vector<vec3f> getRandomNavigablePointsOnIsland(
+      int numPoints,
+      const vec3f& islandPoint);
+
   vec3f getRandomNavigablePointAroundSphere(const vec3f& circleCenter,
                                             float radius,
                                             int maxTries = 10);
@@ -260,10 +292,15 @@ class PathFinder {
    *
    * @param[in] path The saved navigation mesh file, generally has extension
    * ``.navmesh``
+   * @param[in] memoryMap Map the file instead of reading its tiles into
+   * memory. The mapping is private and copy-on-write: only the pages Detour
+   * writes to (polygons and links) are copied, the rest of the tile data is
+   * shared by every process mapping the same file. Navmeshes saved by @ref
+   * saveNavMesh need the fewest writes.
    *
    * @return Whether or not the navmesh was successfully loaded
    */
-  bool loadNavMesh(const std::string& path);
+  bool loadNavMesh(const std::string& path, bool memoryMap = false);
 
   /**
    * @brief Saves a navigation mesh to later be loaded by @ref loadNavMesh
@@ -284,7 +321,8 @@ class PathFinder {
    *
    * @param[in] newSeed The random seed
    *
-   * @note This just seeds the global c @ref rand function.
+   * @note Every pathfinder has its own generator, so pathfinders used from
+   * different threads sample reproducibly.
    */
   void seed(uint32_t newSeed);
 
@@ -305,10 +343,40 @@ class PathFinder {
    *
    * @return The distance to the closest non-navigable location or @ref
    * maxSearchRadius if all locations within @ref maxSearchRadius are navigable
+   *
+   * With a clearance field (see @ref buildClearanceField) this is a lookup,
+   * accurate to about one cell of the field, and only distances beyond the
+   * field's radius fall back to searching the navmesh.
    */
   float distanceToClosestObstacle(const vec3f& pt,
                                   float maxSearchRadius = 2.0) const;
 
+  /**
+   * @brief Precompute the distance to the closest non-navigable location on
+   * a grid over the navmesh, for fast @ref distanceToClosestObstacle queries.
+   *
+   * The field is rebuilt whenever the navmesh is built or loaded, until @ref
+   * clearClearanceField is called. @ref closestObstacleSurfacePoint always
+   * searches the navmesh.
+   *
+   * @param[in] maxRadius Distances are stored up to this radius
+   * @param[in] cellSize Grid resolution, or 0 to use the navmesh's cell size
+   *
+   * @return Whether the field was built, false if no navmesh is loaded
+   */
+  bool buildClearanceField(float maxRadius = 2.0f, float cellSize = 0.0f);
+
+  /**
+   * @brief Discard the clearance field built by @ref buildClearanceField
+   */
+  void clearClearanceField();
+
+  /**
+   * @brief Whether a clearance field is used for @ref
+   * distanceToClosestObstacle
+   */
+  bool hasClearanceField() const;
+
   /**
    * @brief Same as @ref distanceToClosestObstacle but returns additional
    * information.
@@ -360,6 +428,33 @@ class PathFinder {
    */
   Corrade::Containers::Optional<NavMeshSettings> getNavMeshSettings() const;
 
+  /**
+   * @brief Return the number of navmesh queries (path searches, steps, snaps,
+   * point samples and obstacle/navigability checks) answered since
+   * construction or the last call to @ref resetNumQueries.
+   */
+  size_t getNumQueries() const { return numQueries_.load(); }
+
+  /**
+   * @brief Reset the counter returned by @ref getNumQueries.
+   */
+  void resetNumQueries() { numQueries_.store(0); }
+
+ protected:
+  friend class Crowd;
+
+  //! The Detour navmesh, nullptr if none is loaded. Invalidated by @ref build
+  //! and @ref loadNavMesh.
+  const dtNavMesh* getDetourNavMesh() const;
+  //! Changes every time @ref getDetourNavMesh is invalidated
+  size_t getNavMeshGeneration() const;
+  //! The filter of walkable polygons used by all queries
+  const dtQueryFilter* getDetourQueryFilter() const;
+
+  //! Incremented by every query entry point, see @ref getNumQueries.
+  //! Atomic since const queries may run on several threads at once.
+  mutable std::atomic<size_t> numQueries_{0};
+
   ESP_SMART_POINTERS_WITH_UNIQUE_PIMPL(PathFinder)
 };
 
@@ -11,6 +11,8 @@
  * JointMotorType, struct @ref JointMotorSettings
  */
 
+#include <Corrade/Containers/ArrayViewStl.h>
+
 #include "RigidBase.h"
 #include "esp/core/Esp.h"
 #include "esp/io/URDFParser.h"
@@ -434,44 +436,112 @@ class ArticulatedObject : public esp::physics::PhysicsObjectBase {
     return objectIdToLinkId_;
   }
 
+  /**
+   * @brief Get the number of degrees of freedom of all joints. This is the
+   * size of the force and velocity arrays.
+   */
+  virtual int getNumDofs() const { return 0; }
+
+  /**
+   * @brief Get the number of position variables of all joints. This is the
+   * size of the position array.
+   */
+  virtual int getNumJointPositions() const { return 0; }
+
   /**
    * @brief Set forces/torques for all joints indexed by degrees of freedom.
    *
    * @param forces The desired joint forces/torques.
    */
-  virtual void setJointForces(CORRADE_UNUSED const std::vector<float>& forces) {
+  void setJointForces(const std::vector<float>& forces) {
+    setJointForces(Corrade::Containers::arrayView(forces));
   }
 
+  /**
+   * @brief Set forces/torques for all joints indexed by degrees of freedom
+   * from a caller-owned buffer of @ref getNumDofs() values.
+   *
+   * @param forces The desired joint forces/torques.
+   */
+  virtual void setJointForces(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> forces) {}
+
   /**
    * @brief Add forces/torques to all joints indexed by degrees of freedom.
    *
    * @param forces The desired joint forces/torques to add.
    */
-  virtual void addJointForces(CORRADE_UNUSED const std::vector<float>& forces) {
+  void addJointForces(const std::vector<float>& forces) {
+    addJointForces(Corrade::Containers::arrayView(forces));
   }
 
+  /**
+   * @brief Add forces/torques to all joints indexed by degrees of freedom
+   * from a caller-owned buffer of @ref getNumDofs() values.
+   *
+   * @param forces The desired joint forces/torques to add.
+   */
+  virtual void addJointForces(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> forces) {}
+
   /**
    * @brief Get current forces/torques for all joints indexed by degrees of
    * freedom.
    *
    * @return The current joint forces/torques.
    */
-  virtual std::vector<float> getJointForces() { return {}; }
+  std::vector<float> getJointForces() {
+    std::vector<float> forces(getNumDofs());
+    getJointForces(Corrade::Containers::arrayView(forces));
+    return forces;
+  }
+
+  /**
+   * @brief Write current forces/torques for all joints indexed by degrees of
+   * freedom into a caller-owned buffer of @ref getNumDofs() values.
+   *
+   * @param[out] forces The current joint forces/torques.
+   */
+  virtual void getJointForces(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> forces) {}
 
   /**
    * @brief Set velocities for all joints indexed by degrees of freedom.
    *
    * @param vels The desired joint velocities.
    */
+  void setJointVelocities(const std::vector<float>& vels) {
+    setJointVelocities(Corrade::Containers::arrayView(vels));
+  }
+
+  /**
+   * @brief Set velocities for all joints indexed by degrees of freedom from a
+   * caller-owned buffer of @ref getNumDofs() values.
+   *
+   * @param vels The desired joint velocities.
+   */
   virtual void setJointVelocities(
-      CORRADE_UNUSED const std::vector<float>& vels) {}
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> vels) {}
 
   /**
    * @brief Get current velocities for all joints indexed by degrees of freedom.
    *
    * @return The current joint velocities.
    */
-  virtual std::vector<float> getJointVelocities() { return {}; }
+  std::vector<float> getJointVelocities() {
+    std::vector<float> vels(getNumDofs());
+    getJointVelocities(Corrade::Containers::arrayView(vels));
+    return vels;
+  }
+
+  /**
+   * @brief Write current velocities for all joints indexed by degrees of
+   * freedom into a caller-owned buffer of @ref getNumDofs() values.
+   *
+   * @param[out] vels The current joint velocities.
+   */
+  virtual void getJointVelocities(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> vels) {}
 
   /**
    * @brief Set positions for all joints.
@@ -483,8 +553,19 @@ class ArticulatedObject : public esp::physics::PhysicsObjectBase {
    *
    * @param positions The desired joint positions.
    */
+  void setJointPositions(const std::vector<float>& positions) {
+    setJointPositions(Corrade::Containers::arrayView(positions));
+  }
+
+  /**
+   * @brief Set positions for all joints from a caller-owned buffer of @ref
+   * getNumJointPositions() values. See @ref setJointPositions(const
+   * std::vector<float>&) for the layout.
+   *
+   * @param positions The desired joint positions.
+   */
   virtual void setJointPositions(
-      CORRADE_UNUSED const std::vector<float>& positions) {}
+      CORRADE_UNUSED Corrade::Containers::ArrayView<const float> positions) {}
 
   /**
    * @brief Get positions for all joints.
@@ -496,7 +577,21 @@ class ArticulatedObject : public esp::physics::PhysicsObjectBase {
    *
    * @return The current joint positions.
    */
-  virtual std::vector<float> getJointPositions() { return {}; }
+  std::vector<float> getJointPositions() {
+    std::vector<float> positions(getNumJointPositions());
+    getJointPositions(Corrade::Containers::arrayView(positions));
+    return positions;
+  }
+
+  /**
+   * @brief Write positions for all joints into a caller-owned buffer of @ref
+   * getNumJointPositions() values. See @ref getJointPositions() for the
+   * layout.
+   *
+   * @param[out] positions The current joint positions.
+   */
+  virtual void getJointPositions(
+      CORRADE_UNUSED Corrade::Containers::ArrayView<float> positions) {}
 
   /**
    * @brief Get the torques on each joint
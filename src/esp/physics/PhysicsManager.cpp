@@ -536,6 +536,7 @@ void PhysicsManager::stepPhysics(double dt) {
   // handle in-between step times? Ideally dt is a multiple of
   // sceneMetaData_.timestep
   double targetTime = worldTime_ + dt;
+  recentNumSubStepsTaken_ = 0;
   while (worldTime_ < targetTime) {
     // per fixed-step operations can be added here
 
@@ -548,6 +549,7 @@ void PhysicsManager::stepPhysics(double dt) {
       }
     }
     worldTime_ += fixedTimeStep_;
+    ++recentNumSubStepsTaken_;
   }
 }
 
@@ -589,17 +591,20 @@ int PhysicsManager::checkActiveObjects() {
   return numActive;
 }
 
-#ifdef ESP_BUILD_WITH_VHACD
-void PhysicsManager::generateVoxelization(const int physObjectID,
-                                          const int resolution) {
+void PhysicsManager::generateVoxelization(
+    const int physObjectID,
+    const int resolution,
+    const esp::geo::VoxelizationMethod method) {
   auto objIter = getRigidObjIteratorOrAssert(physObjectID);
-  objIter->second->generateVoxelization(resourceManager_, resolution);
+  objIter->second->generateVoxelization(resourceManager_, resolution, method);
 }
 
-void PhysicsManager::generateStageVoxelization(const int resolution) {
-  staticStageObject_->generateVoxelization(resourceManager_, resolution);
+void PhysicsManager::generateStageVoxelization(
+    const int resolution,
+    const esp::geo::VoxelizationMethod method) {
+  staticStageObject_->generateVoxelization(resourceManager_, resolution,
+                                           method);
 }
-#endif
 
 std::shared_ptr<esp::geo::VoxelWrapper> PhysicsManager::getObjectVoxelization(
     const int physObjectID) const {
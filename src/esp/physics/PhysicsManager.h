@@ -28,6 +28,7 @@
 #include "esp/assets/GenericSemanticMeshData.h"
 #include "esp/assets/MeshMetaData.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/Check.h"
 #include "esp/gfx/DrawableGroup.h"
 #include "esp/io/URDFParser.h"
 #include "esp/physics/objectWrappers/ManagedArticulatedObject.h"
@@ -76,6 +77,48 @@ struct RaycastResults {
   ESP_SMART_POINTERS(RaycastResults)
 };
 
+/**
+ * @brief Holds hit information for a batch of rays cast with @ref
+ * PhysicsManager::castRays, stored as flat arrays rather than one @ref
+ * RaycastResults per ray.
+ *
+ * The hits of ray @p i occupy indices [hitOffsets[i], hitOffsets[i + 1]) of
+ * the per-hit arrays, sorted by distance. For closest-hit queries each ray has
+ * at most one hit.
+ */
+struct RaycastBatchResults {
+  /** @brief Per-ray offsets into the hit arrays. Number of rays + 1 long. */
+  std::vector<std::size_t> hitOffsets;
+
+  /** @brief The id of the object hit. Stage hits are -1. */
+  std::vector<int> objectIds;
+
+  /** @brief The impact points in world space. */
+  std::vector<Magnum::Vector3> points;
+
+  /** @brief The collision object normals at the points of impact. */
+  std::vector<Magnum::Vector3> normals;
+
+  /** @brief Distances along the ray direction from the ray origin (in units of
+   * ray length). */
+  std::vector<float> rayDistances;
+
+  /** @brief Number of rays in the batch. */
+  std::size_t numRays() const {
+    return hitOffsets.empty() ? 0 : hitOffsets.size() - 1;
+  }
+
+  /** @brief Number of hits of ray @p rayIndex. */
+  std::size_t numHits(std::size_t rayIndex) const {
+    ESP_CHECK(rayIndex < numRays(), "RaycastBatchResults::numHits(): ray index"
+                                        << rayIndex << "out of range for"
+                                        << numRays() << "rays");
+    return hitOffsets[rayIndex + 1] - hitOffsets[rayIndex];
+  }
+
+  ESP_SMART_POINTERS(RaycastBatchResults)
+};
+
 /** @brief based on Bullet b3ContactPointData */
 struct ContactPointData {
   int objectIdA = -2;  // stage is -1
@@ -602,6 +645,14 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   virtual double getWorldTime() const { return worldTime_; }
 
+  /** @brief Get the number of fixed-size substeps taken by the most recent
+   * call to @ref stepPhysics. See @ref recentNumSubStepsTaken_.
+   * @return The number of substeps. -1 if @ref stepPhysics hasn't been called
+   * since the world was initialized, or if collision detection was run on its
+   * own since the last step.
+   */
+  int getRecentNumSubStepsTaken() const { return recentNumSubStepsTaken_; }
+
   /** @brief Get the current gravity in the physical world. By default returns
    * [0,0,0] since their is no notion of force in a kinematic world.
    * @return The current gravity vector in the physical world.
@@ -640,23 +691,28 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
   virtual void setStageRestitutionCoefficient(
       CORRADE_UNUSED const double restitutionCoefficient) {}
 
-#ifdef ESP_BUILD_WITH_VHACD
-  /** @brief Initializes a new VoxelWrapper with a boundary voxelization using
-   * VHACD's voxelization library and assigns it to a rigid body.
+  /** @brief Initializes a new VoxelWrapper with a boundary voxelization and
+   * assigns it to a rigid body.
    * @param  physObjectID The object ID and key identifying the object in @ref
    * PhysicsManager::existingObjects_.
    * @param resolution Represents the approximate number of voxels in the new
    * voxelization.
+   * @param method The voxelizer to use.
    */
-  void generateVoxelization(int physObjectID, int resolution = 1000000);
+  void generateVoxelization(int physObjectID,
+                            int resolution = 1000000,
+                            esp::geo::VoxelizationMethod method =
+                                esp::geo::DefaultVoxelizationMethod);
 
-  /** @brief Initializes a new VoxelWrapper with a boundary voxelization using
-   * VHACD's voxelization library and assigns it to the stage's rigid body.
+  /** @brief Initializes a new VoxelWrapper with a boundary voxelization and
+   * assigns it to the stage's rigid body.
    * @param resolution Represents the approximate number of voxels in the new
    * voxelization.
+   * @param method The voxelizer to use.
    */
-  void generateStageVoxelization(int resolution = 1000000);
-#endif
+  void generateStageVoxelization(int resolution = 1000000,
+                                 esp::geo::VoxelizationMethod method =
+                                     esp::geo::DefaultVoxelizationMethod);
 
   /** @brief Gets the VoxelWrapper associated with a rigid object.
    * @param physObjectID The object ID and key identifying the object in @ref
@@ -858,6 +914,30 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
     return results;
   }
 
+  /**
+   * @brief Cast a batch of rays into the collision world and return their
+   * hits in flat arrays. See @ref RaycastBatchResults.
+   *
+   * Note: not implemented here in default PhysicsManager as there are no
+   * collision objects without a simulation implementation; every ray reports
+   * no hits.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param maxDistance The maximum distance along each ray direction to
+   * search. In units of ray length.
+   * @param allHits If false, only the closest hit of each ray is reported.
+   * @return The hits of all rays, each ray's hits sorted by distance.
+   */
+  virtual RaycastBatchResults castRays(
+      Corrade::Containers::ArrayView<const esp::geo::Ray> rays,
+      CORRADE_UNUSED double maxDistance = 100.0,
+      CORRADE_UNUSED bool allHits = false) {
+    RaycastBatchResults results;
+    results.hitOffsets.assign(rays.size() + 1, 0);
+    return results;
+  }
+
   /**
    * @brief returns the wrapper manager for the currently created rigid
    * objects.
@@ -1258,6 +1338,11 @@ class PhysicsManager : public std::enable_shared_from_this<PhysicsManager> {
    */
   double worldTime_ = 0.0;
 
+  /** @brief The number of fixed-size substeps integrated by the most recent
+   * call to @ref stepPhysics, or -1 if none has been taken yet.
+   */
+  int recentNumSubStepsTaken_ = -1;
+
  public:
   ESP_SMART_POINTERS(PhysicsManager)
 };
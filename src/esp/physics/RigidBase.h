@@ -372,26 +372,27 @@ class RigidBase : public esp::physics::PhysicsObjectBase {
     return voxelWrapper;
   }
 
-#ifdef ESP_BUILD_WITH_VHACD
-
   /** @brief Initializes a new VoxelWrapper with a specified resolution. Creates
    * a boundary voxelization (registered under the key "Boundary" in the
-   * VoxelGrid) using VHACD.
+   * VoxelGrid).
    * @param resourceManager_ A reference to the current resource manager, used
    * for registering the newly created voxel grid within the resource manager's
    * VoxelGrid dictionary.
    * @param resolution Represents the approximate number of voxels in the new
    * voxelization.
+   * @param method The voxelizer to use.
    */
-  void generateVoxelization(esp::assets::ResourceManager& resourceManager_,
-                            int resolution = 1000000) {
+  void generateVoxelization(
+      esp::assets::ResourceManager& resourceManager_,
+      int resolution = 1000000,
+      esp::geo::VoxelizationMethod method =
+          esp::geo::DefaultVoxelizationMethod) {
     std::string renderAssetHandle =
         initializationAttributes_->getRenderAssetHandle();
     voxelWrapper =
         std::make_shared<esp::geo::VoxelWrapper>(esp::geo::VoxelWrapper(
-            renderAssetHandle, &node(), resourceManager_, resolution));
+            renderAssetHandle, &node(), resourceManager_, resolution, method));
   }
-#endif
 
   /**
    * @brief The @ref SceneNode of a bounding box debug drawable. If nullptr, BB
@@ -8,6 +8,7 @@
 #include "BulletDynamics/Featherstone/btMultiBodyLinkCollider.h"
 #include "BulletPhysicsManager.h"
 #include "BulletURDFImporter.h"
+#include "esp/core/Check.h"
 #include "esp/scene/SceneNode.h"
 
 namespace Mn = Magnum;
@@ -377,11 +378,15 @@ void BulletArticulatedObject::setRootAngularVelocity(
   btMultiBody_->setBaseOmega(btVector3(angVel));
 }
 
-void BulletArticulatedObject::setJointForces(const std::vector<float>& forces) {
+void BulletArticulatedObject::setJointForces(
+    Cr::Containers::ArrayView<const float> forces) {
   if (forces.size() != size_t(btMultiBody_->getNumDofs())) {
     ESP_DEBUG() << "Force vector size mis-match (input:" << forces.size()
                 << ", expected:" << btMultiBody_->getNumDofs()
                 << "), aborting.";
+    if (forces.size() < size_t(btMultiBody_->getNumDofs())) {
+      return;
+    }
   }
 
   int dofCount = 0;
@@ -394,11 +399,15 @@ void BulletArticulatedObject::setJointForces(const std::vector<float>& forces) {
   }
 }
 
-void BulletArticulatedObject::addJointForces(const std::vector<float>& forces) {
+void BulletArticulatedObject::addJointForces(
+    Cr::Containers::ArrayView<const float> forces) {
   if (forces.size() != size_t(btMultiBody_->getNumDofs())) {
     ESP_DEBUG() << "Force vector size mis-match (input:" << forces.size()
                 << ", expected:" << btMultiBody_->getNumDofs()
                 << "), aborting.";
+    if (forces.size() < size_t(btMultiBody_->getNumDofs())) {
+      return;
+    }
   }
 
   int dofCount = 0;
@@ -411,8 +420,12 @@ void BulletArticulatedObject::addJointForces(const std::vector<float>& forces) {
   }
 }
 
-std::vector<float> BulletArticulatedObject::getJointForces() {
-  std::vector<float> forces(btMultiBody_->getNumDofs());
+void BulletArticulatedObject::getJointForces(
+    Cr::Containers::ArrayView<float> forces) {
+  ESP_CHECK(forces.size() == size_t(btMultiBody_->getNumDofs()),
+            "BulletArticulatedObject::getJointForces(): expected"
+                << btMultiBody_->getNumDofs() << "values, got"
+                << forces.size());
   int dofCount = 0;
   for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
     btScalar* dofForces = btMultiBody_->getJointTorqueMultiDof(i);
@@ -421,15 +434,17 @@ std::vector<float> BulletArticulatedObject::getJointForces() {
       ++dofCount;
     }
   }
-  return forces;
 }
 
 void BulletArticulatedObject::setJointVelocities(
-    const std::vector<float>& vels) {
+    Cr::Containers::ArrayView<const float> vels) {
   if (vels.size() != size_t(btMultiBody_->getNumDofs())) {
     ESP_DEBUG() << "Velocity vector size mis-match (input:" << vels.size()
                 << ", expected:" << btMultiBody_->getNumDofs()
                 << "), aborting.";
+    if (vels.size() < size_t(btMultiBody_->getNumDofs())) {
+      return;
+    }
   }
 
   int dofCount = 0;
@@ -443,8 +458,11 @@ void BulletArticulatedObject::setJointVelocities(
   }
 }
 
-std::vector<float> BulletArticulatedObject::getJointVelocities() {
-  std::vector<float> vels(btMultiBody_->getNumDofs());
+void BulletArticulatedObject::getJointVelocities(
+    Cr::Containers::ArrayView<float> vels) {
+  ESP_CHECK(vels.size() == size_t(btMultiBody_->getNumDofs()),
+            "BulletArticulatedObject::getJointVelocities(): expected"
+                << btMultiBody_->getNumDofs() << "values, got" << vels.size());
   int dofCount = 0;
   for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
     btScalar* dofVels = btMultiBody_->getJointVelMultiDof(i);
@@ -453,15 +471,17 @@ std::vector<float> BulletArticulatedObject::getJointVelocities() {
       ++dofCount;
     }
   }
-  return vels;
 }
 
 void BulletArticulatedObject::setJointPositions(
-    const std::vector<float>& positions) {
+    Cr::Containers::ArrayView<const float> positions) {
   if (positions.size() != size_t(btMultiBody_->getNumPosVars())) {
     ESP_DEBUG(Mn::Debug::Flag::NoSpace)
         << "Position vector size mis-match (input:" << positions.size()
         << ", expected:" << btMultiBody_->getNumPosVars() << "), aborting.";
+    if (positions.size() < size_t(btMultiBody_->getNumPosVars())) {
+      return;
+    }
   }
 
   int posCount = 0;
@@ -478,8 +498,12 @@ void BulletArticulatedObject::setJointPositions(
   updateKinematicState();
 }
 
-std::vector<float> BulletArticulatedObject::getJointPositions() {
-  std::vector<float> positions(btMultiBody_->getNumPosVars());
+void BulletArticulatedObject::getJointPositions(
+    Cr::Containers::ArrayView<float> positions) {
+  ESP_CHECK(positions.size() == size_t(btMultiBody_->getNumPosVars()),
+            "BulletArticulatedObject::getJointPositions(): expected"
+                << btMultiBody_->getNumPosVars() << "values, got"
+                << positions.size());
   int posCount = 0;
   for (int i = 0; i < btMultiBody_->getNumLinks(); ++i) {
     btScalar* linkPos = btMultiBody_->getJointPosMultiDof(i);
@@ -488,7 +512,6 @@ std::vector<float> BulletArticulatedObject::getJointPositions() {
       ++posCount;
     }
   }
-  return positions;
 }
 
 std::vector<float> BulletArticulatedObject::getJointMotorTorques(
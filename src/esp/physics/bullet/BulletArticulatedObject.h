@@ -30,12 +30,13 @@ struct JointLimitConstraintInfo;
 
 class BulletArticulatedLink : public ArticulatedLink, public BulletBase {
  public:
-  BulletArticulatedLink(scene::SceneNode* bodyNode,
-                        const assets::ResourceManager& resMgr,
-                        std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-                        int index,
-                        std::shared_ptr<std::map<const btCollisionObject*, int>>
-                            collisionObjToObjIds)
+  BulletArticulatedLink(
+      scene::SceneNode* bodyNode,
+      const assets::ResourceManager& resMgr,
+      std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
+      int index,
+      std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
+          collisionObjToObjIds)
       : ArticulatedLink(bodyNode, index, resMgr),
         BulletBase(std::move(bWorld), std::move(collisionObjToObjIds)) {}
 
@@ -68,7 +69,7 @@ class BulletArticulatedObject : public ArticulatedObject {
       assets::ResourceManager& resMgr,
       int objectId,
       std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-      std::shared_ptr<std::map<const btCollisionObject*, int>>
+      std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
           collisionObjToObjIds)
       : ArticulatedObject(rootNode, resMgr, objectId),
         bWorld_(std::move(bWorld)) {
@@ -153,6 +154,26 @@ class BulletArticulatedObject : public ArticulatedObject {
    */
   void setRootAngularVelocity(const Mn::Vector3& angVel) override;
 
+  using ArticulatedObject::addJointForces;
+  using ArticulatedObject::getJointForces;
+  using ArticulatedObject::getJointPositions;
+  using ArticulatedObject::getJointVelocities;
+  using ArticulatedObject::setJointForces;
+  using ArticulatedObject::setJointPositions;
+  using ArticulatedObject::setJointVelocities;
+
+  /**
+   * @brief Get the number of degrees of freedom of all joints.
+   */
+  int getNumDofs() const override { return btMultiBody_->getNumDofs(); }
+
+  /**
+   * @brief Get the number of position variables of all joints.
+   */
+  int getNumJointPositions() const override {
+    return btMultiBody_->getNumPosVars();
+  }
+
   /**
    * @brief Set forces/torques for all joints indexed by degrees of freedom.
    *
@@ -160,7 +181,8 @@ class BulletArticulatedObject : public ArticulatedObject {
    *
    * @param forces The desired joint forces/torques.
    */
-  void setJointForces(const std::vector<float>& forces) override;
+  void setJointForces(
+      Corrade::Containers::ArrayView<const float> forces) override;
 
   /**
    * @brief Add forces/torques to all joints indexed by degrees of freedom.
@@ -169,7 +191,8 @@ class BulletArticulatedObject : public ArticulatedObject {
    *
    * @param forces The desired joint forces/torques to add.
    */
-  void addJointForces(const std::vector<float>& forces) override;
+  void addJointForces(
+      Corrade::Containers::ArrayView<const float> forces) override;
 
   /**
    * @brief Get current forces/torques for all joints indexed by degrees of
@@ -177,23 +200,24 @@ class BulletArticulatedObject : public ArticulatedObject {
    *
    * Bullet clears joint forces/torques with each simulation step.
    *
-   * @return The current joint forces/torques.
+   * @param[out] forces The current joint forces/torques.
    */
-  std::vector<float> getJointForces() override;
+  void getJointForces(Corrade::Containers::ArrayView<float> forces) override;
 
   /**
    * @brief Set velocities for all joints indexed by degrees of freedom.
    *
    * @param vels The desired joint velocities.
    */
-  void setJointVelocities(const std::vector<float>& vels) override;
+  void setJointVelocities(
+      Corrade::Containers::ArrayView<const float> vels) override;
 
   /**
    * @brief Get current velocities for all joints indexed by degrees of freedom.
    *
-   * @return The current joint velocities.
+   * @param[out] vels The current joint velocities.
    */
-  std::vector<float> getJointVelocities() override;
+  void getJointVelocities(Corrade::Containers::ArrayView<float> vels) override;
 
   /**
    * @brief Set positions for all joints.
@@ -205,7 +229,8 @@ class BulletArticulatedObject : public ArticulatedObject {
    *
    * @param positions The desired joint positions.
    */
-  void setJointPositions(const std::vector<float>& positions) override;
+  void setJointPositions(
+      Corrade::Containers::ArrayView<const float> positions) override;
 
   /**
    * @brief Get positions for all joints.
@@ -215,9 +240,10 @@ class BulletArticulatedObject : public ArticulatedObject {
    * block of 4 position values should specify the state as a unit quaternion (x
    * y z w).
    *
-   * @return The current joint positions.
+   * @param[out] positions The current joint positions.
    */
-  std::vector<float> getJointPositions() override;
+  void getJointPositions(
+      Corrade::Containers::ArrayView<float> positions) override;
 
   /**
    * @brief Get the torques on each joint
@@ -479,7 +505,7 @@ class BulletArticulatedObject : public ArticulatedObject {
       linkChildShapes_;
 
   // used to update raycast objectId checks (maps to link ids)
-  std::shared_ptr<std::map<const btCollisionObject*, int>>
+  std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
       collisionObjToObjIds_;
 
   ESP_SMART_POINTERS(BulletArticulatedObject)
@@ -8,6 +8,7 @@
 #include <Magnum/BulletIntegration/MotionState.h>
 #include <btBulletDynamicsCommon.h>
 
+#include <unordered_map>
 #include <utility>
 
 #include "BulletDynamics/Featherstone/btMultiBodyDynamicsWorld.h"
@@ -66,9 +67,10 @@ struct SimulationContactResultCallback
 
 class BulletBase {
  public:
-  BulletBase(std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-             std::shared_ptr<std::map<const btCollisionObject*, int>>
-                 collisionObjToObjIds)
+  BulletBase(
+      std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
+      std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
+          collisionObjToObjIds)
       : bWorld_(std::move(bWorld)),
         collisionObjToObjIds_(std::move(collisionObjToObjIds)) {}
 
@@ -152,7 +154,7 @@ class BulletBase {
 
   //! keep a map of collision objects to object ids for quick lookups from
   //! Bullet collision checking.
-  std::shared_ptr<std::map<const btCollisionObject*, int>>
+  std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
       collisionObjToObjIds_;
 
  public:
@@ -15,16 +15,142 @@
 #include "esp/physics/objectManagers/RigidObjectManager.h"
 #include "esp/sim/Simulator.h"
 
+#include <algorithm>
+
+#if BT_THREADSAFE
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "LinearMath/btThreads.h"
+#endif
+
 namespace esp {
 namespace physics {
 
+namespace {
+
+#if BT_THREADSAFE
+/**
+ * @brief Multi-threaded narrowphase which restores a fixed manifold order
+ * after every dispatch.
+ *
+ * Worker threads append the manifolds they create in scheduling order, which
+ * changes the order the solver visits contacts and so the simulation result.
+ * Sorting by the world indices of the colliding objects makes it depend on the
+ * world contents only.
+ */
+class DeterministicCollisionDispatcherMt : public btCollisionDispatcherMt {
+ public:
+  using btCollisionDispatcherMt::btCollisionDispatcherMt;
+
+  void dispatchAllCollisionPairs(btOverlappingPairCache* pairCache,
+                                 const btDispatcherInfo& dispatchInfo,
+                                 btDispatcher* dispatcher) override {
+    btCollisionDispatcherMt::dispatchAllCollisionPairs(pairCache, dispatchInfo,
+                                                       dispatcher);
+    m_manifoldsPtr.quickSort(ManifoldOrder());
+    // releaseManifold() relies on each manifold knowing its own index
+    for (int i = 0; i < m_manifoldsPtr.size(); ++i) {
+      m_manifoldsPtr[i]->m_index1a = i;
+    }
+  }
+
+ private:
+  struct ManifoldOrder {
+    bool operator()(const btPersistentManifold* a,
+                    const btPersistentManifold* b) const {
+      const int a0 = a->getBody0()->getWorldArrayIndex();
+      const int b0 = b->getBody0()->getWorldArrayIndex();
+      if (a0 != b0) {
+        return a0 < b0;
+      }
+      const int a1 = a->getBody1()->getWorldArrayIndex();
+      const int b1 = b->getBody1()->getWorldArrayIndex();
+      if (a1 != b1) {
+        return a1 < b1;
+      }
+      // compound shapes may hold several manifolds per object pair, one per
+      // pair of children
+      if (a->getNumContacts() == 0 || b->getNumContacts() == 0) {
+        return a->getNumContacts() < b->getNumContacts();
+      }
+      const btManifoldPoint& pa = a->getContactPoint(0);
+      const btManifoldPoint& pb = b->getContactPoint(0);
+      return pa.m_index0 != pb.m_index0 ? pa.m_index0 < pb.m_index0
+                                        : pa.m_index1 < pb.m_index1;
+    }
+  };
+};
+
+/**
+ * @brief Install Bullet's task scheduler and let it use up to @p numThreads
+ * threads. The scheduler is process-wide, so the most recent request wins.
+ * @return The number of threads the scheduler uses, 0 if no multi-threaded
+ * scheduler is available.
+ */
+int setUpTaskScheduler(int numThreads) {
+  static btITaskScheduler* scheduler = nullptr;
+  if (scheduler == nullptr) {
+    scheduler = btCreateDefaultTaskScheduler();
+    if (scheduler == nullptr) {
+      scheduler = btGetOpenMPTaskScheduler();
+    }
+    if (scheduler == nullptr) {
+      return 0;
+    }
+    btSetTaskScheduler(scheduler);
+  }
+  scheduler->setNumThreadsToUse(
+      std::min(numThreads, scheduler->getMaxNumThreads()));
+  return scheduler->getNumThreads();
+}
+#endif
+
+/**
+ * @brief Create the narrowphase dispatcher for stepping with @p numThreads
+ * threads, falling back to the single-threaded one where Bullet is not built
+ * with multi-threading support.
+ * @param[out] effectiveNumThreads The number of threads the dispatcher runs on
+ */
+std::unique_ptr<btCollisionDispatcher> createCollisionDispatcher(
+    btCollisionConfiguration* collisionConfig,
+    int numThreads,
+    bool deterministic,
+    int& effectiveNumThreads) {
+  effectiveNumThreads = 1;
+  if (numThreads > 1) {
+#if BT_THREADSAFE
+    const int schedulerThreads = setUpTaskScheduler(numThreads);
+    if (schedulerThreads > 0) {
+      effectiveNumThreads = schedulerThreads;
+      ESP_DEBUG() << "Stepping physics on up to" << schedulerThreads
+                  << "threads" << (deterministic ? "deterministically." : ".");
+      if (deterministic) {
+        return std::make_unique<DeterministicCollisionDispatcherMt>(
+            collisionConfig);
+      }
+      return std::make_unique<btCollisionDispatcherMt>(collisionConfig);
+    }
+    ESP_WARNING() << "No Bullet task scheduler is available on this "
+                     "platform, stepping physics single-threaded.";
+#else
+    static_cast<void>(deterministic);
+    ESP_WARNING() << "Requested" << numThreads
+                  << "physics threads but Bullet was built without "
+                     "multi-threading support (BT_THREADSAFE), stepping "
+                     "physics single-threaded.";
+#endif
+  }
+  return std::make_unique<btCollisionDispatcher>(collisionConfig);
+}
+
+}  // namespace
+
 BulletPhysicsManager::BulletPhysicsManager(
     assets::ResourceManager& _resourceManager,
     const metadata::attributes::PhysicsManagerAttributes::cptr&
         _physicsManagerAttributes)
     : PhysicsManager(_resourceManager, _physicsManagerAttributes) {
   collisionObjToObjIds_ =
-      std::make_shared<std::map<const btCollisionObject*, int>>();
+      std::make_shared<std::unordered_map<const btCollisionObject*, int>>();
   urdfImporter_ = std::make_unique<BulletURDFImporter>(_resourceManager);
   if (_resourceManager.getCreateRenderer()) {
     debugDrawer_ = std::make_unique<Magnum::BulletIntegration::DebugDraw>();
@@ -54,11 +180,14 @@ void BulletPhysicsManager::removeArticulatedObject(int objectId) {
 bool BulletPhysicsManager::initPhysicsFinalize() {
   activePhysSimLib_ = PhysicsSimulationLibrary::Bullet;
 
+  bDispatcher_ = createCollisionDispatcher(
+      &bCollisionConfig_, physicsManagerAttributes_->getNumThreads(),
+      physicsManagerAttributes_->getDeterministic(), numPhysicsThreads_);
   //! We can potentially use other collision checking algorithms, by
   //! uncommenting the line below
-  // btGImpactCollisionAlgorithm::registerAlgorithm(&bDispatcher_);
+  // btGImpactCollisionAlgorithm::registerAlgorithm(bDispatcher_.get());
   bWorld_ = std::make_shared<btMultiBodyDynamicsWorld>(
-      &bDispatcher_, &bBroadphase_, &bSolver_, &bCollisionConfig_);
+      bDispatcher_.get(), &bBroadphase_, &bSolver_, &bCollisionConfig_);
 
   if (debugDrawer_) {
     debugDrawer_->setMode(
@@ -525,18 +654,142 @@ RaycastResults BulletPhysicsManager::castRay(const esp::geo::Ray& ray,
         rayLength;
     // default to -1 for "scene collision" if we don't know which object was
     // involved
-    hit.objectId = -1;
-    auto rawColObjIdIter =
-        collisionObjToObjIds_->find(allResults.m_collisionObjects[i]);
-    if (rawColObjIdIter != collisionObjToObjIds_->end()) {
-      hit.objectId = rawColObjIdIter->second;
-    }
+    hit.objectId = getCollisionObjectId(allResults.m_collisionObjects[i]);
     results.hits.push_back(hit);
   }
   results.sortByDistance();
   return results;
 }
 
+namespace {
+
+/**
+ * @brief Broadphase tree visitor mirroring btCollisionWorld's internal
+ * btSingleRayCallback, but holding no state shared between rays.
+ */
+struct ConcurrentRayTester : btDbvt::ICollide {
+  ConcurrentRayTester(const btVector3& from,
+                      const btVector3& to,
+                      btCollisionWorld::RayResultCallback& resultCallback)
+      : resultCallback_(resultCallback) {
+    rayFromTrans_.setIdentity();
+    rayFromTrans_.setOrigin(from);
+    rayToTrans_.setIdentity();
+    rayToTrans_.setOrigin(to);
+  }
+
+  void Process(const btDbvtNode* leaf) override {
+    // terminate further ray tests once the closestHitFraction reaches zero
+    if (resultCallback_.m_closestHitFraction == btScalar(0.f)) {
+      return;
+    }
+    const auto* proxy = static_cast<const btDbvtProxy*>(leaf->data);
+    const auto* collisionObject =
+        static_cast<const btCollisionObject*>(proxy->m_clientObject);
+    if (resultCallback_.needsCollision(
+            collisionObject->getBroadphaseHandle())) {
+      btCollisionWorld::rayTestSingle(
+          rayFromTrans_, rayToTrans_, collisionObject,
+          collisionObject->getCollisionShape(),
+          collisionObject->getWorldTransform(), resultCallback_);
+    }
+  }
+
+  btTransform rayFromTrans_;
+  btTransform rayToTrans_;
+  btCollisionWorld::RayResultCallback& resultCallback_;
+};
+
+}  // namespace
+
+void BulletPhysicsManager::rayTestConcurrent(
+    const btVector3& from,
+    const btVector3& to,
+    btCollisionWorld::RayResultCallback& resultCallback) const {
+  ConcurrentRayTester tester(from, to, resultCallback);
+  // btDbvt::rayTest allocates its own traversal stack, unlike
+  // btDbvtBroadphase::rayTest. Set 0 holds dynamic, set 1 static proxies.
+  for (const btDbvt& set : bBroadphase_.m_sets) {
+    btDbvt::rayTest(set.m_root, from, to, tester);
+  }
+}
+
+RaycastBatchResults BulletPhysicsManager::castRays(
+    Cr::Containers::ArrayView<const esp::geo::Ray> rays,
+    double maxDistance,
+    bool allHits) {
+  const std::size_t numRays = rays.size();
+  // each ray fills its own slot, compacted into the flat arrays afterwards
+  std::vector<std::vector<RayHitInfo>> rayHits(numRays);
+
+#pragma omp parallel for schedule(dynamic, 64)
+  for (std::size_t i = 0; i < numRays; ++i) {
+    const esp::geo::Ray& ray = rays[i];
+    const double rayLength = static_cast<double>(ray.direction.length());
+    if (rayLength == 0) {
+      continue;
+    }
+    btVector3 from(ray.origin);
+    btVector3 to(ray.origin + ray.direction * maxDistance);
+    std::vector<RayHitInfo>& hits = rayHits[i];
+
+    if (allHits) {
+      btCollisionWorld::AllHitsRayResultCallback callback(from, to);
+      rayTestConcurrent(from, to, callback);
+      hits.resize(callback.m_hitFractions.size());
+      for (int j = 0; j < callback.m_hitFractions.size(); ++j) {
+        RayHitInfo& hit = hits[j];
+        hit.normal = Magnum::Vector3{callback.m_hitNormalWorld[j]};
+        hit.point = Magnum::Vector3{callback.m_hitPointWorld[j]};
+        hit.rayDistance =
+            (static_cast<double>(callback.m_hitFractions[j]) * maxDistance) /
+            rayLength;
+        hit.objectId = getCollisionObjectId(callback.m_collisionObjects[j]);
+      }
+      std::sort(hits.begin(), hits.end(),
+                [](const RayHitInfo& A, const RayHitInfo& B) {
+                  return A.rayDistance < B.rayDistance;
+                });
+    } else {
+      btCollisionWorld::ClosestRayResultCallback callback(from, to);
+      rayTestConcurrent(from, to, callback);
+      if (callback.hasHit()) {
+        hits.emplace_back();
+        RayHitInfo& hit = hits.back();
+        hit.normal = Magnum::Vector3{callback.m_hitNormalWorld};
+        hit.point = Magnum::Vector3{callback.m_hitPointWorld};
+        hit.rayDistance =
+            (static_cast<double>(callback.m_closestHitFraction) * maxDistance) /
+            rayLength;
+        hit.objectId = getCollisionObjectId(callback.m_collisionObject);
+      }
+    }
+  }
+
+  RaycastBatchResults results;
+  results.hitOffsets.resize(numRays + 1);
+  std::size_t numHits = 0;
+  for (std::size_t i = 0; i < numRays; ++i) {
+    results.hitOffsets[i] = numHits;
+    numHits += rayHits[i].size();
+  }
+  results.hitOffsets[numRays] = numHits;
+
+  results.objectIds.reserve(numHits);
+  results.points.reserve(numHits);
+  results.normals.reserve(numHits);
+  results.rayDistances.reserve(numHits);
+  for (const std::vector<RayHitInfo>& hits : rayHits) {
+    for (const RayHitInfo& hit : hits) {
+      results.objectIds.push_back(hit.objectId);
+      results.points.push_back(hit.point);
+      results.normals.push_back(hit.normal);
+      results.rayDistances.push_back(static_cast<float>(hit.rayDistance));
+    }
+  }
+  return results;
+}
+
 void BulletPhysicsManager::lookUpObjectIdAndLinkId(
     const btCollisionObject* colObj,
     int* objectId,
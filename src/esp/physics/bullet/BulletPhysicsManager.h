@@ -260,6 +260,27 @@ class BulletPhysicsManager : public PhysicsManager {
   RaycastResults castRay(const esp::geo::Ray& ray,
                          double maxDistance = 100.0) override;
 
+  /**
+   * @brief Cast a batch of rays into the collision world and return their
+   * hits in flat arrays.
+   *
+   * Rays are cast in parallel (with OpenMP, if available) against the
+   * collision world, which is only read. Unlike @ref castRay, the broadphase
+   * is traversed with per-ray state so concurrent queries don't share
+   * Bullet's internal ray test stack.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param maxDistance The maximum distance along each ray direction to
+   * search. In units of ray length.
+   * @param allHits If false, only the closest hit of each ray is reported.
+   * @return The hits of all rays, each ray's hits sorted by distance.
+   */
+  RaycastBatchResults castRays(
+      Corrade::Containers::ArrayView<const esp::geo::Ray> rays,
+      double maxDistance = 100.0,
+      bool allHits = false) override;
+
   /**
    * @brief Query the number of contact points that were active during the
    * collision detection check.
@@ -276,6 +297,12 @@ class BulletPhysicsManager : public PhysicsManager {
         bWorld_.get());
   }
 
+  /**
+   * @brief The number of threads the narrowphase runs on. 1 when a single
+   * thread was requested, or when Bullet has no multi-threading support.
+   */
+  int getNumPhysicsThreads() const { return numPhysicsThreads_; }
+
   /**
    * @brief Query the number of overlapping pairs that were active during the
    * collision detection check.
@@ -412,7 +439,14 @@ class BulletPhysicsManager : public PhysicsManager {
   btDefaultCollisionConfiguration bCollisionConfig_;
 
   btMultiBodyConstraintSolver bSolver_;
-  btCollisionDispatcher bDispatcher_{&bCollisionConfig_};
+
+  /** @brief The narrowphase dispatcher. Multi-threaded if the @ref
+   * PhysicsManagerAttributes request more than one thread and Bullet supports
+   * it. Created in @ref initPhysicsFinalize.*/
+  std::unique_ptr<btCollisionDispatcher> bDispatcher_;
+
+  //! The number of threads @ref bDispatcher_ runs on
+  int numPhysicsThreads_ = 1;
 
   /** @brief A pointer to the Bullet world. See @ref btMultiBodyDynamicsWorld.*/
   std::shared_ptr<btMultiBodyDynamicsWorld> bWorld_;
@@ -421,13 +455,11 @@ class BulletPhysicsManager : public PhysicsManager {
 
   //! keep a map of collision objects to object ids for quick lookups from
   //! Bullet collision checking.
-  std::shared_ptr<std::map<const btCollisionObject*, int>>
+  std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
       collisionObjToObjIds_;
 
   //! necessary to acquire forces from impulses
   double recentTimeStep_ = fixedTimeStep_;
-  //! for recent call to stepPhysics
-  int recentNumSubStepsTaken_ = -1;
 
  private:
   /** @brief Check if a particular mesh can be used as a collision mesh for
@@ -453,6 +485,32 @@ class BulletPhysicsManager : public PhysicsManager {
                                int* objectId,
                                int* linkId) const;
 
+  /**
+   * @brief Thread-safe equivalent of btCollisionWorld::rayTest. Walks the
+   * broadphase trees with a local stack instead of the one shared by the
+   * broadphase, so it can be called concurrently between simulation steps.
+   *
+   * @param from Ray start in world space.
+   * @param to Ray end in world space.
+   * @param resultCallback Receives the hits, as for btCollisionWorld::rayTest.
+   */
+  void rayTestConcurrent(
+      const btVector3& from,
+      const btVector3& to,
+      btCollisionWorld::RayResultCallback& resultCallback) const;
+
+  /**
+   * @brief Look up the object id of a collision object, or -1 for the stage
+   * and unknown objects.
+   */
+  int getCollisionObjectId(const btCollisionObject* colObj) const {
+    auto rawColObjIdIter = collisionObjToObjIds_->find(colObj);
+    if (rawColObjIdIter != collisionObjToObjIds_->end()) {
+      return rawColObjIdIter->second;
+    }
+    return -1;
+  }
+
   /**
    * @brief Helper function for removing all rigid constraints referencing an
    * object.
@@ -38,7 +38,7 @@ BulletRigidObject::BulletRigidObject(
     int objectId,
     const assets::ResourceManager& resMgr,
     std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-    std::shared_ptr<std::map<const btCollisionObject*, int> >
+    std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
         collisionObjToObjIds)
     : BulletBase(std::move(bWorld), std::move(collisionObjToObjIds)),
       RigidObject(rigidBodyNode, objectId, resMgr),
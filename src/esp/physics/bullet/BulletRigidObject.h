@@ -50,12 +50,13 @@ class BulletRigidObject : public BulletBase,
    * @param collisionObjToObjIds The global map of btCollisionObjects to Habitat
    * object IDs for contact query identification.
    */
-  BulletRigidObject(scene::SceneNode* rigidBodyNode,
-                    int objectId,
-                    const assets::ResourceManager& resMgr,
-                    std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-                    std::shared_ptr<std::map<const btCollisionObject*, int>>
-                        collisionObjToObjIds);
+  BulletRigidObject(
+      scene::SceneNode* rigidBodyNode,
+      int objectId,
+      const assets::ResourceManager& resMgr,
+      std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
+      std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
+          collisionObjToObjIds);
 
   /**
    * @brief Destructor cleans up simulation structures for the object.
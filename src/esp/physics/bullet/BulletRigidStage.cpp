@@ -23,7 +23,7 @@ BulletRigidStage::BulletRigidStage(
     scene::SceneNode* rigidBodyNode,
     const assets::ResourceManager& resMgr,
     std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-    std::shared_ptr<std::map<const btCollisionObject*, int> >
+    std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
         collisionObjToObjIds)
     : BulletBase(std::move(bWorld), std::move(collisionObjToObjIds)),
       RigidStage{rigidBodyNode, resMgr} {}
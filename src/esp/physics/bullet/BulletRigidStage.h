@@ -21,11 +21,12 @@ namespace physics {
 
 class BulletRigidStage : public BulletBase, public RigidStage {
  public:
-  BulletRigidStage(scene::SceneNode* rigidBodyNode,
-                   const assets::ResourceManager& resMgr,
-                   std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-                   std::shared_ptr<std::map<const btCollisionObject*, int>>
-                       collisionObjToObjIds);
+  BulletRigidStage(
+      scene::SceneNode* rigidBodyNode,
+      const assets::ResourceManager& resMgr,
+      std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
+      std::shared_ptr<std::unordered_map<const btCollisionObject*, int>>
+          collisionObjToObjIds);
 
   /**
    * @brief Destructor cleans up simulation structures for the stage object.
@@ -4,9 +4,22 @@
 
 #include "ArticulatedObjectManager.h"
 
+#include "esp/core/Check.h"
+
 namespace esp {
 namespace physics {
 
+namespace {
+void checkArticulatedObjectIds(const PhysicsManager& physMgr,
+                               const std::vector<int>& objectIds,
+                               const char* caller) {
+  for (const int objectId : objectIds) {
+    ESP_CHECK(physMgr.isValidArticulatedObjectId(objectId),
+              caller << "no articulated object with id" << objectId);
+  }
+}
+}  // namespace
+
 ArticulatedObjectManager::ArticulatedObjectManager()
     : esp::physics::PhysicsObjectBaseManager<ManagedArticulatedObject>::
           PhysicsObjectBaseManager("ArticulatedObject") {
@@ -66,5 +79,78 @@ ArticulatedObjectManager::addArticulatedObjectFromURDFWithDrawables(
   return nullptr;
 }
 
+int ArticulatedObjectManager::getNumDofs(
+    const std::vector<int>& objectIds) const {
+  int numDofs = 0;
+  if (auto physMgr = this->getPhysicsManager()) {
+    checkArticulatedObjectIds(*physMgr, objectIds,
+                              "ArticulatedObjectManager::getNumDofs():");
+    for (const int objectId : objectIds) {
+      numDofs += physMgr->getArticulatedObject(objectId).getNumDofs();
+    }
+  }
+  return numDofs;
+}
+
+int ArticulatedObjectManager::getNumJointPositions(
+    const std::vector<int>& objectIds) const {
+  int numPositions = 0;
+  if (auto physMgr = this->getPhysicsManager()) {
+    checkArticulatedObjectIds(
+        *physMgr, objectIds,
+        "ArticulatedObjectManager::getNumJointPositions():");
+    for (const int objectId : objectIds) {
+      numPositions +=
+          physMgr->getArticulatedObject(objectId).getNumJointPositions();
+    }
+  }
+  return numPositions;
+}
+
+void ArticulatedObjectManager::gatherJointPositions(
+    const std::vector<int>& objectIds,
+    Corrade::Containers::ArrayView<float> positions) {
+  auto physMgr = this->getPhysicsManager();
+  if (!physMgr) {
+    return;
+  }
+  checkArticulatedObjectIds(
+      *physMgr, objectIds, "ArticulatedObjectManager::gatherJointPositions():");
+  ESP_CHECK(positions.size() == size_t(getNumJointPositions(objectIds)),
+            "ArticulatedObjectManager::gatherJointPositions(): expected"
+                << getNumJointPositions(objectIds) << "values, got"
+                << positions.size());
+  size_t offset = 0;
+  for (const int objectId : objectIds) {
+    ArticulatedObject& ao = physMgr->getArticulatedObject(objectId);
+    const size_t count = ao.getNumJointPositions();
+    ao.getJointPositions(positions.slice(offset, offset + count));
+    offset += count;
+  }
+}
+
+void ArticulatedObjectManager::gatherJointVelocities(
+    const std::vector<int>& objectIds,
+    Corrade::Containers::ArrayView<float> velocities) {
+  auto physMgr = this->getPhysicsManager();
+  if (!physMgr) {
+    return;
+  }
+  checkArticulatedObjectIds(
+      *physMgr, objectIds,
+      "ArticulatedObjectManager::gatherJointVelocities():");
+  ESP_CHECK(velocities.size() == size_t(getNumDofs(objectIds)),
+            "ArticulatedObjectManager::gatherJointVelocities(): expected"
+                << getNumDofs(objectIds) << "values, got"
+                << velocities.size());
+  size_t offset = 0;
+  for (const int objectId : objectIds) {
+    ArticulatedObject& ao = physMgr->getArticulatedObject(objectId);
+    const size_t count = ao.getNumDofs();
+    ao.getJointVelocities(velocities.slice(offset, offset + count));
+    offset += count;
+  }
+}
+
 }  // namespace physics
 }  // namespace esp
@@ -123,6 +123,49 @@ class ArticulatedObjectManager
       bool maintainLinkOrder = false,
       const std::string& lightSetup = DEFAULT_LIGHTING_KEY);
 
+  /**
+   * @brief Get the summed number of degrees of freedom of the given articulated
+   * objects. This is the size of the buffer expected by @ref
+   * gatherJointVelocities.
+   * @param objectIds The ids of the articulated objects to query. Every id
+   * must refer to an existing articulated object.
+   */
+  int getNumDofs(const std::vector<int>& objectIds) const;
+
+  /**
+   * @brief Get the summed number of joint positions of the given articulated
+   * objects. This is the size of the buffer expected by @ref
+   * gatherJointPositions.
+   * @param objectIds The ids of the articulated objects to query.
+   */
+  int getNumJointPositions(const std::vector<int>& objectIds) const;
+
+  /**
+   * @brief Write the joint positions of many articulated objects into one
+   * contiguous caller-owned buffer, without intermediate allocations.
+   *
+   * Positions of each object are laid out back to back in the order of @p
+   * objectIds, each block being @ref ArticulatedObject::getNumJointPositions
+   * values long.
+   * @param objectIds The ids of the articulated objects to query.
+   * @param[out] positions Buffer of @ref getNumJointPositions values.
+   */
+  void gatherJointPositions(const std::vector<int>& objectIds,
+                            Corrade::Containers::ArrayView<float> positions);
+
+  /**
+   * @brief Write the joint velocities of many articulated objects into one
+   * contiguous caller-owned buffer, without intermediate allocations.
+   *
+   * Velocities of each object are laid out back to back in the order of @p
+   * objectIds, each block being @ref ArticulatedObject::getNumDofs values
+   * long.
+   * @param objectIds The ids of the articulated objects to query.
+   * @param[out] velocities Buffer of @ref getNumDofs values.
+   */
+  void gatherJointVelocities(const std::vector<int>& objectIds,
+                             Corrade::Containers::ArrayView<float> velocities);
+
  protected:
   /**
    * @brief This method will remove articulated objects from physics manager.
@@ -96,18 +96,44 @@ class ManagedArticulatedObject
     return Mn::Vector3(0);
   }
 
+  int getNumDofs() const {
+    if (auto sp = getObjectReference()) {
+      return sp->getNumDofs();
+    }
+    return 0;
+  }
+
+  int getNumJointPositions() const {
+    if (auto sp = getObjectReference()) {
+      return sp->getNumJointPositions();
+    }
+    return 0;
+  }
+
   void setJointForces(const std::vector<float>& forces) {
     if (auto sp = getObjectReference()) {
       sp->setJointForces(forces);
     }
   }
 
+  void setJointForces(Corrade::Containers::ArrayView<const float> forces) {
+    if (auto sp = getObjectReference()) {
+      sp->setJointForces(forces);
+    }
+  }
+
   void addJointForces(const std::vector<float>& forces) {
     if (auto sp = getObjectReference()) {
       sp->addJointForces(forces);
     }
   }
 
+  void addJointForces(Corrade::Containers::ArrayView<const float> forces) {
+    if (auto sp = getObjectReference()) {
+      sp->addJointForces(forces);
+    }
+  }
+
   std::vector<float> getJointForces() {
     if (auto sp = getObjectReference()) {
       return sp->getJointForces();
@@ -115,12 +141,24 @@ class ManagedArticulatedObject
     return {};
   }
 
+  void getJointForces(Corrade::Containers::ArrayView<float> forces) {
+    if (auto sp = getObjectReference()) {
+      sp->getJointForces(forces);
+    }
+  }
+
   void setJointVelocities(const std::vector<float>& vels) {
     if (auto sp = getObjectReference()) {
       sp->setJointVelocities(vels);
     }
   }
 
+  void setJointVelocities(Corrade::Containers::ArrayView<const float> vels) {
+    if (auto sp = getObjectReference()) {
+      sp->setJointVelocities(vels);
+    }
+  }
+
   std::vector<float> getJointVelocities() {
     if (auto sp = getObjectReference()) {
       return sp->getJointVelocities();
@@ -128,12 +166,25 @@ class ManagedArticulatedObject
     return {};
   }
 
+  void getJointVelocities(Corrade::Containers::ArrayView<float> vels) {
+    if (auto sp = getObjectReference()) {
+      sp->getJointVelocities(vels);
+    }
+  }
+
   void setJointPositions(const std::vector<float>& positions) {
     if (auto sp = getObjectReference()) {
       sp->setJointPositions(positions);
     }
   }
 
+  void setJointPositions(
+      Corrade::Containers::ArrayView<const float> positions) {
+    if (auto sp = getObjectReference()) {
+      sp->setJointPositions(positions);
+    }
+  }
+
   std::vector<float> getJointPositions() {
     if (auto sp = getObjectReference()) {
       return sp->getJointPositions();
@@ -141,6 +192,12 @@ class ManagedArticulatedObject
     return {};
   }
 
+  void getJointPositions(Corrade::Containers::ArrayView<float> positions) {
+    if (auto sp = getObjectReference()) {
+      sp->getJointPositions(positions);
+    }
+  }
+
   std::vector<float> getJointMotorTorques(double fixedTimeStep) {
     if (auto sp = getObjectReference()) {
       return sp->getJointMotorTorques(fixedTimeStep);
@@ -207,6 +207,9 @@ const Mn::Range3D& SceneNode::computeCumulativeBB() {
     }
     child = child->nextSibling();
   }
+  // the world box is recomputed on the next clean; marking the node dirty
+  // also notifies features caching it (e.g. drawables)
+  setDirty();
   return cumulativeBB_;
 }
 
@@ -62,10 +62,11 @@ class SceneNode : public MagnumObject,
   void setType(SceneNodeType type) { type_ = type; }
 
   // Add a feature. Used to avoid naked `new` and makes intent clearer.
+  // The node owns the feature; the reference is for further setup.
   template <class U, class... Args>
-  void addFeature(Args&&... args) {
+  U& addFeature(Args&&... args) {
     // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
-    new U{*this, std::forward<Args>(args)...};
+    return *(new U{*this, std::forward<Args>(args)...});
   }
 
   // Returns sceneNodeTags of SceneNode
@@ -122,8 +123,14 @@ class SceneNode : public MagnumObject,
   //! Returns node semanticId
   virtual int getSemanticId() const { return semanticId_; }
 
-  //! Sets node semanticId
-  virtual void setSemanticId(int semanticId) { semanticId_ = semanticId; }
+  //! Sets node semanticId; notifies the node's features as a move would,
+  //! since e.g. gfx::replay::Recorder tracks both the same way
+  virtual void setSemanticId(int semanticId) {
+    if (semanticId_ != uint32_t(semanticId)) {
+      semanticId_ = semanticId;
+      setDirty();
+    }
+  }
 
   Magnum::Vector3 absoluteTranslation() const;
 
@@ -198,7 +205,11 @@ class SceneNode : public MagnumObject,
   void setMeshBB(Magnum::Range3D meshBB) { meshBB_ = meshBB; };
 
   //! set the global bounding box for mesh stored in this node
-  void setAbsoluteAABB(Magnum::Range3D aabb) { aabb_ = aabb; };
+  void setAbsoluteAABB(Magnum::Range3D aabb) {
+    aabb_ = aabb;
+    // let features caching the node's bounds (e.g. drawables) know
+    setDirty();
+  };
 
   //! return the frustum plane in last frame that culls this node
   int getFrustumPlaneIndex() const { return frustumPlaneIndex; };
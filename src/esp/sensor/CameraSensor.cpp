@@ -120,11 +120,22 @@ bool CameraSensor::drawObservation(sim::Simulator& sim) {
   }
 
   renderTarget().renderEnter();
+  renderCamera_->resetDrawStats();
+  renderCamera_->setLodThreshold(cameraSensorSpec_->lodThreshold);
 
   gfx::RenderCamera::Flags flags;
   if (sim.isFrustumCullingEnabled()) {
     flags |= gfx::RenderCamera::Flag::FrustumCulling;
   }
+  if (sim.isDrawStateSortingEnabled()) {
+    flags |= gfx::RenderCamera::Flag::SortByState;
+  }
+  if (sim.isInstancingEnabled()) {
+    flags |= gfx::RenderCamera::Flag::Instancing;
+  }
+  if (sim.isDrawStateStatsEnabled()) {
+    flags |= gfx::RenderCamera::Flag::CollectStateStats;
+  }
 
   if (cameraSensorSpec_->sensorType == SensorType::Semantic) {
     // TODO: check sim has semantic scene graph
@@ -159,6 +170,7 @@ bool CameraSensor::drawObservation(sim::Simulator& sim) {
   }
 
   renderTarget().renderExit();
+  collectDrawStats(*renderCamera_);
 
   return true;
 }
@@ -95,21 +95,28 @@ bool CubeMapSensorBaseSpec::operator==(const CubeMapSensorBaseSpec& a) const {
   return (VisualSensorSpec::operator==(a) && cubemapSize == a.cubemapSize);
 }
 
+gfx::CubeMap::Faces CubeMapSensorBase::getSampledCubeFaces(
+    CORRADE_UNUSED int cubemapSize) {
+  return gfx::CubeMap::Faces{Mn::UnsignedByte(0x3f)};
+}
+
 bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
   if (!hasRenderTarget()) {
     return false;
   }
 
   // in case the fisheye sensor resolution changed at runtime
-  {
-    int size = computeCubemapSize(cubeMapSensorBaseSpec_->resolution,
-                                  cubeMapSensorBaseSpec_->cubemapSize);
-    bool reset = cubeMap_->reset(size);
-    if (reset) {
-      cubeMapCamera_->setProjectionMatrix(size, cubeMapSensorBaseSpec_->near,
-                                          cubeMapSensorBaseSpec_->far);
-    }
+  int size = computeCubemapSize(cubeMapSensorBaseSpec_->resolution,
+                                cubeMapSensorBaseSpec_->cubemapSize);
+  bool reset = cubeMap_->reset(size);
+  if (reset) {
+    cubeMapCamera_->setProjectionMatrix(size, cubeMapSensorBaseSpec_->near,
+                                        cubeMapSensorBaseSpec_->far);
   }
+  const gfx::CubeMap::Faces faces = getSampledCubeFaces(size);
+
+  cubeMapCamera_->resetDrawStats();
+  cubeMapCamera_->setLodThreshold(cubeMapSensorBaseSpec_->lodThreshold);
 
   esp::gfx::RenderCamera::Flags flags = {
       gfx::RenderCamera::Flag::ClearColor |
@@ -118,6 +125,15 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
   if (sim.isFrustumCullingEnabled()) {
     flags |= gfx::RenderCamera::Flag::FrustumCulling;
   }
+  if (sim.isDrawStateSortingEnabled()) {
+    flags |= gfx::RenderCamera::Flag::SortByState;
+  }
+  if (sim.isInstancingEnabled()) {
+    flags |= gfx::RenderCamera::Flag::Instancing;
+  }
+  if (sim.isDrawStateStatsEnabled()) {
+    flags |= gfx::RenderCamera::Flag::CollectStateStats;
+  }
 
   // generate the cubemap texture
   const char* defaultDrawableGroupName = "";
@@ -129,11 +145,11 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
       VisualSensor::MoveSemanticSensorNodeHelper helper(*this, sim);
       cubeMap_->renderToTexture(*cubeMapCamera_,
                                 sim.getActiveSemanticSceneGraph(),
-                                defaultDrawableGroupName, flags);
+                                defaultDrawableGroupName, flags, faces);
     } else {
       cubeMap_->renderToTexture(*cubeMapCamera_,
                                 sim.getActiveSemanticSceneGraph(),
-                                defaultDrawableGroupName, flags);
+                                defaultDrawableGroupName, flags, faces);
     }
 
     if (twoSceneGraphs) {
@@ -145,13 +161,15 @@ bool CubeMapSensorBase::renderToCubemapTexture(sim::Simulator& sim) {
       flags &= ~gfx::RenderCamera::Flag::ClearDepth;
       flags &= ~gfx::RenderCamera::Flag::ClearObjectId;
       cubeMap_->renderToTexture(*cubeMapCamera_, sim.getActiveSceneGraph(),
-                                defaultDrawableGroupName, flags);
+                                defaultDrawableGroupName, flags, faces);
     }
   } else {
     cubeMap_->renderToTexture(*cubeMapCamera_, sim.getActiveSceneGraph(),
-                              defaultDrawableGroupName, flags);
+                              defaultDrawableGroupName, flags, faces);
   }
 
+  collectDrawStats(*cubeMapCamera_);
+
   return true;
 }
 
@@ -82,6 +82,15 @@ class CubeMapSensorBase : public VisualSensor {
 
   virtual Magnum::ResourceKey getShaderKey() = 0;
 
+  /**
+   * @brief The cube faces the projection of this sensor can sample. Faces
+   * outside of this set are not rendered.
+   * @param[in] cubemapSize the size of the cubemap
+   *
+   * The default returns all six faces.
+   */
+  virtual gfx::CubeMap::Faces getSampledCubeFaces(int cubemapSize);
+
   template <typename T>
   Magnum::Resource<gfx::CubeMapShaderBase, T> getShader();
 
@@ -5,8 +5,11 @@
 #include "esp/core/Check.h"
 #include "esp/gfx/DoubleSphereCameraShader.h"
 
+#include <cmath>
+
 #include <Corrade/Utility/Assert.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Functions.h>
 
 namespace Mn = Magnum;
 namespace Cr = Corrade;
@@ -81,6 +84,115 @@ Mn::ResourceKey FisheyeSensor::getShaderKey() {
           cubeMapShaderBaseFlags_));
 }
 
+namespace {
+
+/**
+ * @brief Add the faces a cubemap lookup in direction @p dir may read to
+ * @p faces, following the face selection rule of OpenGL cubemap sampling.
+ * @param margin distance to the face border, in face coordinates ([-1, 1]),
+ * within which the neighboring face is added as well
+ */
+void addSampledFaces(const Mn::Vector3& dir,
+                     float margin,
+                     gfx::CubeMap::Faces& faces) {
+  const Mn::Vector3 absDir = Mn::Math::abs(dir);
+  int majorAxis = 2;
+  if (absDir.x() >= absDir.y() && absDir.x() >= absDir.z()) {
+    majorAxis = 0;
+  } else if (absDir.y() >= absDir.z()) {
+    majorAxis = 1;
+  }
+  // faces are ordered +X, -X, +Y, -Y, +Z, -Z
+  faces.set(2 * majorAxis + (dir[majorAxis] < 0.0f ? 1 : 0), true);
+  for (int axis = 0; axis < 3; ++axis) {
+    if (axis != majorAxis &&
+        absDir[axis] > (1.0f - margin) * absDir[majorAxis]) {
+      faces.set(2 * axis + (dir[axis] < 0.0f ? 1 : 0), true);
+    }
+  }
+}
+
+}  // namespace
+
+gfx::CubeMap::Faces FisheyeSensor::computeSampledCubeFaces(
+    const FisheyeSensorSpec& spec,
+    int cubemapSize) {
+  CORRADE_ASSERT(spec.fisheyeModelType == FisheyeSensorModelType::DoubleSphere,
+                 "FisheyeSensor::computeSampledCubeFaces(): unknown fisheye "
+                 "model type.",
+                 gfx::CubeMap::Faces{Mn::UnsignedByte(0x3f)});
+  const auto& actualSpec =
+      static_cast<const FisheyeSensorDoubleSphereSpec&>(spec);
+  const float alpha = actualSpec.alpha;
+  const float xi = actualSpec.xi;
+  const Mn::Vector2 focalLength = actualSpec.focalLength;
+  const Mn::Vector2 principalPointOffset =
+      computePrincipalPointOffset(actualSpec);
+  // two texels, a face spans [-1, 1]
+  const float margin = 4.0f / cubemapSize;
+
+  gfx::CubeMap::Faces faces;
+  // resolution is H x W, see VisualSensor::framebufferSize()
+  const int width = spec.resolution[1];
+  const int height = spec.resolution[0];
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      // same as the double sphere shader, for the fragment at the pixel center
+      const Mn::Vector2 mxy =
+          (Mn::Vector2{x + 0.5f, y + 0.5f} - principalPointOffset) /
+          focalLength;
+      const float r2 = Mn::Math::dot(mxy, mxy);
+      const float sq1 = 1.0f - (2.0f * alpha - 1.0f) * r2;
+      if (sq1 < 0.0f) {
+        continue;
+      }
+      const float mz = (1.0f - alpha * alpha * r2) /
+                       (alpha * std::sqrt(sq1) + 1.0f - alpha);
+      const float mz2 = mz * mz;
+      const float sq2 = mz2 + (1.0f - xi * xi) * r2;
+      if (sq2 < 0.0f) {
+        continue;
+      }
+      Mn::Vector3 ray = (mz * xi + std::sqrt(sq2)) / (mz2 + r2) *
+                            Mn::Vector3{mxy, mz} -
+                        Mn::Vector3{0.0f, 0.0f, xi};
+      // OpenGL cubemaps are left-handed
+      ray.z() = -ray.z();
+      addSampledFaces(ray, margin, faces);
+    }
+    if (faces.all()) {
+      break;
+    }
+  }
+  return faces;
+}
+
+gfx::CubeMap::Faces FisheyeSensor::getSampledCubeFaces(int cubemapSize) {
+  std::vector<float> parameters{
+      float(cubemapSize),
+      float(fisheyeSensorSpec_->resolution[0]),
+      float(fisheyeSensorSpec_->resolution[1]),
+      fisheyeSensorSpec_->focalLength.x(),
+      fisheyeSensorSpec_->focalLength.y()};
+  const Mn::Vector2 principalPointOffset =
+      computePrincipalPointOffset(*fisheyeSensorSpec_);
+  parameters.push_back(principalPointOffset.x());
+  parameters.push_back(principalPointOffset.y());
+  if (fisheyeSensorSpec_->fisheyeModelType ==
+      FisheyeSensorModelType::DoubleSphere) {
+    const auto& actualSpec =
+        static_cast<FisheyeSensorDoubleSphereSpec&>(*fisheyeSensorSpec_);
+    parameters.push_back(actualSpec.alpha);
+    parameters.push_back(actualSpec.xi);
+  }
+
+  if (parameters != sampledFacesParameters_) {
+    sampledFaces_ = computeSampledCubeFaces(*fisheyeSensorSpec_, cubemapSize);
+    sampledFacesParameters_ = std::move(parameters);
+  }
+  return sampledFaces_;
+}
+
 bool FisheyeSensor::drawObservation(sim::Simulator& sim) {
   if (!hasRenderTarget()) {
     return false;
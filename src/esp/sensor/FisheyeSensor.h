@@ -5,6 +5,8 @@
 #ifndef ESP_SENSOR_FISHEYESENSOR_H_
 #define ESP_SENSOR_FISHEYESENSOR_H_
 
+#include <vector>
+
 #include <Corrade/Containers/Optional.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Magnum.h>
@@ -123,10 +125,32 @@ class FisheyeSensor : public CubeMapSensorBase {
 
   gfx::RenderCamera* getRenderCamera() = delete;
 
+  /**
+   * @brief Compute the cube faces sampled by the fisheye projection of a
+   * sensor.
+   * @param[in] spec the specification of the fisheye sensor
+   * @param[in] cubemapSize the size of the cubemap
+   *
+   * Every pixel of the output image is unprojected the same way the shader
+   * does. A face is kept if any pixel ray hits it, or passes within two texels
+   * of its border, so that filtering across the cube edges still reads
+   * rendered texels.
+   */
+  static gfx::CubeMap::Faces computeSampledCubeFaces(
+      const FisheyeSensorSpec& spec,
+      int cubemapSize);
+
  protected:
   FisheyeSensorSpec::ptr fisheyeSensorSpec_ =
       std::dynamic_pointer_cast<FisheyeSensorSpec>(spec_);
   Magnum::ResourceKey getShaderKey() override;
+  gfx::CubeMap::Faces getSampledCubeFaces(int cubemapSize) override;
+
+  // the faces returned by the last computeSampledCubeFaces(), together with
+  // the parameters they were computed for, so the per-pixel pass only runs
+  // again when the projection changes
+  gfx::CubeMap::Faces sampledFaces_;
+  std::vector<float> sampledFacesParameters_;
 
   ESP_SMART_POINTERS(FisheyeSensor)
 };
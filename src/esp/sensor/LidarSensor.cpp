@@ -0,0 +1,159 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "LidarSensor.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "esp/core/Check.h"
+#include "esp/geo/Geo.h"
+#include "esp/sim/Simulator.h"
+
+namespace Mn = Magnum;
+namespace Cr = Corrade;
+
+namespace esp {
+namespace sensor {
+
+LidarSensorSpec::LidarSensorSpec() : SensorSpec() {
+  uuid = "lidar";
+  sensorType = SensorType::Lidar;
+  sensorSubType = SensorSubType::Raycast;
+}
+
+void LidarSensorSpec::sanityCheck() const {
+  SensorSpec::sanityCheck();
+  CORRADE_ASSERT(sensorType == SensorType::Lidar,
+                 "LidarSensorSpec::sanityCheck(): sensorType must be Lidar", );
+  CORRADE_ASSERT(
+      sensorSubType == SensorSubType::Raycast,
+      "LidarSensorSpec::sanityCheck(): sensorSubType must be Raycast", );
+  CORRADE_ASSERT(horizontalResolution > 0 && verticalResolution > 0,
+                 "LidarSensorSpec::sanityCheck(): resolution"
+                     << horizontalResolution << "x" << verticalResolution
+                     << "is illegal", );
+  CORRADE_ASSERT(horizontalFov > Mn::Deg{0.0f} &&
+                     horizontalFov <= Mn::Deg{360.0f},
+                 "LidarSensorSpec::sanityCheck(): horizontalFov"
+                     << float(horizontalFov) << "is illegal", );
+  CORRADE_ASSERT(verticalFovMin <= verticalFovMax &&
+                     verticalFovMin >= Mn::Deg{-90.0f} &&
+                     verticalFovMax <= Mn::Deg{90.0f},
+                 "LidarSensorSpec::sanityCheck(): vertical field of view ["
+                     << float(verticalFovMin) << "," << float(verticalFovMax)
+                     << "] is illegal", );
+  CORRADE_ASSERT(minRange >= 0.0f && minRange < maxRange,
+                 "LidarSensorSpec::sanityCheck(): range [" << minRange << ","
+                                                           << maxRange
+                                                           << "] is illegal", );
+}
+
+bool LidarSensorSpec::operator==(const LidarSensorSpec& a) const {
+  return SensorSpec::operator==(a) &&
+         horizontalResolution == a.horizontalResolution &&
+         verticalResolution == a.verticalResolution &&
+         horizontalFov == a.horizontalFov &&
+         verticalFovMin == a.verticalFovMin &&
+         verticalFovMax == a.verticalFovMax && minRange == a.minRange &&
+         maxRange == a.maxRange && noReturnValue == a.noReturnValue;
+}
+
+LidarSensor::LidarSensor(scene::SceneNode& node,
+                         const LidarSensorSpec::ptr& spec)
+    : Sensor{node, spec} {
+  lidarSensorSpec_->sanityCheck();
+  updateBeamDirections();
+}
+
+void LidarSensor::updateBeamDirections() {
+  const LidarSensorSpec& spec = *lidarSensorSpec_;
+  beamDirections_.clear();
+  beamDirections_.reserve(spec.numBeams());
+
+  const Mn::Rad fov{spec.horizontalFov};
+  const Mn::Rad minElevation{spec.verticalFovMin};
+  const Mn::Rad maxElevation{spec.verticalFovMax};
+  for (int ring = 0; ring < spec.verticalResolution; ++ring) {
+    // rings from top to bottom, a single ring sits in the middle
+    const float t = spec.verticalResolution == 1
+                        ? 0.5f
+                        : float(ring) / (spec.verticalResolution - 1);
+    const Mn::Rad elevation = maxElevation + (minElevation - maxElevation) * t;
+    const float cosElevation = Mn::Math::cos(elevation);
+    const float sinElevation = Mn::Math::sin(elevation);
+    for (int beam = 0; beam < spec.horizontalResolution; ++beam) {
+      // counter-clockwise about +Y from the right edge of the field of view,
+      // so a full circle never casts the same beam twice
+      const Mn::Rad azimuth =
+          fov * ((beam + 0.5f) / spec.horizontalResolution - 0.5f);
+      beamDirections_.emplace_back(
+          -Mn::Math::sin(azimuth) * cosElevation, sinElevation,
+          -Mn::Math::cos(azimuth) * cosElevation);
+    }
+  }
+}
+
+void LidarSensor::scan(sim::Simulator& sim,
+                       Cr::Containers::ArrayView<float> ranges) {
+  const LidarSensorSpec& spec = *lidarSensorSpec_;
+  if (beamDirections_.size() != spec.numBeams()) {
+    updateBeamDirections();
+  }
+  ESP_CHECK(ranges.size() == beamDirections_.size(),
+            "LidarSensor::scan(): expected an output of"
+                << beamDirections_.size() << "elements, got"
+                << ranges.size());
+
+  const Mn::Matrix4 transform = node().absoluteTransformationMatrix();
+  const Mn::Vector3 sensorOrigin = transform.translation();
+
+  // start beams at the minimum range so closer geometry is never reported
+  std::vector<geo::Ray> rays;
+  rays.reserve(beamDirections_.size());
+  for (const Mn::Vector3& localDirection : beamDirections_) {
+    const Mn::Vector3 direction =
+        transform.transformVector(localDirection).normalized();
+    rays.emplace_back(sensorOrigin + direction * spec.minRange, direction);
+  }
+
+  const physics::RaycastBatchResults results =
+      sim.castRays(rays, spec.maxRange - spec.minRange);
+  for (std::size_t i = 0; i < ranges.size(); ++i) {
+    ranges[i] = results.numHits(i) > 0
+                    ? spec.minRange +
+                          results.rayDistances[results.hitOffsets[i]]
+                    : spec.noReturnValue;
+  }
+}
+
+bool LidarSensor::getObservationSpace(ObservationSpace& space) {
+  space.spaceType = ObservationSpaceType::Tensor;
+  space.shape = {static_cast<size_t>(lidarSensorSpec_->verticalResolution),
+                 static_cast<size_t>(lidarSensorSpec_->horizontalResolution)};
+  space.dataType = core::DataType::DT_FLOAT;
+  return true;
+}
+
+bool LidarSensor::getObservation(sim::Simulator& sim, Observation& obs) {
+  ObservationSpace space;
+  getObservationSpace(space);
+  if (buffer_ == nullptr || buffer_->shape != space.shape) {
+    buffer_ = core::Buffer::create(space.shape, space.dataType);
+  }
+  obs.buffer = buffer_;
+
+  scan(sim, Cr::Containers::arrayCast<float>(
+                Cr::Containers::arrayView(buffer_->data)));
+  return true;
+}
+
+bool LidarSensor::displayObservation(sim::Simulator&) {
+  ESP_ERROR() << "Display observation is not supported for lidar sensors.";
+  return false;
+}
+
+}  // namespace sensor
+}  // namespace esp
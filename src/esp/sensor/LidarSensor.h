@@ -0,0 +1,146 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_SENSOR_LIDARSENSOR_H_
+#define ESP_SENSOR_LIDARSENSOR_H_
+
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Angle.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/core/Esp.h"
+#include "esp/sensor/Sensor.h"
+
+namespace esp {
+
+// forward declaration
+namespace sim {
+class Simulator;
+}
+
+namespace sensor {
+
+/**
+ * @brief Specification of a @ref LidarSensor.
+ *
+ * Beams are laid out on a grid of @ref verticalResolution rings by
+ * @ref horizontalResolution beams per ring, in the frame of the sensor node
+ * (-Z forward, +Y up). A single ring gives a planar (2D) scan.
+ */
+struct LidarSensorSpec : public SensorSpec {
+  /**
+   * @brief Number of beams per ring. The beams are evenly spaced over
+   * @ref horizontalFov, centered on the forward direction and sweeping to the
+   * left (counter-clockwise about +Y).
+   */
+  int horizontalResolution = 360;
+
+  /**
+   * @brief Number of rings. Rings are evenly spaced from
+   * @ref verticalFovMax down to @ref verticalFovMin inclusive, like the rows
+   * of an image; a single ring is placed halfway between the two.
+   */
+  int verticalResolution = 1;
+
+  /** @brief Horizontal field of view of each ring. */
+  Magnum::Deg horizontalFov{360.0f};
+
+  /** @brief Elevation of the lowest ring. */
+  Magnum::Deg verticalFovMin{0.0f};
+
+  /** @brief Elevation of the highest ring. */
+  Magnum::Deg verticalFovMax{0.0f};
+
+  /** @brief Hits closer than this distance (meters) are ignored. */
+  float minRange = 0.0f;
+
+  /** @brief Maximum distance (meters) of a return. */
+  float maxRange = 30.0f;
+
+  /** @brief Range reported for beams without a return. */
+  float noReturnValue = 0.0f;
+
+  LidarSensorSpec();
+  void sanityCheck() const override;
+  bool isVisualSensorSpec() const override { return false; }
+  bool operator==(const LidarSensorSpec& a) const;
+
+  /** @brief Total number of beams of the scan. */
+  std::size_t numBeams() const {
+    return std::size_t(horizontalResolution) * verticalResolution;
+  }
+
+  ESP_SMART_POINTERS(LidarSensorSpec)
+};
+
+/**
+ * @brief A range sensor which measures distances by casting rays against the
+ * collision world of the @ref sim::Simulator.
+ *
+ * Needs no renderer. Observations are float buffers of shape
+ * [verticalResolution, horizontalResolution] holding the distance in meters
+ * along each beam, or @ref LidarSensorSpec::noReturnValue for beams which hit
+ * nothing within range. Physics must be enabled, otherwise there is nothing
+ * to hit.
+ */
+class LidarSensor : public Sensor {
+ public:
+  explicit LidarSensor(scene::SceneNode& node,
+                       const LidarSensorSpec::ptr& spec);
+  ~LidarSensor() override = default;
+
+  /**
+   * @brief Return that this is not a visual sensor
+   */
+  bool isVisualSensor() const override { return false; }
+
+  /**
+   * @brief Return a pointer to this lidar sensor's SensorSpec
+   */
+  LidarSensorSpec::ptr specification() const { return lidarSensorSpec_; }
+
+  /**
+   * @brief Return the unit beam directions in the sensor frame, ring by ring.
+   */
+  const std::vector<Magnum::Vector3>& getBeamDirections() const {
+    return beamDirections_;
+  }
+
+  /**
+   * @brief Recompute the beam pattern. Call after modifying the specification.
+   */
+  void updateBeamDirections();
+
+  /**
+   * @brief Cast all beams from the current sensor pose and write the ranges
+   * to @p ranges.
+   * @param[in] sim Instance of Simulator class whose collision world is
+   *                scanned
+   * @param[out] ranges Output, must hold @ref LidarSensorSpec::numBeams()
+   *                elements
+   */
+  void scan(sim::Simulator& sim, Corrade::Containers::ArrayView<float> ranges);
+
+  // ------ Sensor class overrides ------
+  bool getObservation(sim::Simulator& sim, Observation& obs) override;
+  bool getObservationSpace(ObservationSpace& space) override;
+  bool displayObservation(sim::Simulator& sim) override;
+
+ protected:
+  LidarSensorSpec::ptr lidarSensorSpec_ =
+      std::dynamic_pointer_cast<LidarSensorSpec>(spec_);
+
+  //! Unit beam directions in the sensor frame
+  std::vector<Magnum::Vector3> beamDirections_;
+
+  ESP_SMART_POINTERS(LidarSensor)
+};
+
+}  // namespace sensor
+}  // namespace esp
+
+#endif  // ESP_SENSOR_LIDARSENSOR_H_
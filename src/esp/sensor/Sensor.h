@@ -32,6 +32,7 @@ enum class SensorType : int32_t {
   Tensor,
   Text,
   Audio,
+  Lidar,
   SensorTypeCount,  // add new type above this term!!
 };
 
@@ -48,6 +49,7 @@ enum class SensorSubType : int32_t {
   Fisheye,
   Equirectangular,
   ImpulseResponse,
+  Raycast,
   SensorSubTypeCount,  // add new type above this term!!
 };
 
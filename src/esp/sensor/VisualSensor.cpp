@@ -7,6 +7,7 @@
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 
+#include <chrono>
 #include <utility>
 
 #include "esp/core/Utility.h"
@@ -52,12 +53,15 @@ void VisualSensorSpec::sanityCheck() const {
   CORRADE_ASSERT(
       near > 0.0 && far > near,
       "VisualSensorSpec::sanityCheck(): the near or far plane is illegal.", );
+  CORRADE_ASSERT(lodThreshold >= 0.0f,
+                 "VisualSensorSpec::sanityCheck(): the LOD threshold"
+                     << lodThreshold << "is illegal", );
 }
 
 bool VisualSensorSpec::operator==(const VisualSensorSpec& a) const {
   return SensorSpec::operator==(a) && resolution == a.resolution &&
          channels == a.channels && gpu2gpuTransfer == a.gpu2gpuTransfer &&
-         far == a.far && near == a.near;
+         far == a.far && near == a.near && lodThreshold == a.lodThreshold;
 }
 
 VisualSensor::VisualSensor(scene::SceneNode& node, VisualSensorSpec::ptr spec)
@@ -108,6 +112,8 @@ void VisualSensor::readObservation(Observation& obs) {
   }
   obs.buffer = buffer_;
 
+  const auto readbackStart = std::chrono::steady_clock::now();
+
   // TODO: have different classes for the different types of sensors
   // TODO: do we need to flip axis?
   if (visualSensorSpec_->sensorType == SensorType::Semantic) {
@@ -123,6 +129,23 @@ void VisualSensor::readObservation(Observation& obs) {
         Magnum::PixelFormat::RGBA8Unorm, renderTarget().framebufferSize(),
         obs.buffer->data});
   }
+
+  stats_.readbackBytes = obs.buffer->data.size();
+  stats_.readbackTimeMs =
+      std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - readbackStart)
+          .count();
+}
+
+void VisualSensor::collectDrawStats(const gfx::RenderCamera& camera) {
+  const gfx::RenderCamera::DrawStats& drawStats = camera.getDrawStats();
+  stats_.drawablesSubmitted = drawStats.drawablesSubmitted;
+  stats_.drawablesCulled = drawStats.drawablesCulled;
+  stats_.trianglesDrawn = drawStats.trianglesDrawn;
+  stats_.stateChanges = drawStats.shaderChanges + drawStats.materialChanges +
+                        drawStats.meshChanges;
+  stats_.stateChangesUnsorted = drawStats.stateChangesUnsorted;
+  stats_.drawCalls = drawStats.drawCalls;
 }
 
 bool VisualSensor::getObservation(sim::Simulator& sim, Observation& obs) {
@@ -52,12 +52,61 @@ struct VisualSensorSpec : public SensorSpec {
    * @brief color used to clear the framebuffer
    */
   Mn::Color4 clearColor = {0, 0, 0, 1};
+  /**
+   * @brief on-screen size, in pixels, below which drawables are rendered with
+   * a simplified mesh, if one was generated; 0 always renders the full meshes.
+   * See @ref gfx::RenderCamera::setLodThreshold.
+   */
+  float lodThreshold = 0.0f;
   VisualSensorSpec();
   void sanityCheck() const override;
   bool isVisualSensorSpec() const override { return true; }
   bool operator==(const VisualSensorSpec& a) const;
   ESP_SMART_POINTERS(VisualSensorSpec)
 };
+
+/**
+ * @brief Counters describing the cost of the most recent observation of a
+ * @ref VisualSensor.
+ */
+struct VisualSensorStats {
+  /**
+   * @brief Number of drawables handed to the render camera, before culling
+   */
+  size_t drawablesSubmitted = 0;
+  /**
+   * @brief Number of drawables removed by frustum culling
+   */
+  size_t drawablesCulled = 0;
+  /**
+   * @brief Number of triangles drawn
+   */
+  size_t trianglesDrawn = 0;
+  /**
+   * @brief Number of shader, material and mesh switches between consecutive
+   * draws. Stays 0 for unsorted draws unless @ref
+   * sim::Simulator::isDrawStateStatsEnabled
+   */
+  size_t stateChanges = 0;
+  /**
+   * @brief Number of such switches the same draws would have caused in scene
+   * graph order, i.e. without @ref sim::Simulator::isDrawStateSortingEnabled
+   */
+  size_t stateChangesUnsorted = 0;
+  /**
+   * @brief Number of draw calls issued; an instanced draw counts once
+   */
+  size_t drawCalls = 0;
+  /**
+   * @brief Number of bytes read back from the render target
+   */
+  size_t readbackBytes = 0;
+  /**
+   * @brief Wall-clock time spent reading back from the render target, in
+   * milliseconds
+   */
+  double readbackTimeMs = 0.0;
+};
 // Represents a sensor that provides visual data from the environment to an
 // agent
 class VisualSensor : public Sensor {
@@ -192,11 +241,33 @@ class VisualSensor : public Sensor {
    */
   Mn::Deg getFOV() const { return hfov_; }
 
+  /**
+   * @brief Returns the counters collected during the most recent call to
+   * @ref drawObservation and @ref readObservation.
+   */
+  const VisualSensorStats& getStats() const { return stats_; }
+
+  /**
+   * @brief Clear the counters returned by @ref getStats until the next
+   * observation.
+   */
+  void resetStats() { stats_ = {}; }
+
  protected:
+  /**
+   * @brief Copy the draw counters of a render camera into @ref stats_.
+   * Subclasses call this at the end of @ref drawObservation.
+   */
+  void collectDrawStats(const gfx::RenderCamera& camera);
+
   /** @brief field of view
    */
   Mn::Deg hfov_ = 90.0_degf;
 
+  /** @brief counters for the most recent observation
+   */
+  VisualSensorStats stats_;
+
   std::unique_ptr<gfx::RenderTarget> tgt_;
   VisualSensorSpec::ptr visualSensorSpec_ =
       std::dynamic_pointer_cast<VisualSensorSpec>(spec_);
@@ -4,6 +4,7 @@
 
 #include "Simulator.h"
 
+#include <cstdlib>
 #include <memory>
 #include <string>
 #include <utility>
@@ -104,6 +105,9 @@ void Simulator::close(const bool destroy) {
   config_ = SimulatorConfiguration{};
 
   frustumCulling_ = true;
+  sortDrawsByState_ = false;
+  instancing_ = false;
+  drawStateStats_ = false;
   requiresTextures_ = Cr::Containers::NullOpt;
 }
 
@@ -164,6 +168,8 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
     ESP_WARNING() << "Not changing requiresTextures as the simulator was "
                      "initialized with True.  Call close() to change this.";
   }
+  // only applies to assets loaded from now on
+  resourceManager_->setMeshLodLevels(config_.meshLodLevels);
 
   if (config_.createRenderer) {
     /* When creating a viewer based app, there is no need to create a
@@ -240,7 +246,8 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
   pathfinder_ = nav::PathFinder::create();
   if (Cr::Utility::Path::exists(navmeshFileLoc)) {
     ESP_DEBUG() << "Loading navmesh from" << navmeshFileLoc;
-    bool pfSuccess = pathfinder_->loadNavMesh(navmeshFileLoc);
+    bool pfSuccess =
+        pathfinder_->loadNavMesh(navmeshFileLoc, config_.memoryMapNavMesh);
     ESP_DEBUG() << (pfSuccess ? "Navmesh Loaded." : "Navmesh load error.");
   } else {
     ESP_WARNING(Mn::Debug::Flag::NoSpace)
@@ -270,8 +277,12 @@ bool Simulator::createSceneInstance(const std::string& activeSceneName) {
   resourceManager_->loadSemanticSceneDescriptor(semanticSceneDescFilename,
                                                 activeSceneName);
 
-  // 4. Specify frustumCulling based on value from config
+  // 4. Specify frustumCulling, draw sorting and instancing based on value
+  // from config
   frustumCulling_ = config_.frustumCulling;
+  sortDrawsByState_ = config_.sortDrawsByState;
+  instancing_ = config_.enableInstancing;
+  drawStateStats_ = config_.collectDrawStateStats;
 
   // 5. (re)seat & (re)init physics manager using the physics manager
   // attributes specified in current simulator configuration held in
@@ -613,6 +624,9 @@ Simulator::buildCurrentStateSceneAttributes() const {
 void Simulator::seed(uint32_t newSeed) {
   random_->seed(newSeed);
   pathfinder_->seed(newSeed);
+  // the pathfinder has its own generator now, but random managed object
+  // handles and core::randomRotation still draw from rand()
+  srand(newSeed);
 }
 
 void Simulator::reconfigureReplayManager(bool enableGfxReplaySave) {
@@ -635,6 +649,22 @@ void Simulator::reconfigureReplayManager(bool enableGfxReplaySave) {
       });
 }
 
+std::vector<uint64_t> Simulator::getDrawableIdsInBox(const Mn::Range3D& box,
+                                                     int sceneID) {
+  std::vector<uint64_t> ids;
+  for (gfx::Drawable* drawable :
+       getDrawableGroup(sceneID).getDrawablesInBox(box)) {
+    ids.push_back(drawable->getDrawableId());
+  }
+  return ids;
+}
+
+std::vector<uint64_t> Simulator::getDrawableIdsAtPoint(
+    const Mn::Vector3& point,
+    int sceneID) {
+  return getDrawableIdsInBox(Mn::Range3D{point, point}, sceneID);
+}
+
 void Simulator::updateShadowMapDrawableGroup() {
   scene::SceneGraph& sg = getActiveSceneGraph();
   // currently the method is naive: destroy the existing group, and recreate one
@@ -786,6 +816,7 @@ void Simulator::setShadowMapsToDrawables() {
 
 double Simulator::stepWorld(const double dt) {
   if (physicsManager_ != nullptr) {
+    const auto stepStart = std::chrono::steady_clock::now();
     physicsManager_->deferNodesUpdate();
     physicsManager_->stepPhysics(dt);
     if (renderer_) {
@@ -793,10 +824,67 @@ double Simulator::stepWorld(const double dt) {
     }
 
     physicsManager_->updateNodes();
+    physicsStepTimeMs_ = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - stepStart)
+                             .count();
   }
   return getWorldTime();
 }
 
+PerfStats Simulator::getPerfStats() const {
+  PerfStats stats;
+  if (physicsManager_ != nullptr) {
+    stats.physicsNumSubSteps = physicsManager_->getRecentNumSubStepsTaken();
+    stats.physicsStepTimeMs = physicsStepTimeMs_;
+  }
+
+  sensor::VisualSensorStats& total = stats.totalSensorStats;
+  for (const auto& ag : agents_) {
+    for (auto& it : ag->getSubtreeSensors()) {
+      if (!it.second.get().isVisualSensor()) {
+        continue;
+      }
+      const sensor::VisualSensorStats& sensorStats =
+          static_cast<sensor::VisualSensor&>(it.second.get()).getStats();
+      stats.sensorStats[it.first] = sensorStats;
+      total.drawablesSubmitted += sensorStats.drawablesSubmitted;
+      total.drawablesCulled += sensorStats.drawablesCulled;
+      total.trianglesDrawn += sensorStats.trianglesDrawn;
+      total.stateChanges += sensorStats.stateChanges;
+      total.stateChangesUnsorted += sensorStats.stateChangesUnsorted;
+      total.drawCalls += sensorStats.drawCalls;
+      total.readbackBytes += sensorStats.readbackBytes;
+      total.readbackTimeMs += sensorStats.readbackTimeMs;
+    }
+  }
+
+  if (pathfinder_ != nullptr) {
+    stats.navMeshQueries = pathfinder_->getNumQueries();
+  }
+  if (resourceManager_ != nullptr) {
+    stats.assetCacheHits = resourceManager_->getNumAssetCacheHits();
+    stats.assetCacheMisses = resourceManager_->getNumAssetCacheMisses();
+  }
+  return stats;
+}
+
+void Simulator::resetPerfStats() {
+  physicsStepTimeMs_ = 0.0;
+  for (const auto& ag : agents_) {
+    for (auto& it : ag->getSubtreeSensors()) {
+      if (it.second.get().isVisualSensor()) {
+        static_cast<sensor::VisualSensor&>(it.second.get()).resetStats();
+      }
+    }
+  }
+  if (pathfinder_ != nullptr) {
+    pathfinder_->resetNumQueries();
+  }
+  if (resourceManager_ != nullptr) {
+    resourceManager_->resetAssetCacheStats();
+  }
+}
+
 // get the simulated world time (0 if no physics enabled)
 double Simulator::getWorldTime() {
   if (physicsManager_ != nullptr) {
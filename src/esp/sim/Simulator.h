@@ -7,6 +7,7 @@
 
 #include <Corrade/Utility/Assert.h>
 
+#include <map>
 #include <utility>
 #include "esp/agent/Agent.h"
 #include "esp/assets/ResourceManager.h"
@@ -25,6 +26,7 @@
 #include "esp/scene/SceneManager.h"
 #include "esp/scene/SceneNode.h"
 #include "esp/sensor/Sensor.h"
+#include "esp/sensor/VisualSensor.h"
 
 #include "SimulatorConfiguration.h"
 
@@ -47,6 +49,49 @@ class ReplayManager;
 
 namespace esp {
 namespace sim {
+
+/**
+ * @brief Lightweight counters and timings describing what the most recent
+ * physics step and sensor observations cost. Collected unconditionally; see
+ * @ref Simulator::getPerfStats.
+ */
+struct PerfStats {
+  /**
+   * @brief Number of fixed-size physics substeps taken by the most recent
+   * @ref Simulator::stepWorld, or -1 if unavailable.
+   */
+  int physicsNumSubSteps = -1;
+  /**
+   * @brief Wall-clock time of the most recent @ref Simulator::stepWorld, in
+   * milliseconds.
+   */
+  double physicsStepTimeMs = 0.0;
+  /**
+   * @brief Per visual sensor counters from its most recent observation, keyed
+   * by sensor uuid.
+   */
+  std::map<std::string, sensor::VisualSensorStats> sensorStats;
+  /**
+   * @brief Sum of @ref sensorStats over all visual sensors.
+   */
+  sensor::VisualSensorStats totalSensorStats;
+  /**
+   * @brief Number of navmesh queries answered by the active PathFinder since
+   * the last reset.
+   */
+  size_t navMeshQueries = 0;
+  /**
+   * @brief Number of render asset loads served from the asset cache since the
+   * last reset.
+   */
+  size_t assetCacheHits = 0;
+  /**
+   * @brief Number of render asset loads that missed the asset cache since the
+   * last reset.
+   */
+  size_t assetCacheMisses = 0;
+};
+
 class Simulator {
  public:
   explicit Simulator(
@@ -345,20 +390,23 @@ class Simulator {
   //===============================================================================//
   // Voxel Field API
 
-#ifdef ESP_BUILD_WITH_VHACD
   /**
    * @brief Creates a voxelization for a particular object. Initializes the
-   * voxelization with a boundary voxel grid using VHACD's voxelization library.
+   * voxelization with a boundary voxel grid.
    *
    * @param objectId The object ID and key identifying the object in @ref
    * esp::physics::PhysicsManager::existingObjects_.
    * @param resolution The approximate number of voxels for the voxel grid that
    * is created.
-   */
-  void createObjectVoxelization(int objectId, int resolution = 1000000) {
-    physicsManager_->generateVoxelization(objectId, resolution);
+   * @param method The voxelizer to use. @ref
+   * esp::geo::VoxelizationMethod::VHACD requires building with VHACD.
+   */
+  void createObjectVoxelization(int objectId,
+                                int resolution = 1000000,
+                                geo::VoxelizationMethod method =
+                                    geo::DefaultVoxelizationMethod) {
+    physicsManager_->generateVoxelization(objectId, resolution, method);
   }
-#endif
 
   /**
    * @brief Turn on/off rendering for the voxel grid of the object's visual
@@ -391,18 +439,20 @@ class Simulator {
     return physicsManager_->getObjectVoxelization(objectId);
   }
 
-#ifdef ESP_BUILD_WITH_VHACD
   /**
    * @brief Creates a voxelization for the scene. Initializes the voxelization
-   * with a boundary voxel grid using VHACD's voxelization library.
+   * with a boundary voxel grid.
    *
    * @param resolution The approximate number of voxels for the voxel grid that
    * is created.
+   * @param method The voxelizer to use. @ref
+   * esp::geo::VoxelizationMethod::VHACD requires building with VHACD.
    */
-  void createStageVoxelization(int resolution = 1000000) {
-    physicsManager_->generateStageVoxelization(resolution);
+  void createStageVoxelization(int resolution = 1000000,
+                               geo::VoxelizationMethod method =
+                                   geo::DefaultVoxelizationMethod) {
+    physicsManager_->generateStageVoxelization(resolution, method);
   }
-#endif
 
   /**
    * @brief Turn on/off rendering for the voxel grid of the scene's visual
@@ -553,6 +603,58 @@ class Simulator {
     return esp::physics::RaycastResults();
   }
 
+  /**
+   * @brief Raycast a batch of rays into the collision world of a scene. See
+   * @ref esp::physics::PhysicsManager::castRays.
+   *
+   * Note: A default @ref physics::PhysicsManager has no collision world, so
+   * physics must be enabled for this feature.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param maxDistance The maximum distance along each ray direction to
+   * search. In units of ray length.
+   * @param allHits If false, only the closest hit of each ray is reported.
+   * @param sceneID !! Not used currently !! Specifies which physical scene of
+   * the object.
+   * @return The hits of all rays in flat arrays.
+   */
+  esp::physics::RaycastBatchResults castRays(
+      Corrade::Containers::ArrayView<const esp::geo::Ray> rays,
+      double maxDistance = 100.0,
+      bool allHits = false,
+      int sceneID = 0) {
+    if (sceneHasPhysics(sceneID)) {
+      return physicsManager_->castRays(rays, maxDistance, allHits);
+    }
+    esp::physics::RaycastBatchResults results;
+    results.hitOffsets.assign(rays.size() + 1, 0);
+    return results;
+  }
+
+  /**
+   * @brief Find the drawables of a scene whose nodes' world bounding boxes
+   * overlap a box. Uses the bounding volume hierarchy of the scene's default
+   * drawable group, see @ref esp::gfx::DrawableGroup::getDrawablesInBox.
+   *
+   * @param box The box, in world space.
+   * @param sceneID !! Not used currently !! Specifies which scene to query.
+   * @return The ids of the drawables, in increasing order.
+   */
+  std::vector<uint64_t> getDrawableIdsInBox(const Magnum::Range3D& box,
+                                            int sceneID = 0);
+
+  /**
+   * @brief Find the drawables of a scene whose nodes' world bounding boxes
+   * contain a point. See @ref getDrawableIdsInBox.
+   *
+   * @param point The point, in world space.
+   * @param sceneID !! Not used currently !! Specifies which scene to query.
+   * @return The ids of the drawables, in increasing order.
+   */
+  std::vector<uint64_t> getDrawableIdsAtPoint(const Magnum::Vector3& point,
+                                              int sceneID = 0);
+
   /**
    * @brief the physical world has a notion of time which passes during
    * animation/simulation/action/etc... Step the physical world forward in time
@@ -566,6 +668,19 @@ class Simulator {
    */
   double stepWorld(double dt = 1.0 / 60.0);
 
+  /**
+   * @brief Gather the performance counters of the most recent physics step and
+   * sensor observations, along with navmesh query and asset cache counters
+   * accumulated since the last @ref resetPerfStats.
+   */
+  PerfStats getPerfStats() const;
+
+  /**
+   * @brief Reset the physics step time, sensor counters, navmesh query and
+   * asset cache counters reported by @ref getPerfStats.
+   */
+  void resetPerfStats();
+
   /**
    * @brief Get the current time in the simulated world. This is always 0 if no
    * @ref esp::physics::PhysicsManager is initialized. See @ref stepWorld. See
@@ -844,6 +959,46 @@ class Simulator {
    */
   bool isFrustumCullingEnabled() const { return frustumCulling_; }
 
+  /**
+   * @brief Enable or disable ordering draws by GL state (disabled by default)
+   * @param val true = enable, false = disable
+   */
+  void setDrawStateSortingEnabled(bool val) { sortDrawsByState_ = val; }
+
+  /**
+   * @brief Get status, whether draws are ordered by GL state or not
+   * @return true if enabled, otherwise false
+   */
+  bool isDrawStateSortingEnabled() const { return sortDrawsByState_; }
+
+  /**
+   * @brief Enable or disable drawing drawables which share mesh and material
+   * with instanced draw calls (disabled by default). Implies ordering draws by
+   * GL state.
+   * @param val true = enable, false = disable
+   */
+  void setInstancingEnabled(bool val) { instancing_ = val; }
+
+  /**
+   * @brief Get status, whether instanced drawing is enabled or not
+   * @return true if enabled, otherwise false
+   */
+  bool isInstancingEnabled() const { return instancing_; }
+
+  /**
+   * @brief Enable or disable counting the GL state changes of draws which are
+   * not sorted by state (disabled by default). Sorted draws are always
+   * counted.
+   * @param val true = enable, false = disable
+   */
+  void setDrawStateStatsEnabled(bool val) { drawStateStats_ = val; }
+
+  /**
+   * @brief Get status, whether GL state changes of unsorted draws are counted
+   * @return true if enabled, otherwise false
+   */
+  bool isDrawStateStatsEnabled() const { return drawStateStats_; }
+
   /**
    * @brief Get a copy of an existing @ref gfx::LightSetup by its key.
    *
@@ -1179,6 +1334,18 @@ class Simulator {
   // PinholeCamera rquires it when drawing the observation
   bool frustumCulling_ = true;
 
+  //! whether sensors order their draws by GL state
+  bool sortDrawsByState_ = false;
+
+  //! whether sensors batch drawables sharing mesh and material
+  bool instancing_ = false;
+
+  //! whether sensors count the GL state changes of unsorted draws
+  bool drawStateStats_ = false;
+
+  //! Wall-clock time of the most recent @ref stepWorld, in milliseconds
+  double physicsStepTimeMs_ = 0.0;
+
   //! NavMesh visualization variables
   int navMeshVisPrimID_ = esp::ID_UNDEFINED;
   esp::scene::SceneNode* navMeshVisNode_ = nullptr;
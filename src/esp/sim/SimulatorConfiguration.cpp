@@ -13,7 +13,12 @@ bool operator==(const SimulatorConfiguration& a,
          a.gpuDeviceId == b.gpuDeviceId && a.randomSeed == b.randomSeed &&
          a.createRenderer == b.createRenderer &&
          a.allowSliding == b.allowSliding &&
+         a.memoryMapNavMesh == b.memoryMapNavMesh &&
          a.frustumCulling == b.frustumCulling &&
+         a.sortDrawsByState == b.sortDrawsByState &&
+         a.enableInstancing == b.enableInstancing &&
+         a.collectDrawStateStats == b.collectDrawStateStats &&
+         a.meshLodLevels == b.meshLodLevels &&
          a.enablePhysics == b.enablePhysics &&
          a.enableGfxReplaySave == b.enableGfxReplaySave &&
          a.loadSemanticMesh == b.loadSemanticMesh &&
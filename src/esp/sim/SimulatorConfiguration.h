@@ -28,8 +28,20 @@ struct SimulatorConfiguration {
   bool createRenderer = true;
   //! Whether or not the agent can slide on NavMesh collisions.
   bool allowSliding = true;
+  //! Map the scene's navmesh file instead of reading it, sharing its memory
+  //! with other processes. See @ref nav::PathFinder::loadNavMesh.
+  bool memoryMapNavMesh = false;
   //! Enable or disable the frustum culling optimisation
   bool frustumCulling = true;
+  //! Order draws by shader, material and mesh to reduce GL state changes
+  bool sortDrawsByState = false;
+  //! Draw drawables sharing mesh and material with instanced draw calls
+  bool enableInstancing = false;
+  //! Count the GL state changes of unsorted draws into the sensor perf stats
+  bool collectDrawStateStats = false;
+  //! Number of simplified levels of detail generated for each render mesh at
+  //! load, drawn by sensors with a nonzero lodThreshold. 0 generates none.
+  int meshLodLevels = 0;
   /**
    * @brief This flags specifies whether or not dynamics is supported by the
    * simulation, if a suitable library (i.e. Bullet) has been installed.
@@ -19,6 +19,9 @@ in highp vec2 texCoord;
 in highp vec3 tangent;
 in highp vec3 biTangent;
 #endif
+#if defined(INSTANCED_OBJECT_ID)
+flat in highp uint interpolatedInstanceObjectId;
+#endif
 
 // -------------- output -------------------
 layout(location = OUTPUT_ATTRIBUTE_LOCATION_COLOR) out vec4 fragmentColor;
@@ -432,6 +435,9 @@ void main() {
 
 #if defined(OBJECT_ID)
   fragmentObjectId = ObjectId;
+#if defined(INSTANCED_OBJECT_ID)
+  fragmentObjectId += interpolatedInstanceObjectId;
+#endif
 #endif
   // PBR equation debug
   // "none", "Diff (l,n)", "F (l,h)", "G (l,v,h)", "D (h)", "Specular"
@@ -14,6 +14,17 @@ layout(location = ATTRIBUTE_LOCATION_TEXCOORD) in highp vec2 vertexTexCoord;
 #if defined(NORMAL_TEXTURE) && defined(PRECOMPUTED_TANGENT)
 layout(location = ATTRIBUTE_LOCATION_TANGENT4) in highp vec4 vertexTangent;
 #endif
+// per-instance model and normal matrix, in world space
+#if defined(INSTANCED_TRANSFORMATION)
+layout(location = ATTRIBUTE_LOCATION_TRANSFORMATION_MATRIX) in highp mat4
+    instancedTransformationMatrix;
+layout(location = ATTRIBUTE_LOCATION_NORMAL_MATRIX) in highp mat3
+    instancedNormalMatrix;
+#endif
+#if defined(INSTANCED_OBJECT_ID)
+layout(location = ATTRIBUTE_LOCATION_OBJECT_ID) in highp uint
+    instanceObjectId;
+#endif
 
 // -------------- output ---------------------
 // position, normal, tangent in *world* space, NOT camera space!
@@ -26,6 +37,9 @@ out highp vec2 texCoord;
 out highp vec3 tangent;
 out highp vec3 biTangent;
 #endif
+#if defined(INSTANCED_OBJECT_ID)
+flat out highp uint interpolatedInstanceObjectId;
+#endif
 
 // ------------ uniform ----------------------
 uniform highp mat4 ViewMatrix;
@@ -43,9 +57,20 @@ uniform highp mat3 TextureMatrix
 
 // ------------ shader -----------------------
 void main() {
-  vec4 vertexWorldPosition = ModelMatrix * vertexPosition;
+#if defined(INSTANCED_TRANSFORMATION)
+  mat4 modelMatrix = ModelMatrix * instancedTransformationMatrix;
+  mat3 normalMatrix = NormalMatrix * instancedNormalMatrix;
+#else
+  mat4 modelMatrix = ModelMatrix;
+  mat3 normalMatrix = NormalMatrix;
+#endif
+#if defined(INSTANCED_OBJECT_ID)
+  interpolatedInstanceObjectId = instanceObjectId;
+#endif
+
+  vec4 vertexWorldPosition = modelMatrix * vertexPosition;
   position = vertexWorldPosition.xyz;
-  normal = normalize(NormalMatrix * vertexNormal);
+  normal = normalize(normalMatrix * vertexNormal);
 #if defined(TEXTURED)
   texCoord =
 #if defined(TEXTURE_TRANSFORMATION)
@@ -56,7 +81,7 @@ void main() {
 #endif  // TEXTURED
 
 #if defined(NORMAL_TEXTURE) && defined(PRECOMPUTED_TANGENT)
-  tangent = normalize(NormalMatrix * vec3(vertexTangent));
+  tangent = normalize(normalMatrix * vec3(vertexTangent));
   // Gram–Schmidt
   tangent = normalize(tangent - dot(tangent, normal) * normal);
   biTangent = normalize(cross(normal, tangent) * vertexTangent.w);
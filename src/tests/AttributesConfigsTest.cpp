@@ -258,6 +258,8 @@ void AttributesConfigsTest::testPhysicsAttrVals(
   CORRADE_COMPARE(physMgrAttr->getSimulator(), "bullet_test");
   CORRADE_COMPARE(physMgrAttr->getFrictionCoefficient(), 1.4);
   CORRADE_COMPARE(physMgrAttr->getRestitutionCoefficient(), 1.1);
+  CORRADE_COMPARE(physMgrAttr->getNumThreads(), 4);
+  CORRADE_COMPARE(physMgrAttr->getDeterministic(), false);
   // test physics manager attributes-level user config vals
   testUserDefinedConfigVals(physMgrAttr->getUserConfiguration(),
                             "pm defined string", true, 15, 12.6,
@@ -279,6 +281,8 @@ void AttributesConfigsTest::testPhysicsJSONLoad() {
   "gravity": [1,2,3],
   "friction_coefficient": 1.4,
   "restitution_coefficient": 1.1,
+  "num_threads": 4,
+  "deterministic": false,
   "user_defined" : {
       "user_string" : "pm defined string",
       "user_bool" : true,
@@ -0,0 +1,184 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/TestSuite/Tester.h>
+
+#include <esp/nav/Crowd.h>
+#include <esp/nav/PathFinder.h>
+
+#include <Corrade/Utility/Path.h>
+#include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Swizzle.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace {
+
+const std::string skokloster =
+    Cr::Utility::Path::join(SCENE_DATASETS,
+                            "habitat-test-scenes/skokloster-castle.navmesh");
+
+struct CrowdTest : Cr::TestSuite::Tester {
+  explicit CrowdTest();
+
+  void agents();
+  void reachTargets();
+  void navMeshReloaded();
+
+  void benchmarkUpdate();
+
+  esp::logging::LoggingContext loggingContext;
+};
+
+CrowdTest::CrowdTest() {
+  addTests({&CrowdTest::agents, &CrowdTest::reachTargets,
+            &CrowdTest::navMeshReloaded});
+
+  addBenchmarks({&CrowdTest::benchmarkUpdate}, 100);
+}
+
+esp::nav::PathFinder::ptr loadPathFinder() {
+  auto pathFinder = esp::nav::PathFinder::create();
+  pathFinder->loadNavMesh(skokloster);
+  pathFinder->seed(0);
+  return pathFinder;
+}
+
+// a point on an island large enough for a few dozen agents
+esp::vec3f pointOnLargeIsland(esp::nav::PathFinder& pathFinder) {
+  esp::vec3f point;
+  do {
+    point = pathFinder.getRandomNavigablePoint();
+  } while (pathFinder.islandRadius(point) < 5.0);
+  return point;
+}
+
+void CrowdTest::agents() {
+  auto pathFinder = loadPathFinder();
+  CORRADE_VERIFY(pathFinder->isLoaded());
+
+  esp::nav::Crowd crowd{pathFinder, 2};
+  CORRADE_COMPARE(crowd.getMaxAgents(), 2);
+  CORRADE_COMPARE(crowd.getNumAgents(), 0);
+
+  const Mn::Vector3 start{pointOnLargeIsland(*pathFinder)};
+  CORRADE_COMPARE(crowd.addAgent({1000.0f, 1000.0f, 1000.0f}),
+                  esp::ID_UNDEFINED);
+
+  const int first = crowd.addAgent(start);
+  const int second = crowd.addAgent(start + Mn::Vector3::xAxis(0.5f));
+  CORRADE_VERIFY(first != esp::ID_UNDEFINED);
+  CORRADE_VERIFY(second != esp::ID_UNDEFINED);
+  CORRADE_COMPARE(crowd.getNumAgents(), 2);
+  // the crowd is full
+  CORRADE_COMPARE(crowd.addAgent(start), esp::ID_UNDEFINED);
+
+  // the agent is snapped to the navmesh
+  CORRADE_VERIFY(pathFinder->isNavigable(Mn::EigenIntegration::cast<esp::vec3f>(
+      crowd.getAgentPositions()[first])));
+  CORRADE_VERIFY(!crowd.setAgentTarget(first, {1000.0f, 1000.0f, 1000.0f}));
+
+  crowd.removeAgent(second);
+  CORRADE_VERIFY(crowd.isAgentActive(first));
+  CORRADE_VERIFY(!crowd.isAgentActive(second));
+  CORRADE_COMPARE(crowd.getNumAgents(), 1);
+  CORRADE_VERIFY(crowd.addAgent(start) != esp::ID_UNDEFINED);
+}
+
+void CrowdTest::reachTargets() {
+  auto pathFinder = loadPathFinder();
+  CORRADE_VERIFY(pathFinder->isLoaded());
+
+  constexpr int NumAgents = 16;
+  const esp::vec3f island = pointOnLargeIsland(*pathFinder);
+  const std::vector<esp::vec3f> starts =
+      pathFinder->getRandomNavigablePointsOnIsland(NumAgents, island);
+  const std::vector<esp::vec3f> targets =
+      pathFinder->getRandomNavigablePointsOnIsland(NumAgents, island);
+
+  esp::nav::Crowd crowd{pathFinder, NumAgents};
+  std::vector<int> ids;
+  for (int i = 0; i < NumAgents; ++i) {
+    const int id = crowd.addAgent(Mn::Vector3{starts[i]});
+    CORRADE_VERIFY(id != esp::ID_UNDEFINED);
+    CORRADE_VERIFY(crowd.setAgentTarget(id, Mn::Vector3{targets[i]}));
+    ids.push_back(id);
+  }
+
+  // two simulated minutes is plenty at 1 m/s on this scene
+  for (int step = 0; step < 1200; ++step) {
+    crowd.update(0.1f);
+  }
+
+  // agents heading to nearby targets may keep pushing each other around, so
+  // only require most of them to arrive
+  int numArrived = 0;
+  for (int i = 0; i < NumAgents; ++i) {
+    const Mn::Vector3 position = crowd.getAgentPositions()[ids[i]];
+    CORRADE_VERIFY(pathFinder->isNavigable(
+        Mn::EigenIntegration::cast<esp::vec3f>(position)));
+    const Mn::Vector3 offset = position - Mn::Vector3{targets[i]};
+    numArrived += Mn::Math::gather<'x', 'z'>(offset).length() < 0.5f ? 1 : 0;
+  }
+  CORRADE_COMPARE_AS(numArrived, NumAgents * 3 / 4,
+                     Cr::TestSuite::Compare::GreaterOrEqual);
+}
+
+void CrowdTest::navMeshReloaded() {
+  auto pathFinder = loadPathFinder();
+  CORRADE_VERIFY(pathFinder->isLoaded());
+
+  esp::nav::Crowd crowd{pathFinder, 4};
+  CORRADE_VERIFY(crowd.hasValidNavMesh());
+  const Mn::Vector3 start{pointOnLargeIsland(*pathFinder)};
+  CORRADE_VERIFY(crowd.addAgent(start) != esp::ID_UNDEFINED);
+
+  // the old Detour navmesh is freed, so the crowd must not touch it anymore
+  CORRADE_VERIFY(pathFinder->loadNavMesh(skokloster));
+  CORRADE_VERIFY(!crowd.hasValidNavMesh());
+
+  esp::nav::Crowd newCrowd{pathFinder, 4};
+  CORRADE_VERIFY(newCrowd.hasValidNavMesh());
+  const int id = newCrowd.addAgent(start);
+  CORRADE_VERIFY(id != esp::ID_UNDEFINED);
+  newCrowd.update(0.1f);
+  CORRADE_VERIFY(newCrowd.isAgentActive(id));
+}
+
+void CrowdTest::benchmarkUpdate() {
+  auto pathFinder = loadPathFinder();
+  CORRADE_VERIFY(pathFinder->isLoaded());
+
+  constexpr int NumAgents = 128;
+  const esp::vec3f island = pointOnLargeIsland(*pathFinder);
+  const std::vector<esp::vec3f> starts =
+      pathFinder->getRandomNavigablePointsOnIsland(NumAgents, island);
+  const std::vector<esp::vec3f> targets =
+      pathFinder->getRandomNavigablePointsOnIsland(NumAgents, island);
+
+  esp::nav::Crowd crowd{pathFinder, NumAgents};
+  for (int i = 0; i < NumAgents; ++i) {
+    const int id = crowd.addAgent(Mn::Vector3{starts[i]});
+    if (id != esp::ID_UNDEFINED) {
+      crowd.setAgentTarget(id, Mn::Vector3{targets[i]});
+    }
+  }
+  // let the path requests go through before measuring
+  for (int step = 0; step < 10; ++step) {
+    crowd.update(0.1f);
+  }
+
+  CORRADE_BENCHMARK(10) { crowd.update(0.1f); };
+  CORRADE_COMPARE(crowd.getNumAgents(), NumAgents);
+}
+
+}  // namespace
+
+CORRADE_TEST_MAIN(CrowdTest)
@@ -11,9 +11,12 @@
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
+#include <set>
 #include <string>
 
 #include "esp/assets/ResourceManager.h"
+#include "esp/gfx/Drawable.h"
+#include "esp/gfx/DrawableGroup.h"
 #include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
@@ -32,6 +35,57 @@ using Magnum::Math::Literals::operator""_degf;
 // on GCC and Clang, the following namespace causes useful warnings to be
 // printed when you have accidentally unused variables or functions in the test
 namespace {
+
+//! drawable without a mesh, enough to exercise culling without GL
+struct BoxDrawable : esp::gfx::Drawable {
+  BoxDrawable(esp::scene::SceneNode& node, esp::gfx::DrawableGroup& group)
+      : esp::gfx::Drawable{node, nullptr, esp::gfx::DrawableType::None,
+                           &group} {}
+
+ private:
+  void draw(const Mn::Matrix4&, Mn::SceneGraph::Camera3D&) override {}
+};
+
+/**
+ * @brief Add a unit box drawable at every point of a grid in front of the
+ * origin, along -Z
+ */
+std::vector<BoxDrawable*> addBoxGrid(esp::scene::SceneGraph& sceneGraph,
+                                     const Mn::Vector3i& size,
+                                     float spacing) {
+  std::vector<BoxDrawable*> boxes;
+  auto& drawables = sceneGraph.getDrawables();
+  for (int x = 0; x < size.x(); ++x) {
+    for (int y = 0; y < size.y(); ++y) {
+      for (int z = 0; z < size.z(); ++z) {
+        esp::scene::SceneNode& node = sceneGraph.getRootNode().createChild();
+        node.setMeshBB({Mn::Vector3{-0.5f}, Mn::Vector3{0.5f}});
+        node.translate(spacing * Mn::Vector3{x - size.x() * 0.5f,
+                                             y - size.y() * 0.5f, -z - 1.0f});
+        node.computeCumulativeBB();
+        // owned by the node
+        boxes.push_back(new BoxDrawable{node, drawables});
+      }
+    }
+  }
+  return boxes;
+}
+
+//! the drawables left by culling, by address
+std::set<const Mn::SceneGraph::Drawable3D*> visibleSet(
+    const esp::gfx::RenderCamera::DrawableTransforms& drawableTransforms) {
+  std::set<const Mn::SceneGraph::Drawable3D*> visible;
+  for (const auto& item : drawableTransforms) {
+    visible.insert(&item.first.get());
+  }
+  return visible;
+}
+
+const struct {
+  const char* name;
+  bool hierarchy;
+} CullingMethodData[]{{"linear", false}, {"hierarchy", true}};
+
 struct CullingTest : Cr::TestSuite::Tester {
   explicit CullingTest();
 
@@ -41,6 +95,10 @@ struct CullingTest : Cr::TestSuite::Tester {
   // tests
   void computeAbsoluteAABB();
   void frustumCulling();
+  void hierarchyCulling();
+
+  // benchmarks
+  void benchmarkCulling();
 
  protected:
   esp::logging::LoggingContext loggingContext_;
@@ -52,8 +110,11 @@ struct CullingTest : Cr::TestSuite::Tester {
 CullingTest::CullingTest() {
   // clang-format off
   addTests({&CullingTest::computeAbsoluteAABB,
-            &CullingTest::frustumCulling});
+            &CullingTest::frustumCulling,
+            &CullingTest::hierarchyCulling});
   // clang-format on
+  addInstancedBenchmarks({&CullingTest::benchmarkCulling}, 10,
+                         Cr::Containers::arraySize(CullingMethodData));
 }
 
 int CullingTest::setupTests() {
@@ -273,6 +334,112 @@ void CullingTest::frustumCulling() {
   target->renderExit();
   CORRADE_COMPARE(numVisibleObjects, numVisibleObjectsGroundTruth);
 }
+void CullingTest::hierarchyCulling() {
+  esp::scene::SceneGraph sceneGraph;
+  auto& drawables = sceneGraph.getDrawables();
+  std::vector<BoxDrawable*> boxes =
+      addBoxGrid(sceneGraph, {20, 4, 20}, 2.0f);
+
+  esp::scene::SceneNode& cameraNode = sceneGraph.getRootNode().createChild();
+  esp::gfx::RenderCamera& renderCamera =
+      *(new esp::gfx::RenderCamera(cameraNode));
+  renderCamera.setProjectionMatrix(800, 600, 0.01f, 15.0f, 60.0_degf);
+  cameraNode.rotateY(20.0_degf);
+
+  // the hierarchy must agree with testing every drawable, also after nodes
+  // move and drawables are removed
+  auto compareWithLinear = [&]() {
+    auto linear = renderCamera.drawableTransformations(drawables);
+    linear.erase(linear.begin() + renderCamera.cull(linear), linear.end());
+
+    esp::gfx::RenderCamera::DrawableTransforms hierarchy;
+    CORRADE_COMPARE(renderCamera.cull(drawables, hierarchy), linear.size());
+    CORRADE_VERIFY(visibleSet(hierarchy) == visibleSet(linear));
+    // same order, so the transformations can be compared pairwise
+    for (size_t i = 0; i < linear.size(); ++i) {
+      CORRADE_VERIFY(&hierarchy[i].first.get() == &linear[i].first.get());
+      CORRADE_COMPARE(hierarchy[i].second, linear[i].second);
+    }
+    return linear.size();
+  };
+
+  const size_t numVisible = compareWithLinear();
+  CORRADE_VERIFY(numVisible > 0);
+  CORRADE_VERIFY(numVisible < boxes.size());
+  // the linear cull above does not count
+  CORRADE_COMPARE(renderCamera.getDrawStats().drawablesSubmitted,
+                  boxes.size());
+  CORRADE_COMPARE(renderCamera.getDrawStats().drawablesCulled,
+                  boxes.size() - numVisible);
+
+  // move every third box, some by more than the hierarchy's margin
+  for (size_t i = 0; i < boxes.size(); i += 3) {
+    boxes[i]->getSceneNode().translate({i % 2 ? 0.05f : 3.0f, 0.0f, 0.0f});
+  }
+  compareWithLinear();
+
+  // move the camera itself
+  cameraNode.rotateY(-40.0_degf);
+  compareWithLinear();
+
+  // remove every other box
+  for (size_t i = 0; i < boxes.size(); i += 2) {
+    delete boxes[i];
+    boxes[i] = nullptr;
+  }
+  compareWithLinear();
+
+  // box queries reuse the hierarchy
+  const Mn::Range3D query{{-5.0f, -1.0f, -10.0f}, {5.0f, 1.0f, -4.0f}};
+  std::vector<esp::gfx::Drawable*> expected;
+  for (BoxDrawable* box : boxes) {
+    if (!box) {
+      continue;
+    }
+    const Mn::Range3D& aabb = box->getSceneNode().getAbsoluteAABB();
+    if (!(aabb.min() > query.max()).any() &&
+        !(aabb.max() < query.min()).any()) {
+      expected.push_back(box);
+    }
+  }
+  CORRADE_VERIFY(!expected.empty());
+  CORRADE_VERIFY(drawables.getDrawablesInBox(query) == expected);
+}
+
+void CullingTest::benchmarkCulling() {
+  auto&& data = CullingMethodData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  // 100k drawables, a small fraction of them visible
+  esp::scene::SceneGraph sceneGraph;
+  auto& drawables = sceneGraph.getDrawables();
+  const std::vector<BoxDrawable*> boxes =
+      addBoxGrid(sceneGraph, {100, 10, 100}, 2.0f);
+
+  esp::scene::SceneNode& cameraNode = sceneGraph.getRootNode().createChild();
+  esp::gfx::RenderCamera& renderCamera =
+      *(new esp::gfx::RenderCamera(cameraNode));
+  renderCamera.setProjectionMatrix(800, 600, 0.01f, 30.0f, 90.0_degf);
+
+  // build the hierarchy before measuring
+  esp::gfx::RenderCamera::DrawableTransforms drawableTransforms;
+  renderCamera.cull(drawables, drawableTransforms);
+  const size_t numVisible = drawableTransforms.size();
+
+  size_t visible = 0;
+  CORRADE_BENCHMARK(5) {
+    if (data.hierarchy) {
+      visible = renderCamera.cull(drawables, drawableTransforms);
+    } else {
+      drawableTransforms = renderCamera.drawableTransformations(drawables);
+      visible = renderCamera.cull(drawableTransforms);
+    }
+  }
+  CORRADE_COMPARE(visible, numVisible);
+  CORRADE_VERIFY(numVisible > 0);
+  CORRADE_COMPARE(boxes.size(), std::size_t{100000});
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(CullingTest)
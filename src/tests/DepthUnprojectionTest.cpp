@@ -36,9 +36,13 @@ struct DepthUnprojectionTest : Mn::GL::OpenGLTester {
   void testCpu();
   void testGpuDirect();
   void testGpuUnprojectExisting();
+  void testCpuBatch();
+  void testCpuPointCloud();
+  void testCpuPointCloudDownsample();
 
   void benchmarkBaseline();
   void benchmarkCpu();
+  void benchmarkCpuPointCloud();
   void benchmarkGpuDirect();
   void benchmarkGpuUnprojectExisting();
 };
@@ -140,12 +144,18 @@ DepthUnprojectionTest::DepthUnprojectionTest() {
        &DepthUnprojectionTest::testGpuUnprojectExisting},
       Cr::Containers::arraySize(TestData));
 
+  addTests({&DepthUnprojectionTest::testCpuBatch,
+            &DepthUnprojectionTest::testCpuPointCloud,
+            &DepthUnprojectionTest::testCpuPointCloudDownsample});
+
   addInstancedBenchmarks({&DepthUnprojectionTest::benchmarkBaseline}, 50,
                          Cr::Containers::arraySize(UnprojectBenchmarkData));
 
   addInstancedBenchmarks({&DepthUnprojectionTest::benchmarkCpu}, 50,
                          Cr::Containers::arraySize(UnprojectBenchmarkData));
 
+  addBenchmarks({&DepthUnprojectionTest::benchmarkCpuPointCloud}, 50);
+
   addBenchmarks({&DepthUnprojectionTest::benchmarkGpuDirect}, 50,
                 BenchmarkType::GpuTime);
 
@@ -171,6 +181,109 @@ void DepthUnprojectionTest::testCpu() {
                        Cr::TestSuite::Compare::around(data.depth * 0.0002f));
 }
 
+void DepthUnprojectionTest::testCpuBatch() {
+  /* Enough values for the SIMD loops and a remainder */
+  Mn::Vector2 unprojection = calculateDepthUnprojection(
+      Mn::Matrix4::perspectiveProjection(60.0_degf, 1.0f, 0.01f, 100.0f));
+  Cr::Containers::Array<float> depth{Cr::NoInit, 1003};
+  for (std::size_t i = 0; i != depth.size(); ++i)
+    depth[i] = i % 5 == 0 ? 1.0f : float(i) / float(depth.size());
+
+  Cr::Containers::Array<float> expected{Cr::NoInit, depth.size()};
+  const float farDepth = unprojection[1] / (1.0f + unprojection[0]);
+  for (std::size_t i = 0; i != depth.size(); ++i) {
+    const float d = unprojection[1] / (depth[i] + unprojection[0]);
+    expected[i] = d == farDepth ? 0.0f : d;
+  }
+
+  unprojectDepth(unprojection, depth);
+  for (std::size_t i = 0; i != depth.size(); ++i) {
+    CORRADE_ITERATION(i);
+    /* All code paths are bit-exact */
+    CORRADE_VERIFY(depth[i] == expected[i]);
+  }
+}
+
+void DepthUnprojectionTest::testCpuPointCloud() {
+  const Mn::Matrix4 projection =
+      Mn::Matrix4::perspectiveProjection(60.0_degf, 4.0f / 3.0f, 0.01f, 100.0f);
+  const Mn::Matrix4 inverse = projection.inverted();
+  constexpr std::size_t Rows = 6, Cols = 8;
+  float depth[Rows][Cols];
+  for (std::size_t row = 0; row != Rows; ++row)
+    for (std::size_t col = 0; col != Cols; ++col)
+      depth[row][col] = 1.0f + 0.5f * row + 0.25f * col;
+  /* No depth, skipped */
+  depth[2][3] = 0.0f;
+
+  const Mn::Matrix4 transformation =
+      Mn::Matrix4::translation({1.0f, -2.0f, 3.0f}) *
+      Mn::Matrix4::rotationY(30.0_degf);
+  const std::vector<Mn::Vector3> points = unprojectDepthToPoints(
+      Cr::Containers::StridedArrayView2D<const float>{
+          Cr::Containers::arrayView(&depth[0][0], Rows * Cols), {Rows, Cols}},
+      projection, transformation);
+  CORRADE_COMPARE(points.size(), Rows * Cols - 1);
+
+  std::size_t i = 0;
+  for (std::size_t row = 0; row != Rows; ++row) {
+    for (std::size_t col = 0; col != Cols; ++col) {
+      if (row == 2 && col == 3)
+        continue;
+      CORRADE_ITERATION(row << "," << col);
+      /* The point at the depth on the ray through the pixel center */
+      const float d = depth[row][col];
+      const Mn::Vector2 ndc =
+          2.0f * (Mn::Vector2{float(col), float(row)} + Mn::Vector2{0.5f}) /
+              Mn::Vector2{float(Cols), float(Rows)} -
+          Mn::Vector2{1.0f};
+      const float ndcZ = projection.transformPoint({0.0f, 0.0f, -d}).z();
+      const Mn::Vector3 expected = transformation.transformPoint(
+          inverse.transformPoint({ndc, ndcZ}));
+      CORRADE_COMPARE_WITH(points[i], expected,
+                           Cr::TestSuite::Compare::around(Mn::Vector3{0.001f}));
+      ++i;
+    }
+  }
+}
+
+void DepthUnprojectionTest::testCpuPointCloudDownsample() {
+  const Mn::Matrix4 projection =
+      Mn::Matrix4::perspectiveProjection(60.0_degf, 1.0f, 0.01f, 100.0f);
+  constexpr std::size_t Size = 32;
+  Cr::Containers::Array<float> depth{Cr::DirectInit, Size * Size, 2.0f};
+  const Cr::Containers::StridedArrayView2D<const float> depthView{depth,
+                                                                 {Size, Size}};
+
+  const std::vector<Mn::Vector3> points =
+      unprojectDepthToPoints(depthView, projection);
+  const std::vector<Mn::Vector3> downsampled =
+      unprojectDepthToPoints(depthView, projection, {}, 0.25f);
+  CORRADE_COMPARE(points.size(), Size * Size);
+  CORRADE_COMPARE_AS(downsampled.size(), points.size() / 4,
+                     Cr::TestSuite::Compare::Less);
+
+  /* Every point is within a voxel of a kept one, and a voxel as large as the
+     view keeps just the centroid */
+  for (const Mn::Vector3& point : points) {
+    float distance = Mn::Constants::inf();
+    for (const Mn::Vector3& kept : downsampled)
+      distance = Mn::Math::min(distance, (kept - point).length());
+    CORRADE_COMPARE_AS(distance, 0.25f * Mn::Constants::sqrt3(),
+                       Cr::TestSuite::Compare::LessOrEqual);
+  }
+  Mn::Vector3 centroid;
+  for (const Mn::Vector3& point : points)
+    centroid += point;
+  centroid /= float(points.size());
+  const std::vector<Mn::Vector3> single = unprojectDepthToPoints(
+      depthView, projection,
+      Mn::Matrix4::translation(Mn::Vector3{50.0f}), 100.0f);
+  CORRADE_COMPARE(single.size(), 1);
+  CORRADE_COMPARE_WITH(single[0], centroid + Mn::Vector3{50.0f},
+                       Cr::TestSuite::Compare::around(Mn::Vector3{0.001f}));
+}
+
 void DepthUnprojectionTest::testGpuDirect() {
   auto&& data = TestData[testCaseInstanceId()];
   setTestCaseDescription(data.name);
@@ -303,6 +416,27 @@ void DepthUnprojectionTest::benchmarkCpu() {
                      Cr::TestSuite::Compare::Greater);
 }
 
+void DepthUnprojectionTest::benchmarkCpuPointCloud() {
+  Mn::Matrix4 projection =
+      Mn::Matrix4::perspectiveProjection(60.0_degf, 1.0f, 0.001f, 100.0f);
+
+  Cr::Containers::Array<float> depth{Cr::NoInit,
+                                     std::size_t(BenchmarkSize.product())};
+  for (std::size_t i = 0; i != depth.size(); ++i)
+    depth[i] = float(i % 10000) / float(1000);
+
+  std::vector<Mn::Vector3> points;
+  CORRADE_BENCHMARK(1) {
+    points = unprojectDepthToPoints(
+        Cr::Containers::StridedArrayView2D<const float>{
+            depth, {std::size_t(BenchmarkSize.y()),
+                    std::size_t(BenchmarkSize.x())}},
+        projection);
+  }
+
+  CORRADE_COMPARE(points.size(), depth.size() - depth.size() / 10000 - 1);
+}
+
 void DepthUnprojectionTest::benchmarkGpuDirect() {
   Mn::GL::Texture2D output{};
   output.setMinificationFilter(Mn::GL::SamplerFilter::Nearest)
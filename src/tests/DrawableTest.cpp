@@ -11,6 +11,7 @@
 #include <Magnum/Trade/MeshData.h>
 #include "esp/assets/ResourceManager.h"
 #include "esp/gfx/GenericDrawable.h"
+#include "esp/gfx/RenderCamera.h"
 #include "esp/gfx/RenderTarget.h"
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/scene/SceneManager.h"
@@ -28,10 +29,18 @@ using esp::scene::SceneManager;
 // printed when you have accidentally unused variables or functions in the test
 namespace {
 
+// exposes the per-drawable level of detail choice made at the start of draw()
+struct LodCamera : esp::gfx::RenderCamera {
+  using esp::gfx::RenderCamera::RenderCamera;
+  using esp::gfx::RenderCamera::selectLods;
+};
+
 struct DrawableTest : Cr::TestSuite::Tester {
   explicit DrawableTest();
   // tests
   void addRemoveDrawables();
+  void instanceCompatibleDrawables();
+  void selectLevelOfDetail();
 
  protected:
   esp::logging::LoggingContext loggingContext_;
@@ -53,7 +62,9 @@ DrawableTest::DrawableTest() {
   auto MM = MetadataMediator::create(cfg);
   resourceManager_ = std::make_unique<ResourceManager>(MM);
   //clang-format off
-  addTests({&DrawableTest::addRemoveDrawables});
+  addTests({&DrawableTest::addRemoveDrawables,
+            &DrawableTest::instanceCompatibleDrawables,
+            &DrawableTest::selectLevelOfDetail});
   //clang-format on
   auto stageAttributesMgr = MM->getStageAttributesManager();
   std::string stageFile =
@@ -145,6 +156,99 @@ void DrawableTest::addRemoveDrawables() {
   CORRADE_VERIFY(!drawableGroup_->hasDrawable(dr->getDrawableId()));
 }
 
+void DrawableTest::instanceCompatibleDrawables() {
+  Mn::GL::Mesh box = Mn::MeshTools::compile(Mn::Primitives::cubeSolid());
+  Mn::GL::Mesh otherBox = Mn::MeshTools::compile(Mn::Primitives::cubeSolid());
+  auto& sceneGraph = sceneManager_.getSceneGraph(sceneID_);
+  esp::scene::SceneNode& sceneRootNode = sceneGraph.getRootNode();
+  esp::gfx::ShaderManager& shaderManager = resourceManager_->getShaderManager();
+  esp::gfx::Drawable::Flags meshAttributeFlags{};
+
+  auto createDrawable = [&](Mn::GL::Mesh& mesh, const char* materialKey) {
+    return new esp::gfx::GenericDrawable{sceneRootNode.createChild(),
+                                         &mesh,
+                                         meshAttributeFlags,
+                                         shaderManager,
+                                         esp::NO_LIGHT_KEY,
+                                         materialKey,
+                                         nullptr};
+  };
+
+  // plain Phong drawables sharing mesh, material and light setup
+  esp::gfx::GenericDrawable* a = createDrawable(box, esp::DEFAULT_MATERIAL_KEY);
+  esp::gfx::GenericDrawable* b = createDrawable(box, esp::DEFAULT_MATERIAL_KEY);
+  CORRADE_VERIFY(a->isInstanceCompatible(*b));
+  CORRADE_VERIFY(b->isInstanceCompatible(*a));
+
+  // a different mesh is drawn separately
+  esp::gfx::GenericDrawable* c =
+      createDrawable(otherBox, esp::DEFAULT_MATERIAL_KEY);
+  CORRADE_VERIFY(!a->isInstanceCompatible(*c));
+
+  // per-vertex object ids occupy the per-instance object id attribute
+  esp::gfx::GenericDrawable* d =
+      createDrawable(box, esp::PER_VERTEX_OBJECT_ID_MATERIAL_KEY);
+  esp::gfx::GenericDrawable* e =
+      createDrawable(box, esp::PER_VERTEX_OBJECT_ID_MATERIAL_KEY);
+  CORRADE_VERIFY(!d->isInstanceCompatible(*e));
+  CORRADE_VERIFY(!a->isInstanceCompatible(*d));
+}
+
+void DrawableTest::selectLevelOfDetail() {
+  Mn::GL::Mesh box = Mn::MeshTools::compile(Mn::Primitives::cubeSolid());
+  Mn::GL::Mesh halfBox;
+  Mn::GL::Mesh quarterBox;
+  auto& sceneGraph = sceneManager_.getSceneGraph(sceneID_);
+  esp::scene::SceneNode& sceneRootNode = sceneGraph.getRootNode();
+  esp::gfx::Drawable::Flags meshAttributeFlags{};
+
+  esp::scene::SceneNode& node = sceneRootNode.createChild();
+  node.setMeshBB(Mn::Range3D{Mn::Vector3{-1.0f}, Mn::Vector3{1.0f}});
+  esp::gfx::GenericDrawable* drawable = new esp::gfx::GenericDrawable{
+      node,
+      &box,
+      meshAttributeFlags,
+      resourceManager_->getShaderManager(),
+      esp::NO_LIGHT_KEY,
+      esp::DEFAULT_MATERIAL_KEY,
+      nullptr};
+  drawable->setLods({{&halfBox, 0.5f}, {&quarterBox, 0.25f}});
+
+  // a level keeps about sqrt(triangleRatio) of the full edge resolution
+  drawable->selectLod(1.0f);
+  CORRADE_COMPARE(&drawable->getMesh(), &box);
+  drawable->selectLod(0.8f);
+  CORRADE_COMPARE(&drawable->getMesh(), &box);
+  drawable->selectLod(0.6f);
+  CORRADE_COMPARE(&drawable->getMesh(), &halfBox);
+  drawable->selectLod(0.3f);
+  CORRADE_COMPARE(&drawable->getMesh(), &quarterBox);
+  drawable->selectLod(0.0f);
+  CORRADE_COMPARE(&drawable->getMesh(), &quarterBox);
+
+  // a 90 degree square view 100 pixels high maps a unit length at distance d
+  // to 50 / d pixels, so the bounding sphere of radius sqrt(3) covers
+  // 173.2 / d pixels
+  auto* camera = new LodCamera{sceneRootNode.createChild()};
+  camera->setProjectionMatrix(100, 100, 0.01f, 1000.0f, Mn::Deg{90.0f});
+  camera->setLodThreshold(100.0f);
+  auto selectedAt = [&](float distance) -> Mn::GL::Mesh* {
+    esp::gfx::RenderCamera::DrawableTransforms transforms{
+        {*drawable, Mn::Matrix4::translation(Mn::Vector3::zAxis(-distance))}};
+    camera->selectLods(transforms);
+    return &drawable->getMesh();
+  };
+  // the camera is inside the bounding sphere
+  CORRADE_COMPARE(selectedAt(1.0f), &box);
+  CORRADE_COMPARE(selectedAt(2.0f), &box);
+  CORRADE_COMPARE(selectedAt(3.0f), &halfBox);
+  CORRADE_COMPARE(selectedAt(10.0f), &quarterBox);
+
+  // no threshold always draws the full mesh
+  camera->setLodThreshold(0.0f);
+  CORRADE_COMPARE(selectedAt(10.0f), &box);
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(DrawableTest)
@@ -2,15 +2,24 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Math/Matrix4.h>
 #include "esp/core/Utility.h"
+#include "esp/geo/AabbTree.h"
 #include "esp/geo/CoordinateFrame.h"
 #include "esp/geo/Geo.h"
+#include "esp/geo/MeshSimplification.h"
 #include "esp/geo/OBB.h"
 
 namespace Cr = Corrade;
@@ -29,6 +38,8 @@ struct GeoTest : Cr::TestSuite::Tester {
   void obbConstruction();
   void obbFunctions();
   void coordinateFrame();
+  void aabbTree();
+  void simplifyMesh();
   // benchmarks
   void getTransformedBB_standard();
   void getTransformedBB();
@@ -52,7 +63,9 @@ GeoTest::GeoTest() {
   addTests({&GeoTest::aabb,
             &GeoTest::obbConstruction,
             &GeoTest::obbFunctions,
-            &GeoTest::coordinateFrame});
+            &GeoTest::coordinateFrame,
+            &GeoTest::aabbTree,
+            &GeoTest::simplifyMesh});
   addBenchmarks({&GeoTest::getTransformedBB_standard,
                  &GeoTest::getTransformedBB}, 10);
   // clang-format on
@@ -201,6 +214,183 @@ void GeoTest::coordinateFrame() {
   CORRADE_COMPARE(c1.toString(), j);
 }
 
+void GeoTest::aabbTree() {
+  auto randomBox = []() {
+    const Mn::Vector3 center{float(rand() % 200) - 100.0f,
+                             float(rand() % 200) - 100.0f,
+                             float(rand() % 200) - 100.0f};
+    const Mn::Vector3 halfSize{0.1f + (rand() % 300) / 100.0f,
+                               0.1f + (rand() % 300) / 100.0f,
+                               0.1f + (rand() % 300) / 100.0f};
+    return Mn::Range3D{center - halfSize, center + halfSize};
+  };
+  auto overlaps = [](const Mn::Range3D& a, const Mn::Range3D& b) {
+    return !(a.min() > b.max()).any() && !(a.max() < b.min()).any();
+  };
+
+  AabbTree tree{0.5f};
+  CORRADE_COMPARE(tree.height(), -1);
+
+  // leaf id -> exact box, empty if removed
+  std::map<int, Mn::Range3D> boxes;
+  for (int i = 0; i < 2000; ++i) {
+    const Mn::Range3D box = randomBox();
+    boxes[tree.insert(box)] = box;
+  }
+  // remove a quarter, move the rest a little or far
+  int iLeaf = 0;
+  for (auto it = boxes.begin(); it != boxes.end(); ++iLeaf) {
+    if (iLeaf % 4 == 0) {
+      tree.remove(it->first);
+      it = boxes.erase(it);
+      continue;
+    }
+    if (iLeaf % 4 == 1) {
+      // moving by less than the margin must not reinsert
+      const Mn::Range3D box{it->second.min() + Mn::Vector3{0.2f},
+                            it->second.max() + Mn::Vector3{0.2f}};
+      CORRADE_VERIFY(!tree.update(it->first, box));
+      it->second = box;
+    } else {
+      it->second = randomBox();
+      tree.update(it->first, it->second);
+    }
+    ++it;
+  }
+  CORRADE_COMPARE(tree.size(), boxes.size());
+  // balanced, so far from the worst case of one leaf per level
+  CORRADE_COMPARE_AS(tree.height(), 30, Cr::TestSuite::Compare::Less);
+
+  // box queries report every overlapping box once, plus only false positives
+  // overlapping the enlarged boxes
+  for (int iQuery = 0; iQuery < 50; ++iQuery) {
+    CORRADE_ITERATION(iQuery);
+    const Mn::Range3D query = randomBox().scaledFromCenter(Mn::Vector3{3.0f});
+    std::map<int, int> reported;
+    tree.query(query, [&](int leaf) { ++reported[leaf]; });
+    for (const auto& item : reported) {
+      CORRADE_COMPARE(item.second, 1);
+      CORRADE_VERIFY(overlaps(tree.getFatBox(item.first), query));
+    }
+    for (const auto& item : boxes) {
+      if (overlaps(item.second, query)) {
+        CORRADE_VERIFY(reported.count(item.first));
+      }
+    }
+  }
+
+  // point queries
+  for (const auto& item : boxes) {
+    const Mn::Vector3 point = item.second.center();
+    bool found = false;
+    tree.query(point, [&](int leaf) { found |= (leaf == item.first); });
+    CORRADE_VERIFY(found);
+  }
+
+  // frustum queries report every box not outside the frustum, and flag as
+  // contained only boxes entirely inside it
+  const Mn::Frustum frustum = Mn::Frustum::fromMatrix(
+      Mn::Matrix4::perspectiveProjection(Mn::Deg{60.0f}, 1.0f, 0.1f, 80.0f) *
+      Mn::Matrix4::lookAt({0.0f, 0.0f, 0.0f}, {1.0f, 0.2f, -1.0f},
+                          {0.0f, 1.0f, 0.0f})
+          .inverted());
+  auto planeDistances = [&](const Mn::Range3D& box, int iPlane) {
+    const Mn::Vector4& plane = frustum[iPlane];
+    const float d = Mn::Math::dot(box.center(), plane.xyz()) + plane.w();
+    const float r =
+        Mn::Math::dot(box.size() * 0.5f, Mn::Math::abs(plane.xyz()));
+    return std::make_pair(d - r, d + r);
+  };
+  std::map<int, bool> reported;
+  tree.query(frustum, [&](int leaf, bool contained) {
+    CORRADE_VERIFY(!reported.count(leaf));
+    reported[leaf] = contained;
+  });
+  size_t numVisible = 0;
+  for (const auto& item : boxes) {
+    bool outside = false;
+    for (int iPlane = 0; iPlane < 6; ++iPlane) {
+      outside |= planeDistances(item.second, iPlane).second < 0.0f;
+    }
+    if (!outside) {
+      ++numVisible;
+      CORRADE_VERIFY(reported.count(item.first));
+    }
+  }
+  CORRADE_VERIFY(numVisible > 0);
+  for (const auto& item : reported) {
+    if (item.second) {
+      for (int iPlane = 0; iPlane < 6; ++iPlane) {
+        CORRADE_COMPARE_AS(planeDistances(boxes[item.first], iPlane).first,
+                           0.0f, Cr::TestSuite::Compare::GreaterOrEqual);
+      }
+    }
+  }
+
+  tree.clear();
+  CORRADE_COMPARE(tree.size(), 0);
+  CORRADE_COMPARE(tree.height(), -1);
+}
+
+void GeoTest::simplifyMesh() {
+  // a square grid of 2 * size * size triangles in the xz plane, facing +y
+  constexpr int size = 40;
+  std::vector<Mn::Vector3> positions;
+  for (int z = 0; z <= size; ++z) {
+    for (int x = 0; x <= size; ++x) {
+      positions.emplace_back(float(x), 0.0f, float(z));
+    }
+  }
+  std::vector<Mn::UnsignedInt> indices;
+  for (int z = 0; z < size; ++z) {
+    for (int x = 0; x < size; ++x) {
+      const Mn::UnsignedInt i = z * (size + 1) + x;
+      indices.insert(indices.end(), {i, i + size + 1, i + 1, i + 1,
+                                     i + size + 1, i + size + 2});
+    }
+  }
+  auto normal = [&](const std::vector<Mn::UnsignedInt>& triangles,
+                    std::size_t t) {
+    const Mn::Vector3& a = positions[triangles[3 * t]];
+    return Mn::Math::cross(positions[triangles[3 * t + 1]] - a,
+                           positions[triangles[3 * t + 2]] - a);
+  };
+
+  // a flat mesh simplifies without any error and keeps its shape: the
+  // triangles still cover the square exactly once, all facing up
+  float error = -1.0f;
+  std::vector<Mn::UnsignedInt> simplified =
+      geo::simplifyMesh(positions, indices, indices.size() / 4,
+                        std::numeric_limits<float>::infinity(), &error);
+  CORRADE_COMPARE_AS(simplified.size(), indices.size() / 4,
+                     Cr::TestSuite::Compare::LessOrEqual);
+  CORRADE_COMPARE(simplified.size() % 3, 0);
+  CORRADE_COMPARE(error, 0.0f);
+  float area = 0.0f;
+  for (std::size_t t = 0; t < simplified.size() / 3; ++t) {
+    const Mn::Vector3 n = normal(simplified, t);
+    CORRADE_COMPARE_AS(n.y(), 0.0f, Cr::TestSuite::Compare::Greater);
+    area += 0.5f * n.length();
+  }
+  CORRADE_COMPARE(area, float(size * size));
+
+  // on a bumpy mesh the error bound stops the simplification
+  for (Mn::Vector3& position : positions) {
+    position.y() = 0.5f * std::sin(position.x() * 0.7f) *
+                   std::cos(position.z() * 0.3f);
+  }
+  simplified = geo::simplifyMesh(positions, indices, 0, 0.05f, &error);
+  CORRADE_COMPARE_AS(error, 0.05f, Cr::TestSuite::Compare::LessOrEqual);
+  CORRADE_COMPARE_AS(simplified.size(), indices.size(),
+                     Cr::TestSuite::Compare::Less);
+  CORRADE_COMPARE_AS(simplified.size(), indices.size() / 20,
+                     Cr::TestSuite::Compare::Greater);
+  // all vertices referenced are input vertices, no new ones are made
+  for (Mn::UnsignedInt index : simplified) {
+    CORRADE_COMPARE_AS(index, positions.size(), Cr::TestSuite::Compare::Less);
+  }
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(GeoTest)
@@ -4,6 +4,7 @@
 
 #include "configure.h"
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
@@ -15,14 +16,17 @@
 #include "esp/assets/ResourceManager.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/WindowlessContext.h"
+#include "esp/gfx/replay/KeyframeStream.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/Recorder.h"
 #include "esp/gfx/replay/ReplayManager.h"
 #include "esp/scene/SceneManager.h"
 #include "esp/sim/Simulator.h"
 
+#include <chrono>
 #include <fstream>
 #include <string>
+#include <thread>
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
@@ -40,6 +44,13 @@ struct GfxReplayTest : Cr::TestSuite::Tester {
 
   void testRecorder();
 
+  void testRecorderDirtyTracking();
+  void testRecorderQuantization();
+  void testKeyframeStream();
+
+  void benchmarkWriteKeyframes();
+  void benchmarkReadKeyframes();
+
   void testPlayer();
 
   void testPlayerReadMissingFile();
@@ -50,6 +61,74 @@ struct GfxReplayTest : Cr::TestSuite::Tester {
 
 };  // struct GfxReplayTest
 
+const struct {
+  const char* name;
+  esp::gfx::replay::TransformQuantization quantization;
+} KeyframeBenchmarkData[]{
+    {"", {}},
+    {"quantized", {0.001f, 10}},
+};
+
+// Helper function to create instances of a box under the root of sceneGraph
+std::vector<esp::scene::SceneNode*> createInstances(
+    esp::scene::SceneGraph& sceneGraph,
+    esp::gfx::replay::Recorder& recorder,
+    int count) {
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt, {}, "");
+  std::vector<esp::scene::SceneNode*> nodes;
+  for (int i = 0; i < count; ++i) {
+    auto& node = sceneGraph.getRootNode().createChild();
+    node.setTranslation(Mn::Vector3(0.37f * i, 0.f, -0.11f * i));
+    node.setRotation(Mn::Quaternion::rotation(
+        Mn::Rad(0.7f * i), Mn::Vector3(1.f, 0.5f * i, 2.f).normalized()));
+    recorder.onCreateRenderAssetInstance(&node, creation);
+    nodes.push_back(&node);
+  }
+  return nodes;
+}
+
+// Helper function to move and rotate instances by small amounts. Skips
+// deleted instances, which are null.
+void moveInstances(const std::vector<esp::scene::SceneNode*>& nodes,
+                   int frame) {
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    // some instances stay still or move less than a millimeter
+    if (!nodes[i] || i % 4 == 0) {
+      continue;
+    }
+    if (i % 4 == 1) {
+      nodes[i]->translate(Mn::Vector3(0.0002f, -0.0001f, 0.f));
+      continue;
+    }
+    nodes[i]->translate(Mn::Vector3(0.013f, -0.006f, 0.003f));
+    nodes[i]->rotate(Mn::Rad(0.01f * frame + 0.002f * i),
+                     Mn::Vector3(0.f, 1.f, 0.f));
+  }
+}
+
+// Helper function to receive streamed keyframes until player has count of them
+void receiveKeyframes(esp::gfx::replay::KeyframeStreamServer& server,
+                      esp::gfx::replay::KeyframeStreamClient& client,
+                      esp::gfx::replay::Player& player,
+                      int count) {
+  for (int i = 0; i < 1000 && player.getNumKeyframes() < count; ++i) {
+    server.poll();
+    if (client.receiveKeyframes(player) == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+
+// Helper function to save the keyframes of 30 frames of moving instances
+void saveMovingKeyframes(esp::gfx::replay::Recorder& recorder,
+                         const std::vector<esp::scene::SceneNode*>& nodes) {
+  for (int frame = 0; frame < 30; ++frame) {
+    moveInstances(nodes, frame);
+    recorder.saveKeyframe();
+  }
+}
+
 // Helper function to get numberOfChildrenOfRoot
 int getNumberOfChildrenOfRoot(esp::scene::SceneNode& rootNode) {
   int numberOfChildrenOfRoot = 1;
@@ -67,10 +146,18 @@ int getNumberOfChildrenOfRoot(esp::scene::SceneNode& rootNode) {
 }
 
 GfxReplayTest::GfxReplayTest() {
-  addTests({&GfxReplayTest::testRecorder, &GfxReplayTest::testPlayer,
+  addTests({&GfxReplayTest::testRecorder,
+            &GfxReplayTest::testRecorderDirtyTracking,
+            &GfxReplayTest::testRecorderQuantization,
+            &GfxReplayTest::testKeyframeStream,
+            &GfxReplayTest::testPlayer,
             &GfxReplayTest::testPlayerReadMissingFile,
             &GfxReplayTest::testPlayerReadInvalidFile,
             &GfxReplayTest::testSimulatorIntegration});
+
+  addInstancedBenchmarks({&GfxReplayTest::benchmarkWriteKeyframes,
+                          &GfxReplayTest::benchmarkReadKeyframes},
+                         10, Cr::Containers::arraySize(KeyframeBenchmarkData));
 }  // ctor
 
 // Manipulate the scene and save some keyframes using replay::Recorder
@@ -181,6 +268,286 @@ void GfxReplayTest::testRecorder() {
       Mn::Vector3(4.f, 5.f, 6.f));
 }
 
+// Only instances which moved since the previous keyframe get state updates
+void GfxReplayTest::testRecorderDirtyTracking() {
+  esp::scene::SceneGraph sceneGraph;
+  auto& parent = sceneGraph.getRootNode().createChild();
+  std::vector<esp::scene::SceneNode*> nodes;
+  for (int i = 0; i < 100; ++i) {
+    auto& node = (i < 50 ? parent : sceneGraph.getRootNode()).createChild();
+    node.setTranslation(Mn::Vector3(float(i), 0.f, 0.f));
+    nodes.push_back(&node);
+  }
+
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt, {}, "");
+  esp::gfx::replay::Recorder recorder;
+  for (auto* node : nodes) {
+    recorder.onCreateRenderAssetInstance(node, creation);
+  }
+  recorder.saveKeyframe();
+  // nothing moved
+  recorder.saveKeyframe();
+
+  // move one instance, change the semantic id of another, and set a third
+  // to where it already is
+  nodes[60]->translate(Mn::Vector3(0.f, 1.f, 0.f));
+  nodes[70]->setSemanticId(3);
+  nodes[80]->setTranslation(Mn::Vector3(80.f, 0.f, 0.f));
+  recorder.saveKeyframe();
+
+  // moving the parent moves its 50 instances
+  parent.translate(Mn::Vector3(0.f, 0.f, 1.f));
+  delete nodes[10];
+  recorder.saveKeyframe();
+
+  // the instance moved in keyframe #2 moves again
+  nodes[60]->translate(Mn::Vector3(0.f, 1.f, 0.f));
+  recorder.saveKeyframe();
+
+  const auto& keyframes = recorder.debugGetSavedKeyframes();
+  CORRADE_COMPARE(keyframes.size(), 5);
+  CORRADE_COMPARE(keyframes[0].stateUpdates.size(), 100);
+  CORRADE_COMPARE(keyframes[1].stateUpdates.size(), 0);
+
+  CORRADE_COMPARE(keyframes[2].stateUpdates.size(), 2);
+  CORRADE_COMPARE(keyframes[2].stateUpdates[0].first,
+                  keyframes[0].stateUpdates[60].first);
+  CORRADE_COMPARE(keyframes[2].stateUpdates[0].second.absTransform.translation,
+                  Mn::Vector3(60.f, 1.f, 0.f));
+  CORRADE_COMPARE(keyframes[2].stateUpdates[1].first,
+                  keyframes[0].stateUpdates[70].first);
+  CORRADE_COMPARE(keyframes[2].stateUpdates[1].second.semanticId, 3);
+
+  CORRADE_COMPARE(keyframes[3].deletions.size(), 1);
+  CORRADE_COMPARE(keyframes[3].stateUpdates.size(), 49);
+  for (const auto& update : keyframes[3].stateUpdates) {
+    CORRADE_COMPARE(update.second.absTransform.translation.z(), 1.f);
+  }
+
+  CORRADE_COMPARE(keyframes[4].stateUpdates.size(), 1);
+  CORRADE_COMPARE(keyframes[4].stateUpdates[0].second.absTransform.translation,
+                  Mn::Vector3(60.f, 2.f, 0.f));
+
+  // writing the keyframes out makes the next keyframe record every instance
+  recorder.writeSavedKeyframesToString();
+  recorder.saveKeyframe();
+  CORRADE_COMPARE(recorder.debugGetSavedKeyframes()[0].stateUpdates.size(),
+                  99);
+}
+
+// Quantized keyframes are smaller and read back within the quantization error
+void GfxReplayTest::testRecorderQuantization() {
+  esp::scene::SceneGraph sceneGraph;
+  esp::gfx::replay::Recorder quantizedRecorder;
+  esp::gfx::replay::Recorder recorder;
+  const esp::gfx::replay::TransformQuantization quantization{0.001f, 10};
+  quantizedRecorder.setTransformQuantization(quantization);
+  auto nodes = createInstances(sceneGraph, quantizedRecorder, 40);
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt, {}, "");
+  for (auto* node : nodes) {
+    recorder.onCreateRenderAssetInstance(node, creation);
+  }
+
+  // the absolute transform of every instance at every keyframe
+  std::vector<std::vector<Mn::Matrix4>> expected;
+  for (int frame = 0; frame < 20; ++frame) {
+    if (frame > 0) {
+      moveInstances(nodes, frame);
+    }
+    if (frame == 10) {
+      delete nodes[5];
+      nodes[5] = nullptr;
+    }
+    recorder.saveKeyframe();
+    quantizedRecorder.saveKeyframe();
+    expected.emplace_back();
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+      expected.back().push_back(nodes[i] ? nodes[i]->absoluteTransformation()
+                                         : Mn::Matrix4{});
+    }
+  }
+  const auto& savedKeyframes = quantizedRecorder.debugGetSavedKeyframes();
+  // instances moving less than a millimeter don't get an update every frame
+  CORRADE_COMPARE_AS(savedKeyframes[1].stateUpdates.size(),
+                     recorder.debugGetSavedKeyframes()[1].stateUpdates.size(),
+                     Cr::TestSuite::Compare::Less);
+
+  const std::string unquantizedString = recorder.writeSavedKeyframesToString();
+  const std::string quantizedString =
+      quantizedRecorder.writeSavedKeyframesToString();
+  CORRADE_COMPARE_AS(quantizedString.size(), unquantizedString.size() / 2,
+                     Cr::TestSuite::Compare::Less);
+  CORRADE_VERIFY(quantizedString.find("\"dt\"") != std::string::npos);
+
+  auto testFilepath =
+      Corrade::Utility::Path::join(DATA_DIR, "./gfx_replay_quantized.json");
+  std::ofstream out(testFilepath);
+  out << quantizedString;
+  out.close();
+  auto dummyCallback =
+      [&](const esp::assets::AssetInfo& assetInfo,
+          const esp::assets::RenderAssetInstanceCreationInfo& creation) {
+        return nullptr;
+      };
+  esp::gfx::replay::Player player(dummyCallback);
+  player.readKeyframesFromFile(testFilepath);
+  Corrade::Utility::Path::remove(testFilepath);
+
+  const auto& keyframes = player.debugGetKeyframes();
+  CORRADE_COMPARE(keyframes.size(), expected.size());
+  CORRADE_COMPARE(keyframes[0].stateUpdates.size(), nodes.size());
+  CORRADE_COMPARE(keyframes[10].deletions.size(), 1);
+
+  // the error of a 10-bit smallest-three rotation is below 0.004 radians
+  const float translationTolerance =
+      0.5f * quantization.translationStep + 1.0e-5f;
+  const float rotationTolerance = 0.005f;
+  // instance keys are assigned in creation order
+  std::vector<esp::gfx::replay::RenderAssetInstanceState> states(
+      nodes.size());
+  for (std::size_t frame = 0; frame < keyframes.size(); ++frame) {
+    CORRADE_ITERATION(frame);
+    for (const auto& update : keyframes[frame].stateUpdates) {
+      states[update.first] = update.second;
+    }
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+      // deleted
+      if (i == 5 && frame >= 10) {
+        continue;
+      }
+      CORRADE_ITERATION(i);
+      const Mn::Matrix4& transform = expected[frame][i];
+      const Mn::Vector3 translationError = Mn::Math::abs(
+          states[i].absTransform.translation - transform.translation());
+      CORRADE_COMPARE_AS(translationError.max(), translationTolerance,
+                         Cr::TestSuite::Compare::LessOrEqual);
+      const Mn::Quaternion rotation =
+          Mn::Quaternion::fromMatrix(transform.rotation());
+      const float cosHalfAngle = Mn::Math::abs(
+          Mn::Math::dot(rotation, states[i].absTransform.rotation));
+      const float angle = 2.f * std::acos(Mn::Math::min(cosHalfAngle, 1.f));
+      CORRADE_COMPARE_AS(angle, rotationTolerance,
+                         Cr::TestSuite::Compare::LessOrEqual);
+    }
+  }
+}
+
+// Stream keyframes to a viewer connected from the start and a late one
+void GfxReplayTest::testKeyframeStream() {
+  esp::scene::SceneGraph sceneGraph;
+  esp::gfx::replay::Recorder recorder;
+  auto nodes = createInstances(sceneGraph, recorder, 10);
+  recorder.saveKeyframe();
+
+  // the server gets the keyframes saved so far
+  auto server = std::make_shared<esp::gfx::replay::KeyframeStreamServer>();
+  recorder.setKeyframeStreamServer(server);
+  esp::gfx::replay::KeyframeStreamClient client(server->getPort());
+  CORRADE_VERIFY(client.isConnected());
+  auto dummyCallback =
+      [&](const esp::assets::AssetInfo& assetInfo,
+          const esp::assets::RenderAssetInstanceCreationInfo& creation) {
+        return nullptr;
+      };
+  esp::gfx::replay::Player player(dummyCallback);
+
+  moveInstances(nodes, 1);
+  recorder.addUserTransformToKeyframe("agent", Mn::Vector3(1.f, 2.f, 3.f),
+                                      Mn::Quaternion{});
+  recorder.saveKeyframe();
+  receiveKeyframes(*server, client, player, 1);
+  CORRADE_COMPARE(server->getNumClients(), 1);
+  CORRADE_COMPARE(player.getNumKeyframes(), 1);
+  // the viewer connected after both keyframes were pushed, so it gets them
+  // merged into one
+  const auto& first = player.debugGetKeyframes()[0];
+  CORRADE_COMPARE(first.creations.size(), nodes.size());
+  CORRADE_COMPARE(first.stateUpdates.size(), nodes.size());
+  CORRADE_VERIFY(first.userTransforms.count("agent"));
+  for (const auto& update : first.stateUpdates) {
+    const auto* node = nodes[update.first];
+    CORRADE_COMPARE(update.second.absTransform.translation,
+                    node->absoluteTransformation().translation());
+  }
+
+  delete nodes[3];
+  nodes[3] = nullptr;
+  moveInstances(nodes, 2);
+  recorder.saveKeyframe();
+  receiveKeyframes(*server, client, player, 2);
+  CORRADE_COMPARE(player.getNumKeyframes(), 2);
+  const auto& second = player.debugGetKeyframes()[1];
+  CORRADE_COMPARE(second.creations.size(), 0);
+  CORRADE_COMPARE(second.deletions.size(), 1);
+  CORRADE_COMPARE(second.deletions[0], 3);
+  CORRADE_VERIFY(second.userTransforms.empty());
+
+  // writing the keyframes out consolidates creations into the next keyframe,
+  // which viewers already have
+  recorder.writeSavedKeyframesToString();
+  esp::gfx::replay::KeyframeStreamClient lateClient(server->getPort());
+  esp::gfx::replay::Player latePlayer(dummyCallback);
+  recorder.saveKeyframe();
+  receiveKeyframes(*server, client, player, 3);
+  receiveKeyframes(*server, lateClient, latePlayer, 1);
+  CORRADE_COMPARE(server->getNumClients(), 2);
+  CORRADE_COMPARE(player.getNumKeyframes(), 3);
+  CORRADE_COMPARE(player.debugGetKeyframes()[2].creations.size(), 0);
+  CORRADE_COMPARE(latePlayer.getNumKeyframes(), 1);
+  CORRADE_COMPARE(latePlayer.debugGetKeyframes()[0].creations.size(),
+                  nodes.size() - 1);
+  CORRADE_COMPARE(latePlayer.debugGetKeyframes()[0].deletions.size(), 0);
+
+  recorder.setKeyframeStreamServer(nullptr);
+  server = nullptr;
+  lateClient.receiveKeyframes(latePlayer);
+  CORRADE_VERIFY(!lateClient.isConnected());
+}
+
+void GfxReplayTest::benchmarkWriteKeyframes() {
+  auto&& data = KeyframeBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  esp::scene::SceneGraph sceneGraph;
+  esp::gfx::replay::Recorder recorder;
+  recorder.setTransformQuantization(data.quantization);
+  const auto nodes = createInstances(sceneGraph, recorder, 1000);
+
+  // writing consolidates the saved keyframes into the current one, so each
+  // measured write needs keyframes saved right before it
+  saveMovingKeyframes(recorder, nodes);
+  CORRADE_COMPARE(recorder.debugGetSavedKeyframes().size(), 30);
+
+  std::string result;
+  CORRADE_BENCHMARK(1) { result = recorder.writeSavedKeyframesToString(); }
+  CORRADE_VERIFY(!result.empty());
+  CORRADE_VERIFY(recorder.debugGetSavedKeyframes().empty());
+}
+
+void GfxReplayTest::benchmarkReadKeyframes() {
+  auto&& data = KeyframeBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  esp::scene::SceneGraph sceneGraph;
+  esp::gfx::replay::Recorder recorder;
+  recorder.setTransformQuantization(data.quantization);
+  const auto nodes = createInstances(sceneGraph, recorder, 1000);
+  saveMovingKeyframes(recorder, nodes);
+  const std::string keyframes = recorder.writeSavedKeyframesToString();
+
+  auto dummyCallback =
+      [&](const esp::assets::AssetInfo& assetInfo,
+          const esp::assets::RenderAssetInstanceCreationInfo& creation) {
+        return nullptr;
+      };
+  esp::gfx::replay::Player player(dummyCallback);
+  // reading replaces the keyframes read before
+  CORRADE_BENCHMARK(5) { player.readKeyframesFromString(keyframes); }
+  CORRADE_COMPARE(player.getNumKeyframes(), 30);
+}
+
 // construct some render keyframes and play them using replay::Player
 void GfxReplayTest::testPlayer() {
   esp::logging::LoggingContext loggingContext;
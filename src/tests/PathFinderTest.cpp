@@ -14,6 +14,9 @@
 #include <Magnum/Math/Swizzle.h>
 #include <Magnum/Math/Vector3.h>
 
+#include <cctype>
+#include <fstream>
+
 #include "configure.h"
 
 namespace Cr = Corrade;
@@ -31,6 +34,12 @@ constexpr struct {
 } MultiGoalBenchMarkData[]{{"path to closest of 1000", false},
                            {"cached path to closest of 1000", true}};
 
+constexpr struct {
+  const char* name;
+  bool clearanceField;
+} DistanceToObstacleBenchmarkData[]{{"navmesh search", false},
+                                    {"clearance field", true}};
+
 struct PathFinderTest : Cr::TestSuite::Tester {
   explicit PathFinderTest();
 
@@ -42,17 +51,32 @@ struct PathFinderTest : Cr::TestSuite::Tester {
   void benchmarkMultiGoal();
 
   void testCaching();
+  void clearanceField();
+  void savedIslands();
+  void memoryMappedNavMesh();
+  void randomNavigablePoints();
+
+  void benchmarkDistanceToObstacle();
+  void benchmarkRandomNavigablePoints();
 
   esp::logging::LoggingContext loggingContext;
 };
 
 PathFinderTest::PathFinderTest() {
   addTests({&PathFinderTest::bounds, &PathFinderTest::tryStepNoSliding,
-            &PathFinderTest::multiGoalPath, &PathFinderTest::testCaching});
-
-  addBenchmarks({&PathFinderTest::benchmarkSingleGoal}, 1000);
+            &PathFinderTest::multiGoalPath, &PathFinderTest::testCaching,
+            &PathFinderTest::clearanceField, &PathFinderTest::savedIslands,
+            &PathFinderTest::memoryMappedNavMesh,
+            &PathFinderTest::randomNavigablePoints});
+
+  addBenchmarks({&PathFinderTest::benchmarkSingleGoal,
+                 &PathFinderTest::benchmarkRandomNavigablePoints},
+                1000);
   addInstancedBenchmarks({&PathFinderTest::benchmarkMultiGoal}, 100,
                          Cr::Containers::arraySize(MultiGoalBenchMarkData));
+  addInstancedBenchmarks(
+      {&PathFinderTest::benchmarkDistanceToObstacle}, 100,
+      Cr::Containers::arraySize(DistanceToObstacleBenchmarkData));
 }
 
 void PathFinderTest::bounds() {
@@ -162,6 +186,204 @@ void PathFinderTest::testCaching() {
   }
 }
 
+void PathFinderTest::clearanceField() {
+  esp::nav::PathFinder pathFinder;
+  CORRADE_VERIFY(!pathFinder.buildClearanceField());
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> points;
+  std::vector<float> expected;
+  for (int i = 0; i < 1000; ++i) {
+    points.emplace_back(pathFinder.getRandomNavigablePoint());
+    expected.push_back(pathFinder.distanceToClosestObstacle(points.back()));
+  }
+
+  constexpr float maxRadius = 1.0f;
+  constexpr float cellSize = 0.05f;
+  CORRADE_VERIFY(pathFinder.buildClearanceField(maxRadius, cellSize));
+  CORRADE_VERIFY(pathFinder.hasClearanceField());
+  for (size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    const float distance = pathFinder.distanceToClosestObstacle(points[i]);
+    // rasterization moves the boundary by up to a cell
+    CORRADE_COMPARE_WITH(distance, expected[i],
+                         Cr::TestSuite::Compare::around(2.0f * cellSize));
+    // the field only answers below its radius, anything else is the exact
+    // navmesh search. The field may still answer where the exact distance is
+    // a bit more than the radius, so decide by the returned value.
+    if (distance >= maxRadius)
+      CORRADE_COMPARE(distance, expected[i]);
+  }
+
+  // the field follows the navmesh
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.hasClearanceField());
+  pathFinder.clearClearanceField();
+  CORRADE_VERIFY(!pathFinder.hasClearanceField());
+  CORRADE_COMPARE(pathFinder.distanceToClosestObstacle(points[0]),
+                  expected[0]);
+}
+
+void PathFinderTest::savedIslands() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  std::vector<esp::vec3f> points;
+  for (int i = 0; i < 100; ++i) {
+    points.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+
+  const std::string testFilepath =
+      Cr::Utility::Path::join(DATA_DIR, "./path_finder_islands.navmesh");
+  CORRADE_VERIFY(pathFinder.saveNavMesh(testFilepath));
+
+  // islands and area are read from the file instead of being recomputed
+  esp::nav::PathFinder loaded;
+  CORRADE_VERIFY(loaded.loadNavMesh(testFilepath));
+  CORRADE_COMPARE(loaded.getNavigableArea(), pathFinder.getNavigableArea());
+  for (size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(loaded.islandRadius(points[i]),
+                    pathFinder.islandRadius(points[i]));
+
+    esp::nav::ShortestPath path;
+    path.requestedStart = points[i];
+    path.requestedEnd = points[(i + 1) % points.size()];
+    esp::nav::ShortestPath expected = path;
+    CORRADE_COMPARE(loaded.findPath(path), pathFinder.findPath(expected));
+    CORRADE_COMPARE(path.geodesicDistance, expected.geodesicDistance);
+  }
+
+  CORRADE_VERIFY(Cr::Utility::Path::remove(testFilepath));
+}
+
+void PathFinderTest::memoryMappedNavMesh() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  pathFinder.seed(0);
+
+  // a saved navmesh carries its islands, so loading it only writes links
+  const std::string testFilepath =
+      Cr::Utility::Path::join(DATA_DIR, "./path_finder_mapped.navmesh");
+  CORRADE_VERIFY(pathFinder.saveNavMesh(testFilepath));
+
+  {
+    esp::nav::PathFinder mapped;
+    CORRADE_VERIFY(mapped.loadNavMesh(testFilepath, true));
+    CORRADE_COMPARE(mapped.getNavigableArea(), pathFinder.getNavigableArea());
+    for (int i = 0; i < 100; ++i) {
+      CORRADE_ITERATION(i);
+      esp::nav::ShortestPath path;
+      path.requestedStart = pathFinder.getRandomNavigablePoint();
+      path.requestedEnd = pathFinder.getRandomNavigablePoint();
+      esp::nav::ShortestPath expected = path;
+      CORRADE_COMPARE(mapped.findPath(path), pathFinder.findPath(expected));
+      CORRADE_COMPARE(path.geodesicDistance, expected.geodesicDistance);
+    }
+
+#ifdef __linux__
+    // Pages Detour wrote to are private copies, the rest of the mapping is
+    // page cache shared with every process mapping the file
+    std::ifstream smaps{"/proc/self/smaps"};
+    std::string line;
+    bool inMapping = false;
+    std::size_t sizeKb = 0, privateDirtyKb = 0;
+    while (std::getline(smaps, line)) {
+      if (!line.empty() && std::isxdigit(line[0]) && !std::isupper(line[0])) {
+        inMapping = line.find("path_finder_mapped.navmesh") !=
+                    std::string::npos;
+      } else if (inMapping && line.compare(0, 5, "Size:") == 0) {
+        sizeKb += std::stoul(line.substr(5));
+      } else if (inMapping && line.compare(0, 14, "Private_Dirty:") == 0) {
+        privateDirtyKb += std::stoul(line.substr(14));
+      }
+    }
+    CORRADE_COMPARE_AS(sizeKb, std::size_t{0},
+                       Cr::TestSuite::Compare::Greater);
+    CORRADE_COMPARE_AS(privateDirtyKb, sizeKb, Cr::TestSuite::Compare::Less);
+#endif
+  }
+
+  CORRADE_VERIFY(Cr::Utility::Path::remove(testFilepath));
+}
+
+void PathFinderTest::randomNavigablePoints() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  // every pathfinder has its own generator
+  esp::nav::PathFinder other;
+  other.loadNavMesh(skokloster);
+  pathFinder.seed(5);
+  other.seed(5);
+  const std::vector<esp::vec3f> points =
+      pathFinder.getRandomNavigablePoints(1000);
+  CORRADE_COMPARE(points.size(), 1000);
+  CORRADE_VERIFY(other.getRandomNavigablePoints(1000) == points);
+  CORRADE_VERIFY(pathFinder.getRandomNavigablePoints(1000) != points);
+  for (size_t i = 0; i < points.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_VERIFY(pathFinder.isNavigable(points[i]));
+  }
+
+  // restricted to large islands
+  const float minIslandRadius = 10.0f;
+  for (const esp::vec3f& pt :
+       pathFinder.getRandomNavigablePoints(100, minIslandRadius)) {
+    CORRADE_COMPARE_AS(pathFinder.islandRadius(pt), minIslandRadius,
+                       Cr::TestSuite::Compare::GreaterOrEqual);
+  }
+  CORRADE_VERIFY(pathFinder.getRandomNavigablePoints(10, 1e6f).empty());
+
+  // restricted to one island
+  esp::vec3f islandPoint;
+  do {
+    islandPoint = pathFinder.getRandomNavigablePoint();
+  } while (pathFinder.islandRadius(islandPoint) < minIslandRadius);
+  for (const esp::vec3f& pt :
+       pathFinder.getRandomNavigablePointsOnIsland(100, islandPoint)) {
+    esp::nav::ShortestPath path;
+    path.requestedStart = islandPoint;
+    path.requestedEnd = pt;
+    CORRADE_VERIFY(pathFinder.findPath(path));
+  }
+  CORRADE_VERIFY(pathFinder
+                     .getRandomNavigablePointsOnIsland(
+                         10, esp::vec3f{1e6f, 1e6f, 1e6f})
+                     .empty());
+}
+
+void PathFinderTest::benchmarkDistanceToObstacle() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+
+  auto&& data = DistanceToObstacleBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  if (data.clearanceField) {
+    CORRADE_VERIFY(pathFinder.buildClearanceField());
+  }
+
+  std::vector<esp::vec3f> points;
+  for (int i = 0; i < 1000; ++i) {
+    points.emplace_back(pathFinder.getRandomNavigablePoint());
+  }
+
+  float sum = 0.0f;
+  CORRADE_BENCHMARK(1) {
+    for (const esp::vec3f& pt : points) {
+      sum += pathFinder.distanceToClosestObstacle(pt);
+    }
+  };
+  CORRADE_VERIFY(sum > 0.0f);
+}
+
 void PathFinderTest::benchmarkSingleGoal() {
   esp::nav::PathFinder pathFinder;
   pathFinder.loadNavMesh(skokloster);
@@ -179,6 +401,18 @@ void PathFinderTest::benchmarkSingleGoal() {
   CORRADE_VERIFY(status);
 }
 
+void PathFinderTest::benchmarkRandomNavigablePoints() {
+  esp::nav::PathFinder pathFinder;
+  pathFinder.loadNavMesh(skokloster);
+  CORRADE_VERIFY(pathFinder.isLoaded());
+  // build the sampling table outside of the benchmark
+  pathFinder.getRandomNavigablePoint();
+
+  std::vector<esp::vec3f> points;
+  CORRADE_BENCHMARK(5) { points = pathFinder.getRandomNavigablePoints(1000); };
+  CORRADE_COMPARE(points.size(), 1000);
+}
+
 void PathFinderTest::benchmarkMultiGoal() {
   esp::nav::PathFinder pathFinder;
   pathFinder.loadNavMesh(skokloster);
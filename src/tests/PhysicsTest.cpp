@@ -73,13 +73,17 @@ struct PhysicsTest : Cr::TestSuite::Tester {
     sceneID_ = sceneManager_->initSceneGraph();
   }
 
-  void initStage(const std::string& stageFile) {
+  void initStage(const std::string& stageFile,
+                 int numPhysicsThreads = 1,
+                 bool deterministic = true) {
     auto& sceneGraph = sceneManager_->getSceneGraph(sceneID_);
     auto& rootNode = sceneGraph.getRootNode();
 
     // construct appropriate physics attributes based on config file
     auto physicsManagerAttributes =
         physicsAttributesManager_->createObject(physicsConfigFile, true);
+    physicsManagerAttributes->setNumThreads(numPhysicsThreads);
+    physicsManagerAttributes->setDeterministic(deterministic);
     auto stageAttributesMgr = metadataMediator_->getStageAttributesManager();
     if (physicsManagerAttributes != nullptr) {
       stageAttributesMgr->setCurrPhysicsManagerAttributesHandle(
@@ -140,6 +144,36 @@ struct PhysicsTest : Cr::TestSuite::Tester {
     return objectWrapper;
   }
 
+  /**
+   * @brief Drop a countX x countY x countZ grid of cubes into the simple room.
+   * @return The wrappers of the added cubes.
+   */
+  std::vector<esp::physics::ManagedRigidObject::ptr> addCubeGrid(int countX,
+                                                                 int countY,
+                                                                 int countZ) {
+    auto& drawables = sceneManager_->getSceneGraph(sceneID_).getDrawables();
+    std::string cubeHandle = metadataMediator_->getObjectAttributesManager()
+                                 ->getObjectHandlesBySubstring("cubeSolid")[0];
+    const Mn::Vector3 gridBase(0.21964, 1.5, -0.0897472);
+    const float spacing = 0.25;
+    std::vector<esp::physics::ManagedRigidObject::ptr> cubes;
+    for (int y = 0; y < countY; ++y) {
+      for (int x = 0; x < countX; ++x) {
+        for (int z = 0; z < countZ; ++z) {
+          auto cubeWrapper = makeObjectGetWrapper(cubeHandle, &drawables);
+          // offset alternate layers so the cubes topple into each other
+          const float layerOffset = (y % 2) * spacing * 0.5f;
+          cubeWrapper->setTranslation(
+              gridBase + Mn::Vector3((x - countX / 2) * spacing + layerOffset,
+                                     y * spacing,
+                                     (z - countZ / 2) * spacing + layerOffset));
+          cubes.push_back(cubeWrapper);
+        }
+      }
+    }
+    return cubes;
+  }
+
   // tests
   void testJoinCompound();
   void testCollisionBoundingBox();
@@ -151,6 +185,10 @@ struct PhysicsTest : Cr::TestSuite::Tester {
   void testMotionTypes();
   void testNumActiveContactPoints();
   void testRemoveSleepingSupport();
+  void testMultiThreadedDeterminism();
+
+  // benchmarks
+  void benchmarkStepManyObjects();
   /////
 
   esp::logging::LoggingContext loggingContext_;
@@ -173,6 +211,14 @@ const struct {
   bool enabled;
 } RendererEnabledData[]{{"", true}, {"renderer disabled", false}};
 
+const struct {
+  const char* name;
+  int numThreads;
+  bool deterministic;
+} PhysicsThreadsData[]{{"1 thread", 1, true},
+                       {"4 threads", 4, true},
+                       {"4 threads, nondeterministic", 4, false}};
+
 PhysicsTest::PhysicsTest() {
   addInstancedTests(
       {&PhysicsTest::testJoinCompound,
@@ -186,6 +232,12 @@ PhysicsTest::PhysicsTest() {
        &PhysicsTest::testNumActiveContactPoints,
        &PhysicsTest::testRemoveSleepingSupport},
       Cr::Containers::arraySize(RendererEnabledData));
+#ifdef ESP_BUILD_WITH_BULLET
+  addTests({&PhysicsTest::testMultiThreadedDeterminism});
+
+  addInstancedBenchmarks({&PhysicsTest::benchmarkStepManyObjects}, 5,
+                         Cr::Containers::arraySize(PhysicsThreadsData));
+#endif
 }
 
 void PhysicsTest::testJoinCompound() {
@@ -1035,6 +1087,64 @@ void PhysicsTest::testRemoveSleepingSupport() {
   }
 }  // PhysicsTest::testRemoveSleepingSupport
 
+void PhysicsTest::testMultiThreadedDeterminism() {
+  // stepping on several threads in deterministic mode must give the same
+  // result run to run
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/simple_room.glb");
+
+  std::vector<Mn::Matrix4> firstRunTransforms;
+  for (int run = 0; run < 2; ++run) {
+    resetCreateRendererFlag(false);
+    initStage(stageFile, 4, true);
+    // on a single thread the comparison below would pass trivially
+    const int numPhysicsThreads =
+        static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get())
+            ->getNumPhysicsThreads();
+    if (numPhysicsThreads < 2) {
+      CORRADE_SKIP("Bullet stepped on" << numPhysicsThreads
+                                       << "thread, multi-threading isn't "
+                                          "available in this build.");
+    }
+    auto cubes = addCubeGrid(6, 4, 6);
+
+    while (physicsManager_->getWorldTime() < 2.0) {
+      physicsManager_->stepPhysics(0.1);
+    }
+
+    for (std::size_t i = 0; i < cubes.size(); ++i) {
+      const Mn::Matrix4 transform =
+          cubes[i]->getSceneNode()->absoluteTransformationMatrix();
+      if (run == 0) {
+        firstRunTransforms.push_back(transform);
+      } else {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(transform, firstRunTransforms[i]);
+      }
+    }
+  }
+}  // PhysicsTest::testMultiThreadedDeterminism
+
+void PhysicsTest::benchmarkStepManyObjects() {
+  auto&& data = PhysicsThreadsData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  std::string stageFile =
+      Cr::Utility::Path::join(dataDir, "test_assets/scenes/simple_room.glb");
+  resetCreateRendererFlag(false);
+  initStage(stageFile, data.numThreads, data.deterministic);
+  auto cubes = addCubeGrid(8, 6, 8);
+
+  // let the pile form so the benchmark measures steps with many contacts
+  while (physicsManager_->getWorldTime() < 0.5) {
+    physicsManager_->stepPhysics(0.1);
+  }
+
+  CORRADE_BENCHMARK(10) { physicsManager_->stepPhysics(1.0 / 60.0); }
+
+  CORRADE_COMPARE(physicsManager_->getNumRigidObjects(), int(cubes.size()));
+}  // PhysicsTest::benchmarkStepManyObjects
+
 }  // namespace
 
 CORRADE_TEST_MAIN(PhysicsTest)
@@ -7,10 +7,12 @@
 #include "esp/scene/SceneManager.h"
 #include "esp/scene/SceneNode.h"
 #include "esp/sensor/CameraSensor.h"
+#include "esp/sensor/FisheyeSensor.h"
 #include "esp/sensor/Sensor.h"
 #include "esp/sensor/SensorFactory.h"
 
 namespace Cr = Corrade;
+namespace Mn = Magnum;
 using namespace esp::sensor;
 using namespace esp::scene;
 
@@ -22,6 +24,7 @@ struct SensorTest : Cr::TestSuite::Tester {
   void testSensorFactory();
   void testSensorDestructors();
   void testSetParent();
+  void testFisheyeSampledCubeFaces();
 
  private:
   esp::logging::LoggingContext loggingContext_;
@@ -32,6 +35,7 @@ SensorTest::SensorTest() {
   addTests({&SensorTest::testSensorFactory});
   addTests({&SensorTest::testSensorDestructors});
   addTests({&SensorTest::testSetParent});
+  addTests({&SensorTest::testFisheyeSampledCubeFaces});
   // clang-format on
 }
 
@@ -376,6 +380,30 @@ void SensorTest::testSetParent() {
   CORRADE_COMPARE(child2Node.getNodeSensors().size(), 1);
   CORRADE_COMPARE(child2Node.getSubtreeSensors().size(), 1);
 }
+void SensorTest::testFisheyeSampledCubeFaces() {
+  using Faces = esp::gfx::CubeMap::Faces;
+  auto spec = FisheyeSensorDoubleSphereSpec::create();
+  spec->fisheyeModelType = FisheyeSensorModelType::DoubleSphere;
+  spec->alpha = 0.57f;
+  spec->xi = -0.27f;
+  spec->resolution = {256, 256};
+
+  // a narrow lens only sees the forward (-Z) face
+  spec->focalLength = {364.84f, 364.84f};
+  CORRADE_COMPARE(FisheyeSensor::computeSampledCubeFaces(*spec, 256),
+                  Faces{Mn::UnsignedByte(1 << 5)});
+
+  // a wide lens sees the sides, but never the back (+Z) face
+  spec->focalLength = {100.0f, 100.0f};
+  CORRADE_COMPARE(FisheyeSensor::computeSampledCubeFaces(*spec, 256),
+                  Faces{Mn::UnsignedByte(0x3f & ~(1 << 4))});
+
+  // a very wide lens sees everything
+  spec->focalLength = {30.0f, 30.0f};
+  CORRADE_COMPARE(FisheyeSensor::computeSampledCubeFaces(*spec, 256),
+                  Faces{Mn::UnsignedByte(0x3f)});
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(SensorTest)
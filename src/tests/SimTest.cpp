@@ -2,6 +2,7 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
@@ -16,6 +17,7 @@
 #include "esp/assets/ResourceManager.h"
 #include "esp/physics/RigidObject.h"
 #include "esp/sensor/CameraSensor.h"
+#include "esp/sensor/FisheyeSensor.h"
 #include "esp/sim/Simulator.h"
 
 #include "configure.h"
@@ -36,6 +38,9 @@ using esp::metadata::attributes::ObjectAttributes;
 using esp::nav::PathFinder;
 using esp::sensor::CameraSensor;
 using esp::sensor::CameraSensorSpec;
+using esp::sensor::FisheyeSensor;
+using esp::sensor::FisheyeSensorDoubleSphereSpec;
+using esp::sensor::FisheyeSensorModelType;
 using esp::sensor::Observation;
 using esp::sensor::ObservationSpace;
 using esp::sensor::ObservationSpaceType;
@@ -59,6 +64,29 @@ const std::string physicsConfigFile =
 const std::string screenshotDir =
     Cr::Utility::Path::join(TEST_ASSETS, "screenshots/");
 
+// renders all six cubemap faces, regardless of what the projection samples
+struct AllFacesFisheyeSensor : FisheyeSensor {
+  using FisheyeSensor::FisheyeSensor;
+
+ protected:
+  esp::gfx::CubeMap::Faces getSampledCubeFaces(int) override {
+    return esp::gfx::CubeMap::Faces{Mn::UnsignedByte(0x3f)};
+  }
+};
+
+//! a wide fisheye lens which sees everything but the back cubemap face
+FisheyeSensorDoubleSphereSpec::ptr wideFisheyeSpec(const std::string& uuid) {
+  auto spec = FisheyeSensorDoubleSphereSpec::create();
+  spec->uuid = uuid;
+  spec->sensorType = SensorType::Color;
+  spec->fisheyeModelType = FisheyeSensorModelType::DoubleSphere;
+  spec->alpha = 0.57f;
+  spec->xi = -0.27f;
+  spec->focalLength = {50.0f, 50.0f};
+  spec->resolution = {128, 128};
+  return spec;
+}
+
 struct SimTest : Cr::TestSuite::Tester {
   explicit SimTest();
 
@@ -128,6 +156,12 @@ struct SimTest : Cr::TestSuite::Tester {
   void addObjectByHandle();
   void addSensorToObject();
   void createMagnumRenderingOff();
+  void getPerfStats();
+  void fisheyeSkipsUnsampledFaces();
+  void sortDrawsByState();
+  void instancedDraws();
+
+  void benchmarkFisheyeObservation();
 
   esp::logging::LoggingContext loggingContext_;
   // TODO: remove outlier pixels from image and lower maxThreshold
@@ -151,6 +185,12 @@ struct {
 
 } SimulatorBuilder[]{{"built with SimConfig", &SimTest::getSimulator},
                      {"built with MetadataMediator", &SimTest::getSimulatorMM}};
+struct {
+  const char* name;
+  bool allFaces;
+} FisheyeBenchmarkData[]{{"all six faces", true},
+                         {"sampled faces only", false}};
+
 SimTest::SimTest() {
   // clang-format off
   //test instances test both mechanisms for constructing simulator
@@ -170,8 +210,17 @@ SimTest::SimTest() {
             &SimTest::buildingPrimAssetObjectTemplates,
             &SimTest::addObjectByHandle,
             &SimTest::addSensorToObject,
-            &SimTest::createMagnumRenderingOff}, Cr::Containers::arraySize(SimulatorBuilder) );
+            &SimTest::createMagnumRenderingOff,
+            &SimTest::getPerfStats}, Cr::Containers::arraySize(SimulatorBuilder) );
   // clang-format on
+
+  addTests({&SimTest::fisheyeSkipsUnsampledFaces,
+            &SimTest::sortDrawsByState,
+            &SimTest::instancedDraws});
+
+  addInstancedBenchmarks({&SimTest::benchmarkFisheyeObservation}, 10,
+                         Cr::Containers::arraySize(FisheyeBenchmarkData),
+                         BenchmarkType::GpuTime);
 }
 void SimTest::basic() {
   auto&& data = SimulatorBuilder[testCaseInstanceId()];
@@ -890,6 +939,208 @@ void SimTest::createMagnumRenderingOff() {
   CORRADE_VERIFY(!cameraSensor.getObservation(*simulator, observation));
 }
 
+void SimTest::getPerfStats() {
+  auto&& data = SimulatorBuilder[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+  auto simulator = data.creator(*this, vangogh, esp::NO_LIGHT_KEY);
+
+  auto pinholeCameraSpec = CameraSensorSpec::create();
+  pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  pinholeCameraSpec->sensorType = SensorType::Color;
+  pinholeCameraSpec->position = {1.0f, 1.5f, 1.0f};
+  pinholeCameraSpec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  simulator->addAgent(agentConfig);
+  simulator->resetPerfStats();
+
+  Observation observation;
+  CORRADE_VERIFY(
+      simulator->getAgentObservation(0, pinholeCameraSpec->uuid, observation));
+  simulator->getPathFinder()->isNavigable(esp::vec3f{0.0f, 0.0f, 0.0f});
+
+  esp::sim::PerfStats stats = simulator->getPerfStats();
+  CORRADE_COMPARE(stats.sensorStats.size(), 1);
+  const esp::sensor::VisualSensorStats& sensorStats =
+      stats.sensorStats.at(pinholeCameraSpec->uuid);
+  CORRADE_VERIFY(sensorStats.drawablesSubmitted > 0);
+  CORRADE_VERIFY(sensorStats.trianglesDrawn > 0);
+  CORRADE_COMPARE(sensorStats.readbackBytes, 128 * 128 * 4);
+  CORRADE_COMPARE(stats.totalSensorStats.readbackBytes, 128 * 128 * 4);
+  CORRADE_COMPARE(stats.navMeshQueries, 1);
+
+  simulator->resetPerfStats();
+  CORRADE_COMPARE(simulator->getPerfStats().navMeshQueries, 0);
+}
+
+void SimTest::fisheyeSkipsUnsampledFaces() {
+  auto simulator = getSimulator(*this, vangogh, esp::NO_LIGHT_KEY);
+  esp::scene::SceneNode& sensorNode =
+      simulator->getActiveSceneGraph().getRootNode().createChild();
+  sensorNode.setTranslation({1.0f, 1.5f, 1.0f});
+
+  auto spec = wideFisheyeSpec("fisheye");
+  auto referenceSpec = wideFisheyeSpec("fisheye_all_faces");
+  // make sure there is something to skip
+  CORRADE_VERIFY(!FisheyeSensor::computeSampledCubeFaces(*spec, 128).all());
+
+  sensorNode.addFeature<FisheyeSensor>(spec);
+  sensorNode.addFeature<AllFacesFisheyeSensor>(referenceSpec);
+  auto& sensor = dynamic_cast<FisheyeSensor&>(
+      sensorNode.getNodeSensorSuite().get(spec->uuid));
+  auto& referenceSensor = dynamic_cast<AllFacesFisheyeSensor&>(
+      sensorNode.getNodeSensorSuite().get(referenceSpec->uuid));
+  simulator->getRenderer()->bindRenderTarget(sensor);
+  simulator->getRenderer()->bindRenderTarget(referenceSensor);
+
+  Observation observation;
+  Observation referenceObservation;
+  CORRADE_VERIFY(sensor.getObservation(*simulator, observation));
+  CORRADE_VERIFY(
+      referenceSensor.getObservation(*simulator, referenceObservation));
+
+  // the skipped faces are never sampled, so the output must not change at all
+  CORRADE_COMPARE_WITH(
+      (Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm,
+                       {spec->resolution[1], spec->resolution[0]},
+                       observation.buffer->data}),
+      (Mn::ImageView2D{Mn::PixelFormat::RGBA8Unorm,
+                       {spec->resolution[1], spec->resolution[0]},
+                       referenceObservation.buffer->data}),
+      (Mn::DebugTools::CompareImage{0.0f, 0.0f}));
+}
+
+void SimTest::sortDrawsByState() {
+  auto simulator = getSimulator(*this, vangogh, esp::NO_LIGHT_KEY);
+
+  auto pinholeCameraSpec = CameraSensorSpec::create();
+  pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  pinholeCameraSpec->sensorType = SensorType::Color;
+  pinholeCameraSpec->position = {1.0f, 1.5f, 1.0f};
+  pinholeCameraSpec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  simulator->addAgent(agentConfig);
+
+  Observation unsortedObservation;
+  CORRADE_VERIFY(!simulator->isDrawStateSortingEnabled());
+  simulator->setDrawStateStatsEnabled(true);
+  CORRADE_VERIFY(simulator->getAgentObservation(0, pinholeCameraSpec->uuid,
+                                                unsortedObservation));
+  const esp::sensor::VisualSensorStats unsortedStats =
+      simulator->getPerfStats().sensorStats.at(pinholeCameraSpec->uuid);
+  CORRADE_VERIFY(unsortedStats.stateChanges > 0);
+  CORRADE_COMPARE(unsortedStats.stateChanges,
+                  unsortedStats.stateChangesUnsorted);
+  // the sensor reuses its buffer for every observation
+  const std::vector<uint8_t> unsortedPixels(
+      unsortedObservation.buffer->data.begin(),
+      unsortedObservation.buffer->data.end());
+
+  simulator->setDrawStateSortingEnabled(true);
+  Observation sortedObservation;
+  CORRADE_VERIFY(simulator->getAgentObservation(0, pinholeCameraSpec->uuid,
+                                                sortedObservation));
+  const esp::sensor::VisualSensorStats sortedStats =
+      simulator->getPerfStats().sensorStats.at(pinholeCameraSpec->uuid);
+  CORRADE_COMPARE(sortedStats.stateChangesUnsorted,
+                  unsortedStats.stateChangesUnsorted);
+  CORRADE_COMPARE_AS(sortedStats.stateChanges,
+                     sortedStats.stateChangesUnsorted,
+                     Cr::TestSuite::Compare::LessOrEqual);
+
+  // the scene is opaque, so only the draw order changes, not the image
+  CORRADE_COMPARE_WITH(
+      (Mn::ImageView2D{
+          Mn::PixelFormat::RGBA8Unorm,
+          {pinholeCameraSpec->resolution[1], pinholeCameraSpec->resolution[0]},
+          sortedObservation.buffer->data}),
+      (Mn::ImageView2D{
+          Mn::PixelFormat::RGBA8Unorm,
+          {pinholeCameraSpec->resolution[1], pinholeCameraSpec->resolution[0]},
+          unsortedPixels}),
+      (Mn::DebugTools::CompareImage{0.0f, 0.0f}));
+}
+
+void SimTest::instancedDraws() {
+  auto simulator = getSimulator(*this, planeStage, esp::NO_LIGHT_KEY);
+  auto objectAttribsMgr = simulator->getObjectAttributesManager();
+  auto rigidObjMgr = simulator->getRigidObjectManager();
+  auto objs = objectAttribsMgr->getObjectHandlesBySubstring("nested_box");
+  // copies of the same object share meshes and materials
+  for (int i = 0; i < 3; ++i) {
+    auto obj =
+        rigidObjMgr->addObjectByHandle(objs[0], nullptr, "custom_lighting_1");
+    CORRADE_VERIFY(obj->isAlive());
+    obj->setTranslation({float(i), 0.5f, -0.5f});
+  }
+
+  auto pinholeCameraSpec = CameraSensorSpec::create();
+  pinholeCameraSpec->sensorSubType = esp::sensor::SensorSubType::Pinhole;
+  pinholeCameraSpec->sensorType = SensorType::Color;
+  pinholeCameraSpec->position = {1.0f, 1.5f, 1.0f};
+  pinholeCameraSpec->resolution = {128, 128};
+  AgentConfiguration agentConfig{};
+  agentConfig.sensorSpecifications = {pinholeCameraSpec};
+  simulator->addAgent(agentConfig);
+
+  Observation observation;
+  CORRADE_VERIFY(!simulator->isInstancingEnabled());
+  CORRADE_VERIFY(
+      simulator->getAgentObservation(0, pinholeCameraSpec->uuid, observation));
+  const esp::sensor::VisualSensorStats stats =
+      simulator->getPerfStats().sensorStats.at(pinholeCameraSpec->uuid);
+  // the sensor reuses its buffer for every observation
+  const std::vector<uint8_t> pixels(observation.buffer->data.begin(),
+                                    observation.buffer->data.end());
+
+  simulator->setInstancingEnabled(true);
+  Observation instancedObservation;
+  CORRADE_VERIFY(simulator->getAgentObservation(0, pinholeCameraSpec->uuid,
+                                                instancedObservation));
+  const esp::sensor::VisualSensorStats instancedStats =
+      simulator->getPerfStats().sensorStats.at(pinholeCameraSpec->uuid);
+  CORRADE_COMPARE(instancedStats.trianglesDrawn, stats.trianglesDrawn);
+  CORRADE_COMPARE_AS(instancedStats.drawCalls, stats.drawCalls,
+                     Cr::TestSuite::Compare::Less);
+
+  // instancing only changes how the drawables are submitted, not the image
+  CORRADE_COMPARE_WITH(
+      (Mn::ImageView2D{
+          Mn::PixelFormat::RGBA8Unorm,
+          {pinholeCameraSpec->resolution[1], pinholeCameraSpec->resolution[0]},
+          instancedObservation.buffer->data}),
+      (Mn::ImageView2D{
+          Mn::PixelFormat::RGBA8Unorm,
+          {pinholeCameraSpec->resolution[1], pinholeCameraSpec->resolution[0]},
+          pixels}),
+      (Mn::DebugTools::CompareImage{0.0f, 0.0f}));
+}
+
+void SimTest::benchmarkFisheyeObservation() {
+  auto&& data = FisheyeBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  auto simulator = getSimulator(*this, vangogh, esp::NO_LIGHT_KEY);
+  esp::scene::SceneNode& sensorNode =
+      simulator->getActiveSceneGraph().getRootNode().createChild();
+  sensorNode.setTranslation({1.0f, 1.5f, 1.0f});
+
+  auto spec = wideFisheyeSpec("fisheye");
+  if (data.allFaces) {
+    sensorNode.addFeature<AllFacesFisheyeSensor>(spec);
+  } else {
+    sensorNode.addFeature<FisheyeSensor>(spec);
+  }
+  auto& sensor = dynamic_cast<FisheyeSensor&>(
+      sensorNode.getNodeSensorSuite().get(spec->uuid));
+  simulator->getRenderer()->bindRenderTarget(sensor);
+  // warm up, so shader compilation is not measured
+  CORRADE_VERIFY(sensor.drawObservation(*simulator));
+
+  CORRADE_BENCHMARK(5) { sensor.drawObservation(*simulator); }
+}
+
 }  // namespace
 
 CORRADE_TEST_MAIN(SimTest)
@@ -1,9 +1,16 @@
 // Copyright (c) Facebook, Inc. and its affiliates.
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Path.h>
 #include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "esp/geo/VoxelUtils.h"
 #include "esp/geo/VoxelWrapper.h"
@@ -16,21 +23,83 @@ namespace Mn = Magnum;
 
 namespace {
 
-// Test is not compiled if --vhacd is not enabled
+const struct {
+  const char* name;
+  esp::geo::VoxelizationMethod method;
+  int resolution;
+} VoxelizationBenchmarkData[]{
+    {"built-in, 10k voxels", esp::geo::VoxelizationMethod::Builtin, 10000},
+    {"built-in, 100k voxels", esp::geo::VoxelizationMethod::Builtin, 100000},
+    {"built-in, 1M voxels", esp::geo::VoxelizationMethod::Builtin, 1000000},
+#ifdef ESP_BUILD_WITH_VHACD
+    {"VHACD, 10k voxels", esp::geo::VoxelizationMethod::VHACD, 10000},
+    {"VHACD, 100k voxels", esp::geo::VoxelizationMethod::VHACD, 100000},
+    {"VHACD, 1M voxels", esp::geo::VoxelizationMethod::VHACD, 1000000},
+#endif
+};
+
 struct VoxelGridTest : Cr::TestSuite::Tester {
   explicit VoxelGridTest();
 
+#ifdef ESP_BUILD_WITH_VHACD
   void testVoxelGridWithVHACD();
   void testVoxelUtilityFunctions();
+#endif
+  void testBuiltinVoxelization();
+  void testEuclideanDistanceSDF();
+  void testSparseGrid();
+  void testSparseGridUtilityFunctions();
+  void testGridHandles();
+  void testBulkOperations();
+
+  void benchmarkVoxelization();
+  void benchmarkEuclideanDistanceSDF();
 
   esp::logging::LoggingContext loggingContext_;
 };
 
 VoxelGridTest::VoxelGridTest() {
+#ifdef ESP_BUILD_WITH_VHACD
   addTests({&VoxelGridTest::testVoxelGridWithVHACD});
   addTests({&VoxelGridTest::testVoxelUtilityFunctions});
+#endif
+  addTests({&VoxelGridTest::testBuiltinVoxelization,
+            &VoxelGridTest::testEuclideanDistanceSDF,
+            &VoxelGridTest::testSparseGrid,
+            &VoxelGridTest::testSparseGridUtilityFunctions,
+            &VoxelGridTest::testGridHandles,
+            &VoxelGridTest::testBulkOperations});
+
+  addInstancedBenchmarks({&VoxelGridTest::benchmarkVoxelization}, 3,
+                         Cr::Containers::arraySize(VoxelizationBenchmarkData));
+  addBenchmarks({&VoxelGridTest::benchmarkEuclideanDistanceSDF}, 3);
 }
 
+esp::sim::Simulator::uptr createSkoklosterSimulator() {
+  auto simConfig = esp::sim::SimulatorConfiguration();
+  simConfig.activeSceneName = Cr::Utility::Path::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.glb");
+  simConfig.enablePhysics = true;
+  return esp::sim::Simulator::create_unique(simConfig);
+}
+
+// the surface of the [-1, 1] cube, optionally without its top face
+esp::assets::MeshData cubeMesh(bool closed) {
+  esp::assets::MeshData mesh;
+  for (int i = 0; i < 8; ++i) {
+    mesh.vbo.emplace_back(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f,
+                          i & 4 ? 1.0f : -1.0f);
+  }
+  // two triangles per face, the top (+Y) face last
+  mesh.ibo = {0, 1, 5, 0, 5, 4, 0, 4, 6, 0, 6, 2, 0, 2, 3, 0, 3, 1,
+              1, 3, 7, 1, 7, 5, 4, 5, 7, 4, 7, 6, 2, 6, 7, 2, 7, 3};
+  if (!closed) {
+    mesh.ibo.resize(mesh.ibo.size() - 6);
+  }
+  return mesh;
+}
+
+#ifdef ESP_BUILD_WITH_VHACD
 void VoxelGridTest::testVoxelGridWithVHACD() {
   // configure and intialize Simulator
   auto simConfig = esp::sim::SimulatorConfiguration();
@@ -146,8 +215,22 @@ void VoxelGridTest::testVoxelUtilityFunctions() {
   auto esdf_grid = voxelization->getGrid<float>("ESDF");
   auto msdf_grid = voxelization->getGrid<int>("MSDF");
 
-  std::vector<float> correct_esdf_values =
-      std::vector<float>{7, 1.73205, 3, 2, -3, 1, -12, -6.16441};
+  // the ESDF is the exact distance, in voxels, to the nearest boundary voxel
+  // and negative inside, so compare it against a brute force search
+  const std::vector<Mn::Vector3i> boundary_indices =
+      esp::geo::getVoxelSetFromIntGrid(voxelization, "InteriorExterior", 0, 0);
+  CORRADE_VERIFY(!boundary_indices.empty());
+  std::vector<float> correct_esdf_values;
+  for (const Mn::Vector3i& ind : voxel_indices) {
+    int squaredDistance = std::numeric_limits<int>::max();
+    for (const Mn::Vector3i& boundary : boundary_indices) {
+      squaredDistance = std::min(squaredDistance, (boundary - ind).dot());
+    }
+    const float distance = std::sqrt(float(squaredDistance));
+    correct_esdf_values.push_back(
+        voxelization->getVoxel<int>(ind, "InteriorExterior") < 0 ? -distance
+                                                                 : distance);
+  }
   std::vector<int> correct_msdf_values =
       std::vector<int>{7, 3, 3, 2, -3, 1, -12, -8};
 
@@ -185,6 +268,283 @@ void VoxelGridTest::testVoxelUtilityFunctions() {
   }
   CORRADE_VERIFY(valuesAreInRange);
 }
+#endif
+
+void VoxelGridTest::testBuiltinVoxelization() {
+  // 0.1 voxels over the cube
+  esp::geo::VoxelGrid closed{cubeMesh(true), "cube", 8000,
+                             esp::geo::VoxelizationMethod::Builtin};
+  CORRADE_COMPARE(closed.getVoxelSize(), Mn::Vector3{0.1f});
+  const Mn::Vector3i dims = closed.getVoxelGridDimensions();
+  CORRADE_VERIFY((dims >= Mn::Vector3i{23}).all());
+  CORRADE_VERIFY((dims <= Mn::Vector3i{24}).all());
+
+  // the cube surface and everything it encloses are filled, the rest isn't
+  int numMismatches = 0;
+  for (int i = 0; i < dims[0]; ++i) {
+    for (int j = 0; j < dims[1]; ++j) {
+      for (int k = 0; k < dims[2]; ++k) {
+        const Mn::Vector3i index{i, j, k};
+        const Mn::Vector3 center = closed.getGlobalCoords(index);
+        const float distance = Mn::Math::abs(center).max();
+        const bool filled = closed.getVoxel<bool>(index, "Boundary");
+        // voxels within half a voxel of the surface may go either way
+        if ((distance < 0.95f && !filled) || (distance > 1.05f && filled)) {
+          ++numMismatches;
+        }
+      }
+    }
+  }
+  CORRADE_COMPARE(numMismatches, 0);
+
+  // without the top face the inside is reachable from outside, only the
+  // surface is left
+  esp::geo::VoxelGrid open{cubeMesh(false), "open cube", 8000,
+                           esp::geo::VoxelizationMethod::Builtin};
+  const Mn::Vector3i middle = open.getVoxelGridDimensions() / 2;
+  CORRADE_VERIFY(!open.getVoxel<bool>(middle, "Boundary"));
+  const Mn::Vector3i bottom{middle[0], 1, middle[2]};
+  CORRADE_VERIFY(open.getVoxel<bool>(bottom, "Boundary"));
+}
+
+void VoxelGridTest::testEuclideanDistanceSDF() {
+  auto simulator = createSkoklosterSimulator();
+  // small enough to check every voxel against every boundary voxel
+  simulator->createStageVoxelization(4000);
+  auto voxelization = simulator->getStageVoxelization();
+  esp::geo::generateEuclideanDistanceSDF(voxelization, "ESDF");
+
+  auto grid = voxelization->getVoxelGrid();
+  const Mn::Vector3i dims = grid->getVoxelGridDimensions();
+  const std::vector<Mn::Vector3i> boundary =
+      esp::geo::getVoxelSetFromBoolGrid(voxelization, "Boundary");
+  CORRADE_VERIFY(!boundary.empty());
+  auto esdfGrid = grid->getGrid<float>("ESDF");
+  auto intExtGrid = grid->getGrid<int>("InteriorExterior");
+
+  int numMismatches = 0;
+  for (int i = 0; i < dims[0]; ++i) {
+    for (int j = 0; j < dims[1]; ++j) {
+      for (int k = 0; k < dims[2]; ++k) {
+        const Mn::Vector3i index{i, j, k};
+        float closest = std::numeric_limits<float>::max();
+        for (const Mn::Vector3i& cell : boundary) {
+          closest =
+              Mn::Math::min(closest, Mn::Vector3(cell - index).length());
+        }
+        const float expected = intExtGrid[i][j][k] < 0 ? -closest : closest;
+        if (Mn::Math::abs(esdfGrid[i][j][k] - expected) > 1e-4f) {
+          ++numMismatches;
+        }
+      }
+    }
+  }
+  CORRADE_COMPARE(numMismatches, 0);
+  // the approximate sweeps' extra grid is gone
+  CORRADE_VERIFY(!grid->gridExists("ClosestBoundaryCell"));
+}
+
+void VoxelGridTest::testSparseGrid() {
+  // not a multiple of the block size, so edge blocks are clipped
+  esp::geo::VoxelGrid grid{Mn::Vector3{0.1f}, Mn::Vector3i{20, 17, 9}};
+  grid.addSparseGrid<int>("sparse", -1);
+  CORRADE_VERIFY(grid.isSparseGrid("sparse"));
+  CORRADE_COMPARE(grid.getBackground<int>("sparse"), -1);
+  CORRADE_COMPARE(grid.getVoxel<int>({19, 16, 8}, "sparse"), -1);
+
+  // setting the background doesn't allocate anything
+  grid.setVoxel<int>({3, 3, 3}, "sparse", -1);
+  CORRADE_COMPARE(grid.getNumAllocatedBlocks("sparse"), std::size_t(0));
+
+  grid.setVoxel<int>({0, 0, 0}, "sparse", 5);
+  grid.setVoxel<int>({7, 7, 7}, "sparse", 6);
+  grid.setVoxel<int>({19, 16, 8}, "sparse", 7);
+  CORRADE_COMPARE(grid.getNumAllocatedBlocks("sparse"), std::size_t(2));
+  CORRADE_COMPARE(grid.getVoxel<int>({0, 0, 0}, "sparse"), 5);
+  CORRADE_COMPARE(grid.getVoxel<int>({7, 7, 7}, "sparse"), 6);
+  CORRADE_COMPARE(grid.getVoxel<int>({19, 16, 8}, "sparse"), 7);
+  CORRADE_COMPARE(grid.getVoxel<int>({1, 0, 0}, "sparse"), -1);
+  CORRADE_COMPARE(grid.getVoxel<int>({16, 16, 8}, "sparse"), -1);
+
+  // only the allocated blocks are visited, clipped to the grid
+  int numVisited = 0;
+  grid.forEachAllocatedBlock<int>(
+      "sparse", [&](const Mn::Vector3i& origin,
+                    const Cr::Containers::StridedArrayView3D<int>& block) {
+        CORRADE_COMPARE(origin % esp::geo::VoxelGrid::SparseBlockSize,
+                        Mn::Vector3i{});
+        numVisited += int(block.size()[0] * block.size()[1] * block.size()[2]);
+      });
+  CORRADE_COMPARE(numVisited, 8 * 8 * 8 + 4 * 1 * 1);
+
+  // a dense copy and a dense grid made sparse hold the same voxels
+  grid.addGrid<int>("dense");
+  auto dense = grid.getGrid<int>("dense");
+  grid.copyGridTo<int>("sparse", dense);
+  grid.makeGridSparse<int>("dense", -1);
+  CORRADE_VERIFY(grid.isSparseGrid("dense"));
+  CORRADE_COMPARE(grid.getNumAllocatedBlocks("dense"), std::size_t(2));
+  for (int i = 0; i < 20; ++i) {
+    for (int j = 0; j < 17; ++j) {
+      for (int k = 0; k < 9; ++k) {
+        CORRADE_ITERATION(Mn::Vector3i(i, j, k));
+        CORRADE_COMPARE(grid.getVoxel<int>({i, j, k}, "dense"),
+                        grid.getVoxel<int>({i, j, k}, "sparse"));
+      }
+    }
+  }
+}
+
+void VoxelGridTest::testSparseGridUtilityFunctions() {
+  auto simulator = createSkoklosterSimulator();
+  simulator->createStageVoxelization(100000);
+  auto voxelization = simulator->getStageVoxelization();
+  auto grid = voxelization->getVoxelGrid();
+  esp::geo::generateEuclideanDistanceSDF(voxelization, "ESDF");
+  const std::vector<Mn::Vector3i> boundary =
+      esp::geo::getVoxelSetFromBoolGrid(voxelization, "Boundary");
+
+  // the same fields computed from a sparse boundary match
+  grid->makeGridSparse<bool>("Boundary");
+  CORRADE_COMPARE_AS(grid->getNumAllocatedBlocks("Boundary"),
+                     std::size_t(grid->gridSize()) /
+                         (esp::geo::VoxelGrid::SparseBlockSize *
+                          esp::geo::VoxelGrid::SparseBlockSize *
+                          esp::geo::VoxelGrid::SparseBlockSize),
+                     Cr::TestSuite::Compare::LessOrEqual);
+  CORRADE_VERIFY(esp::geo::getVoxelSetFromBoolGrid(voxelization, "Boundary") ==
+                 boundary);
+
+  grid->removeGrid("InteriorExterior");
+  esp::geo::generateEuclideanDistanceSDF(voxelization, "SparseESDF");
+  CORRADE_VERIFY(grid->isSparseGrid("InteriorExterior"));
+  const Mn::Vector3i dims = grid->getVoxelGridDimensions();
+  auto esdf = grid->getGrid<float>("ESDF");
+  auto sparseEsdf = grid->getGrid<float>("SparseESDF");
+  int numMismatches = 0;
+  for (int i = 0; i < dims[0]; ++i) {
+    for (int j = 0; j < dims[1]; ++j) {
+      for (int k = 0; k < dims[2]; ++k) {
+        numMismatches += esdf[i][j][k] == sparseEsdf[i][j][k] ? 0 : 1;
+      }
+    }
+  }
+  CORRADE_COMPARE(numMismatches, 0);
+}
+
+void VoxelGridTest::testGridHandles() {
+  esp::geo::VoxelGrid grid{Mn::Vector3{0.1f}, Mn::Vector3i{20, 17, 9}};
+  grid.addGrid<int>("dense");
+  grid.addSparseGrid<int>("sparse", -1);
+
+  const auto dense = grid.getGridHandle<int>("dense");
+  const auto sparse = grid.getGridHandle<int>("sparse");
+  CORRADE_VERIFY(dense);
+  CORRADE_VERIFY(!esp::geo::VoxelGrid::GridHandle<int>{});
+  CORRADE_VERIFY(!dense.isSparse());
+  CORRADE_VERIFY(sparse.isSparse());
+  CORRADE_COMPARE(dense.getDimensions(), (Mn::Vector3i{20, 17, 9}));
+  CORRADE_COMPARE(dense.size(), std::size_t(20 * 17 * 9));
+  CORRADE_VERIFY(sparse.data() == nullptr);
+
+  // handles and name lookups see the same voxels
+  dense.set({19, 16, 8}, 3);
+  sparse.set({19, 16, 8}, 3);
+  CORRADE_COMPARE(grid.getVoxel<int>({19, 16, 8}, "dense"), 3);
+  CORRADE_COMPARE(grid.getVoxel<int>({19, 16, 8}, "sparse"), 3);
+  CORRADE_COMPARE(dense.data()[20 * 17 * 9 - 1], 3);
+  grid.setVoxel<int>({1, 2, 3}, "dense", 4);
+  grid.setVoxel<int>({1, 2, 3}, "sparse", 4);
+  CORRADE_COMPARE(dense.get({1, 2, 3}), 4);
+  CORRADE_COMPARE(sparse.get({1, 2, 3}), 4);
+  CORRADE_COMPARE(sparse.get({0, 0, 0}), -1);
+  CORRADE_COMPARE(grid.getNumAllocatedBlocks("sparse"), std::size_t(2));
+
+  // the dense expansion of a sparse grid has the background everywhere else
+  Cr::Containers::Array<char> storage;
+  const int* expanded = sparse.denseData(storage);
+  CORRADE_COMPARE(expanded[0], -1);
+  CORRADE_COMPARE(expanded[(1 * 17 + 2) * 9 + 3], 4);
+  CORRADE_COMPARE(expanded[20 * 17 * 9 - 1], 3);
+}
+
+void VoxelGridTest::testBulkOperations() {
+  // large enough to be split into many chunks
+  const Mn::Vector3i dims{70, 60, 50};
+  esp::geo::VoxelGrid grid{Mn::Vector3{0.1f}, dims};
+  grid.addGrid<int>("index");
+  const auto index = grid.getGridHandle<int>("index");
+  for (std::size_t i = 0; i != index.size(); ++i) {
+    index.data()[i] = int(i);
+  }
+
+  grid.addGrid<float>("half");
+  const auto half = grid.getGridHandle<float>("half");
+  esp::geo::transformGrid(index, half, [](int value) { return value * 0.5f; });
+  CORRADE_COMPARE(half.get({1, 0, 0}), 60 * 50 * 0.5f);
+
+  grid.addGrid<bool>("match");
+  const auto match = grid.getGridHandle<bool>("match");
+  esp::geo::combineGrids(index, half, match, [](int value, float halfValue) {
+    return value == int(halfValue * 2.0f);
+  });
+  const int numMatches = esp::geo::reduceGrid(
+      match, 0, [](int count, bool value) { return count + int(value); },
+      [](int a, int b) { return a + b; });
+  CORRADE_COMPARE(numMatches, int(index.size()));
+
+  const long long sum = esp::geo::reduceGrid(
+      index, 0ll, [](long long a, int value) { return a + value; },
+      [](long long a, long long b) { return a + b; });
+  const long long n = index.size();
+  CORRADE_COMPARE(sum, n * (n - 1) / 2);
+
+  // masked extraction is in [i][j][k] order, from dense and sparse grids
+  const std::vector<Mn::Vector3i> multiples = esp::geo::getVoxelSetWhere(
+      index, [](int value) { return value % 1000 == 0; });
+  CORRADE_COMPARE(multiples.size(), (index.size() + 999) / 1000);
+  for (std::size_t i = 0; i != multiples.size(); ++i) {
+    CORRADE_ITERATION(i);
+    CORRADE_COMPARE(index.get(multiples[i]), int(i * 1000));
+  }
+  // with a background outside the mask only the allocated blocks are scanned
+  grid.makeGridSparse<int>("index", -1);
+  CORRADE_VERIFY(esp::geo::getVoxelSetWhere(
+                     grid.getGridHandle<int>("index"),
+                     [](int value) { return value % 1000 == 0; }) ==
+                 multiples);
+}
+
+void VoxelGridTest::benchmarkVoxelization() {
+  auto&& data = VoxelizationBenchmarkData[testCaseInstanceId()];
+  setTestCaseDescription(data.name);
+
+  auto simConfig = esp::sim::SimulatorConfiguration();
+  simConfig.activeSceneName = Cr::Utility::Path::join(
+      SCENE_DATASETS, "habitat-test-scenes/skokloster-castle.glb");
+  auto simulator = esp::sim::Simulator::create_unique(simConfig);
+  const esp::assets::MeshData::ptr mesh = simulator->getJoinedMesh();
+  CORRADE_VERIFY(mesh);
+
+  esp::geo::VoxelGrid::ptr grid;
+  CORRADE_BENCHMARK(1) {
+    grid = std::make_shared<esp::geo::VoxelGrid>(*mesh, "stage",
+                                                 data.resolution, data.method);
+  };
+  CORRADE_VERIFY(grid);
+}
+
+void VoxelGridTest::benchmarkEuclideanDistanceSDF() {
+  auto simulator = createSkoklosterSimulator();
+  simulator->createStageVoxelization(1000000);
+  auto voxelization = simulator->getStageVoxelization();
+  esp::geo::generateInteriorExteriorVoxelGrid(voxelization);
+
+  CORRADE_BENCHMARK(1) {
+    esp::geo::generateEuclideanDistanceSDF(voxelization, "ESDF");
+  };
+  CORRADE_VERIFY(voxelization->getVoxelGrid()->gridExists("ESDF"));
+}
 }  // namespace
 
 CORRADE_TEST_MAIN(VoxelGridTest)
@@ -84,6 +84,8 @@ if not getattr(builtins, "__HSIM_SETUP__", False):
         FisheyeSensorDoubleSphereSpec,
         FisheyeSensorModelType,
         FisheyeSensorSpec,
+        LidarSensor,
+        LidarSensorSpec,
         RLRAudioPropagationChannelLayout,
         RLRAudioPropagationChannelLayoutType,
         RLRAudioPropagationConfiguration,
@@ -1,4 +1,6 @@
 from habitat_sim._ext.habitat_sim_bindings import (
+    Crowd,
+    CrowdAgentParams,
     GreedyFollowerCodes,
     GreedyGeodesicFollowerImpl,
     HitRecord,
@@ -12,6 +14,8 @@ from habitat_sim._ext.habitat_sim_bindings import (
 from .greedy_geodesic_follower import GreedyGeodesicFollower
 
 __all__ = [
+    "Crowd",
+    "CrowdAgentParams",
     "GreedyGeodesicFollower",
     "GreedyGeodesicFollowerImpl",
     "GreedyFollowerCodes",
@@ -192,6 +192,27 @@ class GreedyGeodesicFollower:
 
         return path
 
+    def build_action_table(self, goal_pos: np.ndarray, cell_size: float = 0.0) -> int:
+        r"""Precomputes the action to take towards the goal from every
+        (position, heading) pose of a lattice, so that :ref:`next_action_along`
+        and :ref:`find_path` towards it become table lookups. Worth it when
+        many episodes share a goal, e.g. when generating demonstrations.
+
+        :param goal_pos: The position of the goal
+        :param cell_size: The lattice resolution. Defaults to half the forward
+            step size.
+        :return: The number of lattice cells, 0 if the goal isn't navigable
+
+        .. note-warning::
+
+            Like :ref:`find_path`, this assumes the agent has no actuation
+            noise while the table is built.
+        """
+        return self.impl.build_action_table(goal_pos, cell_size)
+
+    def clear_action_table(self) -> None:
+        self.impl.clear_action_table()
+
     def reset(self) -> None:
         self.impl.reset()
         self.last_goal = None
@@ -15,6 +15,8 @@ from habitat_sim._ext.habitat_sim_bindings import (
     FisheyeSensorDoubleSphereSpec,
     FisheyeSensorModelType,
     FisheyeSensorSpec,
+    LidarSensor,
+    LidarSensorSpec,
     Observation,
     RLRAudioPropagationChannelLayout,
     RLRAudioPropagationChannelLayoutType,
@@ -39,6 +41,8 @@ __all__ = [
     "FisheyeSensorDoubleSphereSpec",
     "FisheyeSensorModelType",
     "FisheyeSensorSpec",
+    "LidarSensor",
+    "LidarSensorSpec",
     "Observation",
     "Sensor",
     "SensorFactory",
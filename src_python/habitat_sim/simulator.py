@@ -89,8 +89,15 @@ class Simulator(SimulatorBackend):
                 "Config has not agents specified.  Must specify at least 1 agent"
             )
 
+        # lidar sensors cast rays into the collision world and need no renderer
         config.sim_cfg.create_renderer = any(
-            (len(cfg.sensor_specifications) > 0 for cfg in config.agents)
+            (
+                any(
+                    sens_spec.sensor_type != SensorType.LIDAR
+                    for sens_spec in cfg.sensor_specifications
+                )
+                for cfg in config.agents
+            )
         )
         config.sim_cfg.load_semantic_mesh |= any(
             (
@@ -575,7 +582,7 @@ class Sensor:
 
         self._spec = self._sensor_object.specification()
 
-        if self._spec.sensor_type == SensorType.AUDIO:
+        if self._spec.sensor_type in (SensorType.AUDIO, SensorType.LIDAR):
             return
 
         if self._sim.renderer is not None:
@@ -645,7 +652,7 @@ class Sensor:
         )
 
     def draw_observation(self) -> None:
-        if self._spec.sensor_type == SensorType.AUDIO:
+        if self._spec.sensor_type in (SensorType.AUDIO, SensorType.LIDAR):
             # do nothing in draw observation, get_observation will be called after this
             # run the simulation there
             return
@@ -661,7 +668,7 @@ class Sensor:
             self._sim.renderer.draw(self._sensor_object, self._sim)
 
     def _draw_observation_async(self) -> None:
-        if self._spec.sensor_type == SensorType.AUDIO:
+        if self._spec.sensor_type in (SensorType.AUDIO, SensorType.LIDAR):
             # do nothing in draw observation, get_observation will be called after this
             # run the simulation there
             return
@@ -716,6 +723,12 @@ class Sensor:
             if self._sim.frustum_culling:
                 render_flags |= habitat_sim.gfx.Camera.Flags.FRUSTUM_CULLING
 
+            if self._sim.sort_draws_by_state:
+                render_flags |= habitat_sim.gfx.Camera.Flags.SORT_BY_STATE
+
+            if self._sim.instancing:
+                render_flags |= habitat_sim.gfx.Camera.Flags.INSTANCING
+
             self._sim.renderer.enqueue_async_draw_job(
                 self._sensor_object, scene, self.view, render_flags
             )
@@ -723,6 +736,8 @@ class Sensor:
     def get_observation(self) -> Union[ndarray, "Tensor"]:
         if self._spec.sensor_type == SensorType.AUDIO:
             return self._get_audio_observation()
+        if self._spec.sensor_type == SensorType.LIDAR:
+            return self._get_lidar_observation()
 
         assert self._sim.renderer is not None
         tgt = self._sensor_object.render_target
@@ -752,6 +767,8 @@ class Sensor:
     def _get_observation_async(self) -> Union[ndarray, "Tensor"]:
         if self._spec.sensor_type == SensorType.AUDIO:
             return self._get_audio_observation()
+        if self._spec.sensor_type == SensorType.LIDAR:
+            return self._get_lidar_observation()
 
         if self._spec.gpu2gpu_transfer:
             obs = self._buffer.flip(0)  # type: ignore[union-attr]
@@ -776,6 +793,15 @@ class Sensor:
         obs = audio_sensor.getIR()
         return obs
 
+    def _get_lidar_observation(self) -> ndarray:
+        assert self._spec.sensor_type == SensorType.LIDAR
+        if not self._sensor_object.object:
+            raise habitat_sim.errors.InvalidAttachedObject(
+                "Sensor observation requested but sensor is invalid.\
+                (has it been detached from a scene node?)"
+            )
+        return self._sensor_object.scan(self._sim)
+
     def close(self) -> None:
         self._sim = None
         self._agent = None
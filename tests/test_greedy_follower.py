@@ -184,3 +184,60 @@ def test_greedy_follower(test_navmesh, move_filter_fn, action_noise, pbar):
 
     if not test_all:
         assert test_spl / NUM_TESTS >= ACCEPTABLE_SPLS[(move_filter_fn, action_noise)]
+
+
+@pytest.mark.parametrize("move_filter_fn", ["try_step", "try_step_no_sliding"])
+def test_greedy_follower_action_table(move_filter_fn):
+    test_navmesh = test_navmeshes[1]
+    if not osp.exists(test_navmesh):
+        pytest.skip(f"{test_navmesh} not found")
+
+    pathfinder = habitat_sim.PathFinder()
+    pathfinder.load_nav_mesh(test_navmesh)
+    assert pathfinder.is_loaded
+    pathfinder.seed(0)
+
+    scene_graph = habitat_sim.SceneGraph()
+    agent = habitat_sim.Agent(scene_graph.get_root_node().create_child())
+    agent.controls.move_filter_fn = getattr(pathfinder, move_filter_fn)
+    agent.agent_config.action_space["turn_left"].actuation.amount = TURN_DEGREE
+    agent.agent_config.action_space["turn_right"].actuation.amount = TURN_DEGREE
+
+    follower = habitat_sim.GreedyGeodesicFollower(
+        pathfinder,
+        agent,
+        forward_key="move_forward",
+        left_key="turn_left",
+        right_key="turn_right",
+    )
+
+    while True:
+        goal_pos = pathfinder.get_random_navigable_point()
+        if pathfinder.island_radius(goal_pos) > 10.0:
+            break
+    assert follower.build_action_table(goal_pos) > 0
+
+    # every episode shares the goal, so actions are looked up
+    num_reached = 0
+    starts = pathfinder.get_random_navigable_points_on_island(20, goal_pos)
+    for start in starts:
+        state = habitat_sim.AgentState()
+        state.position = start
+        agent.state = state
+        try:
+            action_list = follower.find_path(goal_pos)
+        except habitat_sim.errors.GreedyFollowerError:
+            continue
+
+        for action in action_list:
+            if action is None:
+                break
+            agent.act(action)
+
+        path = habitat_sim.ShortestPath()
+        path.requested_start = agent.state.position
+        path.requested_end = goal_pos
+        pathfinder.find_path(path)
+        num_reached += path.geodesic_distance <= follower.forward_spec.amount
+
+    assert num_reached / len(starts) >= 0.8
@@ -196,3 +196,38 @@ def test_save_navmesh_settings(agent_radius_mul, tmpdir):
         pathfinder.load_nav_mesh(osp.join(tmpdir, "out.navmesh"))
         assert pathfinder.is_loaded
         assert sim.pathfinder.nav_mesh_settings == pathfinder.nav_mesh_settings
+
+
+def test_crowd_recomputed_navmesh():
+    test_scene = osp.join(
+        base_dir, "data/scene_datasets/habitat-test-scenes/skokloster-castle.glb"
+    )
+    if not osp.exists(test_scene):
+        pytest.skip(f"{test_scene} not found")
+
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = test_scene
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        crowd = habitat_sim.nav.Crowd(sim.pathfinder, 4)
+        start = sim.pathfinder.get_random_navigable_point()
+        assert crowd.add_agent(start) != -1
+        crowd.update(0.1)
+        assert crowd.has_valid_navmesh
+
+        navmesh_settings = habitat_sim.NavMeshSettings()
+        navmesh_settings.set_defaults()
+        assert sim.recompute_navmesh(sim.pathfinder, navmesh_settings)
+
+        # the crowd's navmesh is gone, using it raises instead of crashing
+        assert not crowd.has_valid_navmesh
+        with pytest.raises(AssertionError):
+            crowd.update(0.1)
+        with pytest.raises(AssertionError):
+            crowd.add_agent(start)
+
+        crowd = habitat_sim.nav.Crowd(sim.pathfinder, 4)
+        assert crowd.has_valid_navmesh
+        assert crowd.add_agent(sim.pathfinder.snap_point(start)) != -1
+        crowd.update(0.1)
@@ -544,6 +544,39 @@ def test_raycast():
             assert abs(raycast_results.hits[0].ray_distance - 1.89) < 0.001
             assert raycast_results.hits[0].object_id == cube_obj.object_id
 
+            # test batched raycasts against the single ray API
+            origins = np.array(
+                [[0.0, 0, 0], [0.0, 0, 2.0], [0.0, 0, 2.0]], dtype=np.float32
+            )
+            directions = np.array(
+                [[1.0, 0, 0], [1.0, 0, 0], [0, 1.0, 0]], dtype=np.float32
+            )
+            for all_hits in [False, True]:
+                batch_results = sim.cast_rays(origins, directions, all_hits=all_hits)
+                assert batch_results.num_rays == len(origins)
+                offsets = batch_results.hit_offsets
+                assert len(offsets) == len(origins) + 1
+                assert offsets[-1] == len(batch_results.object_ids)
+                assert batch_results.points.shape == (offsets[-1], 3)
+                for i in range(len(origins)):
+                    ray = habitat_sim.geo.Ray(
+                        mn.Vector3(origins[i]), mn.Vector3(directions[i])
+                    )
+                    hits = sim.cast_ray(ray).hits
+                    if not all_hits:
+                        hits = hits[:1]
+                    assert batch_results.num_hits(i) == len(hits)
+                    for j, hit in enumerate(hits):
+                        k = offsets[i] + j
+                        assert batch_results.object_ids[k] == hit.object_id
+                        assert np.allclose(batch_results.points[k], hit.point)
+                        assert np.allclose(batch_results.normals[k], hit.normal)
+                        assert np.isclose(
+                            batch_results.ray_distances[k], hit.ray_distance
+                        )
+                with pytest.raises(AssertionError):
+                    batch_results.num_hits(len(origins))
+
             # test raycast against a non-collidable object.
             # should not register a hit with the object.
             cube_obj.collidable = False
@@ -1012,6 +1045,84 @@ def test_articulated_object_kinematics(test_asset):
         assert np.all(robot.joint_positions >= lower_pos_limits)
 
 
+@pytest.mark.skipif(
+    not habitat_sim.built_with_bullet,
+    reason="ArticulatedObject API requires Bullet physics.",
+)
+def test_articulated_object_joint_state_arrays():
+    cfg_settings = examples.settings.default_sim_settings.copy()
+    cfg_settings["scene"] = "NONE"
+    cfg_settings["enable_physics"] = True
+    hab_cfg = examples.settings.make_cfg(cfg_settings)
+
+    with habitat_sim.Simulator(hab_cfg) as sim:
+        art_obj_mgr = sim.get_articulated_object_manager()
+        robots = [
+            art_obj_mgr.add_articulated_object_from_urdf(
+                filepath="data/test_assets/urdf/kuka_iiwa/model_free_base.urdf"
+            ),
+            art_obj_mgr.add_articulated_object_from_urdf(
+                filepath="data/test_assets/urdf/prim_chain.urdf"
+            ),
+        ]
+        for robot in robots:
+            assert robot.num_dofs == len(robot.joint_forces)
+            assert robot.num_joint_positions == len(robot.joint_positions)
+
+            # set from a numpy array, read back through both APIs
+            target = np.linspace(0.1, 0.5, robot.num_joint_positions).astype(
+                np.float32
+            )
+            robot.set_joint_positions_array(target)
+            assert np.allclose(robot.joint_positions, target)
+            assert np.allclose(robot.get_joint_positions_array(), target)
+
+            vels = np.full(robot.num_dofs, 0.25, dtype=np.float32)
+            robot.set_joint_velocities_array(vels)
+            assert np.allclose(robot.get_joint_velocities_array(), vels)
+
+            # writing into a caller-provided buffer reuses it
+            out = np.zeros(robot.num_joint_positions, dtype=np.float32)
+            result = robot.get_joint_positions_array(out=out)
+            assert np.shares_memory(result, out)
+            assert np.allclose(out, target)
+
+            # buffers of the wrong dtype or size are rejected, not copied
+            with pytest.raises(AssertionError):
+                robot.get_joint_positions_array(
+                    out=np.zeros(robot.num_joint_positions, dtype=np.float64)
+                )
+            with pytest.raises(AssertionError):
+                robot.get_joint_positions_array(
+                    out=np.zeros(robot.num_joint_positions + 1, dtype=np.float32)
+                )
+
+        # batch gather over several objects
+        ids = [robot.object_id for robot in robots]
+        positions = art_obj_mgr.get_joint_positions(ids)
+        assert len(positions) == art_obj_mgr.get_num_joint_positions(ids)
+        assert np.allclose(
+            positions, np.concatenate([robot.joint_positions for robot in robots])
+        )
+        velocities = np.zeros(art_obj_mgr.get_num_dofs(ids), dtype=np.float32)
+        art_obj_mgr.get_joint_velocities(ids, out=velocities)
+        assert np.allclose(
+            velocities,
+            np.concatenate([robot.joint_velocities for robot in robots]),
+        )
+
+        # unknown object ids are rejected instead of aborting
+        bad_ids = ids + [max(ids) + 1000]
+        with pytest.raises(AssertionError):
+            art_obj_mgr.get_num_dofs(bad_ids)
+        with pytest.raises(AssertionError):
+            art_obj_mgr.get_num_joint_positions(bad_ids)
+        with pytest.raises(AssertionError):
+            art_obj_mgr.get_joint_positions(bad_ids)
+        with pytest.raises(AssertionError):
+            art_obj_mgr.get_joint_velocities(bad_ids)
+
+
 @pytest.mark.skipif(
     not osp.exists("data/scene_datasets/habitat-test-scenes/apartment_1.glb"),
     reason="Requires the habitat-test-scenes",
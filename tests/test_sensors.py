@@ -365,3 +365,64 @@ def test_rgba_noise(scene_and_dataset, model_name, make_cfg_settings):
         assert np.linalg.norm(
             obs["color_sensor"].astype(float) - gt.astype(float)
         ) > 1.5e-2 * np.linalg.norm(gt.astype(float)), "Incorrect color_sensor output"
+
+
+@pytest.mark.skipif(
+    not habitat_sim.built_with_bullet,
+    reason="Lidar sensors raycast against the Bullet collision world",
+)
+@pytest.mark.skipif(
+    not osp.exists("data/scene_datasets/habitat-test-scenes/apartment_1.glb"),
+    reason="Requires the habitat-test-scenes",
+)
+def test_lidar_sensor(make_cfg_settings):
+    make_cfg_settings = {k: v for k, v in make_cfg_settings.items()}
+    make_cfg_settings["color_sensor"] = False
+    make_cfg_settings["semantic_sensor"] = False
+    make_cfg_settings["depth_sensor"] = False
+    make_cfg_settings["enable_physics"] = True
+    make_cfg_settings[
+        "scene"
+    ] = "data/scene_datasets/habitat-test-scenes/apartment_1.glb"
+    cfg = make_cfg(make_cfg_settings)
+
+    lidar_spec = habitat_sim.LidarSensorSpec()
+    lidar_spec.uuid = "lidar"
+    lidar_spec.position = [0, make_cfg_settings["sensor_height"], 0]
+    lidar_spec.horizontal_resolution = 180
+    lidar_spec.vertical_resolution = 4
+    lidar_spec.vertical_fov_min = mn.Deg(-15.0)
+    lidar_spec.vertical_fov_max = mn.Deg(15.0)
+    lidar_spec.max_range = 20.0
+    cfg.agents[0].sensor_specifications = [lidar_spec]
+
+    with habitat_sim.Simulator(cfg) as sim:
+        # lidar sensors do not need a renderer
+        assert sim.renderer is None
+
+        obs = sim.get_sensor_observations()["lidar"]
+        assert obs.shape == (4, 180)
+        assert obs.dtype == np.float32
+        assert np.all(obs >= 0.0) and np.all(obs <= lidar_spec.max_range)
+        assert np.count_nonzero(obs) > 0
+
+        # every beam agrees with a single raycast along its direction
+        lidar = sim.get_agent(0)._sensors["lidar"]
+        directions = lidar.beam_directions
+        assert directions.shape == (lidar_spec.num_beams, 3)
+        assert np.allclose(np.linalg.norm(directions, axis=1), 1.0)
+        transform = lidar.node.absolute_transformation()
+        for i in range(0, lidar_spec.num_beams, 37):
+            ray = habitat_sim.geo.Ray(
+                transform.translation,
+                transform.transform_vector(mn.Vector3(directions[i])).normalized(),
+            )
+            hits = sim.cast_ray(ray, lidar_spec.max_range).hits
+            expected = hits[0].ray_distance if len(hits) else 0.0
+            assert np.isclose(obs.flat[i], expected, atol=1e-4)
+
+        # scanning into a caller-provided buffer reuses it
+        out = np.empty(lidar_spec.num_beams, dtype=np.float32)
+        ranges = lidar.scan(sim, out)
+        assert np.shares_memory(ranges, out)
+        assert np.allclose(ranges, obs)